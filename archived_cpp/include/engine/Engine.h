@@ -6,7 +6,8 @@
 namespace SwordAndStone {
 
 // Forward declarations
-namespace Renderer { class IRenderer; }
+namespace Renderer { class IRenderer; class CommandBuffer; class CommandListRecorder; }
+namespace Platform { class FrameArena; }
 class Window;
 class InputManager;
 class TimeManager;
@@ -28,10 +29,15 @@ public:
     
     // Accessors
     Renderer::IRenderer* GetRenderer() const { return m_renderer.get(); }
+    Renderer::CommandBuffer* GetCommandBuffer() const { return m_commandBuffer.get(); }
+    Renderer::CommandListRecorder* GetCommandRecorder() const { return m_commandRecorder.get(); }
     Window* GetWindow() const { return m_window.get(); }
     InputManager* GetInput() const { return m_input.get(); }
     TimeManager* GetTime() const { return m_time.get(); }
     SceneManager* GetScene() const { return m_scene.get(); }
+    // Per-frame scratch memory for main-thread systems (command submission, chunk culling);
+    // allocations stay valid until the end of the next frame
+    Platform::FrameArena* GetFrameArena() const { return m_frameArena.get(); }
     
     bool IsRunning() const { return m_isRunning; }
     void RequestExit() { m_isRunning = false; }
@@ -39,9 +45,12 @@ public:
 private:
     std::unique_ptr<Window> m_window;
     std::unique_ptr<Renderer::IRenderer> m_renderer;
+    std::unique_ptr<Renderer::CommandBuffer> m_commandBuffer;
+    std::unique_ptr<Renderer::CommandListRecorder> m_commandRecorder;
     std::unique_ptr<InputManager> m_input;
     std::unique_ptr<TimeManager> m_time;
     std::unique_ptr<SceneManager> m_scene;
+    std::unique_ptr<Platform::FrameArena> m_frameArena;
     
     bool m_isRunning;
     
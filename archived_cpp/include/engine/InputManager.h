@@ -1,33 +1,100 @@
 #pragma once
 
+#include "platform/SpscQueue.h"
+#include <atomic>
+#include <bitset>
 #include <cstdint>
 
 namespace SwordAndStone {
 
 class Window;
 
+enum class InputEventType : uint8_t {
+    Key,
+    MouseButton,
+    Scroll
+};
+
+struct InputEvent {
+    InputEventType type;
+    bool down;      // keys and buttons
+    int16_t code;   // GLFW key or mouse button code
+    float scroll;   // vertical scroll offset
+};
+
+/**
+ * Input Manager
+ * Event-driven input. Window callbacks (or a dedicated input thread) push
+ * key, button and scroll events into a lock-free single-producer queue;
+ * Update() drains it once a frame into bitsets, so down, pressed and
+ * released queries are O(1) lookups with no calls into the windowing
+ * layer. A press and release inside one frame reports both edges. Cursor
+ * motion bypasses the queue: the producer overwrites an atomic position at
+ * whatever rate the device reports, and the consumer latches it. LateLatch()
+ * re-polls and re-latches the cursor just before render submission, so the
+ * camera sees motion up to that point rather than from the start of the
+ * frame. Key codes are GLFW's.
+ */
 class InputManager {
 public:
+    static constexpr int KEY_COUNT = 512;         // covers GLFW_KEY_LAST
+    static constexpr int MOUSE_BUTTON_COUNT = 8;  // GLFW_MOUSE_BUTTON_LAST + 1
+    static constexpr int KEY_ESCAPE = 256;        // GLFW_KEY_ESCAPE
+    static constexpr uint32_t EVENT_CAPACITY = 256;
+
     InputManager();
     ~InputManager();
 
     void Initialize(Window* window);
     void Update();
-    
+
+    // Polls the window again and folds cursor motion since Update() into this frame's delta
+    void LateLatch();
+
     bool IsKeyPressed(int keyCode) const;
     bool IsKeyDown(int keyCode) const;
     bool IsKeyReleased(int keyCode) const;
-    
+
     bool IsMouseButtonPressed(int button) const;
     bool IsMouseButtonDown(int button) const;
     bool IsMouseButtonReleased(int button) const;
-    
+
     void GetMousePosition(float& x, float& y) const;
     void GetMouseDelta(float& dx, float& dy) const;
-    
+    float GetScrollDelta() const { return m_scrollDelta; }
+
+    // Producer side, called from window callbacks; safe from one thread other than the consumer
+    void PushKey(int keyCode, bool down);
+    void PushMouseButton(int button, bool down);
+    void PushScroll(float offset);
+    void SetCursorPosition(double x, double y);
+
+    // Events lost to a full queue since startup
+    uint64_t GetDroppedEventCount() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+
 private:
     Window* m_window;
-    // TODO: Add key and mouse state arrays
+
+    Platform::SpscQueue<InputEvent, EVENT_CAPACITY> m_events;
+    std::atomic<uint64_t> m_droppedEvents;
+    // Packed x/y floats, so the pair is published in one store
+    std::atomic<uint64_t> m_cursor;
+
+    std::bitset<KEY_COUNT> m_keysDown;
+    std::bitset<KEY_COUNT> m_keysPressed;
+    std::bitset<KEY_COUNT> m_keysReleased;
+    std::bitset<MOUSE_BUTTON_COUNT> m_buttonsDown;
+    std::bitset<MOUSE_BUTTON_COUNT> m_buttonsPressed;
+    std::bitset<MOUSE_BUTTON_COUNT> m_buttonsReleased;
+
+    float m_mouseX;       // latched position
+    float m_mouseY;
+    float m_mouseDeltaX;  // accumulated over the frame, including late latches
+    float m_mouseDeltaY;
+    float m_scrollDelta;
+
+    void Push(const InputEvent& event);
+    void LatchCursor();
 };
 
 } // namespace SwordAndStone
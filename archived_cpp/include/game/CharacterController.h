@@ -0,0 +1,42 @@
+#pragma once
+
+#include "game/VoxelSystem.h"
+#include "platform/JobSystem.h"
+
+namespace SwordAndStone {
+namespace Game {
+
+struct CharacterDesc {
+    float radius = 0.3f;        // half the width of the collision box
+    float height = 1.8f;
+    float stepHeight = 1.0f;    // ledges up to this high are climbed without jumping
+    float snapDistance = 1.0f;  // drops up to this deep are walked down without leaving the ground
+    float gravity = 20.0f;
+};
+
+struct Character {
+    CharacterDesc desc;
+    float position[3] = { 0.0f, 0.0f, 0.0f };  // bottom center of the box
+    float velocity[3] = { 0.0f, 0.0f, 0.0f };  // set the horizontal part and jumps; gravity is applied here
+    bool grounded = false;
+};
+
+/**
+ * Character Controller
+ * Kinematic box movement against the voxel grid. Gravity is applied, then
+ * the motion is resolved one axis at a time, vertical first, each with a
+ * swept box so nothing is tunnelled through, and the blocked face is
+ * snapped exactly onto the voxel boundary. A grounded character blocked
+ * horizontally retries the move lifted by up to stepHeight and keeps
+ * whichever attempt got further, so hillsides, which are staircases of
+ * whole voxels, are walked up; ground snapping walks them down. Cost
+ * depends only on the voxels the box passes, never on mesh complexity.
+ */
+void MoveCharacter(const VoxelSystem& voxels, Character& character, float deltaTime);
+
+// Moves players and NPCs together, in batches on the job system
+void MoveCharacters(const VoxelSystem& voxels, Character* characters, uint32_t count, float deltaTime,
+                    Platform::JobSystem* jobSystem = nullptr);
+
+} // namespace Game
+} // namespace SwordAndStone
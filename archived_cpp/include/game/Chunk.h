@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Game {
+
+constexpr int CHUNK_SIZE = 16;
+constexpr int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+// Voxel types, matching the GDScript VoxelType enum
+enum class VoxelType : uint8_t {
+    Air = 0,
+    Grass,
+    Dirt,
+    Stone,
+    Bedrock,
+    Water,
+    Sand,
+    Wood,
+    Leaves,
+    IronOre,
+    CopperOre,
+    TinOre,
+    Coal,
+    Clay,
+    Cobblestone,
+    WoodPlanks,
+    Thatch,
+    Bricks,
+    StoneBricks,
+    GoldOre,
+    SilverOre,
+    Snow,
+    Ice,
+    Gravel
+};
+
+constexpr int VOXEL_TYPE_COUNT = static_cast<int>(VoxelType::Gravel) + 1;
+
+inline bool IsSolid(VoxelType type) {
+    return type != VoxelType::Air && type != VoxelType::Water;
+}
+
+inline bool IsTransparent(VoxelType type) {
+    return type == VoxelType::Air || type == VoxelType::Water || type == VoxelType::Leaves;
+}
+
+// Blocks sight; used for visibility rather than collision
+inline bool IsOpaque(VoxelType type) {
+    return !IsTransparent(type);
+}
+
+// Chunk faces, ordered so that face ^ 1 is the opposite face
+enum class ChunkFace : uint8_t {
+    NegX = 0,
+    PosX,
+    NegY,
+    PosY,
+    NegZ,
+    PosZ
+};
+
+constexpr int CHUNK_FACE_COUNT = 6;
+
+struct ChunkCoord {
+    int x;
+    int y;
+    int z;
+
+    bool operator==(const ChunkCoord& other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+    bool operator!=(const ChunkCoord& other) const { return !(*this == other); }
+};
+
+struct ChunkCoordHash {
+    size_t operator()(const ChunkCoord& coord) const {
+        uint64_t packed = (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) * 73856093u) ^
+                          (static_cast<uint64_t>(static_cast<uint32_t>(coord.y)) * 19349663u) ^
+                          (static_cast<uint64_t>(static_cast<uint32_t>(coord.z)) * 83492791u);
+        return std::hash<uint64_t>()(packed);
+    }
+};
+
+/**
+ * Voxel Chunk
+ * CHUNK_SIZE^3 voxels. A chunk holding a single voxel type (all air, all
+ * stone) stores no voxel array at all. The chunk also caches which pairs of
+ * its faces are connected through non-opaque voxels; the visibility pass
+ * walks that graph to skip chunks sealed off behind solid terrain, and uses
+ * the solid base of the chunk as an occluder.
+ */
+class Chunk {
+public:
+    explicit Chunk(VoxelType fill = VoxelType::Air);
+
+    VoxelType Get(int x, int y, int z) const {
+        return m_voxels.empty() ? m_uniformType : m_voxels[Index(x, y, z)];
+    }
+    void Set(int x, int y, int z, VoxelType type);
+    void Fill(VoxelType type);
+
+    bool IsUniform() const { return m_voxels.empty(); }
+    VoxelType GetUniformType() const { return m_uniformType; }
+    const VoxelType* GetData() const { return m_voxels.empty() ? nullptr : m_voxels.data(); }
+
+    // Drops the voxel array again if every voxel has the same type
+    void Compact();
+
+    // Connectivity: one bit per unordered pair of distinct faces
+    void UpdateConnectivity();
+    uint16_t GetConnectivity() const { return m_connectivity; }
+    bool AreFacesConnected(ChunkFace a, ChunkFace b) const;
+
+    // Occluder: the number of completely opaque layers counted up from y = 0,
+    // so the chunk hides everything behind the box of that height
+    void UpdateOccluder();
+    int GetOccluderHeight() const { return m_occluderHeight; }
+
+    bool IsDirty() const { return m_dirty; }
+    void SetDirty(bool dirty) { m_dirty = dirty; }
+
+    static int Index(int x, int y, int z) { return (y * CHUNK_SIZE + z) * CHUNK_SIZE + x; }
+    static uint16_t FacePairBit(ChunkFace a, ChunkFace b);
+
+    static constexpr uint16_t ALL_FACES_CONNECTED = 0x7FFF;
+
+private:
+    VoxelType m_uniformType;
+    std::vector<VoxelType> m_voxels;  // empty when uniform
+    uint16_t m_connectivity;
+    uint8_t m_occluderHeight;
+    bool m_dirty;
+};
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "game/VoxelSystem.h"
+#include "renderer/Frustum.h"
+#include "renderer/OcclusionCuller.h"
+namespace SwordAndStone {
+
+namespace Platform {
+class FrameArena;
+}
+
+namespace Game {
+
+struct ChunkVisibilityStats {
+    uint32_t chunksInRange = 0;       // loaded, non-empty chunks within render distance
+    uint32_t frustumCulled = 0;
+    uint32_t connectivityCulled = 0;  // in the frustum but sealed off behind opaque voxels
+    uint32_t occlusionCulled = 0;     // reachable, but hidden behind nearer solid chunks
+    uint32_t occluders = 0;
+    uint32_t visible = 0;
+};
+
+/**
+ * Chunk Visibility
+ * Finds the chunks worth drawing around the camera. Chunk bounds in render
+ * distance are frustum tested in one SIMD batch, then a breadth-first walk
+ * from the camera chunk only crosses a chunk from the face it entered to a
+ * face connected to it through non-opaque voxels, and never turns back
+ * towards the camera. Chunks the walk cannot reach (caves, buried terrain)
+ * are skipped. With an occlusion culler attached, the solid bases of the
+ * nearest visible chunks are rasterized as occluders and the remaining
+ * chunks are tested against the resulting depth pyramid.
+ */
+class ChunkVisibility {
+public:
+    ChunkVisibility();
+
+    void SetCaveCulling(bool enabled) { m_caveCulling = enabled; }
+    bool IsCaveCullingEnabled() const { return m_caveCulling; }
+
+    // The caller starts the culler's frame with the view-projection matrix
+    // before Update(); afterwards the same pyramid can test entity bounds
+    void SetOcclusionCuller(Renderer::OcclusionCuller* culler) { m_occlusionCuller = culler; }
+    Renderer::OcclusionCuller* GetOcclusionCuller() const { return m_occlusionCuller; }
+
+    // The occlusion pass takes its scratch from here when set, otherwise from the thread's scratch stack
+    void SetFrameArena(Platform::FrameArena* frameArena) { m_frameArena = frameArena; }
+
+    void Update(const VoxelSystem& voxels, const float cameraPosition[3], const Renderer::Frustum& frustum,
+                int renderDistance = VoxelSystem::RENDER_DISTANCE);
+
+    const std::vector<ChunkCoord>& GetVisibleChunks() const { return m_visibleChunks; }
+    const ChunkVisibilityStats& GetStats() const { return m_stats; }
+
+private:
+    struct Step {
+        uint32_t index;
+        int8_t entryFace;    // -1 for the camera chunk
+        uint8_t directions;  // bit per ChunkFace already travelled through
+    };
+
+    struct OccluderCandidate {
+        float score;  // lower is better
+        uint32_t index;
+
+        bool operator<(const OccluderCandidate& other) const { return score < other.score; }
+    };
+
+    static constexpr size_t MAX_OCCLUDERS = 64;
+
+    bool m_caveCulling;
+    Renderer::OcclusionCuller* m_occlusionCuller;
+    Platform::FrameArena* m_frameArena;
+    ChunkCoord m_origin;  // lowest chunk of the region
+    int m_side;           // region width and depth in chunks
+
+    // Region chunk bounds, structure of arrays for the batched frustum test
+    std::vector<float> m_minX;
+    std::vector<float> m_minY;
+    std::vector<float> m_minZ;
+    std::vector<float> m_maxX;
+    std::vector<float> m_maxY;
+    std::vector<float> m_maxZ;
+
+    std::vector<uint8_t> m_inFrustum;
+    std::vector<uint8_t> m_visited;
+    std::vector<const Chunk*> m_chunks;
+    std::vector<Step> m_queue;
+
+    std::vector<ChunkCoord> m_visibleChunks;
+    ChunkVisibilityStats m_stats;
+
+    void RebuildBounds(const ChunkCoord& origin, int side);
+    void CullOccluded(const float cameraPosition[3]);
+    uint32_t RegionIndex(int x, int y, int z) const {
+        return static_cast<uint32_t>((y * m_side + (z - m_origin.z)) * m_side + (x - m_origin.x));
+    }
+    ChunkCoord RegionCoord(uint32_t index) const;
+};
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+namespace SwordAndStone {
+namespace Game {
+
+// Components for the simple, numerous entities GameWorld simulates natively
+
+struct Position {
+    float x, y, z;
+};
+
+struct Velocity {
+    float x, y, z;
+};
+
+// Bounding sphere radius around Position; entities with both are tracked by GameWorld's spatial grid
+struct Bounds {
+    float radius;
+};
+
+// Downward acceleration in blocks per second squared
+struct Gravity {
+    float acceleration;
+};
+
+// Seconds until the entity is destroyed
+struct Lifetime {
+    float remaining;
+};
+
+struct ItemDrop {
+    uint16_t itemType;
+    uint16_t count;
+};
+
+struct Projectile {
+    float damage;
+    uint32_t owner;  // Entity::index of the shooter
+};
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "platform/JobSystem.h"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Game {
+
+struct Entity {
+    uint32_t index;
+    uint32_t generation;  // bumped when the index is freed, so stale handles stop resolving
+
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+constexpr Entity NULL_ENTITY = { 0xFFFFFFFFu, 0 };
+
+using ComponentMask = uint64_t;
+constexpr uint32_t MAX_COMPONENT_TYPES = 64;
+
+struct ComponentInfo {
+    uint32_t size;
+    uint32_t alignment;
+};
+
+// Assigns the next component id; use GetComponentId<T>() instead
+uint32_t RegisterComponentType(uint32_t size, uint32_t alignment);
+const ComponentInfo& GetComponentInfo(uint32_t id);
+
+// Ids are assigned on first use, process-wide. Components are moved between chunks with memcpy.
+template<typename T>
+uint32_t GetComponentId() {
+    static_assert(std::is_trivially_copyable<T>::value, "components must be trivially copyable");
+    static const uint32_t id = RegisterComponentType(sizeof(T), alignof(T));
+    return id;
+}
+
+template<typename... Ts>
+ComponentMask MakeComponentMask() {
+    return (ComponentMask(0) | ... | (ComponentMask(1) << GetComponentId<Ts>()));
+}
+
+/**
+ * Entity Commands
+ * Structural changes recorded while the registry is being iterated (for
+ * example from parallel systems) and applied later by
+ * EntityRegistry::FlushCommands(). Commands on entities that are gone by
+ * then are ignored.
+ */
+class EntityCommands {
+public:
+    void Destroy(Entity entity) { Record(Op::Destroy, entity, 0, nullptr, 0); }
+
+    template<typename T>
+    void Add(Entity entity, const T& value) {
+        Record(Op::Add, entity, GetComponentId<T>(), &value, sizeof(T));
+    }
+
+    template<typename T>
+    void Remove(Entity entity) {
+        Record(Op::Remove, entity, GetComponentId<T>(), nullptr, 0);
+    }
+
+    template<typename... Ts>
+    void Spawn(const Ts&... values) {
+        Record(Op::Spawn, NULL_ENTITY, sizeof...(Ts), nullptr, 0);
+        (Record(Op::SpawnComponent, NULL_ENTITY, GetComponentId<Ts>(), &values, sizeof(Ts)), ...);
+    }
+
+    bool IsEmpty() const { return m_bytes.empty(); }
+    void Clear() { m_bytes.clear(); }
+
+private:
+    friend class EntityRegistry;
+
+    enum class Op : uint8_t {
+        Destroy,
+        Add,
+        Remove,
+        Spawn,           // component holds the number of SpawnComponent records that follow
+        SpawnComponent
+    };
+
+    // Followed by size payload bytes; read back with memcpy, so records need no padding
+    struct Header {
+        Entity entity;
+        uint32_t component;
+        uint32_t size;
+        Op op;
+    };
+
+    // Cleared after playback but keeps its capacity
+    std::vector<uint8_t> m_bytes;
+
+    void Record(Op op, Entity entity, uint32_t component, const void* payload, uint32_t size);
+};
+
+/**
+ * Entity Registry
+ * Archetype-based entity storage. Entities with the same set of components
+ * share an archetype, whose rows live in fixed-size chunks laid out as one
+ * array per component (SoA), so a query walks contiguous arrays of exactly
+ * the components it asks for. Adding or removing a component moves the
+ * entity's row to the neighbouring archetype through a cached edge; removal
+ * fills the hole with the archetype's last row. Query results are cached
+ * per component mask and extended as archetypes appear. Structural changes
+ * are not thread-safe: systems running on workers record them into
+ * GetCommands() and the owner applies them with FlushCommands().
+ */
+class EntityRegistry {
+public:
+    static constexpr uint32_t CHUNK_BYTES = 16 * 1024;
+
+    explicit EntityRegistry(Platform::JobSystem* jobSystem = nullptr);
+    ~EntityRegistry();
+
+    EntityRegistry(const EntityRegistry&) = delete;
+    EntityRegistry& operator=(const EntityRegistry&) = delete;
+
+    template<typename... Ts>
+    Entity Create(const Ts&... values) {
+        Entity entity = CreateWithMask(MakeComponentMask<Ts...>());
+        (std::memcpy(GetComponentPointer(entity, GetComponentId<Ts>()), &values, sizeof(Ts)), ...);
+        return entity;
+    }
+
+    void Destroy(Entity entity);
+    bool IsAlive(Entity entity) const;
+
+    // Replaces the value if the entity already has T
+    template<typename T>
+    void Add(Entity entity, const T& value) {
+        if (void* component = AddComponent(entity, GetComponentId<T>())) {
+            std::memcpy(component, &value, sizeof(T));
+        }
+    }
+
+    template<typename T>
+    void Remove(Entity entity) {
+        RemoveComponent(entity, GetComponentId<T>());
+    }
+
+    template<typename T>
+    bool Has(Entity entity) const {
+        return GetComponentPointer(entity, GetComponentId<T>()) != nullptr;
+    }
+
+    // Null if the entity is dead or lacks T; invalidated by structural changes
+    template<typename T>
+    T* Get(Entity entity) {
+        return static_cast<T*>(GetComponentPointer(entity, GetComponentId<T>()));
+    }
+
+    // Calls body(count, entities, Ts* arrays...) once per non-empty chunk holding all of Ts
+    template<typename... Ts, typename Func>
+    void ForEachChunk(Func&& body) {
+        for (uint32_t archetypeIndex : MatchArchetypes(MakeComponentMask<Ts...>())) {
+            Archetype& archetype = *m_archetypes[archetypeIndex];
+            for (Chunk& chunk : archetype.chunks) {
+                InvokeChunk<Ts...>(archetype, chunk, body);
+            }
+        }
+    }
+
+    // Calls body(entity, Ts&...) for every entity holding all of Ts
+    template<typename... Ts, typename Func>
+    void ForEach(Func&& body) {
+        ForEachChunk<Ts...>([&body](uint32_t count, const Entity* entities, Ts*... components) {
+            for (uint32_t i = 0; i < count; i++) {
+                body(entities[i], components[i]...);
+            }
+        });
+    }
+
+    // ForEachChunk with chunks spread over the job system. body runs concurrently and must not make
+    // structural changes directly; it records them into GetCommands().
+    template<typename... Ts, typename Func>
+    void ParallelForEachChunk(Func&& body, uint32_t chunksPerJob = 1) {
+        m_parallelChunks.clear();
+        for (uint32_t archetypeIndex : MatchArchetypes(MakeComponentMask<Ts...>())) {
+            Archetype& archetype = *m_archetypes[archetypeIndex];
+            for (Chunk& chunk : archetype.chunks) {
+                m_parallelChunks.push_back({ &archetype, &chunk });
+            }
+        }
+        GetJobSystem().ParallelFor(static_cast<uint32_t>(m_parallelChunks.size()), chunksPerJob,
+                                   [this, &body](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                InvokeChunk<Ts...>(*m_parallelChunks[i].archetype, *m_parallelChunks[i].chunk, body);
+            }
+        });
+    }
+
+    template<typename... Ts, typename Func>
+    void ParallelForEach(Func&& body, uint32_t chunksPerJob = 1) {
+        ParallelForEachChunk<Ts...>([&body](uint32_t count, const Entity* entities, Ts*... components) {
+            for (uint32_t i = 0; i < count; i++) {
+                body(entities[i], components[i]...);
+            }
+        }, chunksPerJob);
+    }
+
+    // The calling thread's buffer. The registry's own thread and its job system's workers each
+    // have a fixed one, so recording needs no lock; any other thread gets its own on first use.
+    EntityCommands& GetCommands();
+    // Applies every thread's buffer: the registry's own thread and its workers in thread index
+    // order, then other threads in the order they first recorded
+    void FlushCommands();
+
+    size_t GetEntityCount() const { return m_liveCount; }
+    size_t GetArchetypeCount() const { return m_archetypes.size(); }
+    size_t GetChunkCount() const;
+
+private:
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    struct Chunk {
+        uint8_t* data;   // entity array at offset 0, then one array per component
+        uint32_t count;
+    };
+
+    struct Archetype {
+        ComponentMask mask;
+        std::vector<uint32_t> components;        // ids in ascending order
+        uint32_t offsets[MAX_COMPONENT_TYPES];   // array offset within a chunk, by component id
+        uint32_t capacity;                       // rows per chunk
+        uint32_t chunkBytes;
+        std::vector<Chunk> chunks;               // every chunk but the last is full
+        uint32_t addEdges[MAX_COMPONENT_TYPES];  // archetype reached by adding / removing a component
+        uint32_t removeEdges[MAX_COMPONENT_TYPES];
+    };
+
+    struct EntityRecord {
+        uint32_t archetype;
+        uint32_t chunk;
+        uint32_t row;
+        uint32_t generation;
+    };
+
+    struct QueryCache {
+        std::vector<uint32_t> archetypes;
+        size_t scanned = 0;  // archetypes checked so far; they are never removed
+    };
+
+    struct ChunkRef {
+        Archetype* archetype;
+        Chunk* chunk;
+    };
+
+    Platform::JobSystem* m_jobSystem;
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::unordered_map<ComponentMask, uint32_t> m_archetypeByMask;
+    std::unordered_map<ComponentMask, QueryCache> m_queries;
+    std::vector<EntityRecord> m_records;
+    std::vector<uint32_t> m_freeIndices;
+    std::vector<uint8_t*> m_freeChunks;  // CHUNK_BYTES blocks kept for reuse
+    std::vector<ChunkRef> m_parallelChunks;
+    std::vector<EntityCommands> m_commands;  // by the job system's local thread index; 0 is m_ownerThread
+    std::thread::id m_ownerThread;           // the thread that created the registry
+    std::mutex m_otherCommandsMutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<EntityCommands>>> m_otherCommands;
+    size_t m_liveCount;
+
+    template<typename... Ts, typename Func>
+    static void InvokeChunk(Archetype& archetype, Chunk& chunk, Func& body) {
+        if (chunk.count == 0) return;
+        body(chunk.count, reinterpret_cast<const Entity*>(chunk.data),
+             reinterpret_cast<Ts*>(chunk.data + archetype.offsets[GetComponentId<Ts>()])...);
+    }
+
+    Platform::JobSystem& GetJobSystem() const;
+
+    Entity CreateWithMask(ComponentMask mask);
+    void PlayCommands(EntityCommands& commands);
+    void* AddComponent(Entity entity, uint32_t component);
+    void RemoveComponent(Entity entity, uint32_t component);
+    void* GetComponentPointer(Entity entity, uint32_t component) const;
+
+    uint32_t GetArchetype(ComponentMask mask);
+    const std::vector<uint32_t>& MatchArchetypes(ComponentMask mask);
+
+    // Appends an uninitialized row and returns its chunk and row
+    void AllocateRow(uint32_t archetypeIndex, uint32_t entityIndex, uint32_t& chunk, uint32_t& row);
+    // Fills the hole with the archetype's last row and releases an emptied chunk
+    void RemoveRow(uint32_t archetypeIndex, uint32_t chunk, uint32_t row);
+    void MoveEntity(uint32_t entityIndex, uint32_t targetArchetype);
+};
+
+} // namespace Game
+} // namespace SwordAndStone
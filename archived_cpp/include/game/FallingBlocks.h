@@ -0,0 +1,94 @@
+#pragma once
+
+#include "game/VoxelSystem.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Game {
+
+// Blocks that fall when nothing solid is beneath them
+inline bool FallsUnderGravity(VoxelType type) {
+    return type == VoxelType::Sand || type == VoxelType::Gravel;
+}
+
+// A falling block handed to the physics engine instead of being simulated on the grid
+struct EscalatedBlock {
+    int position[3];
+    VoxelType type;
+};
+
+struct FallingBlockStats {
+    uint32_t ticks = 0;       // last Update()
+    uint32_t moved = 0;       // blocks that fell a cell during those ticks
+    uint32_t escalated = 0;
+    size_t active = 0;        // cells to check next tick
+    size_t waiting = 0;       // blocks held up by chunks that are not loaded
+};
+
+/**
+ * Falling Block Simulation
+ * Sand and gravel fall as a cellular automaton on the voxel grid rather than
+ * as rigid bodies. Only cells in the active set are checked: those reported
+ * through Wake() after an edit, and those next to a block that moved. Each
+ * fixed-rate tick visits the active cells bottom-up, so a whole column drops
+ * a cell together, and a block with air or water beneath it swaps places
+ * with it. Writes go through VoxelSystem::SetVoxel, which queues each edited
+ * chunk once, so every chunk an avalanche crosses is refreshed and remeshed
+ * once per frame however many blocks moved in it. Within the focus radius
+ * (usually around the camera) a block about to fall a long way is instead
+ * removed and reported as escalated, a few per tick, so the game can
+ * spawn a rigid body for it; the body writes the block back and wakes it
+ * when it comes to rest. A block over a chunk that is not loaded yet is
+ * set aside, costing nothing per tick, until OnChunkLoaded() reports that
+ * chunk. Cost is proportional to the blocks in motion.
+ */
+class FallingBlockSimulation {
+public:
+    static constexpr float TICK_RATE = 20.0f;
+    static constexpr uint32_t MAX_TICKS_PER_UPDATE = 4;
+    // Drop a block must have ahead of it before it is escalated
+    static constexpr int ESCALATE_MIN_DROP = 3;
+    static constexpr uint32_t MAX_ESCALATIONS_PER_TICK = 4;
+
+    FallingBlockSimulation();
+
+    // Queues the cell and the one above it; call after any edit that could leave a block unsupported
+    void Wake(int x, int y, int z);
+    // Queues the blocks that were waiting for the chunk to load; call once it has its voxels
+    void OnChunkLoaded(const ChunkCoord& coord);
+    void Clear();
+
+    // Runs the ticks due since the last call; the escalated list covers only this call
+    void Update(VoxelSystem& voxels, float deltaTime);
+    // One tick regardless of time; returns the number of blocks that moved
+    uint32_t Tick(VoxelSystem& voxels);
+
+    // Blocks within radius of the position may be escalated; a radius of zero disables escalation
+    void SetFocus(const float position[3], float radius);
+
+    const std::vector<EscalatedBlock>& GetEscalatedBlocks() const { return m_escalated; }
+    size_t GetActiveCount() const { return m_active.size(); }
+    size_t GetWaitingCount() const;
+    const FallingBlockStats& GetStats() const { return m_stats; }
+
+private:
+    bool ShouldEscalate(const VoxelSystem& voxels, int x, int y, int z) const;
+
+    std::vector<uint64_t> m_active;   // packed cell keys, sorted bottom-up at the start of each tick
+    std::vector<uint64_t> m_next;
+    // Cells over unloaded terrain, by the chunk they wait for
+    std::unordered_map<ChunkCoord, std::vector<uint64_t>, ChunkCoordHash> m_waiting;
+    std::vector<EscalatedBlock> m_escalated;
+
+    float m_accumulator;
+    float m_focus[3];
+    float m_focusRadius;
+    uint32_t m_escalationsThisTick;
+
+    FallingBlockStats m_stats;
+};
+
+} // namespace Game
+} // namespace SwordAndStone
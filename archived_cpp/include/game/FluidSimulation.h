@@ -0,0 +1,133 @@
+#pragma once
+
+#include "game/VoxelSystem.h"
+#include "platform/JobSystem.h"
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Game {
+
+struct FluidStats {
+    uint32_t ticks = 0;          // last Update()
+    uint32_t updatedCells = 0;   // active cells visited during those ticks
+    uint32_t changedVoxels = 0;  // cells that became water or dried out
+    size_t awakeChunks = 0;      // chunks with cells to visit next tick
+    size_t chunks = 0;           // chunks with a level layer
+    size_t unloadedChunks = 0;   // unloaded chunks whose flowing levels are kept
+};
+
+/**
+ * Fluid Simulation
+ * Water flow as a cellular automaton over per-voxel levels. Levels live in
+ * a sparse layer beside the voxels: only chunks where water has moved, and
+ * their neighbours, get one, initialised from the voxels with every water
+ * voxel as a source, which never drains. RemoveChunk() keeps the flowing
+ * levels of a chunk being unloaded, so they are restored rather than
+ * turned into sources when the chunk loads again. Flowing water holds 1 to MAX_LEVEL;
+ * each tick a cell pours as much as fits into the cell below and, once
+ * resting on something solid or full, passes one unit to each side that is
+ * at least two lower, so a source spreads MAX_LEVEL - 1 cells over flat
+ * ground and a finite pour levels out to within one unit and stops.
+ *
+ * Only cells in the active set are visited. A cell whose level changed wakes
+ * itself and its neighbours for the next tick; one that changed nothing
+ * drops out, so settled lakes, rivers and puddles cost nothing. Active cells
+ * are kept per chunk and chunks run in parallel in eight checkerboard passes
+ * over (x, y, z) chunk parity. Cells only flow into face neighbours, so two
+ * chunks of the same parity never touch the same cell, and the result does
+ * not depend on the thread count. Wake-ups crossing chunks and the voxel
+ * writes for cells that filled or dried out are collected per chunk and
+ * applied after the passes; the voxel writes go through SetVoxel, so each
+ * touched chunk is refreshed once per frame. Call Wake() after any edit
+ * next to water, and RemoveChunk() before a chunk is unloaded.
+ */
+class FluidSimulation {
+public:
+    static constexpr uint8_t MAX_LEVEL = 8;
+    static constexpr float TICK_RATE = 10.0f;
+    static constexpr uint32_t MAX_TICKS_PER_UPDATE = 2;
+
+    explicit FluidSimulation(Platform::JobSystem* jobSystem = nullptr);
+    ~FluidSimulation();
+
+    // Resyncs the cell with its voxel and queues it and its neighbours
+    void Wake(const VoxelSystem& voxels, int x, int y, int z);
+    // Places flowing water (or a source) and queues it; a level of zero removes water
+    void SetWater(VoxelSystem& voxels, int x, int y, int z, uint8_t level, bool source = false);
+    // 0 for no water, MAX_LEVEL for full cells and sources
+    uint8_t GetLevel(const VoxelSystem& voxels, int x, int y, int z) const;
+
+    // Drops the chunk's level layer but keeps its flowing levels for when it is loaded again
+    void RemoveChunk(const ChunkCoord& coord);
+    void Clear();
+
+    // Runs the ticks due since the last call
+    void Update(VoxelSystem& voxels, float deltaTime);
+    // One tick regardless of time; returns the number of active cells visited
+    uint32_t Tick(VoxelSystem& voxels);
+
+    // Chunks with cells queued for the next tick; zero once everything has settled
+    size_t GetAwakeChunkCount() const { return m_pending.size(); }
+    const FluidStats& GetStats() const { return m_stats; }
+
+private:
+    // Stored cell values besides the flowing levels 0..MAX_LEVEL
+    static constexpr uint8_t SOURCE = MAX_LEVEL + 1;
+    static constexpr uint8_t SOLID = MAX_LEVEL + 2;
+
+    struct FluidChunk;
+
+    struct CellRef {
+        FluidChunk* chunk;
+        uint16_t index;
+    };
+
+    struct FluidChunk {
+        ChunkCoord coord;
+        uint8_t cells[CHUNK_VOLUME];
+        FluidChunk* neighbors[CHUNK_FACE_COUNT];  // indexed by ChunkFace; null where nothing is loaded
+        std::vector<uint16_t> active;             // cells to visit this tick
+        std::vector<uint16_t> next;               // cells queued for the next tick
+        std::bitset<CHUNK_VOLUME> queued;         // cells in next
+        // Written only by this chunk's job during a tick, applied after all passes
+        std::vector<CellRef> wakes;
+        std::vector<CellRef> changes;
+        uint32_t updated;
+    };
+
+    struct SavedCell {
+        uint16_t index;
+        uint8_t level;
+    };
+
+    using FluidChunkMap = std::unordered_map<ChunkCoord, std::unique_ptr<FluidChunk>, ChunkCoordHash>;
+
+    FluidChunk* FindChunk(const ChunkCoord& coord) const;
+    // Null when the voxel chunk is not loaded
+    FluidChunk* GetOrCreateChunk(const VoxelSystem& voxels, const ChunkCoord& coord);
+    CellRef GetCell(const VoxelSystem& voxels, int x, int y, int z, bool create);
+    void Queue(const CellRef& cell);
+    void QueueWithNeighbors(const VoxelSystem& voxels, int x, int y, int z);
+    void FlowChunk(FluidChunk& chunk);
+
+    // The face neighbour of a cell, possibly in the next chunk over
+    static CellRef Neighbor(FluidChunk& chunk, uint16_t index, ChunkFace face);
+
+    Platform::JobSystem* m_jobSystem;
+    FluidChunkMap m_chunks;
+    // Flowing cells of unloaded chunks; everything else in them is rebuilt from the voxels
+    std::unordered_map<ChunkCoord, std::vector<SavedCell>, ChunkCoordHash> m_unloaded;
+    std::vector<FluidChunk*> m_pending;   // chunks with queued cells
+    std::vector<FluidChunk*> m_awake;     // chunks being ticked
+    std::vector<FluidChunk*> m_passes[8];
+
+    float m_accumulator;
+    FluidStats m_stats;
+};
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -1,20 +1,35 @@
 #pragma once
 
+#include "game/EntityRegistry.h"
+#include "game/SpatialGrid.h"
+
 namespace SwordAndStone {
 namespace Game {
 
-// Stub game world class
+/**
+ * Game World
+ * Owns the entity registry and runs the per-tick systems over it: gravity,
+ * integration and lifetime expiry. Systems run chunk-parallel on the job
+ * system; entities they destroy are recorded and removed at the end of the
+ * tick. The spatial grid is then synced, so pickups, triggers, perception
+ * and projectile hits query it instead of scanning every entity.
+ */
 class GameWorld {
 public:
-    GameWorld();
+    explicit GameWorld(Platform::JobSystem* jobSystem = nullptr);
     ~GameWorld();
     
     void Initialize();
     void Update(float deltaTime);
     void Render();
     
+    EntityRegistry& GetEntities() { return m_entities; }
+    // Entities with Position and Bounds, as of the end of the last Update()
+    SpatialGrid& GetSpatialGrid() { return m_spatialGrid; }
+    
 private:
-    // TODO: Add world data
+    EntityRegistry m_entities;
+    SpatialGrid m_spatialGrid;
 };
 
 } // namespace Game
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "renderer/CommandBuffer.h"
+#include <vector>
+
+namespace SwordAndStone {
+namespace Game {
+
+/**
+ * Instance Batcher
+ * Collects per-frame instances of small shared meshes (dropped items,
+ * arrows, falling blocks, decorations) and records one instanced draw per
+ * mesh type. Instance data is written into the renderer's streaming ring;
+ * when the ring is full the mesh's own dynamic buffer is used instead.
+ */
+class InstanceBatcher {
+public:
+    static constexpr uint32_t INVALID_MESH = 0xFFFFFFFFu;
+
+    InstanceBatcher();
+
+    // Buffers are owned by the caller and must outlive the batcher's use of them
+    uint32_t RegisterMesh(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount, uint32_t shader,
+                          uint32_t texture, uint8_t state = Renderer::StateDefault, uint32_t pass = 0);
+
+    // Starts a new frame; instances added since the last Begin() are dropped
+    void Begin();
+
+    void Add(uint32_t mesh, const Renderer::InstanceData& instance);
+    // Rotated about +Y by yaw (radians) and uniformly scaled; color may be null for white
+    void Add(uint32_t mesh, const float position[3], float yaw, float scale, const float* color = nullptr);
+
+    // Uploads every mesh's instances and records one draw per non-empty mesh; returns the draw count
+    uint32_t Flush(Renderer::IRenderer& renderer, Renderer::CommandBuffer& commands);
+
+    // Deletes the fallback instance buffers
+    void Release(Renderer::IRenderer& renderer);
+
+    size_t GetMeshCount() const { return m_meshes.size(); }
+    uint32_t GetInstanceCount(uint32_t mesh) const;
+    uint32_t GetTotalInstanceCount() const { return m_totalInstances; }
+
+private:
+    struct MeshBatch {
+        uint32_t vertexBuffer;
+        uint32_t indexBuffer;
+        uint32_t indexCount;
+        uint32_t shader;
+        uint32_t texture;
+        uint8_t state;
+        uint32_t pass;
+        std::vector<Renderer::InstanceData> instances;
+
+        // Dynamic buffer used when the streaming ring cannot take the instances
+        uint32_t fallbackBuffer = 0;
+        size_t fallbackCapacity = 0;
+    };
+
+    std::vector<MeshBatch> m_meshes;
+    uint32_t m_totalInstances;
+
+    bool UploadFallback(Renderer::IRenderer& renderer, MeshBatch& batch, size_t size);
+};
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace SwordAndStone {
+namespace Game {
+
+/**
+ * Perlin Noise
+ * Seeded 2D gradient noise with fractal (fBm) octaves, normalized to roughly
+ * [-1, 1] like FastNoiseLite's Perlin type used by the GDScript generators.
+ * SampleGrid() evaluates a whole grid of unit-spaced samples at once, four
+ * samples per SIMD step, which is how world chunks are generated.
+ */
+class PerlinNoise {
+public:
+    explicit PerlinNoise(int seed = 0, float frequency = 0.01f, int octaves = 1, float lacunarity = 2.0f,
+                         float gain = 0.5f);
+
+    float Sample(float x, float y) const;
+
+    // out[row * width + column] = Sample(x + column, y + row)
+    void SampleGrid(float x, float y, int width, int height, float* out) const;
+
+    float GetFrequency() const { return m_frequency; }
+    int GetOctaves() const { return m_octaves; }
+
+private:
+    uint8_t m_permutation[512];
+    float m_frequency;
+    int m_octaves;
+    float m_lacunarity;
+    float m_gain;
+    float m_amplitudeScale;  // 1 / sum of octave amplitudes
+
+    float SingleOctave(float x, float y) const;
+    void AccumulateRow(float x, float y, int octave, float frequency, float amplitude, int width, float* out) const;
+};
+
+} // namespace Game
+} // namespace SwordAndStone
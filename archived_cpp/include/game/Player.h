@@ -1,20 +1,44 @@
 #pragma once
 
+#include "game/CharacterController.h"
+
 namespace SwordAndStone {
 namespace Game {
 
-// Stub player class
+/**
+ * Player
+ * First-person movement over the voxel world, mirroring
+ * player_controller.gd: walk and run speeds, jumping from the ground, and
+ * movement relative to the player's yaw. Collision goes through the native
+ * character controller instead of CharacterBody3D over chunk colliders.
+ */
 class Player {
 public:
+    static constexpr float WALK_SPEED = 5.0f;
+    static constexpr float RUN_SPEED = 8.0f;
+    static constexpr float JUMP_VELOCITY = 6.0f;
+    
     Player();
     ~Player();
     
-    void Initialize();
+    void Initialize(const VoxelSystem* voxels, const float spawn[3]);
     void Update(float deltaTime);
     void Render();
     
+    // right and back are in [-1, 1] (forward is -back); yaw is in radians about +Y
+    void SetMoveInput(float right, float back, bool sprint, bool jump);
+    void SetYaw(float yaw) { m_yaw = yaw; }
+    
+    const Character& GetCharacter() const { return m_character; }
+    
 private:
-    // TODO: Add player data
+    const VoxelSystem* m_voxels;
+    Character m_character;
+    float m_yaw;
+    float m_inputRight;
+    float m_inputBack;
+    bool m_sprint;
+    bool m_jump;
 };
 
 } // namespace Game
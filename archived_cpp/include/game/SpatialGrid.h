@@ -0,0 +1,105 @@
+#pragma once
+
+#include "game/EntityRegistry.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Game {
+
+struct SpatialGridStats {
+    uint32_t synced = 0;        // last Sync()
+    uint32_t cellChanges = 0;   // entities that moved to another cell
+    uint32_t removed = 0;       // entities gone from the registry or without bounds
+    size_t entities = 0;
+    size_t cells = 0;
+};
+
+/**
+ * Spatial Grid
+ * Loose hashed grid of entity bounding spheres for proximity queries. An
+ * entity lives in the cell holding its center; since its radius is at most
+ * half a cell, it stays inside that cell grown by half a cell on every side,
+ * so a query only visits the cells overlapping its own bounds grown by the
+ * same margin. Larger entities are kept in a separate list that every query
+ * checks. Cells are hashed, so the world is unbounded, and are kept when
+ * they empty so entities moving back and forth do not reallocate. Insert,
+ * Update and Remove are O(1); Update only touches the cells when the center
+ * crosses a cell boundary. Not thread-safe for writes; queries may run
+ * concurrently with each other.
+ */
+class SpatialGrid {
+public:
+    explicit SpatialGrid(float cellSize = 8.0f);
+
+    // Update() inserts entities that are not yet in the grid
+    void Insert(Entity entity, const float center[3], float radius);
+    void Update(Entity entity, const float center[3], float radius);
+    void Remove(Entity entity);
+    bool Contains(Entity entity) const;
+    void Clear();
+
+    // Incremental per-tick rebuild: updates every entity with Position and Bounds and drops the rest
+    void Sync(EntityRegistry& registry);
+
+    // Append the entities whose bounds overlap the sphere or box; return the number appended
+    uint32_t QueryRadius(const float center[3], float radius, std::vector<Entity>& out) const;
+    uint32_t QueryAABB(const float min[3], const float max[3], std::vector<Entity>& out) const;
+
+    // One radius query per center (xyz triples), run in parallel. Results for query i are
+    // results[offsets[i], offsets[i + 1]); offsets gets count + 1 entries.
+    void QueryRadiusBatch(const float* centers, const float* radii, uint32_t count,
+                          std::vector<uint32_t>& offsets, std::vector<Entity>& results,
+                          Platform::JobSystem* jobSystem = nullptr);
+
+    float GetCellSize() const { return m_cellSize; }
+    size_t GetEntityCount() const { return m_items.size(); }
+    const SpatialGridStats& GetStats() const { return m_stats; }
+
+private:
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+    static constexpr uint32_t LARGE_CELL = 0xFFFFFFFEu;  // cell index of entities in m_large
+    static constexpr uint64_t LARGE_KEY = ~0ull;
+
+    struct Item {
+        Entity entity;
+        float center[3];
+        float radius;
+        uint64_t key;    // cell key, compared on Update() so unmoved entities skip the hash lookup
+        uint32_t cell;   // index into m_cells, or LARGE_CELL
+        uint32_t slot;   // position within the cell's (or m_large's) item list
+        uint32_t stamp;  // Sync() pass that last saw the entity
+    };
+
+    struct Cell {
+        std::vector<uint32_t> items;  // indices into m_items
+    };
+
+    float m_cellSize;
+    float m_inverseCellSize;
+    std::vector<Item> m_items;
+    std::vector<uint32_t> m_itemByEntity;  // by Entity::index
+    std::vector<Cell> m_cells;
+    std::unordered_map<uint64_t, uint32_t> m_cellByKey;
+    std::vector<uint32_t> m_large;
+    uint32_t m_stamp;
+    SpatialGridStats m_stats;
+
+    // Per-batch result lists for QueryRadiusBatch, kept for their capacity
+    std::vector<std::vector<Entity>> m_batchResults;
+    std::vector<std::vector<uint32_t>> m_batchCounts;
+
+    uint64_t GetCellKey(const float point[3]) const;
+    static uint64_t PackCellKey(int32_t x, int32_t y, int32_t z);
+    uint32_t GetCell(uint64_t key);
+    void Link(uint32_t item, uint32_t cell);
+    void Unlink(uint32_t item);
+    bool IsLarge(float radius) const { return radius > 0.5f * m_cellSize; }
+
+    template<typename Overlaps>
+    uint32_t Query(const float min[3], const float max[3], const Overlaps& overlaps, std::vector<Entity>& out) const;
+};
+
+} // namespace Game
+} // namespace SwordAndStone
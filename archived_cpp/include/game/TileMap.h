@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace SwordAndStone {
+namespace Game {
+
+constexpr int TILE_REGION_SIZE = 32;
+constexpr int TILE_REGION_AREA = TILE_REGION_SIZE * TILE_REGION_SIZE;
+
+// Tile ids index the tileset atlas row by row; EMPTY_TILE draws nothing
+constexpr uint16_t EMPTY_TILE = 0xFFFF;
+
+struct TileRegionCoord {
+    int x;
+    int y;
+
+    bool operator==(const TileRegionCoord& other) const { return x == other.x && y == other.y; }
+    bool operator!=(const TileRegionCoord& other) const { return !(*this == other); }
+};
+
+struct TileRegionCoordHash {
+    size_t operator()(const TileRegionCoord& coord) const {
+        uint64_t packed = (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) |
+                          static_cast<uint32_t>(coord.y);
+        return std::hash<uint64_t>()(packed * 0x9E3779B97F4A7C15ull);
+    }
+};
+
+/**
+ * Tile Region
+ * TILE_REGION_SIZE^2 tiles stored row by row. The version changes on every
+ * edit, so renderers can rebuild cached geometry for edited regions only.
+ */
+struct TileRegion {
+    uint16_t tiles[TILE_REGION_AREA];
+    uint32_t version = 1;
+
+    TileRegion() {
+        for (uint16_t& tile : tiles) tile = EMPTY_TILE;
+    }
+
+    uint16_t Get(int x, int y) const { return tiles[y * TILE_REGION_SIZE + x]; }
+};
+
+/**
+ * Tile Map
+ * Sparse 2D tile grid for the top-down and isometric modes, stored as
+ * 32x32 regions created on first write. Missing regions read as empty,
+ * so the map is unbounded in every direction.
+ */
+class TileMap {
+public:
+    using RegionMap = std::unordered_map<TileRegionCoord, std::unique_ptr<TileRegion>, TileRegionCoordHash>;
+
+    uint16_t GetTile(int x, int y) const;
+    void SetTile(int x, int y, uint16_t tile);
+
+    TileRegion* GetRegion(const TileRegionCoord& coord);
+    const TileRegion* GetRegion(const TileRegionCoord& coord) const;
+    TileRegion& GetOrCreateRegion(const TileRegionCoord& coord);
+    // Replaces the region at coord; the new region gets a version newer than the one it replaces
+    TileRegion& SetRegion(const TileRegionCoord& coord, std::unique_ptr<TileRegion> region);
+    void RemoveRegion(const TileRegionCoord& coord);
+    void Clear() { m_regions.clear(); }
+
+    const RegionMap& GetRegions() const { return m_regions; }
+    size_t GetRegionCount() const { return m_regions.size(); }
+
+    static TileRegionCoord TileToRegion(int x, int y);
+
+private:
+    RegionMap m_regions;
+    uint32_t m_nextVersion = 1;
+};
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "game/TileMap.h"
+#include "renderer/CommandBuffer.h"
+#include <unordered_map>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Game {
+
+enum class TileProjection {
+    TopDown,
+    Isometric  // diamond tiles: screen x = (x - y) * width / 2, screen y = (x + y) * height / 2
+};
+
+struct TileRendererDesc {
+    TileProjection projection = TileProjection::TopDown;
+    float tileWidth = 32.0f;
+    float tileHeight = 32.0f;
+    float imageHeight = 0.0f;  // tile image height when taller than the tile (isometric blocks); 0 = tileHeight
+    uint32_t atlasColumns = 8;
+    uint32_t atlasRows = 1;
+    uint32_t texture = 0;
+    uint32_t shader = 0;
+    uint32_t pass = 0;
+    uint8_t state = Renderer::StateBlending;
+};
+
+struct TileRenderStats {
+    uint32_t regionsVisible = 0;
+    uint32_t regionsRebuilt = 0;
+    uint32_t regionsEvicted = 0;
+    uint32_t tilesBuilt = 0;
+    uint32_t drawCalls = 0;
+};
+
+/**
+ * Tile Renderer
+ * Draws a TileMap through static per-region vertex buffers. Each 32x32
+ * region is meshed once and rebuilt only when its version changes; regions
+ * outside the view are never meshed, and cached meshes that stay out of view
+ * (or whose region left the map) are evicted. Isometric regions are meshed
+ * back to front along diagonals and drawn in diagonal order through the
+ * command buffer's radix-sorted keys. Positions are in screen pixels, y down.
+ */
+class TileRenderer {
+public:
+    static constexpr uint32_t EVICT_AFTER_FRAMES = 120;
+
+    explicit TileRenderer(const TileRendererDesc& desc);
+
+    // Meshes edited or newly visible regions and records one draw per visible region
+    void Render(Renderer::IRenderer& renderer, Renderer::CommandBuffer& commands, const TileMap& map,
+                const float viewMin[2], const float viewMax[2]);
+
+    // Deletes every cached region buffer
+    void Release(Renderer::IRenderer& renderer);
+
+    // Screen position of a tile's top-left (top-down) or top corner (isometric), and its inverse
+    void TileToScreen(float x, float y, float screen[2]) const;
+    void ScreenToTile(float screenX, float screenY, float tile[2]) const;
+
+    const TileRendererDesc& GetDesc() const { return m_desc; }
+    size_t GetCachedRegionCount() const { return m_meshes.size(); }
+    const TileRenderStats& GetStats() const { return m_stats; }
+
+private:
+    struct RegionMesh {
+        uint32_t vertexBuffer = 0;
+        size_t capacity = 0;  // bytes
+        uint32_t indexCount = 0;
+        uint32_t version = 0;
+        uint64_t lastVisibleFrame = 0;
+    };
+
+    TileRendererDesc m_desc;
+    std::unordered_map<TileRegionCoord, RegionMesh, TileRegionCoordHash> m_meshes;
+    std::vector<uint16_t> m_tileOrder;  // region-local tile indices in draw order
+    std::vector<Renderer::Vertex> m_vertices;
+    uint32_t m_indexBuffer;  // shared by every region: quad i uses vertices 4i..4i+3
+    uint64_t m_frame;
+    TileRenderStats m_stats;
+
+    void GetRegionBounds(const TileRegionCoord& coord, float min[2], float max[2]) const;
+    void BuildRegion(Renderer::IRenderer& renderer, const TileRegionCoord& coord, const TileRegion& region,
+                     RegionMesh& mesh);
+    void EvictRegions(Renderer::IRenderer& renderer, const TileMap& map);
+};
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "game/PerlinNoise.h"
+#include "game/TileMap.h"
+#include "platform/JobSystem.h"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Game {
+
+// Terrain tiles, in the order of the 2D tileset atlas (WorldGenerator2D.TerrainType)
+enum class TileTerrain : uint16_t {
+    DeepWater = 0,
+    ShallowWater,
+    Sand,
+    Grass,
+    Dirt,
+    Stone,
+    Snow,
+    Forest
+};
+
+struct TileWorldDesc {
+    int seed = 42;
+    float terrainScale = 0.05f;
+    float moistureScale = 0.03f;
+    float temperatureScale = 0.04f;
+    int terrainOctaves = 4;
+    int climateOctaves = 2;               // moisture and temperature
+    int moistureSeedOffset = 1000;
+    int temperatureSeedOffset = 2000;
+    int paddingRegions = 1;               // regions generated beyond the view on every side
+    size_t cacheCapacity = 256;           // generated regions kept before the least recently used are evicted
+    uint32_t maxRegionsInFlight = 16;     // generation jobs queued at once
+};
+
+struct TileWorldStats {
+    uint32_t regionsRequested = 0;        // last Update()
+    uint32_t regionsIntegrated = 0;
+    uint32_t regionsEvicted = 0;
+    uint32_t regionsPending = 0;
+    size_t regionsResident = 0;
+};
+
+/**
+ * Tile World Streamer
+ * Generates an unbounded 2D tile world into a TileMap one 32x32 region at a
+ * time, around the view, on worker threads. Each region samples its height,
+ * moisture and temperature as whole 32x32 noise grids and classifies them
+ * with the same thresholds as WorldGenerator2D. Only regions the streamer
+ * generated itself are kept in its LRU cache; once it exceeds its capacity
+ * the least recently viewed of them are removed from the map (edits made to
+ * them are lost, and they are regenerated from the seed when seen again).
+ * Regions that are already in the map, such as loaded or edited ones, are
+ * never cached, so they are neither overwritten nor evicted.
+ */
+class TileWorldStreamer {
+public:
+    TileWorldStreamer(TileMap& map, const TileWorldDesc& desc = TileWorldDesc(),
+                      Platform::JobSystem* jobSystem = nullptr);
+    ~TileWorldStreamer();
+
+    TileWorldStreamer(const TileWorldStreamer&) = delete;
+    TileWorldStreamer& operator=(const TileWorldStreamer&) = delete;
+
+    // Integrates finished regions, requests missing ones nearest first and evicts beyond the cache capacity.
+    // The range is inclusive, in tiles; it never blocks on generation.
+    void Update(const int tileMin[2], const int tileMax[2]);
+
+    // Waits for every requested region and integrates it
+    void Flush();
+
+    // Fills a region with generated terrain; deterministic for a given seed, safe to call from any thread
+    void GenerateRegion(const TileRegionCoord& coord, TileRegion& region) const;
+
+    // Inputs are noise values remapped to [0, 1]
+    static TileTerrain ClassifyTerrain(float height, float moisture, float temperature);
+
+    const TileWorldDesc& GetDesc() const { return m_desc; }
+    size_t GetPendingCount() const { return m_pending.size(); }
+    size_t GetResidentCount() const { return m_resident.size(); }
+    const TileWorldStats& GetStats() const { return m_stats; }
+
+private:
+    struct CachedRegion {
+        TileRegionCoord coord;
+        uint64_t lastUsedFrame;
+    };
+
+    struct GeneratedRegion {
+        TileRegionCoord coord;
+        std::unique_ptr<TileRegion> region;
+    };
+
+    using CacheList = std::list<CachedRegion>;
+
+    TileMap& m_map;
+    TileWorldDesc m_desc;
+    Platform::JobSystem* m_jobSystem;
+    PerlinNoise m_terrainNoise;
+    PerlinNoise m_moistureNoise;
+    PerlinNoise m_temperatureNoise;
+
+    Platform::JobCounter m_counter;
+    std::mutex m_generatedMutex;
+    std::vector<GeneratedRegion> m_generated;  // written by workers, drained by Update()
+    std::vector<GeneratedRegion> m_integrating;
+
+    std::unordered_set<TileRegionCoord, TileRegionCoordHash> m_pending;
+    CacheList m_lru;  // most recently used first
+    std::unordered_map<TileRegionCoord, CacheList::iterator, TileRegionCoordHash> m_resident;
+    std::vector<TileRegionCoord> m_requests;
+    uint64_t m_frame;
+    TileWorldStats m_stats;
+
+    void IntegrateGenerated();
+    void Touch(const TileRegionCoord& coord);
+    void Evict();
+};
+
+} // namespace Game
+} // namespace SwordAndStone
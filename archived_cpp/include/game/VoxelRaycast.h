@@ -0,0 +1,57 @@
+#pragma once
+
+#include "game/VoxelSystem.h"
+#include "platform/JobSystem.h"
+
+namespace SwordAndStone {
+namespace Game {
+
+// Which voxels stop a ray or a moving box
+using VoxelFilter = bool (*)(VoxelType type);
+
+struct VoxelRayHit {
+    bool hit = false;
+    int block[3] = { 0, 0, 0 };   // world voxel coordinates of the hit voxel
+    int normal[3] = { 0, 0, 0 };  // face the ray entered through; zero when it started inside the voxel
+    float distance = 0.0f;        // along the normalized direction
+    VoxelType type = VoxelType::Air;
+};
+
+struct VoxelSweepHit {
+    bool hit = false;
+    int block[3] = { 0, 0, 0 };
+    int normal[3] = { 0, 0, 0 };  // face of the block that was struck
+    float time = 1.0f;            // fraction of the motion travelled before contact
+};
+
+/**
+ * Voxel Raycast
+ * Amanatides-Woo traversal over VoxelSystem storage: one step per voxel
+ * boundary, reading chunk arrays directly. Missing chunks, and uniform
+ * chunks the filter lets through (all air, all water), are crossed in a
+ * single step to the chunk's exit face. No colliders are involved, so block
+ * picking for mining, placement and projectiles costs microseconds.
+ * Returns false if nothing is hit within maxDistance.
+ */
+bool RaycastVoxels(const VoxelSystem& voxels, const float origin[3], const float direction[3], float maxDistance,
+                   VoxelRayHit& hit, VoxelFilter blocks = IsSolid);
+
+// Rays are xyz triples; each ray's result lands in hits[i]. Runs in batches on the job system.
+void RaycastVoxelsBatch(const VoxelSystem& voxels, const float* origins, const float* directions,
+                        const float* maxDistances, uint32_t count, VoxelRayHit* hits,
+                        VoxelFilter blocks = IsSolid, Platform::JobSystem* jobSystem = nullptr);
+
+/**
+ * Swept AABB
+ * Moves the box [min, max] by motion and finds the first voxel its leading
+ * faces run into, stepping one voxel layer at a time along whichever axis
+ * reaches its next boundary first. Voxels the box already overlaps at the
+ * start are ignored, so a box resting flush against a wall can still slide
+ * along it. The box reaches min + motion * hit.time; callers resolve the
+ * blocked axis and sweep the rest of the motion again.
+ */
+bool SweepVoxels(const VoxelSystem& voxels, const float min[3], const float max[3], const float motion[3],
+                 VoxelSweepHit& hit, VoxelFilter blocks = IsSolid);
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -1,20 +1,72 @@
 #pragma once
 
+#include "game/Chunk.h"
+#include "renderer/TextureAtlas.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 namespace SwordAndStone {
 namespace Game {
 
-// Stub voxel system class
+/**
+ * Voxel System
+ * Owns the loaded chunks of the voxel world. Missing chunks read as air.
+ * Edited chunks are queued and have their derived data (compaction,
+ * face connectivity) refreshed in Update(). Every block type samples the
+ * same terrain atlas texture.
+ */
 class VoxelSystem {
 public:
+    static constexpr int WORLD_HEIGHT_IN_CHUNKS = 64;
+    static constexpr int RENDER_DISTANCE = 8;
+
+    using ChunkMap = std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, ChunkCoordHash>;
+
     VoxelSystem();
     ~VoxelSystem();
-    
+
     void Initialize();
     void Update(float deltaTime);
     void Render();
-    
+
+    // Chunk access
+    Chunk* GetChunk(const ChunkCoord& coord);
+    const Chunk* GetChunk(const ChunkCoord& coord) const;
+    Chunk& GetOrCreateChunk(const ChunkCoord& coord);
+    void RemoveChunk(const ChunkCoord& coord);
+    const ChunkMap& GetChunks() const { return m_chunks; }
+    size_t GetChunkCount() const { return m_chunks.size(); }
+
+    // Voxel access in world voxel coordinates
+    VoxelType GetVoxel(int x, int y, int z) const;
+    void SetVoxel(int x, int y, int z, VoxelType type);
+
+    // Queues a chunk edited directly through Chunk for refresh
+    void MarkChunkDirty(const ChunkCoord& coord);
+    // Refreshes every chunk edited since the last call
+    void RefreshDirtyChunks();
+
+    // Packs <directory>/<name>.png for every block type into one atlas texture.
+    // The atlas is BC7-compressed; with a cache path, later launches skip
+    // decoding, mip generation and compression.
+    bool LoadTerrainTextures(Renderer::IRenderer& renderer, const std::string& directory,
+                             const std::string& cachePath = "");
+    uint32_t GetTerrainTexture() const { return m_terrainTexture; }
+    const Renderer::AtlasRect& GetBlockTextureRect(VoxelType type) const {
+        return m_blockTextureRects[static_cast<int>(type)];
+    }
+    static const char* GetBlockTextureName(VoxelType type);
+
+    static ChunkCoord WorldToChunk(int x, int y, int z);
+    static int FloorDiv(int value, int divisor);
+
 private:
-    // TODO: Add voxel data structures
+    ChunkMap m_chunks;
+    std::vector<ChunkCoord> m_dirtyChunks;
+
+    uint32_t m_terrainTexture;
+    Renderer::AtlasRect m_blockTextureRects[VOXEL_TYPE_COUNT];
 };
 
 } // namespace Game
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Platform {
+
+// Tracks completion of a group of jobs
+struct JobCounter {
+    std::atomic<uint32_t> pending{0};
+};
+
+/**
+ * Job System
+ * Fixed pool of worker threads fed from a shared queue. Threads that wait on
+ * a counter execute queued jobs themselves, so jobs may spawn and wait on
+ * nested jobs without deadlocking. The queue is a ring buffer that only
+ * grows, so once warm, queuing jobs whose captures fit std::function's
+ * inline storage does not allocate.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+
+    // workerCount == 0 picks hardware concurrency minus the calling thread
+    explicit JobSystem(uint32_t workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void Run(Job job, JobCounter* counter = nullptr);
+    void Wait(JobCounter& counter);
+
+    // Splits [0, count) into batches and runs them in parallel, returning when all are done
+    void ParallelFor(uint32_t count, uint32_t batchSize, const RangeJob& body);
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    // Number of distinct thread indices (workers plus non-worker threads)
+    uint32_t GetThreadCount() const { return GetWorkerCount() + 1; }
+
+    // 0 on non-worker threads, 1..GetWorkerCount() on workers
+    static uint32_t GetThreadIndex();
+    // As GetThreadIndex(), but 0 on workers of any other job system
+    uint32_t GetLocalThreadIndex() const;
+
+    // Process-wide instance, created on first use
+    static JobSystem& GetDefault();
+
+private:
+    struct QueuedJob {
+        Job job;
+        JobCounter* counter;
+    };
+
+    std::vector<std::thread> m_workers;
+    std::vector<QueuedJob> m_queue;  // ring buffer
+    size_t m_queueHead;
+    size_t m_queueSize;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_shutdown;
+
+    void WorkerLoop(uint32_t threadIndex);
+    bool TryRunOne();
+    void PushLocked(QueuedJob&& queued);
+    QueuedJob PopLocked();
+    static void Execute(QueuedJob& queued);
+};
+
+} // namespace Platform
+} // namespace SwordAndStone
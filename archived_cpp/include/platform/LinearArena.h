@@ -0,0 +1,176 @@
+#pragma once
+
+#include "platform/MemoryTracker.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Platform {
+
+/**
+ * Linear Arena
+ * Bump allocator over a list of blocks. Allocations are released all at
+ * once by Reset() or, stack-wise, by rewinding to a marker; blocks are
+ * kept, so a workload that repeats every frame stops touching the heap
+ * after its first run. Reset() merges overflow blocks into one, so the
+ * next cycle fits in a single block. Not thread-safe.
+ */
+class LinearArena {
+public:
+    struct Marker {
+        uint32_t block;
+        size_t offset;
+    };
+
+    explicit LinearArena(size_t blockSize = 64 * 1024, MemoryTag tag = MemoryTag::Scratch);
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    // Never returns null; alignment must be a power of two
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    // Uninitialized storage for count objects of T
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    Marker GetMarker() const { return { m_current, m_offset }; }
+    void Rewind(const Marker& marker);
+    void Reset();
+
+    size_t GetUsedBytes() const;
+    size_t GetCapacity() const;
+    size_t GetBlockCount() const { return m_blocks.size(); }
+
+private:
+    struct Block {
+        uint8_t* data;
+        size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+    uint32_t m_current;  // block being bumped
+    size_t m_offset;     // into the current block
+    size_t m_blockSize;
+    MemoryTag m_tag;
+
+    Block AllocateBlock(size_t size);
+};
+
+/**
+ * Frame Arena
+ * Two linear arenas used on alternate frames. BeginFrame() switches to the
+ * other arena and resets it, so memory handed out during a frame stays
+ * valid through the following frame (long enough for the render thread or
+ * GPU uploads to consume it) and is then reclaimed with no per-object
+ * frees. Owned by Engine and used from the main thread.
+ */
+class FrameArena {
+public:
+    explicit FrameArena(size_t blockSize = 1024 * 1024);
+
+    void BeginFrame();
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return m_arenas[m_current].Allocate(size, alignment);
+    }
+
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return m_arenas[m_current].AllocateArray<T>(count);
+    }
+
+    LinearArena& GetArena() { return m_arenas[m_current]; }
+    uint64_t GetFrame() const { return m_frame; }
+
+private:
+    LinearArena m_arenas[2];
+    uint32_t m_current;
+    uint64_t m_frame;
+};
+
+/**
+ * Scratch Scope
+ * Temporary allocations from the calling thread's scratch stack, a
+ * thread-local LinearArena, released when the scope ends. Scopes nest;
+ * inner scopes must end first. Suited to per-call working memory on job
+ * workers (flood fills, sort keys, index lists) that would otherwise be a
+ * local std::vector allocated on every call.
+ */
+class ScratchScope {
+public:
+    ScratchScope()
+        : m_arena(GetThreadArena())
+        , m_marker(m_arena.GetMarker())
+    {
+    }
+
+    ~ScratchScope() {
+        m_arena.Rewind(m_marker);
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return m_arena.Allocate(size, alignment);
+    }
+
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return m_arena.AllocateArray<T>(count);
+    }
+
+    LinearArena& GetArena() { return m_arena; }
+
+    static LinearArena& GetThreadArena();
+
+private:
+    LinearArena& m_arena;
+    LinearArena::Marker m_marker;
+};
+
+// STL allocator over a LinearArena; deallocation is a no-op, so reserve() up front where possible
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    explicit ArenaAllocator(LinearArena& arena) : m_arena(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.GetArena()) {}
+
+    T* allocate(size_t count) {
+        if (count > SIZE_MAX / sizeof(T)) throw std::bad_array_new_length();
+        return m_arena->AllocateArray<T>(count);
+    }
+
+    void deallocate(T*, size_t) {}
+
+    LinearArena* GetArena() const { return m_arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.GetArena(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.GetArena(); }
+
+private:
+    LinearArena* m_arena;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace Platform
+} // namespace SwordAndStone
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <new>
+
+namespace SwordAndStone {
+namespace Platform {
+
+// Subsystems that memory is charged to; untagged allocations land in Untagged
+enum class MemoryTag : uint8_t {
+    Untagged = 0,
+    Voxels,
+    Tiles,
+    Meshes,
+    RenderResources,  // backend resource tables and CPU-side buffer copies
+    Textures,
+    Entities,
+    Jobs,
+    Profiler,
+    FrameArena,
+    Scratch,  // thread-local scratch stacks
+    Count
+};
+
+constexpr int MEMORY_TAG_COUNT = static_cast<int>(MemoryTag::Count);
+
+// Bucket 0 holds sizes up to 16 bytes, bucket i sizes up to 16 << i; the last bucket holds everything larger
+constexpr int MEMORY_HISTOGRAM_BUCKETS = 20;
+
+struct MemoryTagStats {
+    uint64_t liveBytes = 0;
+    uint64_t peakBytes = 0;
+    uint64_t liveAllocations = 0;
+    uint64_t totalAllocations = 0;
+    uint64_t histogram[MEMORY_HISTOGRAM_BUCKETS] = {};  // allocation counts by size
+};
+
+struct MemorySnapshot {
+    MemoryTagStats tags[MEMORY_TAG_COUNT];
+    uint64_t liveBytes = 0;
+    uint64_t peakBytes = 0;
+
+    const MemoryTagStats& operator[](MemoryTag tag) const { return tags[static_cast<int>(tag)]; }
+};
+
+/**
+ * Memory Tracker
+ * Charges every allocation to a MemoryTag. The global operator new family
+ * is replaced so all heap allocations are counted, charged to the calling
+ * thread's current tag (see MemoryTagScope); Allocate() and TaggedAllocator
+ * charge an explicit tag instead. Each allocation carries a small header
+ * recording its size and tag, so frees are charged back correctly from any
+ * thread. Counters are relaxed atomics, so snapshots are cheap to take at
+ * runtime but only approximately consistent across tags while other
+ * threads allocate. Defining SWORDANDSTONE_DISABLE_GLOBAL_NEW_TRACKING
+ * leaves the global operators alone; explicit tagged allocations are still
+ * counted.
+ */
+class MemoryTracker {
+public:
+    // Returns null on failure; alignment must be a power of two
+    static void* Allocate(size_t size, MemoryTag tag, size_t alignment = alignof(std::max_align_t));
+    // Accepts memory from Allocate() or from the tracked global operator new
+    static void Free(void* pointer);
+
+    static MemoryTag GetCurrentTag();
+    static void SetCurrentTag(MemoryTag tag);
+
+    static MemorySnapshot GetSnapshot();
+    // Restarts peak tracking from the current live sizes
+    static void ResetPeaks();
+    // Human-readable table of every tag that has allocated, for logs and headless servers
+    static void Dump(std::ostream& out);
+
+    static const char* GetTagName(MemoryTag tag);
+    static int GetHistogramBucket(size_t size);
+    static bool IsTrackingGlobalNew();
+};
+
+// Charges allocations made on this thread to a tag for the lifetime of the scope
+class MemoryTagScope {
+public:
+    explicit MemoryTagScope(MemoryTag tag)
+        : m_previous(MemoryTracker::GetCurrentTag())
+    {
+        MemoryTracker::SetCurrentTag(tag);
+    }
+
+    ~MemoryTagScope() {
+        MemoryTracker::SetCurrentTag(m_previous);
+    }
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag m_previous;
+};
+
+// STL allocator that charges a fixed tag regardless of the thread's current tag
+template<typename T, MemoryTag Tag>
+class TaggedAllocator {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = TaggedAllocator<U, Tag>;
+    };
+
+    TaggedAllocator() = default;
+
+    template<typename U>
+    TaggedAllocator(const TaggedAllocator<U, Tag>&) {}
+
+    T* allocate(size_t count) {
+        if (count > SIZE_MAX / sizeof(T)) throw std::bad_array_new_length();
+        void* pointer = MemoryTracker::Allocate(count * sizeof(T), Tag, alignof(T));
+        if (!pointer) throw std::bad_alloc();
+        return static_cast<T*>(pointer);
+    }
+
+    void deallocate(T* pointer, size_t) {
+        MemoryTracker::Free(pointer);
+    }
+
+    template<typename U>
+    bool operator==(const TaggedAllocator<U, Tag>&) const { return true; }
+    template<typename U>
+    bool operator!=(const TaggedAllocator<U, Tag>&) const { return false; }
+};
+
+} // namespace Platform
+} // namespace SwordAndStone
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Platform {
+
+// One static instance per PROFILE_ZONE call site; its address identifies the zone
+struct ProfileZone {
+    const char* name;
+    const char* file;
+    uint32_t line;
+};
+
+enum class ProfileEventType : uint8_t {
+    ZoneBegin,
+    ZoneEnd,
+    Counter,
+    FrameMark
+};
+
+struct ProfileEvent {
+    uint64_t ticks;
+    const void* source;  // ProfileZone* for zones, the counter name for counters, null for frame marks
+    double value;        // counter value, or the frame number for frame marks
+    uint32_t thread;     // profiler thread id, in order of each thread's first event
+    ProfileEventType type;
+};
+
+/**
+ * Profiler
+ * Scoped-zone instrumentation for hot paths. Each thread records into its
+ * own fixed-size lock-free ring with raw timestamp-counter ticks; Collect()
+ * drains the rings into a capture that can be exported as a Chrome trace
+ * (chrome://tracing, Perfetto) or a compact binary file. The capture keeps
+ * the most recent events up to its capacity, so profiling can stay on for
+ * a whole session. Recording is off by default and costs one relaxed load
+ * per zone while off; events from a full ring are dropped and counted
+ * rather than blocking the thread. Zones are dropped whole: a ring only
+ * takes a zone's begin while it has room left for the ends of every open
+ * zone, so neither the ring nor the trimmed capture has unmatched ends.
+ * Defining SWORDANDSTONE_PROFILER_DISABLED compiles the macros out.
+ */
+class Profiler {
+public:
+    static constexpr uint32_t RING_CAPACITY = 1 << 14;  // events per thread between collections
+    static constexpr size_t DEFAULT_CAPTURE_CAPACITY = 1 << 20;  // events kept by Collect()
+
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // False if the zone was dropped; its EndZone must then be skipped as well
+    static bool BeginZone(const ProfileZone* zone);
+    static void EndZone(const ProfileZone* zone);
+    // name must outlive the capture (a string literal)
+    static void Counter(const char* name, double value);
+    static void FrameMark();
+
+    // Moves every thread's recorded events into the capture, then drops its oldest events
+    // beyond the capture capacity; call from one thread at a time
+    static void Collect();
+    static void SetCaptureCapacity(size_t events);
+    static const std::vector<ProfileEvent>& GetEvents();
+    static void Clear();
+    static uint64_t GetDroppedCount();
+
+    // Both collect first
+    static bool ExportChromeTrace(const std::string& path);
+    static bool ExportBinary(const std::string& path);
+
+    static uint64_t ReadTicks();
+    static double GetTicksPerSecond();
+
+private:
+    static std::atomic<bool> s_enabled;
+
+    static bool Record(ProfileEventType type, const void* source, double value);
+};
+
+// Records a zone from construction to destruction; see PROFILE_ZONE
+class ProfileScope {
+public:
+    explicit ProfileScope(const ProfileZone* zone)
+        : m_zone(Profiler::IsEnabled() && Profiler::BeginZone(zone) ? zone : nullptr)
+    {
+    }
+
+    ~ProfileScope() {
+        if (m_zone) Profiler::EndZone(m_zone);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const ProfileZone* m_zone;  // null when the profiler was off or the zone was dropped
+};
+
+} // namespace Platform
+} // namespace SwordAndStone
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifndef SWORDANDSTONE_PROFILER_DISABLED
+#define PROFILE_ZONE(name)                                                                              \
+    static const ::SwordAndStone::Platform::ProfileZone PROFILE_CONCAT(s_profileZone, __LINE__) = {    \
+        name, __FILE__, __LINE__ };                                                                     \
+    ::SwordAndStone::Platform::ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(                    \
+        &PROFILE_CONCAT(s_profileZone, __LINE__))
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#define PROFILE_COUNTER(name, value)                                                                    \
+    do {                                                                                                \
+        if (::SwordAndStone::Platform::Profiler::IsEnabled())                                           \
+            ::SwordAndStone::Platform::Profiler::Counter(name, static_cast<double>(value));             \
+    } while (0)
+#define PROFILE_FRAME_MARK()                                                                            \
+    do {                                                                                                \
+        if (::SwordAndStone::Platform::Profiler::IsEnabled())                                           \
+            ::SwordAndStone::Platform::Profiler::FrameMark();                                           \
+    } while (0)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#define PROFILE_FRAME_MARK() ((void)0)
+#endif
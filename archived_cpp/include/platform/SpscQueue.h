@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace SwordAndStone {
+namespace Platform {
+
+/**
+ * SPSC Queue
+ * Fixed-capacity lock-free ring for exactly one producer thread and one
+ * consumer thread. Push() fails instead of blocking when the ring is full,
+ * so a stalled consumer never holds up the producer. Head and tail live on
+ * separate cache lines. Capacity must be a power of two.
+ */
+template<typename T, uint32_t Capacity>
+class SpscQueue {
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // Producer side; false when full
+    bool Push(const T& value) {
+        const uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        m_items[head & (Capacity - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; false when empty
+    bool Pop(T& value) {
+        const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = m_items[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate unless called from the producer or consumer with the other side idle
+    uint32_t GetSize() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr uint32_t GetCapacity() { return Capacity; }
+
+private:
+    alignas(64) std::atomic<uint32_t> m_head{0};  // written by the producer
+    alignas(64) std::atomic<uint32_t> m_tail{0};  // written by the consumer
+    alignas(64) T m_items[Capacity];
+};
+
+} // namespace Platform
+} // namespace SwordAndStone
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "IRenderer.h"
+#include <vector>
+
+namespace SwordAndStone {
+
+namespace Platform {
+class JobSystem;
+}
+
+namespace Renderer {
+
+/*
+ * Block compression
+ * Encoders and decoders for the BC formats in TextureFormat. Blocks are 4x4
+ * RGBA8 texels in row-major order. The encoders fit endpoints along the
+ * principal axis of each block's colours and pick indices four texels at a
+ * time with SIMD:
+ *   BC1 - opaque colour, one least-squares endpoint refinement
+ *   BC3 - BC1 colour plus an interpolated 8-level alpha block
+ *   BC7 - mode 6 only (one subset, RGBA 7.7.7.7 endpoints with p-bits,
+ *         16 index levels): fast, and far better than BC1/BC3 on colour gradients
+ * The sRGB variants encode the stored bytes exactly like the linear ones.
+ */
+
+void EncodeBC1Block(const uint8_t* texels, uint8_t* block);
+void EncodeBC3Block(const uint8_t* texels, uint8_t* block);
+void EncodeBC7Block(const uint8_t* texels, uint8_t* block);
+
+void DecodeBC1Block(const uint8_t* block, uint8_t* texels);
+void DecodeBC3Block(const uint8_t* block, uint8_t* texels);
+// Decodes mode 6 blocks; blocks in other modes decode to opaque magenta
+void DecodeBC7Block(const uint8_t* block, uint8_t* texels);
+
+// Compresses an RGBA8 image, one job per row of blocks. Partial edge blocks
+// repeat the last row and column. Returns false for uncompressed formats.
+bool CompressTexture(const uint8_t* pixels, uint32_t width, uint32_t height, TextureFormat format,
+                     std::vector<uint8_t>& output, Platform::JobSystem* jobSystem = nullptr);
+
+// Expands compressed data back to RGBA8
+bool DecompressTexture(const uint8_t* data, uint32_t width, uint32_t height, TextureFormat format,
+                       std::vector<uint8_t>& pixels);
+
+} // namespace Renderer
+} // namespace SwordAndStone
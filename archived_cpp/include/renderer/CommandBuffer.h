@@ -0,0 +1,156 @@
+#pragma once
+
+#include "IRenderer.h"
+
+namespace SwordAndStone {
+namespace Renderer {
+
+// Render state flags carried by each draw command
+enum RenderStateFlags : uint8_t {
+    StateDepthTest = 1 << 0,
+    StateBlending = 1 << 1,
+    StateCulling = 1 << 2,
+    StateDefault = StateDepthTest | StateCulling
+};
+
+/**
+ * 64-bit draw sort key, most significant field first:
+ *   [63..60] pass  [59..44] shader  [43..28] texture  [27..4] depth  [3..0] unused
+ * Sorting ascending groups draws by pass, then shader, then texture, and
+ * orders each group front to back (or back to front for transparent passes).
+ */
+namespace SortKey {
+    constexpr uint32_t PASS_BITS = 4;
+    constexpr uint32_t SHADER_BITS = 16;
+    constexpr uint32_t TEXTURE_BITS = 16;
+    constexpr uint32_t DEPTH_BITS = 24;
+
+    uint64_t Make(uint32_t pass, uint32_t shader, uint32_t texture, uint32_t depth);
+
+    // Quantizes a normalized depth in [0, 1]; backToFront inverts the order
+    uint32_t QuantizeDepth(float depth, bool backToFront = false);
+}
+
+// A recorded draw
+struct DrawCommand {
+    static constexpr uint32_t NO_INDIRECT = 0xFFFFFFFFu;
+
+    uint64_t key;
+    uint32_t shader;
+    uint32_t texture;
+    uint32_t vertexBuffer;
+    uint32_t indexBuffer;   // 0 for non-indexed draws
+    uint32_t count;         // index count, vertex count when non-indexed, or draw count for multi-draws
+    PrimitiveTopology topology;
+    uint8_t state;          // RenderStateFlags
+    uint32_t firstIndirect = NO_INDIRECT;  // first IndirectDrawCommand of a multi-draw
+    uint32_t instanceBuffer = 0;           // InstanceData stream of an instanced draw
+    uint32_t instanceOffset = 0;
+    uint32_t instanceCount = 0;
+};
+
+/**
+ * Renderer State Cache
+ * Filters IRenderer binds and state changes that would not change anything.
+ * Invalidate() must be called whenever state may have been changed behind
+ * the cache's back (for example at the start of a frame).
+ */
+class RenderStateCache {
+public:
+    RenderStateCache();
+
+    void Invalidate();
+
+    void BindShader(IRenderer& renderer, uint32_t shader);
+    void BindTexture(IRenderer& renderer, uint32_t slot, uint32_t texture);
+    void SetState(IRenderer& renderer, uint8_t state);
+
+    uint32_t GetBindsSkipped() const { return m_bindsSkipped; }
+    void ResetCounters() { m_bindsSkipped = 0; }
+
+private:
+    static constexpr uint32_t MAX_TEXTURE_SLOTS = 16;
+
+    uint32_t m_shader;
+    uint32_t m_textures[MAX_TEXTURE_SLOTS];
+    uint8_t m_state;
+    bool m_shaderValid;
+    uint32_t m_textureValid;  // bit per slot
+    uint8_t m_stateValid;     // bit per RenderStateFlags entry
+    uint32_t m_bindsSkipped;
+};
+
+/**
+ * Draw Command Buffer
+ * Renderer-agnostic list of draws recorded during a frame. Execute() radix
+ * sorts the commands by key and submits them through a RenderStateCache so
+ * consecutive draws sharing a shader, texture or state pay for no rebinds.
+ */
+class CommandBuffer {
+public:
+    CommandBuffer() = default;
+
+    void Reserve(size_t count);
+    void Clear() {
+        m_commands.clear();
+        m_indirectCommands.clear();
+        m_frustumCulled = 0;
+        m_occlusionCulled = 0;
+        m_prepared = false;
+    }
+
+    void DrawIndexed(uint64_t key, uint32_t shader, uint32_t texture, uint32_t vertexBuffer,
+                     uint32_t indexBuffer, uint32_t indexCount, uint8_t state = StateDefault,
+                     PrimitiveTopology topology = PrimitiveTopology::TriangleList);
+    void Draw(uint64_t key, uint32_t shader, uint32_t texture, uint32_t vertexBuffer,
+              uint32_t vertexCount, uint8_t state = StateDefault,
+              PrimitiveTopology topology = PrimitiveTopology::TriangleList);
+    // The indirect commands are copied, so the caller's array may be reused immediately
+    void MultiDrawIndexed(uint64_t key, uint32_t shader, uint32_t texture, uint32_t vertexBuffer,
+                          uint32_t indexBuffer, const IndirectDrawCommand* commands, uint32_t drawCount,
+                          uint8_t state = StateDefault, PrimitiveTopology topology = PrimitiveTopology::TriangleList);
+    // Instances are read from instanceBuffer at instanceOffset when the buffer executes
+    void DrawIndexedInstanced(uint64_t key, uint32_t shader, uint32_t texture, uint32_t vertexBuffer,
+                              uint32_t indexBuffer, uint32_t indexCount, uint32_t instanceBuffer,
+                              uint32_t instanceOffset, uint32_t instanceCount, uint8_t state = StateDefault,
+                              PrimitiveTopology topology = PrimitiveTopology::TriangleList);
+    void Submit(const DrawCommand& command) { m_commands.push_back(command); }
+
+    // Objects the visibility passes rejected before recording; reported with the next Execute()
+    void AddCullingStats(uint32_t frustumCulled, uint32_t occlusionCulled) {
+        m_frustumCulled += frustumCulled;
+        m_occlusionCulled += occlusionCulled;
+    }
+
+    // Sorts by key (stable) and returns the submission order
+    const std::vector<uint32_t>& Sort();
+
+    // Sorts ahead of Execute(), so a list recorded on a worker is also sorted there.
+    // Recording more commands afterwards makes Execute() sort again.
+    void Prepare();
+
+    // Sorts, submits every command to the renderer and clears the buffer
+    void Execute(IRenderer& renderer);
+
+    size_t GetCommandCount() const { return m_commands.size(); }
+    const std::vector<DrawCommand>& GetCommands() const { return m_commands; }
+
+    // Submission-side counters of the last Execute()
+    const RenderStats& GetStats() const { return m_stats; }
+
+private:
+    std::vector<DrawCommand> m_commands;
+    std::vector<IndirectDrawCommand> m_indirectCommands;
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_orderScratch;
+    std::vector<uint64_t> m_keys;
+    std::vector<uint64_t> m_keysScratch;
+    RenderStateCache m_stateCache;
+    RenderStats m_stats;
+    uint32_t m_frustumCulled = 0;
+    uint32_t m_occlusionCulled = 0;
+    bool m_prepared = false;
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
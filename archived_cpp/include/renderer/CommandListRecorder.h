@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CommandBuffer.h"
+#include <functional>
+#include <memory>
+
+namespace SwordAndStone {
+
+namespace Platform {
+class FrameArena;
+class JobSystem;
+}
+
+namespace Renderer {
+
+/**
+ * Command List Recorder
+ * Records the passes of a frame (chunks, entities, UI) into separate command
+ * lists on the job system, sorting each list on the worker that recorded it,
+ * then submits them through IRenderer::ExecuteCommandLists. Lists are
+ * submitted in the order their passes were added, and a parallel pass is
+ * split into batches by index range rather than by thread, so the submitted
+ * command stream is identical whatever the worker count.
+ */
+class CommandListRecorder {
+public:
+    using RecordFunction = std::function<void(CommandBuffer& list)>;
+    using RangeRecordFunction = std::function<void(CommandBuffer& list, uint32_t begin, uint32_t end)>;
+
+    explicit CommandListRecorder(Platform::JobSystem* jobSystem = nullptr);
+
+    // Submit() takes its per-frame list array from here when set; the arena must be flipped by the
+    // thread that submits
+    void SetFrameArena(Platform::FrameArena* frameArena) { m_frameArena = frameArena; }
+
+    // Passes are recorded once by the next Record() and dropped by Submit()
+    void AddPass(RecordFunction record);
+    // Records [0, count) as one list per batchSize items
+    void AddParallelPass(uint32_t count, uint32_t batchSize, RangeRecordFunction record);
+
+    // Records and prepares every list, returning once all are done
+    void Record();
+
+    // Render thread: submits the recorded lists in pass order and clears them; records
+    // first if Record() has not run since the last pass was added
+    void Submit(IRenderer& renderer);
+
+    uint32_t GetListCount() const { return static_cast<uint32_t>(m_tasks.size()); }
+
+    // Submission counters summed over the lists of the last Submit()
+    const RenderStats& GetStats() const { return m_stats; }
+
+private:
+    struct Task {
+        RecordFunction record;
+        int32_t rangeRecord;  // index into m_rangeRecords, shared by the batches of a parallel pass; -1 if none
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    Platform::JobSystem* m_jobSystem;
+    Platform::FrameArena* m_frameArena;
+    // Cleared by Submit() but keep their capacity, so a steady frame adds passes without allocating
+    std::vector<Task> m_tasks;
+    std::vector<RangeRecordFunction> m_rangeRecords;
+
+    // Lists are kept across frames so their storage is reused
+    std::vector<std::unique_ptr<CommandBuffer>> m_lists;
+    std::vector<CommandBuffer*> m_submitted;  // used without a frame arena
+    RenderStats m_stats;
+    bool m_recorded;
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -5,6 +5,7 @@
 #include <dxgi.h>
 #include <wrl/client.h>
 #include <unordered_map>
+#include <vector>
 
 using Microsoft::WRL::ComPtr;
 
@@ -36,6 +37,11 @@ public:
     void UpdateVertexBuffer(uint32_t buffer, const void* data, size_t size, size_t offset) override;
     void DeleteBuffer(uint32_t buffer) override;
 
+    StreamingAllocation AllocateStreaming(size_t size, size_t alignment) override;
+    void CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) override;
+    void CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                    size_t size) override;
+
     uint32_t CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) override;
     void UpdateTexture2D(uint32_t texture, const void* data, uint32_t mipLevel) override;
     void DeleteTexture(uint32_t texture) override;
@@ -45,10 +51,17 @@ public:
     void DeleteShader(uint32_t shader) override;
     void BindShader(uint32_t shader) override;
     void SetShaderUniform(uint32_t shader, const std::string& name, const void* data, size_t size) override;
+    void SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) override;
 
     void DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount, 
                     PrimitiveTopology topology) override;
     void Draw(uint32_t vertexBuffer, uint32_t vertexCount, PrimitiveTopology topology) override;
+    void MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, const IndirectDrawCommand* commands,
+                          uint32_t drawCount, PrimitiveTopology topology) override;
+    void DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                              uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                              PrimitiveTopology topology) override;
+    void ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) override;
 
     void SetDepthTest(bool enabled) override;
     void SetBlending(bool enabled) override;
@@ -57,6 +70,7 @@ public:
 
     const RenderStats& GetStats() const override { return m_stats; }
     void ResetStats() override { m_stats = RenderStats(); }
+    void AddCommandStats(const RenderStats& commandStats) override { AccumulateCommandStats(m_stats, commandStats); }
 
     RenderAPI GetAPI() const override { return RenderAPI::DirectX11; }
     const char* GetAPIName() const override { return "DirectX 11"; }
@@ -77,19 +91,23 @@ private:
     ComPtr<ID3D11DepthStencilState> m_depthStencilStateDisabled;
     ComPtr<ID3D11BlendState> m_blendStateEnabled;
     ComPtr<ID3D11BlendState> m_blendStateDisabled;
-    ComPtr<ID3D11InputLayout> m_inputLayout;
     
     // Resource maps
     std::unordered_map<uint32_t, ComPtr<ID3D11Buffer>> m_buffers;
     std::unordered_map<uint32_t, ComPtr<ID3D11Texture2D>> m_textures;
     std::unordered_map<uint32_t, ComPtr<ID3D11ShaderResourceView>> m_textureSRVs;
     
+    // Input layouts are validated against the vertex shader's signature, so each shader
+    // has its own; instancedLayout is null if the shader reads no per-instance inputs
     struct ShaderData {
         ComPtr<ID3D11VertexShader> vertexShader;
         ComPtr<ID3D11PixelShader> pixelShader;
         ComPtr<ID3D11Buffer> constantBuffer;
+        ComPtr<ID3D11InputLayout> inputLayout;
+        ComPtr<ID3D11InputLayout> instancedLayout;
     };
     std::unordered_map<uint32_t, ShaderData> m_shaders;
+    uint32_t m_currentShader;
     
     uint32_t m_width;
     uint32_t m_height;
@@ -97,6 +115,27 @@ private:
     RenderStats m_stats;
     uint32_t m_nextID;
     
+    // Streaming ring: a dynamic vertex buffer mirroring a CPU shadow that any thread may
+    // allocate from. The render thread copies each range in with MAP_WRITE_NO_OVERWRITE
+    // before the GPU reads it; event queries fence the frames still in flight.
+    static constexpr uint32_t FENCE_SLOTS = StreamingRingBuffer::FRAME_COUNT + 1;
+    
+    StreamingRingBuffer m_streaming;
+    uint32_t m_streamingBuffer;
+    std::vector<uint8_t> m_streamingShadow;
+    ComPtr<ID3D11Query> m_frameQueries[FENCE_SLOTS];
+    uint64_t m_submittedFence;
+    uint64_t m_completedFence;
+    
+    bool CreateStreamingBuffer(size_t capacity);
+    void DestroyStreamingBuffer();
+    void RetireStreamingFrames();
+    // Copies a shadow range into the GPU ring; false if the range is outside it
+    bool UploadStreaming(size_t offset, size_t size);
+    
+    // Binds the current shader's layout; false if it has none for this kind of draw
+    bool BindInputLayout(bool instanced);
+    
     bool CreateRenderTarget();
     bool CreateDepthStencil();
     void CreateDefaultStates();
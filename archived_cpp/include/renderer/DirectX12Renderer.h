@@ -5,6 +5,7 @@
 #include <dxgi1_6.h>
 #include <wrl/client.h>
 #include <vector>
+#include <memory>
 #include <queue>
 #include <unordered_map>
 
@@ -13,6 +14,12 @@ using Microsoft::WRL::ComPtr;
 namespace SwordAndStone {
 namespace Renderer {
 
+/**
+ * DirectX 12 Renderer
+ * ExecuteCommandLists records each CommandBuffer into its own ID3D12GraphicsCommandList on
+ * the job system, one allocator per list and frame, and submits them behind the immediate
+ * list in a single ExecuteCommandLists call.
+ */
 class DirectX12Renderer : public IRenderer {
 public:
     DirectX12Renderer();
@@ -38,6 +45,11 @@ public:
     void UpdateVertexBuffer(uint32_t buffer, const void* data, size_t size, size_t offset) override;
     void DeleteBuffer(uint32_t buffer) override;
 
+    StreamingAllocation AllocateStreaming(size_t size, size_t alignment) override;
+    void CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) override;
+    void CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                    size_t size) override;
+
     uint32_t CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) override;
     void UpdateTexture2D(uint32_t texture, const void* data, uint32_t mipLevel) override;
     void DeleteTexture(uint32_t texture) override;
@@ -47,10 +59,17 @@ public:
     void DeleteShader(uint32_t shader) override;
     void BindShader(uint32_t shader) override;
     void SetShaderUniform(uint32_t shader, const std::string& name, const void* data, size_t size) override;
+    void SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) override;
 
     void DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount, 
                     PrimitiveTopology topology) override;
     void Draw(uint32_t vertexBuffer, uint32_t vertexCount, PrimitiveTopology topology) override;
+    void MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, const IndirectDrawCommand* commands,
+                          uint32_t drawCount, PrimitiveTopology topology) override;
+    void DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                              uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                              PrimitiveTopology topology) override;
+    void ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) override;
 
     void SetDepthTest(bool enabled) override;
     void SetBlending(bool enabled) override;
@@ -59,6 +78,9 @@ public:
 
     const RenderStats& GetStats() const override { return m_stats; }
     void ResetStats() override { m_stats = RenderStats(); }
+    void AddCommandStats(const RenderStats& commandStats) override {
+        AccumulateCommandStats(GetRecordingStats(), commandStats);
+    }
 
     RenderAPI GetAPI() const override { return RenderAPI::DirectX12; }
     const char* GetAPIName() const override { return "DirectX 12"; }
@@ -80,6 +102,17 @@ private:
     ComPtr<ID3D12CommandAllocator> m_commandAllocators[FRAME_COUNT];
     ComPtr<ID3D12GraphicsCommandList> m_commandList;
     
+    // Deferred lists: one direct command list per submitted CommandBuffer, reused across
+    // frames; a frame hands them out in order so several submissions never share one
+    struct RecordedList {
+        ComPtr<ID3D12CommandAllocator> allocators[FRAME_COUNT];
+        ComPtr<ID3D12GraphicsCommandList> list;
+        RenderStats stats;
+    };
+    std::vector<std::unique_ptr<RecordedList>> m_recordedLists;
+    uint32_t m_recordedListsUsed;
+    std::vector<ID3D12CommandList*> m_submission;
+    
     // Synchronization objects
     ComPtr<ID3D12Fence> m_fence;
     UINT64 m_fenceValues[FRAME_COUNT];
@@ -96,6 +129,7 @@ private:
         D3D12_INDEX_BUFFER_VIEW indexView;
         size_t size;
         bool isIndexBuffer;
+        D3D12_RESOURCE_STATES state;  // between commands; upload heap buffers stay in GENERIC_READ
     };
     
     struct TextureResource {
@@ -121,6 +155,11 @@ private:
     D3D12_VIEWPORT m_viewport;
     D3D12_RECT m_scissorRect;
     
+    // Streaming ring: one persistently mapped upload heap buffer whose frames are
+    // retired by the same fence values that pace the swap chain
+    StreamingRingBuffer m_streaming;
+    uint32_t m_streamingBuffer;
+    
     // Helper methods
     bool CreateDevice();
     bool CreateCommandObjects();
@@ -130,9 +169,23 @@ private:
     bool CreateDepthStencil();
     bool CreateRootSignature();
     
+    // The list and stats draws go to: the deferred list being recorded on this thread,
+    // otherwise the immediate list
+    ID3D12GraphicsCommandList* GetRecordingList();
+    RenderStats& GetRecordingStats();
+    // Binds the back buffer, depth buffer, viewport and scissor on a freshly reset list
+    void SetFrameTargets(ID3D12GraphicsCommandList* list);
+    bool CreateRecordedList(RecordedList& recorded);
+    
     void WaitForGPU();
     void MoveToNextFrame();
     
+    bool CreateStreamingBuffer(size_t capacity);
+    void DestroyStreamingBuffer();
+    // Records CopyBufferRegion with the transitions both buffers need around it
+    void CopyBufferRegion(BufferResource& destination, size_t destinationOffset, BufferResource& source,
+                          size_t sourceOffset, size_t size);
+    
     D3D12_PRIMITIVE_TOPOLOGY_TYPE ConvertTopologyType(PrimitiveTopology topology);
     D3D_PRIMITIVE_TOPOLOGY ConvertTopology(PrimitiveTopology topology);
     DXGI_FORMAT ConvertTextureFormat(TextureFormat format);
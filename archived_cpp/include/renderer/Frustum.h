@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+/**
+ * View Frustum
+ * Six planes extracted from a column-major view-projection matrix (the same
+ * convention as the u_mvp uniform). Planes point inwards and are not
+ * normalized, which is all a containment test needs.
+ */
+class Frustum {
+public:
+    enum Plane { Left = 0, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    Frustum();
+
+    static Frustum FromMatrix(const float* viewProjection);
+
+    bool TestAABB(const float min[3], const float max[3]) const;
+
+    // Tests count boxes stored as separate min/max arrays, four at a time with SSE2;
+    // visible[i] is set to 1 when box i intersects the frustum and 0 otherwise
+    void TestAABBs(const float* minX, const float* minY, const float* minZ,
+                   const float* maxX, const float* maxY, const float* maxZ,
+                   size_t count, uint8_t* visible) const;
+
+    const float* GetPlane(Plane plane) const { return m_planes[plane]; }
+
+private:
+    float m_planes[PlaneCount][4];  // a*x + b*y + c*z + d >= 0 inside
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
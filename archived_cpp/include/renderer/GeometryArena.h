@@ -0,0 +1,121 @@
+#pragma once
+
+#include "IRenderer.h"
+#include <map>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+/**
+ * Range Allocator
+ * Best-fit free-list suballocator over [0, capacity) in abstract units
+ * (vertices, indices). Free ranges are indexed by offset and by size, and
+ * neighbours are coalesced when a range is released.
+ */
+class RangeAllocator {
+public:
+    static constexpr uint32_t INVALID_OFFSET = 0xFFFFFFFFu;
+
+    explicit RangeAllocator(uint32_t capacity = 0);
+
+    void Reset(uint32_t capacity);
+    void Grow(uint32_t capacity);  // extends the range, keeping every allocation in place
+
+    uint32_t Allocate(uint32_t size);
+    // Lowest-offset fit ending at or below limit; used to compact allocations downwards
+    uint32_t AllocateBelow(uint32_t size, uint32_t limit);
+    void Free(uint32_t offset, uint32_t size);
+
+    uint32_t GetCapacity() const { return m_capacity; }
+    uint32_t GetFreeSpace() const { return m_freeSpace; }
+    uint32_t GetLargestFreeRange() const;
+    size_t GetFreeRangeCount() const { return m_freeByOffset.size(); }
+
+private:
+    uint32_t m_capacity;
+    uint32_t m_freeSpace;
+    std::map<uint32_t, uint32_t> m_freeByOffset;     // offset -> size
+    std::multimap<uint32_t, uint32_t> m_freeBySize;  // size -> offset
+
+    void InsertFree(uint32_t offset, uint32_t size);
+    void EraseFree(std::map<uint32_t, uint32_t>::iterator it);
+    uint32_t TakeFrom(std::map<uint32_t, uint32_t>::iterator it, uint32_t size);
+};
+
+// Location of one mesh inside the arena buffers, in vertices and indices
+struct GeometryRange {
+    uint32_t vertexOffset;
+    uint32_t vertexCount;
+    uint32_t indexOffset;
+    uint32_t indexCount;
+};
+
+/**
+ * Geometry Arena
+ * One large vertex/index buffer pair shared by many small meshes (chunk
+ * meshes). Mesh indices are local to the mesh and offset by baseVertex at
+ * draw time, so every mesh in the arena can be drawn by a single
+ * MultiDrawIndexed. The buffers are Static, so they can be copy
+ * destinations; uploads write only the mesh's range. The arena doubles its
+ * buffers when full and Defragment() incrementally moves the highest meshes
+ * into lower holes, copying through a scratch buffer since no backend can
+ * copy a buffer onto itself.
+ */
+class GeometryArena {
+public:
+    static constexpr uint32_t INVALID_HANDLE = 0;
+
+    GeometryArena();
+    ~GeometryArena();
+
+    bool Initialize(IRenderer* renderer, uint32_t vertexCapacity, uint32_t indexCapacity);
+    void Shutdown();
+
+    // Returns INVALID_HANDLE when the buffers could not grow to fit the mesh
+    uint32_t Allocate(uint32_t vertexCount, uint32_t indexCount);
+    void Free(uint32_t handle);
+
+    void Upload(uint32_t handle, const Vertex* vertices, const uint32_t* indices);
+    // Copies mesh data written into streaming memory, for example by meshing jobs
+    void Upload(uint32_t handle, const StreamingAllocation& vertices, const StreamingAllocation& indices);
+
+    // Moves up to maxMoves meshes into lower free ranges; returns the number moved
+    uint32_t Defragment(uint32_t maxMoves);
+
+    const GeometryRange* GetRange(uint32_t handle) const;
+    IndirectDrawCommand GetDrawCommand(uint32_t handle) const;
+
+    uint32_t GetVertexBuffer() const { return m_vertexBuffer; }
+    uint32_t GetIndexBuffer() const { return m_indexBuffer; }
+    uint32_t GetAllocationCount() const { return m_allocationCount; }
+    const RangeAllocator& GetVertexSpace() const { return m_vertexSpace; }
+    const RangeAllocator& GetIndexSpace() const { return m_indexSpace; }
+
+    // 0 when all free vertex space is contiguous, approaching 1 as it splinters
+    float GetFragmentation() const;
+
+private:
+    struct Slot {
+        GeometryRange range;
+        bool live;
+    };
+
+    IRenderer* m_renderer;
+    uint32_t m_vertexBuffer;
+    uint32_t m_indexBuffer;
+    uint32_t m_moveBuffer;      // scratch that Defragment() copies through
+    size_t m_moveBufferSize;
+    RangeAllocator m_vertexSpace;
+    RangeAllocator m_indexSpace;
+
+    std::vector<Slot> m_slots;         // handle = slot index + 1
+    std::vector<uint32_t> m_freeSlots;
+    uint32_t m_allocationCount;
+
+    bool Grow(uint32_t vertexCapacity, uint32_t indexCapacity);
+    // Copies size bytes from one offset of buffer to another; false if there is no scratch to copy through
+    bool MoveBytes(uint32_t buffer, size_t from, size_t to, size_t size);
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "StreamingBuffer.h"
+#include "UniformBlock.h"
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -19,7 +21,9 @@ enum class RenderAPI {
     None = 0,
     OpenGL,
     DirectX11,
-    DirectX12
+    DirectX12,
+    Software,
+    Null
 };
 
 // Primitive topology
@@ -34,12 +38,51 @@ enum class PrimitiveTopology {
 enum class TextureFormat {
     RGBA8,
     RGB8,
+    SRGBA8,  // RGBA8 with sRGB-encoded colour, decoded to linear when sampled
     RGBA16F,
     RGBA32F,
     Depth24Stencil8,
-    Depth32F
+    Depth32F,
+    // Block compressed, 4x4 texels per block
+    BC1,      // RGB, 8 bytes per block
+    BC1SRGB,
+    BC3,      // RGBA, 16 bytes per block
+    BC3SRGB,
+    BC7,      // RGBA, 16 bytes per block
+    BC7SRGB
 };
 
+// Bytes per 4x4 block, or 0 for uncompressed formats
+inline uint32_t GetCompressedBlockSize(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC1SRGB: return 8;
+        case TextureFormat::BC3:
+        case TextureFormat::BC3SRGB:
+        case TextureFormat::BC7:
+        case TextureFormat::BC7SRGB: return 16;
+        default: return 0;
+    }
+}
+
+inline bool IsCompressedFormat(TextureFormat format) {
+    return GetCompressedBlockSize(format) != 0;
+}
+
+// Size of one mip level's data; compressed levels round up to whole blocks
+inline size_t GetTextureDataSize(uint32_t width, uint32_t height, TextureFormat format) {
+    if (uint32_t blockSize = GetCompressedBlockSize(format)) {
+        return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+    }
+    size_t pixels = static_cast<size_t>(width) * height;
+    switch (format) {
+        case TextureFormat::RGB8: return pixels * 3;
+        case TextureFormat::RGBA16F: return pixels * 8;
+        case TextureFormat::RGBA32F: return pixels * 16;
+        default: return pixels * 4;
+    }
+}
+
 // Buffer usage hints
 enum class BufferUsage {
     Static,
@@ -55,6 +98,23 @@ struct Vertex {
     float color[4];
 };
 
+// Per-instance attributes of an instanced draw, read once per instance.
+// transform holds the first three rows of a row-major affine matrix that
+// takes mesh space to world space; color multiplies the vertex color.
+struct InstanceData {
+    float transform[12];
+    float color[4];
+};
+
+// One draw of a multi-draw batch; layout matches GL's DrawElementsIndirectCommand
+struct IndirectDrawCommand {
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
 // Clear flags
 enum ClearFlags {
     ClearColor = 1 << 0,
@@ -69,8 +129,30 @@ struct RenderStats {
     uint32_t vertices = 0;
     uint32_t textureBinds = 0;
     uint32_t shaderSwitches = 0;
+    uint32_t stateChanges = 0;
+    uint64_t bytesUploaded = 0;
+    uint32_t commandsSorted = 0;
+    uint32_t bindsSkipped = 0;
+    uint32_t vertexArrayCacheHits = 0;
+    uint32_t vertexArrayCacheMisses = 0;
+    uint64_t bytesStreamed = 0;
+    uint32_t streamingStalls = 0;
+    uint32_t multiDrawCommands = 0;
+    uint32_t frustumCulled = 0;
+    uint32_t occlusionCulled = 0;
+    uint32_t instancesDrawn = 0;
 };
 
+// Adds the counts only a command buffer knows about; the draw counters are already kept by the backend
+inline void AccumulateCommandStats(RenderStats& stats, const RenderStats& commandStats) {
+    stats.commandsSorted += commandStats.commandsSorted;
+    stats.bindsSkipped += commandStats.bindsSkipped;
+    stats.frustumCulled += commandStats.frustumCulled;
+    stats.occlusionCulled += commandStats.occlusionCulled;
+}
+
+class CommandBuffer;
+
 /**
  * Abstract Renderer Interface
  * Provides a unified API for different rendering backends
@@ -100,9 +182,21 @@ public:
     // Buffer operations
     virtual uint32_t CreateVertexBuffer(const void* data, size_t size, BufferUsage usage) = 0;
     virtual uint32_t CreateIndexBuffer(const uint32_t* data, size_t count, BufferUsage usage) = 0;
+    // Writes [offset, offset + size) and keeps the rest of the buffer
     virtual void UpdateVertexBuffer(uint32_t buffer, const void* data, size_t size, size_t offset = 0) = 0;
     virtual void DeleteBuffer(uint32_t buffer) = 0;
 
+    // Streaming uploads
+    // AllocateStreaming may be called from any thread between BeginFrame and EndFrame.
+    // The memory stays valid until the GPU has finished the frame it was allocated in.
+    virtual StreamingAllocation AllocateStreaming(size_t size, size_t alignment = sizeof(Vertex)) = 0;
+    // Only Static buffers can be copy destinations; Dynamic and Stream buffers are written by the CPU
+    virtual void CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset = 0) = 0;
+
+    // GPU-side copy into a Static buffer; a buffer cannot be copied onto itself
+    virtual void CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                            size_t size) = 0;
+
     // Texture operations
     virtual uint32_t CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, 
                                       const void* data = nullptr) = 0;
@@ -115,12 +209,26 @@ public:
     virtual void DeleteShader(uint32_t shader) = 0;
     virtual void BindShader(uint32_t shader) = 0;
     virtual void SetShaderUniform(uint32_t shader, const std::string& name, const void* data, size_t size) = 0;
+    // Same as the name overload without the per-call string lookup; see InternUniformName
+    virtual void SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) = 0;
 
     // Draw operations
     virtual void DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount, 
                             PrimitiveTopology topology = PrimitiveTopology::TriangleList) = 0;
     virtual void Draw(uint32_t vertexBuffer, uint32_t vertexCount, 
                      PrimitiveTopology topology = PrimitiveTopology::TriangleList) = 0;
+    // Draws every command from one vertex/index buffer pair as a single submission
+    virtual void MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, const IndirectDrawCommand* commands,
+                                  uint32_t drawCount, PrimitiveTopology topology = PrimitiveTopology::TriangleList) = 0;
+    // Draws instanceCount copies of an indexed mesh. Instance i reads the InstanceData at
+    // instanceOffset + i * sizeof(InstanceData) in instanceBuffer, which may be the streaming
+    // buffer; streaming allocations for instances should be aligned to sizeof(InstanceData).
+    virtual void DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                                      uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                                      PrimitiveTopology topology = PrimitiveTopology::TriangleList) = 0;
+    // Submits deferred command lists in array order. Lists may be recorded on any thread;
+    // submission belongs to the render thread and clears every list.
+    virtual void ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) = 0;
 
     // State management
     virtual void SetDepthTest(bool enabled) = 0;
@@ -131,6 +239,8 @@ public:
     // Stats
     virtual const RenderStats& GetStats() const = 0;
     virtual void ResetStats() = 0;
+    // Called by CommandBuffer::Execute to fold its sorting, bind filtering and culling counts into GetStats()
+    virtual void AddCommandStats(const RenderStats& commandStats) = 0;
 
     // API info
     virtual RenderAPI GetAPI() const = 0;
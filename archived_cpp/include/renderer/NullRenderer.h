@@ -0,0 +1,215 @@
+#pragma once
+
+#include "IRenderer.h"
+#include <fstream>
+#include <unordered_map>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+// Command types recorded by the null backend
+enum class NullCommandType : uint32_t {
+    Clear,
+    SetViewport,
+    SetScissor,
+    CreateVertexBuffer,
+    CreateIndexBuffer,
+    UpdateVertexBuffer,
+    DeleteBuffer,
+    CreateTexture2D,
+    UpdateTexture2D,
+    DeleteTexture,
+    BindTexture,
+    CreateShader,
+    DeleteShader,
+    BindShader,
+    SetShaderUniform,
+    DrawIndexed,
+    Draw,
+    SetDepthTest,
+    SetBlending,
+    SetCulling,
+    SetWireframe,
+    CopyStreamingToBuffer,
+    CopyBuffer,
+    MultiDrawIndexed,
+    DrawIndexedInstanced,
+    ExecuteCommandLists
+};
+
+// Fixed-size record of a single IRenderer call. Plain data so frames can be
+// written to and read from capture files verbatim.
+struct NullCommand {
+    NullCommandType type;
+    uint32_t args[4];
+    float values[4];
+};
+
+// One EndFrame worth of recorded commands
+struct NullCapturedFrame {
+    uint64_t frameIndex = 0;
+    RenderStats stats;
+    std::vector<NullCommand> commands;
+};
+
+/**
+ * Null Renderer
+ * Implements IRenderer against CPU-side resource tables without touching a GPU.
+ * Every call is recorded into a command stream and counted in RenderStats, so
+ * renderer overhead can be profiled and draw-call regressions tested headless.
+ * Copies follow the rules the GPU backends impose: only Static buffers are
+ * copy destinations and no buffer is copied onto itself; others are dropped.
+ */
+class NullRenderer : public IRenderer {
+public:
+    NullRenderer();
+    ~NullRenderer() override;
+
+    // IRenderer implementation
+    bool Initialize(void* windowHandle, uint32_t width, uint32_t height) override;
+    void Shutdown() override;
+    void Resize(uint32_t width, uint32_t height) override;
+
+    void BeginFrame() override;
+    void EndFrame() override;
+    void Present() override;
+
+    void Clear(uint32_t flags, float r, float g, float b, float a) override;
+    void SetClearColor(float r, float g, float b, float a) override;
+
+    void SetViewport(int x, int y, uint32_t width, uint32_t height) override;
+    void SetScissor(int x, int y, uint32_t width, uint32_t height) override;
+
+    uint32_t CreateVertexBuffer(const void* data, size_t size, BufferUsage usage) override;
+    uint32_t CreateIndexBuffer(const uint32_t* data, size_t count, BufferUsage usage) override;
+    void UpdateVertexBuffer(uint32_t buffer, const void* data, size_t size, size_t offset) override;
+    void DeleteBuffer(uint32_t buffer) override;
+
+    StreamingAllocation AllocateStreaming(size_t size, size_t alignment) override;
+    void CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) override;
+    void CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                    size_t size) override;
+
+    uint32_t CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) override;
+    void UpdateTexture2D(uint32_t texture, const void* data, uint32_t mipLevel) override;
+    void DeleteTexture(uint32_t texture) override;
+    void BindTexture(uint32_t slot, uint32_t texture) override;
+
+    uint32_t CreateShader(const std::string& vertexSource, const std::string& fragmentSource) override;
+    void DeleteShader(uint32_t shader) override;
+    void BindShader(uint32_t shader) override;
+    void SetShaderUniform(uint32_t shader, const std::string& name, const void* data, size_t size) override;
+    void SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) override;
+
+    void DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                    PrimitiveTopology topology) override;
+    void Draw(uint32_t vertexBuffer, uint32_t vertexCount, PrimitiveTopology topology) override;
+    void MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, const IndirectDrawCommand* commands,
+                          uint32_t drawCount, PrimitiveTopology topology) override;
+    void DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                              uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                              PrimitiveTopology topology) override;
+    void ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) override;
+
+    void SetDepthTest(bool enabled) override;
+    void SetBlending(bool enabled) override;
+    void SetCulling(bool enabled) override;
+    void SetWireframe(bool enabled) override;
+
+    const RenderStats& GetStats() const override { return m_stats; }
+    void ResetStats() override { m_stats = RenderStats(); }
+    void AddCommandStats(const RenderStats& commandStats) override { AccumulateCommandStats(m_stats, commandStats); }
+
+    RenderAPI GetAPI() const override { return RenderAPI::Null; }
+    const char* GetAPIName() const override { return "Null"; }
+
+    // Command recording
+    void SetRecording(bool enabled) { m_recording = enabled; }
+    bool IsRecording() const { return m_recording; }
+    const std::vector<NullCommand>& GetFrameCommands() const { return m_commands; }
+    uint64_t GetFrameIndex() const { return m_frameIndex; }
+
+    // Capture files: every frame ended while a capture is open is appended
+    bool BeginCapture(const std::string& path);
+    void EndCapture();
+    bool IsCapturing() const { return m_capture.is_open(); }
+    static bool LoadCapture(const std::string& path, std::vector<NullCapturedFrame>& frames);
+
+    // Streaming emulation: a frame's fence completes gpuLatency frames after it ends
+    void SetStreamingCapacity(size_t capacity);
+    void SetSimulatedGpuLatency(uint32_t frames) { m_gpuLatency = frames; }
+    const StreamingRingBuffer& GetStreamingBuffer() const { return m_streaming; }
+
+    // Resource inspection
+    size_t GetBufferCount() const { return m_buffers.size(); }
+    size_t GetTextureCount() const { return m_textures.size(); }
+    size_t GetShaderCount() const { return m_shaders.size(); }
+    const std::vector<uint8_t>* GetBufferData(uint32_t buffer) const;
+    const std::vector<uint8_t>* GetUniformData(uint32_t shader, const std::string& name) const;
+
+private:
+    struct BufferResource {
+        std::vector<uint8_t> data;
+        BufferUsage usage;
+        bool isIndexBuffer;
+    };
+
+    struct TextureResource {
+        uint32_t width;
+        uint32_t height;
+        TextureFormat format;
+        std::vector<std::vector<uint8_t>> mips;
+    };
+
+    struct UniformValue {
+        uint32_t nameHash;  // recorded instead of the handle, which can differ between runs
+        std::vector<uint8_t> data;
+    };
+
+    struct ShaderResource {
+        std::string vertexSource;
+        std::string fragmentSource;
+        std::unordered_map<UniformHandle, UniformValue> uniforms;
+    };
+
+    std::unordered_map<uint32_t, BufferResource> m_buffers;
+    std::unordered_map<uint32_t, TextureResource> m_textures;
+    std::unordered_map<uint32_t, ShaderResource> m_shaders;
+
+    // Streaming ring, kept out of m_buffers so its memory never moves
+    BufferResource m_streamingBuffer;
+    uint32_t m_streamingID;
+    StreamingRingBuffer m_streaming;
+    uint64_t m_submittedFence;
+    uint32_t m_gpuLatency;
+
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_nextID;
+    float m_clearColor[4];
+    RenderStats m_stats;
+
+    // Currently bound state, used to count real state switches
+    uint32_t m_currentShader;
+    std::vector<uint32_t> m_boundTextures;
+    bool m_depthTest;
+    bool m_blending;
+    bool m_culling;
+    bool m_wireframe;
+
+    bool m_recording;
+    uint64_t m_frameIndex;
+    std::vector<NullCommand> m_commands;
+    std::ofstream m_capture;
+
+    BufferResource* FindBuffer(uint32_t buffer);
+    const BufferResource* FindBuffer(uint32_t buffer) const;
+    void Record(NullCommandType type, uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0, uint32_t a3 = 0,
+                float v0 = 0.0f, float v1 = 0.0f, float v2 = 0.0f, float v3 = 0.0f);
+    void SetState(bool& state, bool enabled, NullCommandType type);
+    void WriteCapturedFrame();
+    static uint32_t CountTriangles(uint32_t count, PrimitiveTopology topology);
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
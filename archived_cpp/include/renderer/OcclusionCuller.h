@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SwordAndStone {
+
+namespace Platform {
+class JobSystem;
+}
+
+namespace Renderer {
+
+/**
+ * Occlusion Culler
+ * Software hierarchical-Z occlusion. Occluder boxes are rasterized at low
+ * resolution into a depth buffer (one job per band of rows), a max-depth
+ * pyramid is built over it, and candidate AABBs are rejected when their
+ * nearest depth lies behind the farthest occluder depth covering their
+ * screen rectangle. Depth is NDC z remapped to [0, 1].
+ */
+class OcclusionCuller {
+public:
+    explicit OcclusionCuller(Platform::JobSystem* jobSystem = nullptr, uint32_t width = 256, uint32_t height = 128);
+
+    // Clears the depth buffer and occluder list; viewProjection is column-major
+    void BeginFrame(const float* viewProjection);
+
+    void AddOccluder(const float min[3], const float max[3]);
+
+    // Rasterizes every occluder added this frame and builds the pyramid
+    void RasterizeOccluders();
+
+    // True when the box may be visible
+    bool TestAABB(const float min[3], const float max[3]) const;
+
+    // Tests every box whose visible[i] is non-zero and clears it when occluded;
+    // returns the number of boxes culled
+    uint32_t TestAABBs(const float* minX, const float* minY, const float* minZ,
+                       const float* maxX, const float* maxY, const float* maxZ,
+                       size_t count, uint8_t* visible) const;
+
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+    size_t GetLevelCount() const { return m_levels.size(); }
+    float GetDepth(size_t level, uint32_t x, uint32_t y) const;
+    size_t GetOccluderCount() const { return m_occluders.size() / 6; }
+
+private:
+    // Screen-space triangle as three edge functions and a depth plane, all
+    // evaluated at pixel centres (y down); edges are >= 0 inside
+    struct ScreenTriangle {
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        float depthA, depthB, depthC;
+        int minX, maxX;
+        int minY, maxY;
+    };
+
+    struct Level {
+        uint32_t width;
+        uint32_t height;
+        std::vector<float> depth;
+    };
+
+    Platform::JobSystem* m_jobSystem;
+    uint32_t m_width;
+    uint32_t m_height;
+    float m_viewProjection[16];
+
+    std::vector<float> m_occluders;  // min xyz, max xyz per occluder
+    std::vector<ScreenTriangle> m_triangles;
+    std::vector<Level> m_levels;     // level 0 is the rasterized depth buffer
+
+    void SetupTriangles();
+    void RasterizeBand(int y0, int y1);
+    void AddTriangle(const float* a, const float* b, const float* c);
+    void RasterizeTriangle(const ScreenTriangle& tri, int y0, int y1);
+    void BuildPyramid();
+
+    // Projects the box; false when it crosses the near plane and cannot be tested
+    bool ProjectAABB(const float min[3], const float max[3], float rect[4], float& nearestDepth) const;
+    bool IsOccluded(const float rect[4], float nearestDepth) const;
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
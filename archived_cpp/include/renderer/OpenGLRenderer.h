@@ -1,7 +1,9 @@
 #pragma once
 
 #include "IRenderer.h"
+#include "VertexArrayCache.h"
 #include <unordered_map>
+#include <vector>
 
 namespace SwordAndStone {
 namespace Renderer {
@@ -31,6 +33,11 @@ public:
     void UpdateVertexBuffer(uint32_t buffer, const void* data, size_t size, size_t offset) override;
     void DeleteBuffer(uint32_t buffer) override;
 
+    StreamingAllocation AllocateStreaming(size_t size, size_t alignment) override;
+    void CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) override;
+    void CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                    size_t size) override;
+
     uint32_t CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) override;
     void UpdateTexture2D(uint32_t texture, const void* data, uint32_t mipLevel) override;
     void DeleteTexture(uint32_t texture) override;
@@ -40,10 +47,17 @@ public:
     void DeleteShader(uint32_t shader) override;
     void BindShader(uint32_t shader) override;
     void SetShaderUniform(uint32_t shader, const std::string& name, const void* data, size_t size) override;
+    void SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) override;
 
     void DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount, 
                     PrimitiveTopology topology) override;
     void Draw(uint32_t vertexBuffer, uint32_t vertexCount, PrimitiveTopology topology) override;
+    void MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, const IndirectDrawCommand* commands,
+                          uint32_t drawCount, PrimitiveTopology topology) override;
+    void DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                              uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                              PrimitiveTopology topology) override;
+    void ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) override;
 
     void SetDepthTest(bool enabled) override;
     void SetBlending(bool enabled) override;
@@ -52,16 +66,21 @@ public:
 
     const RenderStats& GetStats() const override { return m_stats; }
     void ResetStats() override { m_stats = RenderStats(); }
+    void AddCommandStats(const RenderStats& commandStats) override { AccumulateCommandStats(m_stats, commandStats); }
 
     RenderAPI GetAPI() const override { return RenderAPI::OpenGL; }
     const char* GetAPIName() const override { return "OpenGL"; }
 
 private:
+    // Vertex layouts a VAO can be configured for
+    static constexpr uint32_t LAYOUT_STANDARD = 0;   // Vertex
+    static constexpr uint32_t LAYOUT_INSTANCED = 1;  // Vertex plus InstanceData from a second buffer
+
     void* m_windowHandle;
     uint32_t m_width;
     uint32_t m_height;
     
-    uint32_t m_vao;  // Vertex Array Object
+    uint32_t m_currentVAO;
     uint32_t m_currentShader;
     uint32_t m_currentVBO;
     uint32_t m_currentIBO;
@@ -69,11 +88,55 @@ private:
     float m_clearColor[4];
     RenderStats m_stats;
     
-    std::unordered_map<uint32_t, int32_t> m_uniformLocations;
+    // Location and GL type of each (shader << 32 | uniform handle), resolved on first use
+    struct UniformLocation {
+        int32_t location;  // -1 if the shader has no such active uniform
+        uint32_t type;
+    };
+    std::unordered_map<uint64_t, UniformLocation> m_uniformLocations;
+    
+    VertexArrayCache m_vertexArrays;
+    std::vector<uint32_t> m_deletedVertexArrays;  // scratch for DeleteVertexArrays
+    
+    // Texture dimensions and mip levels with storage, so UpdateTexture2D
+    // knows each level's size and whether it must be allocated first
+    struct TextureInfo {
+        uint32_t width;
+        uint32_t height;
+        TextureFormat format;
+        uint32_t allocatedLevels;  // bit per mip level
+    };
+    std::unordered_map<uint32_t, TextureInfo> m_textures;
+    
+    // Streaming ring: persistently mapped when buffer storage is available,
+    // otherwise written to a CPU shadow copy and uploaded per allocation
+    static constexpr uint32_t FENCE_SLOTS = StreamingRingBuffer::FRAME_COUNT + 1;
+    
+    StreamingRingBuffer m_streaming;
+    uint32_t m_streamingBuffer;
+    bool m_streamingPersistent;
+    std::vector<uint8_t> m_streamingShadow;
+    void* m_frameFences[FENCE_SLOTS];  // GLsync per in-flight frame
+    uint64_t m_submittedFence;
+    uint64_t m_completedFence;
+    
+    // Scratch arrays for the glMultiDrawElementsBaseVertex fallback
+    std::vector<int32_t> m_multiDrawCounts;
+    std::vector<const void*> m_multiDrawOffsets;
+    std::vector<int32_t> m_multiDrawBaseVertices;
+    
+    uint32_t GetVertexArray(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t layout, uint32_t instanceBuffer = 0);
+    void BindVertexArray(uint32_t vao);
+    void DeleteVertexArrays(uint32_t buffer);
+    
+    void CreateStreamingBuffer(size_t capacity);
+    void DestroyStreamingBuffer();
+    void RetireStreamingFrames();
     
     uint32_t ConvertTopology(PrimitiveTopology topology);
     uint32_t ConvertBufferUsage(BufferUsage usage);
     void SetupVertexAttributes();
+    void SetupInstanceAttributes(size_t offset);
 };
 
 } // namespace Renderer
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "IRenderer.h"
+#include <unordered_map>
+
+namespace SwordAndStone {
+namespace Platform { class JobSystem; }
+
+namespace Renderer {
+
+/**
+ * Software Renderer
+ * CPU rasterizer for headless rendering (thumbnails, server screenshots,
+ * regression images). Draws are transformed and set up immediately, binned
+ * into 64x64 screen tiles, and the tiles are rasterized in parallel on the
+ * job system with SIMD edge functions when the frame is flushed.
+ *
+ * There is no shader compiler: vertices are transformed by the 4x4
+ * column-major "u_mvp" uniform of the bound shader (identity if unset) and
+ * shaded as vertex color times the texture bound to slot 0.
+ */
+class SoftwareRenderer : public IRenderer {
+public:
+    static constexpr uint32_t TILE_SIZE = 64;
+
+    explicit SoftwareRenderer(Platform::JobSystem* jobSystem = nullptr);
+    ~SoftwareRenderer() override;
+
+    // IRenderer implementation
+    bool Initialize(void* windowHandle, uint32_t width, uint32_t height) override;
+    void Shutdown() override;
+    void Resize(uint32_t width, uint32_t height) override;
+
+    void BeginFrame() override;
+    void EndFrame() override;
+    void Present() override;
+
+    void Clear(uint32_t flags, float r, float g, float b, float a) override;
+    void SetClearColor(float r, float g, float b, float a) override;
+
+    void SetViewport(int x, int y, uint32_t width, uint32_t height) override;
+    void SetScissor(int x, int y, uint32_t width, uint32_t height) override;
+
+    uint32_t CreateVertexBuffer(const void* data, size_t size, BufferUsage usage) override;
+    uint32_t CreateIndexBuffer(const uint32_t* data, size_t count, BufferUsage usage) override;
+    void UpdateVertexBuffer(uint32_t buffer, const void* data, size_t size, size_t offset) override;
+    void DeleteBuffer(uint32_t buffer) override;
+
+    StreamingAllocation AllocateStreaming(size_t size, size_t alignment) override;
+    void CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) override;
+    void CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                    size_t size) override;
+
+    uint32_t CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) override;
+    void UpdateTexture2D(uint32_t texture, const void* data, uint32_t mipLevel) override;
+    void DeleteTexture(uint32_t texture) override;
+    void BindTexture(uint32_t slot, uint32_t texture) override;
+
+    uint32_t CreateShader(const std::string& vertexSource, const std::string& fragmentSource) override;
+    void DeleteShader(uint32_t shader) override;
+    void BindShader(uint32_t shader) override;
+    void SetShaderUniform(uint32_t shader, const std::string& name, const void* data, size_t size) override;
+    void SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) override;
+
+    void DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                    PrimitiveTopology topology) override;
+    void Draw(uint32_t vertexBuffer, uint32_t vertexCount, PrimitiveTopology topology) override;
+    void MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, const IndirectDrawCommand* commands,
+                          uint32_t drawCount, PrimitiveTopology topology) override;
+    void DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                              uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                              PrimitiveTopology topology) override;
+    void ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) override;
+
+    void SetDepthTest(bool enabled) override;
+    void SetBlending(bool enabled) override;
+    void SetCulling(bool enabled) override;
+    void SetWireframe(bool enabled) override;
+
+    const RenderStats& GetStats() const override { return m_stats; }
+    void ResetStats() override { m_stats = RenderStats(); }
+    void AddCommandStats(const RenderStats& commandStats) override { AccumulateCommandStats(m_stats, commandStats); }
+
+    RenderAPI GetAPI() const override { return RenderAPI::Software; }
+    const char* GetAPIName() const override { return "Software"; }
+
+    // Rasterizes all binned triangles; called implicitly by EndFrame and Clear
+    void Flush();
+
+    // Framebuffer access (RGBA8, top row first)
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+    void ReadPixels(std::vector<uint8_t>& rgba) const;
+    float ReadDepth(uint32_t x, uint32_t y) const;
+    bool SaveFramebuffer(const std::string& path) const;  // binary PPM
+
+private:
+    struct BufferResource {
+        std::vector<uint8_t> data;
+    };
+
+    struct TextureResource {
+        uint32_t width;
+        uint32_t height;
+        TextureFormat format;          // format of uploaded data
+        bool srgb;                     // texels are sRGB-encoded and decoded to linear when sampled
+        std::vector<uint32_t> texels;  // RGBA8
+    };
+
+    struct ShaderResource {
+        float mvp[16];
+    };
+
+    // Post-transform vertex: clip position and attributes
+    struct ClipVertex {
+        float position[4];
+        float texcoord[2];
+        float color[4];
+    };
+
+    // Pipeline state captured per draw
+    struct DrawState {
+        const TextureResource* texture;
+        bool depthTest;
+        bool blending;
+    };
+
+    // Screen-space triangle ready for rasterization; every quantity is a
+    // plane equation value = p[0] * x + p[1] * y + p[2]
+    struct TriangleSetup {
+        float edges[3][3];
+        bool topLeft[3];         // edge owns pixel centres lying exactly on it
+        float depth[3];
+        float invW[3];
+        float attributes[6][3];  // u/w, v/w, r/w, g/w, b/w, a/w
+        int minX, minY, maxX, maxY;
+        uint32_t state;
+    };
+
+    Platform::JobSystem* m_jobSystem;
+
+    std::unordered_map<uint32_t, BufferResource> m_buffers;
+    std::unordered_map<uint32_t, TextureResource> m_textures;
+    std::unordered_map<uint32_t, ShaderResource> m_shaders;
+
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_stride;  // padded to a multiple of 4 pixels for SIMD access
+    std::vector<uint32_t> m_color;
+    std::vector<float> m_depth;
+
+    int m_viewport[4];
+    float m_clearColor[4];
+    RenderStats m_stats;
+    uint32_t m_nextID;
+
+    // Frames are fully rasterized by EndFrame, so every fence completes immediately
+    StreamingRingBuffer m_streaming;
+    uint64_t m_submittedFence;
+
+    uint32_t m_currentShader;
+    uint32_t m_boundTexture;
+    bool m_depthTest;
+    bool m_blending;
+    bool m_culling;
+
+    // Frame geometry
+    uint32_t m_tilesX;
+    uint32_t m_tilesY;
+    std::vector<DrawState> m_drawStates;
+    std::vector<TriangleSetup> m_triangles;
+    std::vector<std::vector<uint32_t>> m_bins;
+    std::vector<ClipVertex> m_clipVertices;
+    std::vector<TriangleSetup> m_setupScratch;
+    std::vector<uint8_t> m_setupCounts;
+
+    void AllocateFramebuffer();
+    // Converts base-level data in the texture's format to RGBA8 texels; returns the bytes read
+    size_t WriteTexels(TextureResource& texture, const void* data);
+    uint32_t SubmitTriangles(const uint32_t* indices, uint32_t vertexCount, uint32_t indexCount,
+                             PrimitiveTopology topology, uint32_t baseVertex = 0);
+    // Grows [first, end) to cover the vertices the indices reach, clamped to the buffer
+    static void ExtendIndexRange(const uint32_t* indices, uint32_t indexCount, uint32_t baseVertex,
+                                 uint32_t vertexCount, uint32_t& first, uint32_t& end);
+    // Transforms vertices [first, end) of a buffer of count; with instances, vertex v of instance i
+    // lands at i * count + v
+    void TransformVertices(const Vertex* vertices, uint32_t count, uint32_t first, uint32_t end,
+                           const InstanceData* instances = nullptr, uint32_t instanceCount = 1);
+    uint32_t SetupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2,
+                           uint32_t state, TriangleSetup* out) const;
+    bool SetupClippedTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2,
+                              uint32_t state, TriangleSetup& out) const;
+    void BinTriangle(uint32_t triangle);
+    void RasterizeTile(uint32_t tileIndex);
+    void RasterizeTriangle(const TriangleSetup& tri, int x0, int y0, int x1, int y1);
+    void ShadePixel(const TriangleSetup& tri, const DrawState& state, int x, int y, float z);
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
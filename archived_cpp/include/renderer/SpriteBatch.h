@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CommandBuffer.h"
+
+namespace SwordAndStone {
+namespace Renderer {
+
+// A textured screen-space quad
+struct Sprite {
+    float position[2];  // top-left corner
+    float size[2];
+    float uv[4];        // u0, v0, u1, v1
+    float color[4];
+    float depth;        // draw order, lowest first; isometric callers pass the screen y of the sprite's base
+    uint32_t texture;
+};
+
+/**
+ * Sprite Batch
+ * Collects the dynamic sprites of a frame (buildings, trees, characters),
+ * radix sorts them by depth, writes their quads into one dynamic vertex
+ * buffer and records one draw per run of sprites sharing a texture. The sort
+ * is stable, so sprites at equal depth keep the order they were added in.
+ */
+class SpriteBatch {
+public:
+    SpriteBatch();
+
+    void Begin();
+    void Add(const Sprite& sprite);
+
+    // Sorts, uploads and records the batch; returns the number of draws recorded
+    uint32_t Flush(IRenderer& renderer, CommandBuffer& commands, uint32_t shader, uint32_t pass = 0,
+                   uint8_t state = StateBlending);
+
+    // Deletes the vertex and index buffers
+    void Release(IRenderer& renderer);
+
+    size_t GetSpriteCount() const { return m_sprites.size(); }
+
+    // Sprite indices in draw order, valid after Flush()
+    const std::vector<uint32_t>& GetDrawOrder() const { return m_order; }
+
+private:
+    std::vector<Sprite> m_sprites;
+    std::vector<uint32_t> m_keys;
+    std::vector<uint32_t> m_keysScratch;
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_orderScratch;
+    std::vector<Vertex> m_vertices;
+
+    uint32_t m_vertexBuffer;
+    uint32_t m_indexBuffer;
+    uint32_t m_capacity;  // sprites the buffers can hold
+
+    void SortByDepth();
+    bool EnsureCapacity(IRenderer& renderer, uint32_t spriteCount);
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+// Default ring size: 4 MB per frame in flight, a multiple of sizeof(Vertex)
+constexpr size_t DEFAULT_STREAMING_CAPACITY = 12 * 1024 * 1024;
+
+// A range of CPU-writable streaming memory backed by a renderer buffer
+struct StreamingAllocation {
+    void* data = nullptr;   // mapped memory, valid until the frame's fence completes
+    uint32_t buffer = 0;    // renderer buffer handle the range lives in
+    size_t offset = 0;      // byte offset of the range inside buffer
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+/**
+ * Streaming Ring Buffer
+ * Lock-free suballocator over one persistently mapped buffer. Allocations
+ * made during a frame are tagged with that frame's fence at EndFrame and the
+ * space is only reused once the fence has completed, so at most FRAME_COUNT
+ * frames of data are in flight. Allocate() may be called from any thread;
+ * EndFrame() and Retire() belong to the render thread.
+ */
+class StreamingRingBuffer {
+public:
+    static constexpr uint32_t FRAME_COUNT = 3;
+
+    StreamingRingBuffer();
+
+    void Initialize(uint8_t* memory, size_t capacity, uint32_t buffer);
+    void Reset();
+
+    // Returns an empty allocation when the ring is full
+    StreamingAllocation Allocate(size_t size, size_t alignment = 16);
+
+    // Closes the current frame, tagging its allocations with fence
+    void EndFrame(uint64_t fence);
+
+    // Releases every frame whose fence is <= completedFence
+    void Retire(uint64_t completedFence);
+
+    // Byte range written since the last EndFrame, as ring offsets; may wrap (begin > end)
+    void GetOpenFrameRange(size_t& begin, size_t& end) const;
+
+    uint32_t GetPendingFrameCount() const { return m_pendingCount; }
+    uint64_t GetOldestPendingFence() const;
+
+    size_t GetCapacity() const { return m_capacity; }
+    size_t GetUsedBytes() const;
+    uint32_t GetBuffer() const { return m_buffer; }
+    uint8_t* GetMemory() const { return m_memory; }
+    uint32_t GetFailedAllocations() const { return m_failedAllocations.load(std::memory_order_relaxed); }
+
+private:
+    struct PendingFrame {
+        uint64_t end;
+        uint64_t fence;
+    };
+
+    uint8_t* m_memory;
+    size_t m_capacity;
+    uint32_t m_buffer;
+
+    // Monotonic byte positions; ring offset = position % capacity
+    std::atomic<uint64_t> m_head;
+    std::atomic<uint64_t> m_tail;
+    uint64_t m_frameStart;
+
+    PendingFrame m_pending[FRAME_COUNT + 1];
+    uint32_t m_pendingFirst;
+    uint32_t m_pendingCount;
+    std::atomic<uint32_t> m_failedAllocations;
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
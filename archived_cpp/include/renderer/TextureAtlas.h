@@ -0,0 +1,110 @@
+#pragma once
+
+#include "IRenderer.h"
+#include <string>
+#include <vector>
+
+namespace SwordAndStone {
+
+namespace Platform {
+class JobSystem;
+}
+
+namespace Renderer {
+
+enum class MipFilter {
+    Box,     // 2x2 average
+    Kaiser   // 6-tap Kaiser-windowed sinc, sharper on distant terrain
+};
+
+struct TextureAtlasDesc {
+    uint32_t tileSize = 0;  // power of two; 0 uses the first source, rounded up
+    uint32_t padding = 8;   // border of wrapped texels around each tile, power of two
+    MipFilter filter = MipFilter::Kaiser;
+    TextureFormat format = TextureFormat::SRGBA8;  // SRGBA8 or a block-compressed format
+};
+
+// Normalized texture coordinates of a tile's interior (padding excluded)
+struct AtlasRect {
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 0.0f;
+    float v1 = 0.0f;
+};
+
+/**
+ * Texture Atlas
+ * Packs equally sized, tiling RGBA8 sRGB images (terrain block textures)
+ * into a grid of padded cells. Mip chains are filtered per tile in linear
+ * space with wrap-around addressing, in parallel on the job system, and the
+ * padding repeats the tile so neither bilinear filtering nor mips bleed
+ * between neighbours. The mip count stops where the padding would vanish.
+ *
+ * With a compressed format every level is block-encoded after filtering.
+ * Build() can load a binary cache instead of decoding, filtering and
+ * encoding; the cache is keyed by a hash of every source's bytes and the
+ * build settings.
+ */
+class TextureAtlas {
+public:
+    static constexpr uint32_t INVALID_TILE = 0xFFFFFFFFu;
+
+    explicit TextureAtlas(Platform::JobSystem* jobSystem = nullptr);
+
+    // Raw RGBA8 pixels; tiles are ordered as added
+    void AddImage(const std::string& name, uint32_t width, uint32_t height, const uint8_t* pixels);
+    // Reads an encoded image (PNG, TGA, ...) now; decoding happens in Build() if the cache misses
+    bool AddFile(const std::string& name, const std::string& path);
+    void Clear();
+
+    // Returns false when there is nothing to pack or a source cannot be decoded
+    bool Build(const TextureAtlasDesc& desc, const std::string& cachePath = "");
+    bool WasLoadedFromCache() const { return m_loadedFromCache; }
+
+    // Creates a texture in GetFormat() with every mip level; returns 0 if not built
+    uint32_t Upload(IRenderer& renderer) const;
+
+    uint32_t FindTile(const std::string& name) const;
+    AtlasRect GetTileRect(uint32_t tile) const;
+    size_t GetTileCount() const { return m_tileNames.size(); }
+
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+    uint32_t GetTileSize() const { return m_tileSize; }
+    uint32_t GetPadding() const { return m_padding; }
+    TextureFormat GetFormat() const { return m_format; }
+    size_t GetLevelCount() const { return m_levels.size(); }
+    const std::vector<uint8_t>& GetLevel(size_t level) const { return m_levels[level]; }
+    uint64_t GetSourceHash() const { return m_sourceHash; }
+
+private:
+    struct Source {
+        std::string name;
+        uint32_t width;   // 0 while still encoded
+        uint32_t height;
+        std::vector<uint8_t> bytes;  // encoded file, or RGBA8 pixels once width is set
+    };
+
+    Platform::JobSystem* m_jobSystem;
+    std::vector<Source> m_sources;
+
+    std::vector<std::string> m_tileNames;
+    std::vector<std::vector<uint8_t>> m_levels;  // texel or block data in m_format, level 0 first
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_tileSize;
+    uint32_t m_padding;
+    uint32_t m_columns;
+    TextureFormat m_format;
+    uint64_t m_sourceHash;
+    bool m_loadedFromCache;
+
+    uint64_t HashSources(const TextureAtlasDesc& desc) const;
+    bool LoadCache(const std::string& path, uint64_t hash);
+    bool SaveCache(const std::string& path) const;
+    void SetLayout(uint32_t tileSize, uint32_t padding, uint32_t tileCount, uint32_t levelCount,
+                   TextureFormat format);
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
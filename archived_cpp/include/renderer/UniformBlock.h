@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+class IRenderer;
+
+// Uniform name interned to a small integer, shared by every shader and backend
+using UniformHandle = uint32_t;
+constexpr UniformHandle INVALID_UNIFORM = 0;
+
+// Returns the handle for a name, registering it on first use. Thread-safe;
+// resolve names once at load time and keep the handles.
+UniformHandle InternUniformName(const std::string& name);
+// Returns INVALID_UNIFORM for names never interned
+UniformHandle FindUniformHandle(const std::string& name);
+const std::string& GetUniformName(UniformHandle handle);
+
+// How often a block's values are expected to change
+enum class UniformFrequency {
+    PerFrame,  // camera, time, lighting
+    PerPass,   // render target size, pass flags
+    PerDraw    // model matrix, material parameters
+};
+
+/**
+ * Uniform Block
+ * CPU-side copy of a group of uniforms that change at the same rate. Fields
+ * are declared once by name; Set() compares against the stored bytes and only
+ * marks a field dirty when they differ. Upload() sends a shader just the
+ * fields that changed since that shader last received the block, and returns
+ * immediately when nothing did, so a per-frame block shared by many shaders
+ * costs one comparison per draw.
+ */
+class UniformBlock {
+public:
+    static constexpr uint32_t INVALID_FIELD = 0xFFFFFFFFu;
+
+    explicit UniformBlock(UniformFrequency frequency = UniformFrequency::PerDraw);
+
+    // Returns the field index; fields are packed in declaration order
+    uint32_t AddField(const std::string& name, size_t size);
+    uint32_t FindField(UniformHandle handle) const;
+
+    // Copies GetFieldSize(field) bytes; returns true if the value changed
+    bool Set(uint32_t field, const void* data);
+    template <typename T>
+    bool Set(uint32_t field, const T& value) {
+        return sizeof(T) == GetFieldSize(field) && Set(field, static_cast<const void*>(&value));
+    }
+
+    // Sends fields changed since this shader's last upload; returns how many were sent
+    uint32_t Upload(IRenderer& renderer, uint32_t shader);
+    // Forgets every shader's upload state, e.g. after shaders are recreated
+    void Invalidate();
+
+    UniformFrequency GetFrequency() const { return m_frequency; }
+    size_t GetFieldCount() const { return m_fields.size(); }
+    uint32_t GetFieldSize(uint32_t field) const { return field < m_fields.size() ? m_fields[field].size : 0; }
+    const void* GetFieldData(uint32_t field) const { return &m_data[m_fields[field].offset]; }
+    size_t GetSize() const { return m_data.size(); }
+    uint64_t GetVersion() const { return m_version; }
+
+private:
+    struct Field {
+        UniformHandle handle;
+        uint32_t offset;
+        uint32_t size;
+        uint64_t changedVersion;  // block version of the last change
+    };
+
+    UniformFrequency m_frequency;
+    std::vector<Field> m_fields;
+    std::vector<uint8_t> m_data;
+    uint64_t m_version;  // bumped by every change
+    std::vector<std::pair<uint32_t, uint64_t>> m_uploadedVersions;  // shader, version it last received
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
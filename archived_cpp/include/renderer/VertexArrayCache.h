@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+/**
+ * Vertex Array Cache
+ * API-independent bookkeeping for one vertex array object per (vertex
+ * buffer, index buffer, layout, instance buffer) combination. Every cached
+ * array is indexed by each buffer it reads from, so deleting a buffer hands
+ * back exactly the arrays that referenced it for the backend to destroy.
+ */
+class VertexArrayCache {
+public:
+    struct Key {
+        uint32_t vertexBuffer;
+        uint32_t indexBuffer;
+        uint32_t layout;
+        uint32_t instanceBuffer;
+
+        bool operator==(const Key& other) const {
+            return vertexBuffer == other.vertexBuffer && indexBuffer == other.indexBuffer && layout == other.layout &&
+                   instanceBuffer == other.instanceBuffer;
+        }
+    };
+
+    // Returns the cached array, or 0 if the combination has none yet
+    uint32_t Find(const Key& key) const;
+    void Insert(const Key& key, uint32_t vertexArray);
+
+    // Forgets every array that reads from buffer and appends them to removed
+    void RemoveBuffer(uint32_t buffer, std::vector<uint32_t>& removed);
+    // Forgets every array and appends them to removed
+    void Clear(std::vector<uint32_t>& removed);
+
+    size_t GetSize() const { return m_vertexArrays.size(); }
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            uint64_t packed = (static_cast<uint64_t>(key.vertexBuffer) << 32) ^
+                              (static_cast<uint64_t>(key.layout) << 24) ^ key.indexBuffer ^
+                              (static_cast<uint64_t>(key.instanceBuffer) * 0x9E3779B97F4A7C15ull);
+            return std::hash<uint64_t>()(packed);
+        }
+    };
+
+    void Unlink(uint32_t buffer, const Key& key);
+
+    std::unordered_map<Key, uint32_t, KeyHash> m_vertexArrays;
+    std::unordered_map<uint32_t, std::vector<Key>> m_buffersToVertexArrays;
+};
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -3,6 +3,11 @@
 #include "engine/InputManager.h"
 #include "engine/TimeManager.h"
 #include "renderer/IRenderer.h"
+#include "renderer/CommandBuffer.h"
+#include "renderer/CommandListRecorder.h"
+#include "platform/LinearArena.h"
+#include "platform/MemoryTracker.h"
+#include "platform/Profiler.h"
 #include <iostream>
 
 namespace SwordAndStone {
@@ -54,6 +59,16 @@ bool Engine::Initialize(uint32_t width, uint32_t height, const std::string& titl
         return false;
     }
     
+    // Draws are recorded into the command buffer and submitted sorted at the end of the frame
+    m_commandBuffer = std::make_unique<Renderer::CommandBuffer>();
+    
+    // Transient per-frame allocations are bumped from here and dropped wholesale two frames later
+    m_frameArena = std::make_unique<Platform::FrameArena>();
+    
+    // Passes added during the frame are recorded on the job system and submitted after it
+    m_commandRecorder = std::make_unique<Renderer::CommandListRecorder>();
+    m_commandRecorder->SetFrameArena(m_frameArena.get());
+    
     // Create input manager
     m_input = std::make_unique<InputManager>();
     m_input->Initialize(m_window.get());
@@ -75,6 +90,15 @@ void Engine::Run() {
     std::cout << "Starting game loop..." << std::endl;
     
     while (m_isRunning && m_window->IsOpen()) {
+        // Last frame's transient allocations stay valid through this one; the frame before is reclaimed
+        m_frameArena->BeginFrame();
+        
+        // Frame boundary for the profiler; recorded zones are drained once a frame so thread rings never fill
+        PROFILE_FRAME_MARK();
+        if (Platform::Profiler::IsEnabled()) {
+            Platform::Profiler::Collect();
+        }
+        
         // Update time
         m_time->Update();
         float deltaTime = m_time->GetDeltaTime();
@@ -101,6 +125,9 @@ void Engine::Shutdown() {
     m_scene.reset();
     m_time.reset();
     m_input.reset();
+    m_commandRecorder.reset();
+    m_commandBuffer.reset();
+    m_frameArena.reset();
     
     if (m_renderer) {
         m_renderer->Shutdown();
@@ -112,19 +139,23 @@ void Engine::Shutdown() {
         m_window.reset();
     }
     
+    // Per-subsystem memory report; on headless servers this lands in the log
+    Platform::MemoryTracker::Dump(std::cout);
     std::cout << "Engine shut down." << std::endl;
 }
 
 void Engine::ProcessInput() {
+    PROFILE_ZONE("Engine::ProcessInput");
     m_input->Update();
     
     // Check for exit request (ESC key)
-    if (m_input->IsKeyPressed(27)) {  // ESC key
+    if (m_input->IsKeyPressed(InputManager::KEY_ESCAPE)) {
         RequestExit();
     }
 }
 
 void Engine::Update(float deltaTime) {
+    PROFILE_ZONE("Engine::Update");
     // TODO: Update game systems
     // if (m_scene) {
     //     m_scene->Update(deltaTime);
@@ -132,6 +163,7 @@ void Engine::Update(float deltaTime) {
 }
 
 void Engine::Render() {
+    PROFILE_ZONE("Engine::Render");
     if (!m_renderer) return;
     
     m_renderer->BeginFrame();
@@ -147,8 +179,21 @@ void Engine::Render() {
     //     m_scene->Render(m_renderer.get());
     // }
     
+    // Late-latch the cursor so camera passes recorded below see motion up to submission, not frame start
+    m_input->LateLatch();
+    
+    m_commandBuffer->Execute(*m_renderer);
+    m_commandRecorder->Record();
+    m_commandRecorder->Submit(*m_renderer);
+    
     m_renderer->EndFrame();
-    m_renderer->Present();
+    PROFILE_COUNTER("Draw Calls", m_renderer->GetStats().drawCalls);
+    PROFILE_COUNTER("Triangles", m_renderer->GetStats().triangles);
+    
+    {
+        PROFILE_ZONE("Engine::Present");
+        m_renderer->Present();
+    }
 }
 
 } // namespace SwordAndStone
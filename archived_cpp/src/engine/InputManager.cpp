@@ -1,5 +1,6 @@
 #include "engine/InputManager.h"
 #include "engine/Window.h"
+#include <cstring>
 
 #ifdef ENABLE_OPENGL
 #include <GLFW/glfw3.h>
@@ -7,79 +8,187 @@
 
 namespace SwordAndStone {
 
+namespace {
+
+uint64_t PackCursor(float x, float y) {
+    uint32_t bits[2];
+    std::memcpy(&bits[0], &x, sizeof(float));
+    std::memcpy(&bits[1], &y, sizeof(float));
+    return static_cast<uint64_t>(bits[0]) | (static_cast<uint64_t>(bits[1]) << 32);
+}
+
+void UnpackCursor(uint64_t packed, float& x, float& y) {
+    uint32_t bits[2] = { static_cast<uint32_t>(packed), static_cast<uint32_t>(packed >> 32) };
+    std::memcpy(&x, &bits[0], sizeof(float));
+    std::memcpy(&y, &bits[1], sizeof(float));
+}
+
+#ifdef ENABLE_OPENGL
+InputManager* FromWindow(GLFWwindow* window) {
+    return static_cast<InputManager*>(glfwGetWindowUserPointer(window));
+}
+#endif
+
+} // namespace
+
 InputManager::InputManager()
     : m_window(nullptr)
+    , m_droppedEvents(0)
+    , m_cursor(PackCursor(0.0f, 0.0f))
+    , m_mouseX(0.0f)
+    , m_mouseY(0.0f)
+    , m_mouseDeltaX(0.0f)
+    , m_mouseDeltaY(0.0f)
+    , m_scrollDelta(0.0f)
 {
 }
 
 InputManager::~InputManager() {
+#ifdef ENABLE_OPENGL
+    if (m_window && m_window->GetNativeHandle()) {
+        GLFWwindow* window = static_cast<GLFWwindow*>(m_window->GetNativeHandle());
+        glfwSetKeyCallback(window, nullptr);
+        glfwSetMouseButtonCallback(window, nullptr);
+        glfwSetScrollCallback(window, nullptr);
+        glfwSetCursorPosCallback(window, nullptr);
+        glfwSetWindowUserPointer(window, nullptr);
+    }
+#endif
 }
 
 void InputManager::Initialize(Window* window) {
     m_window = window;
+
+#ifdef ENABLE_OPENGL
+    if (m_window && m_window->GetNativeHandle()) {
+        GLFWwindow* native = static_cast<GLFWwindow*>(m_window->GetNativeHandle());
+        glfwSetWindowUserPointer(native, this);
+        // Repeats are dropped: they carry no edge and the key is already down
+        glfwSetKeyCallback(native, [](GLFWwindow* w, int key, int, int action, int) {
+            if (action != GLFW_REPEAT) FromWindow(w)->PushKey(key, action == GLFW_PRESS);
+        });
+        glfwSetMouseButtonCallback(native, [](GLFWwindow* w, int button, int action, int) {
+            FromWindow(w)->PushMouseButton(button, action == GLFW_PRESS);
+        });
+        glfwSetScrollCallback(native, [](GLFWwindow* w, double, double y) {
+            FromWindow(w)->PushScroll(static_cast<float>(y));
+        });
+        glfwSetCursorPosCallback(native, [](GLFWwindow* w, double x, double y) {
+            FromWindow(w)->SetCursorPosition(x, y);
+        });
+
+        double x, y;
+        glfwGetCursorPos(native, &x, &y);
+        SetCursorPosition(x, y);
+    }
+#endif
+
+    // Start from the current cursor so the first frame has no jump
+    UnpackCursor(m_cursor.load(std::memory_order_acquire), m_mouseX, m_mouseY);
 }
 
 void InputManager::Update() {
-    // TODO: Update input state
+    m_keysPressed.reset();
+    m_keysReleased.reset();
+    m_buttonsPressed.reset();
+    m_buttonsReleased.reset();
+    m_mouseDeltaX = m_mouseDeltaY = 0.0f;
+    m_scrollDelta = 0.0f;
+
+    InputEvent event;
+    while (m_events.Pop(event)) {
+        switch (event.type) {
+        case InputEventType::Key:
+            if (event.down && !m_keysDown[event.code]) m_keysPressed.set(event.code);
+            if (!event.down && m_keysDown[event.code]) m_keysReleased.set(event.code);
+            m_keysDown[event.code] = event.down;
+            break;
+        case InputEventType::MouseButton:
+            if (event.down && !m_buttonsDown[event.code]) m_buttonsPressed.set(event.code);
+            if (!event.down && m_buttonsDown[event.code]) m_buttonsReleased.set(event.code);
+            m_buttonsDown[event.code] = event.down;
+            break;
+        case InputEventType::Scroll:
+            m_scrollDelta += event.scroll;
+            break;
+        }
+    }
+
+    LatchCursor();
+}
+
+void InputManager::LateLatch() {
+    if (m_window) {
+        m_window->PollEvents();
+    }
+    LatchCursor();
+}
+
+void InputManager::LatchCursor() {
+    float x, y;
+    UnpackCursor(m_cursor.load(std::memory_order_acquire), x, y);
+    m_mouseDeltaX += x - m_mouseX;
+    m_mouseDeltaY += y - m_mouseY;
+    m_mouseX = x;
+    m_mouseY = y;
+}
+
+void InputManager::Push(const InputEvent& event) {
+    if (!m_events.Push(event)) {
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void InputManager::PushKey(int keyCode, bool down) {
+    if (keyCode < 0 || keyCode >= KEY_COUNT) return;  // GLFW_KEY_UNKNOWN
+    Push({ InputEventType::Key, down, static_cast<int16_t>(keyCode), 0.0f });
+}
+
+void InputManager::PushMouseButton(int button, bool down) {
+    if (button < 0 || button >= MOUSE_BUTTON_COUNT) return;
+    Push({ InputEventType::MouseButton, down, static_cast<int16_t>(button), 0.0f });
+}
+
+void InputManager::PushScroll(float offset) {
+    Push({ InputEventType::Scroll, false, 0, offset });
+}
+
+void InputManager::SetCursorPosition(double x, double y) {
+    m_cursor.store(PackCursor(static_cast<float>(x), static_cast<float>(y)), std::memory_order_release);
 }
 
 bool InputManager::IsKeyPressed(int keyCode) const {
-    // TODO: Implement key press detection
-    return false;
+    return keyCode >= 0 && keyCode < KEY_COUNT && m_keysPressed[keyCode];
 }
 
 bool InputManager::IsKeyDown(int keyCode) const {
-#ifdef ENABLE_OPENGL
-    if (m_window) {
-        GLFWwindow* window = static_cast<GLFWwindow*>(m_window->GetNativeHandle());
-        return glfwGetKey(window, keyCode) == GLFW_PRESS;
-    }
-#endif
-    return false;
+    return keyCode >= 0 && keyCode < KEY_COUNT && m_keysDown[keyCode];
 }
 
 bool InputManager::IsKeyReleased(int keyCode) const {
-    // TODO: Implement key release detection
-    return false;
+    return keyCode >= 0 && keyCode < KEY_COUNT && m_keysReleased[keyCode];
 }
 
 bool InputManager::IsMouseButtonPressed(int button) const {
-    // TODO: Implement mouse button press detection
-    return false;
+    return button >= 0 && button < MOUSE_BUTTON_COUNT && m_buttonsPressed[button];
 }
 
 bool InputManager::IsMouseButtonDown(int button) const {
-#ifdef ENABLE_OPENGL
-    if (m_window) {
-        GLFWwindow* window = static_cast<GLFWwindow*>(m_window->GetNativeHandle());
-        return glfwGetMouseButton(window, button) == GLFW_PRESS;
-    }
-#endif
-    return false;
+    return button >= 0 && button < MOUSE_BUTTON_COUNT && m_buttonsDown[button];
 }
 
 bool InputManager::IsMouseButtonReleased(int button) const {
-    // TODO: Implement mouse button release detection
-    return false;
+    return button >= 0 && button < MOUSE_BUTTON_COUNT && m_buttonsReleased[button];
 }
 
 void InputManager::GetMousePosition(float& x, float& y) const {
-#ifdef ENABLE_OPENGL
-    if (m_window) {
-        GLFWwindow* window = static_cast<GLFWwindow*>(m_window->GetNativeHandle());
-        double dx, dy;
-        glfwGetCursorPos(window, &dx, &dy);
-        x = static_cast<float>(dx);
-        y = static_cast<float>(dy);
-        return;
-    }
-#endif
-    x = y = 0.0f;
+    x = m_mouseX;
+    y = m_mouseY;
 }
 
 void InputManager::GetMouseDelta(float& dx, float& dy) const {
-    // TODO: Implement mouse delta tracking
-    dx = dy = 0.0f;
+    dx = m_mouseDeltaX;
+    dy = m_mouseDeltaY;
 }
 
 } // namespace SwordAndStone
@@ -0,0 +1,128 @@
+#include "game/CharacterController.h"
+#include "game/VoxelRaycast.h"
+#include "platform/Profiler.h"
+
+namespace SwordAndStone {
+namespace Game {
+
+namespace {
+
+// Characters handed to each job by MoveCharacters
+constexpr uint32_t CHARACTERS_PER_BATCH = 32;
+
+struct Box {
+    float min[3];
+    float max[3];
+};
+
+Box MakeBox(const Character& character) {
+    const float radius = character.desc.radius;
+    return { { character.position[0] - radius, character.position[1], character.position[2] - radius },
+             { character.position[0] + radius, character.position[1] + character.desc.height,
+               character.position[2] + radius } };
+}
+
+// Sweeps the box along one axis; a blocked box stops with its leading face exactly on the voxel boundary
+bool MoveAxis(const VoxelSystem& voxels, Box& box, int axis, float distance) {
+    if (distance == 0.0f) return false;
+
+    float motion[3] = { 0.0f, 0.0f, 0.0f };
+    motion[axis] = distance;
+    VoxelSweepHit hit;
+    if (!SweepVoxels(voxels, box.min, box.max, motion, hit)) {
+        box.min[axis] += distance;
+        box.max[axis] += distance;
+        return false;
+    }
+
+    // Exact integer faces keep the next sweep from starting inside the voxel it just touched
+    const float size = box.max[axis] - box.min[axis];
+    if (distance > 0.0f) {
+        box.max[axis] = static_cast<float>(hit.block[axis]);
+        box.min[axis] = box.max[axis] - size;
+    } else {
+        box.min[axis] = static_cast<float>(hit.block[axis] + 1);
+        box.max[axis] = box.min[axis] + size;
+    }
+    return true;
+}
+
+float HorizontalDistanceSquared(const Box& from, const Box& to) {
+    const float dx = to.min[0] - from.min[0];
+    const float dz = to.min[2] - from.min[2];
+    return dx * dx + dz * dz;
+}
+
+} // namespace
+
+void MoveCharacter(const VoxelSystem& voxels, Character& character, float deltaTime) {
+    const CharacterDesc& desc = character.desc;
+    float* velocity = character.velocity;
+    const bool wasGrounded = character.grounded;
+
+    velocity[1] -= desc.gravity * deltaTime;
+    Box box = MakeBox(character);
+
+    // Vertical first, so step-up and snapping know whether the character is standing
+    character.grounded = false;
+    if (MoveAxis(voxels, box, 1, velocity[1] * deltaTime)) {
+        character.grounded = velocity[1] < 0.0f;
+        velocity[1] = 0.0f;
+    }
+
+    const float dx = velocity[0] * deltaTime;
+    const float dz = velocity[2] * deltaTime;
+    Box moved = box;
+    bool blockedX = MoveAxis(voxels, moved, 0, dx);
+    bool blockedZ = MoveAxis(voxels, moved, 2, dz);
+
+    if ((blockedX || blockedZ) && character.grounded && desc.stepHeight > 0.0f) {
+        // Retry from as high as the step allows (less under a low ceiling), then settle back down
+        Box stepped = box;
+        MoveAxis(voxels, stepped, 1, desc.stepHeight);
+        const float lifted = stepped.min[1] - box.min[1];
+        if (lifted > 0.0f) {
+            const bool steppedX = MoveAxis(voxels, stepped, 0, dx);
+            const bool steppedZ = MoveAxis(voxels, stepped, 2, dz);
+            MoveAxis(voxels, stepped, 1, -lifted);
+            if (HorizontalDistanceSquared(box, stepped) > HorizontalDistanceSquared(box, moved) + 1e-8f) {
+                moved = stepped;
+                blockedX = steppedX;
+                blockedZ = steppedZ;
+            }
+        }
+    }
+    if (blockedX) velocity[0] = 0.0f;
+    if (blockedZ) velocity[2] = 0.0f;
+    box = moved;
+
+    // Follow the ground down steps and slopes instead of launching off them, unless jumping
+    if (wasGrounded && velocity[1] <= 0.0f && desc.snapDistance > 0.0f) {
+        Box probe = box;
+        if (MoveAxis(voxels, probe, 1, -desc.snapDistance)) {
+            box = probe;
+            character.grounded = true;
+            velocity[1] = 0.0f;
+        } else {
+            character.grounded = false;
+        }
+    }
+
+    character.position[0] = 0.5f * (box.min[0] + box.max[0]);
+    character.position[1] = box.min[1];
+    character.position[2] = 0.5f * (box.min[2] + box.max[2]);
+}
+
+void MoveCharacters(const VoxelSystem& voxels, Character* characters, uint32_t count, float deltaTime,
+                    Platform::JobSystem* jobSystem) {
+    PROFILE_ZONE("MoveCharacters");
+    Platform::JobSystem& jobs = jobSystem ? *jobSystem : Platform::JobSystem::GetDefault();
+    jobs.ParallelFor(count, CHARACTERS_PER_BATCH, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            MoveCharacter(voxels, characters[i], deltaTime);
+        }
+    });
+}
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,143 @@
+#include "game/Chunk.h"
+#include "platform/LinearArena.h"
+#include <algorithm>
+#include <cstring>
+
+namespace SwordAndStone {
+namespace Game {
+
+Chunk::Chunk(VoxelType fill)
+    : m_uniformType(fill)
+    , m_connectivity(IsOpaque(fill) ? 0 : ALL_FACES_CONNECTED)
+    , m_occluderHeight(IsOpaque(fill) ? CHUNK_SIZE : 0)
+    , m_dirty(true)
+{
+}
+
+void Chunk::Set(int x, int y, int z, VoxelType type) {
+    if (m_voxels.empty()) {
+        if (type == m_uniformType) return;
+        m_voxels.assign(CHUNK_VOLUME, m_uniformType);
+    }
+    m_voxels[Index(x, y, z)] = type;
+    m_dirty = true;
+}
+
+void Chunk::Fill(VoxelType type) {
+    m_voxels.clear();
+    m_voxels.shrink_to_fit();
+    m_uniformType = type;
+    m_dirty = true;
+}
+
+void Chunk::Compact() {
+    if (m_voxels.empty()) return;
+
+    VoxelType first = m_voxels[0];
+    if (std::all_of(m_voxels.begin(), m_voxels.end(), [first](VoxelType v) { return v == first; })) {
+        m_voxels.clear();
+        m_voxels.shrink_to_fit();
+        m_uniformType = first;
+    }
+}
+
+void Chunk::UpdateConnectivity() {
+    if (m_voxels.empty()) {
+        m_connectivity = IsOpaque(m_uniformType) ? 0 : ALL_FACES_CONNECTED;
+        return;
+    }
+
+    m_connectivity = 0;
+
+    // Runs for every dirty chunk, often on job workers; working memory comes from the thread's scratch stack
+    Platform::ScratchScope scratch;
+    uint8_t* visited = scratch.AllocateArray<uint8_t>(CHUNK_VOLUME);
+    std::memset(visited, 0, CHUNK_VOLUME);
+    int* stack = scratch.AllocateArray<int>(CHUNK_VOLUME);  // each voxel is pushed at most once
+    int stackSize = 0;
+
+    // Flood fill each region of non-opaque voxels that reaches the chunk border
+    for (int start = 0; start < CHUNK_VOLUME; start++) {
+        int sx = start % CHUNK_SIZE;
+        int sz = (start / CHUNK_SIZE) % CHUNK_SIZE;
+        int sy = start / (CHUNK_SIZE * CHUNK_SIZE);
+        bool border = sx == 0 || sx == CHUNK_SIZE - 1 || sy == 0 || sy == CHUNK_SIZE - 1 ||
+                      sz == 0 || sz == CHUNK_SIZE - 1;
+        if (!border || visited[start] || IsOpaque(m_voxels[start])) continue;
+
+        uint32_t faces = 0;
+        visited[start] = 1;
+        stack[stackSize++] = start;
+        while (stackSize > 0) {
+            int index = stack[--stackSize];
+
+            int x = index % CHUNK_SIZE;
+            int z = (index / CHUNK_SIZE) % CHUNK_SIZE;
+            int y = index / (CHUNK_SIZE * CHUNK_SIZE);
+            if (x == 0) faces |= 1u << static_cast<int>(ChunkFace::NegX);
+            if (x == CHUNK_SIZE - 1) faces |= 1u << static_cast<int>(ChunkFace::PosX);
+            if (y == 0) faces |= 1u << static_cast<int>(ChunkFace::NegY);
+            if (y == CHUNK_SIZE - 1) faces |= 1u << static_cast<int>(ChunkFace::PosY);
+            if (z == 0) faces |= 1u << static_cast<int>(ChunkFace::NegZ);
+            if (z == CHUNK_SIZE - 1) faces |= 1u << static_cast<int>(ChunkFace::PosZ);
+
+            const int neighbors[6][2] = {
+                { x > 0, index - 1 },
+                { x < CHUNK_SIZE - 1, index + 1 },
+                { y > 0, index - CHUNK_SIZE * CHUNK_SIZE },
+                { y < CHUNK_SIZE - 1, index + CHUNK_SIZE * CHUNK_SIZE },
+                { z > 0, index - CHUNK_SIZE },
+                { z < CHUNK_SIZE - 1, index + CHUNK_SIZE }
+            };
+            for (const auto& neighbor : neighbors) {
+                int next = neighbor[1];
+                if (neighbor[0] && !visited[next] && !IsOpaque(m_voxels[next])) {
+                    visited[next] = 1;
+                    stack[stackSize++] = next;
+                }
+            }
+        }
+
+        for (int a = 0; a < CHUNK_FACE_COUNT; a++) {
+            for (int b = a + 1; b < CHUNK_FACE_COUNT; b++) {
+                if ((faces & (1u << a)) && (faces & (1u << b))) {
+                    m_connectivity |= FacePairBit(static_cast<ChunkFace>(a), static_cast<ChunkFace>(b));
+                }
+            }
+        }
+        if (m_connectivity == ALL_FACES_CONNECTED) return;
+    }
+}
+
+void Chunk::UpdateOccluder() {
+    if (m_voxels.empty()) {
+        m_occluderHeight = IsOpaque(m_uniformType) ? CHUNK_SIZE : 0;
+        return;
+    }
+
+    const int layerSize = CHUNK_SIZE * CHUNK_SIZE;
+    int height = 0;
+    while (height < CHUNK_SIZE) {
+        auto layer = m_voxels.begin() + height * layerSize;
+        if (!std::all_of(layer, layer + layerSize, IsOpaque)) break;
+        height++;
+    }
+    m_occluderHeight = static_cast<uint8_t>(height);
+}
+
+bool Chunk::AreFacesConnected(ChunkFace a, ChunkFace b) const {
+    return a != b && (m_connectivity & FacePairBit(a, b)) != 0;
+}
+
+uint16_t Chunk::FacePairBit(ChunkFace a, ChunkFace b) {
+    int lo = std::min(static_cast<int>(a), static_cast<int>(b));
+    int hi = std::max(static_cast<int>(a), static_cast<int>(b));
+    if (lo == hi) return 0;
+
+    // Pairs (0,1)..(0,5) are bits 0-4, (1,2)..(1,5) bits 5-8, and so on
+    int bit = lo * (2 * CHUNK_FACE_COUNT - lo - 1) / 2 + (hi - lo - 1);
+    return static_cast<uint16_t>(1u << bit);
+}
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,213 @@
+#include "game/ChunkVisibility.h"
+#include "platform/LinearArena.h"
+#include <algorithm>
+#include <cmath>
+
+namespace SwordAndStone {
+namespace Game {
+
+namespace {
+
+const int FACE_OFFSETS[CHUNK_FACE_COUNT][3] = {
+    { -1, 0, 0 }, { 1, 0, 0 },
+    { 0, -1, 0 }, { 0, 1, 0 },
+    { 0, 0, -1 }, { 0, 0, 1 }
+};
+
+bool IsEmpty(const Chunk* chunk) {
+    return !chunk || (chunk->IsUniform() && chunk->GetUniformType() == VoxelType::Air);
+}
+
+} // namespace
+
+ChunkVisibility::ChunkVisibility()
+    : m_caveCulling(true)
+    , m_occlusionCuller(nullptr)
+    , m_frameArena(nullptr)
+    , m_origin{ 0, 0, 0 }
+    , m_side(0)
+{
+}
+
+void ChunkVisibility::Update(const VoxelSystem& voxels, const float cameraPosition[3],
+                             const Renderer::Frustum& frustum, int renderDistance) {
+    const int height = VoxelSystem::WORLD_HEIGHT_IN_CHUNKS;
+    ChunkCoord camera = VoxelSystem::WorldToChunk(static_cast<int>(std::floor(cameraPosition[0])),
+                                                  static_cast<int>(std::floor(cameraPosition[1])),
+                                                  static_cast<int>(std::floor(cameraPosition[2])));
+    camera.y = std::min(std::max(camera.y, 0), height - 1);
+
+    ChunkCoord origin = { camera.x - renderDistance, 0, camera.z - renderDistance };
+    int side = renderDistance * 2 + 1;
+    if (side != m_side || origin != m_origin) {
+        RebuildBounds(origin, side);
+    }
+
+    const size_t regionSize = m_minX.size();
+    frustum.TestAABBs(m_minX.data(), m_minY.data(), m_minZ.data(), m_maxX.data(), m_maxY.data(), m_maxZ.data(),
+                      regionSize, m_inFrustum.data());
+
+    m_stats = ChunkVisibilityStats();
+    m_chunks.assign(regionSize, nullptr);
+    for (const auto& entry : voxels.GetChunks()) {
+        const ChunkCoord& coord = entry.first;
+        if (coord.x < m_origin.x || coord.x >= m_origin.x + m_side || coord.y < 0 || coord.y >= height ||
+            coord.z < m_origin.z || coord.z >= m_origin.z + m_side) continue;
+
+        const Chunk* chunk = entry.second.get();
+        uint32_t index = RegionIndex(coord.x, coord.y, coord.z);
+        m_chunks[index] = chunk;
+        if (!IsEmpty(chunk)) {
+            m_stats.chunksInRange++;
+            m_stats.frustumCulled += m_inFrustum[index] ? 0 : 1;
+        }
+    }
+
+    m_visibleChunks.clear();
+    if (!m_caveCulling) {
+        for (uint32_t i = 0; i < regionSize; i++) {
+            if (m_inFrustum[i] && !IsEmpty(m_chunks[i])) {
+                m_visibleChunks.push_back(RegionCoord(i));
+            }
+        }
+    } else {
+        m_visited.assign(regionSize, 0);
+        m_queue.clear();
+
+        uint32_t start = RegionIndex(camera.x, camera.y, camera.z);
+        m_visited[start] = 1;
+        m_queue.push_back({ start, -1, 0 });
+
+        for (size_t head = 0; head < m_queue.size(); head++) {
+            Step step = m_queue[head];
+            const Chunk* chunk = m_chunks[step.index];
+            ChunkCoord coord = RegionCoord(step.index);
+            if (!IsEmpty(chunk)) {
+                m_visibleChunks.push_back(coord);
+            }
+
+            for (int face = 0; face < CHUNK_FACE_COUNT; face++) {
+                // Never walk back against a direction already taken
+                if (step.directions & (1u << (face ^ 1))) continue;
+                if (step.entryFace >= 0 && chunk &&
+                    !chunk->AreFacesConnected(static_cast<ChunkFace>(step.entryFace), static_cast<ChunkFace>(face))) {
+                    continue;
+                }
+
+                int nx = coord.x + FACE_OFFSETS[face][0];
+                int ny = coord.y + FACE_OFFSETS[face][1];
+                int nz = coord.z + FACE_OFFSETS[face][2];
+                if (nx < m_origin.x || nx >= m_origin.x + m_side || ny < 0 || ny >= height ||
+                    nz < m_origin.z || nz >= m_origin.z + m_side) continue;
+
+                uint32_t next = RegionIndex(nx, ny, nz);
+                if (m_visited[next] || !m_inFrustum[next]) continue;
+
+                m_visited[next] = 1;
+                m_queue.push_back({ next, static_cast<int8_t>(face ^ 1),
+                                    static_cast<uint8_t>(step.directions | (1u << face)) });
+            }
+        }
+    }
+
+    m_stats.connectivityCulled = m_stats.chunksInRange - m_stats.frustumCulled -
+                                 static_cast<uint32_t>(m_visibleChunks.size());
+    if (m_occlusionCuller) {
+        CullOccluded(cameraPosition);
+    }
+    m_stats.visible = static_cast<uint32_t>(m_visibleChunks.size());
+}
+
+void ChunkVisibility::CullOccluded(const float cameraPosition[3]) {
+    Platform::ScratchScope scratch;
+    Platform::LinearArena& arena = m_frameArena ? m_frameArena->GetArena() : scratch.GetArena();
+    const size_t count = m_visibleChunks.size();
+
+    // Rank the solid bases of visible chunks by volume over squared distance
+    OccluderCandidate* candidates = arena.AllocateArray<OccluderCandidate>(count);
+    size_t candidateCount = 0;
+    for (const ChunkCoord& coord : m_visibleChunks) {
+        uint32_t index = RegionIndex(coord.x, coord.y, coord.z);
+        int height = m_chunks[index]->GetOccluderHeight();
+        if (height == 0) continue;
+
+        float dx = m_minX[index] + CHUNK_SIZE * 0.5f - cameraPosition[0];
+        float dy = m_minY[index] + height * 0.5f - cameraPosition[1];
+        float dz = m_minZ[index] + CHUNK_SIZE * 0.5f - cameraPosition[2];
+        float distanceSquared = std::max(dx * dx + dy * dy + dz * dz, 1.0f);
+        candidates[candidateCount++] = { -static_cast<float>(height) / distanceSquared, index };
+    }
+    if (candidateCount > MAX_OCCLUDERS) {
+        std::nth_element(candidates, candidates + MAX_OCCLUDERS, candidates + candidateCount);
+        candidateCount = MAX_OCCLUDERS;
+    }
+
+    for (size_t i = 0; i < candidateCount; i++) {
+        uint32_t index = candidates[i].index;
+        const float min[3] = { m_minX[index], m_minY[index], m_minZ[index] };
+        const float max[3] = { m_maxX[index], m_minY[index] + m_chunks[index]->GetOccluderHeight(), m_maxZ[index] };
+        m_occlusionCuller->AddOccluder(min, max);
+    }
+    m_occlusionCuller->RasterizeOccluders();
+    m_stats.occluders = static_cast<uint32_t>(candidateCount);
+
+    // Visible chunk bounds as six consecutive arrays (min x, y, z, max x, y, z)
+    float* bounds = arena.AllocateArray<float>(count * 6);
+    uint8_t* visible = arena.AllocateArray<uint8_t>(count);
+    std::fill(visible, visible + count, static_cast<uint8_t>(1));
+    for (size_t i = 0; i < count; i++) {
+        const ChunkCoord& coord = m_visibleChunks[i];
+        uint32_t index = RegionIndex(coord.x, coord.y, coord.z);
+        bounds[i] = m_minX[index];
+        bounds[count + i] = m_minY[index];
+        bounds[count * 2 + i] = m_minZ[index];
+        bounds[count * 3 + i] = m_maxX[index];
+        bounds[count * 4 + i] = m_maxY[index];
+        bounds[count * 5 + i] = m_maxZ[index];
+    }
+    m_stats.occlusionCulled = m_occlusionCuller->TestAABBs(bounds, bounds + count, bounds + count * 2,
+                                                           bounds + count * 3, bounds + count * 4,
+                                                           bounds + count * 5, count, visible);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (visible[i]) {
+            m_visibleChunks[kept++] = m_visibleChunks[i];
+        }
+    }
+    m_visibleChunks.resize(kept);
+}
+
+void ChunkVisibility::RebuildBounds(const ChunkCoord& origin, int side) {
+    m_origin = origin;
+    m_side = side;
+
+    const size_t regionSize = static_cast<size_t>(side) * side * VoxelSystem::WORLD_HEIGHT_IN_CHUNKS;
+    m_minX.resize(regionSize);
+    m_minY.resize(regionSize);
+    m_minZ.resize(regionSize);
+    m_maxX.resize(regionSize);
+    m_maxY.resize(regionSize);
+    m_maxZ.resize(regionSize);
+    m_inFrustum.resize(regionSize);
+
+    for (uint32_t i = 0; i < regionSize; i++) {
+        ChunkCoord coord = RegionCoord(i);
+        m_minX[i] = static_cast<float>(coord.x * CHUNK_SIZE);
+        m_minY[i] = static_cast<float>(coord.y * CHUNK_SIZE);
+        m_minZ[i] = static_cast<float>(coord.z * CHUNK_SIZE);
+        m_maxX[i] = m_minX[i] + CHUNK_SIZE;
+        m_maxY[i] = m_minY[i] + CHUNK_SIZE;
+        m_maxZ[i] = m_minZ[i] + CHUNK_SIZE;
+    }
+}
+
+ChunkCoord ChunkVisibility::RegionCoord(uint32_t index) const {
+    int x = static_cast<int>(index % m_side);
+    int z = static_cast<int>((index / m_side) % m_side);
+    int y = static_cast<int>(index / (m_side * m_side));
+    return { m_origin.x + x, y, m_origin.z + z };
+}
+
+} // namespace Game
+} // namespace SwordAndStone
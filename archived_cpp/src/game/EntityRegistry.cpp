@@ -0,0 +1,377 @@
+#include "game/EntityRegistry.h"
+#include "platform/MemoryTracker.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace SwordAndStone {
+namespace Game {
+
+namespace {
+
+// Arrays start on a cache line so rows of different components never share one at the array boundaries
+constexpr uint32_t CHUNK_ALIGNMENT = 64;
+
+struct ComponentTypes {
+    std::mutex mutex;
+    ComponentInfo infos[MAX_COMPONENT_TYPES];
+    uint32_t count = 0;
+};
+
+ComponentTypes& GetComponentTypes() {
+    static ComponentTypes types;
+    return types;
+}
+
+inline uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+uint32_t RegisterComponentType(uint32_t size, uint32_t alignment) {
+    ComponentTypes& types = GetComponentTypes();
+    std::lock_guard<std::mutex> lock(types.mutex);
+    if (types.count == MAX_COMPONENT_TYPES) {
+        throw std::runtime_error("Too many entity component types");
+    }
+    types.infos[types.count] = { size, alignment };
+    return types.count++;
+}
+
+const ComponentInfo& GetComponentInfo(uint32_t id) {
+    return GetComponentTypes().infos[id];
+}
+
+void EntityCommands::Record(Op op, Entity entity, uint32_t component, const void* payload, uint32_t size) {
+    Header header = { entity, component, size, op };
+    const size_t offset = m_bytes.size();
+    m_bytes.resize(offset + sizeof(Header) + size);
+    std::memcpy(m_bytes.data() + offset, &header, sizeof(Header));
+    if (size) {
+        std::memcpy(m_bytes.data() + offset + sizeof(Header), payload, size);
+    }
+}
+
+EntityRegistry::EntityRegistry(Platform::JobSystem* jobSystem)
+    : m_jobSystem(jobSystem)
+    , m_commands(GetJobSystem().GetThreadCount())
+    , m_ownerThread(std::this_thread::get_id())
+    , m_liveCount(0)
+{
+    // Archetype 0 holds entities with no components
+    GetArchetype(0);
+}
+
+EntityRegistry::~EntityRegistry() {
+    for (std::unique_ptr<Archetype>& archetype : m_archetypes) {
+        for (Chunk& chunk : archetype->chunks) {
+            Platform::MemoryTracker::Free(chunk.data);
+        }
+    }
+    for (uint8_t* data : m_freeChunks) {
+        Platform::MemoryTracker::Free(data);
+    }
+}
+
+Platform::JobSystem& EntityRegistry::GetJobSystem() const {
+    return m_jobSystem ? *m_jobSystem : Platform::JobSystem::GetDefault();
+}
+
+uint32_t EntityRegistry::GetArchetype(ComponentMask mask) {
+    auto found = m_archetypeByMask.find(mask);
+    if (found != m_archetypeByMask.end()) {
+        return found->second;
+    }
+
+    Platform::MemoryTagScope tag(Platform::MemoryTag::Entities);
+    auto archetype = std::make_unique<Archetype>();
+    archetype->mask = mask;
+    std::fill(std::begin(archetype->offsets), std::end(archetype->offsets), 0u);
+    std::fill(std::begin(archetype->addEdges), std::end(archetype->addEdges), INVALID_INDEX);
+    std::fill(std::begin(archetype->removeEdges), std::end(archetype->removeEdges), INVALID_INDEX);
+
+    uint32_t rowBytes = sizeof(Entity);
+    uint32_t padding = 0;
+    for (uint32_t id = 0; id < MAX_COMPONENT_TYPES; id++) {
+        if (mask & (ComponentMask(1) << id)) {
+            archetype->components.push_back(id);
+            rowBytes += GetComponentInfo(id).size;
+            padding += std::max(GetComponentInfo(id).alignment, CHUNK_ALIGNMENT);
+        }
+    }
+
+    // Standard chunks unless a single row does not fit in one
+    archetype->chunkBytes = std::max(CHUNK_BYTES, rowBytes + padding);
+    archetype->capacity = (archetype->chunkBytes - padding) / rowBytes;
+
+    uint32_t offset = archetype->capacity * sizeof(Entity);
+    for (uint32_t id : archetype->components) {
+        offset = AlignUp(offset, std::max(GetComponentInfo(id).alignment, CHUNK_ALIGNMENT));
+        archetype->offsets[id] = offset;
+        offset += archetype->capacity * GetComponentInfo(id).size;
+    }
+
+    const uint32_t index = static_cast<uint32_t>(m_archetypes.size());
+    m_archetypes.push_back(std::move(archetype));
+    m_archetypeByMask.emplace(mask, index);
+    return index;
+}
+
+const std::vector<uint32_t>& EntityRegistry::MatchArchetypes(ComponentMask mask) {
+    QueryCache& query = m_queries[mask];
+    for (; query.scanned < m_archetypes.size(); query.scanned++) {
+        if ((m_archetypes[query.scanned]->mask & mask) == mask) {
+            query.archetypes.push_back(static_cast<uint32_t>(query.scanned));
+        }
+    }
+    return query.archetypes;
+}
+
+void EntityRegistry::AllocateRow(uint32_t archetypeIndex, uint32_t entityIndex, uint32_t& chunk, uint32_t& row) {
+    Archetype& archetype = *m_archetypes[archetypeIndex];
+    if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity) {
+        uint8_t* data;
+        if (archetype.chunkBytes == CHUNK_BYTES && !m_freeChunks.empty()) {
+            data = m_freeChunks.back();
+            m_freeChunks.pop_back();
+        } else {
+            data = static_cast<uint8_t*>(Platform::MemoryTracker::Allocate(archetype.chunkBytes,
+                                                                           Platform::MemoryTag::Entities,
+                                                                           CHUNK_ALIGNMENT));
+            if (!data) throw std::bad_alloc();
+        }
+        Platform::MemoryTagScope tag(Platform::MemoryTag::Entities);
+        archetype.chunks.push_back({ data, 0 });
+    }
+
+    chunk = static_cast<uint32_t>(archetype.chunks.size() - 1);
+    Chunk& target = archetype.chunks.back();
+    row = target.count++;
+    Entity* entities = reinterpret_cast<Entity*>(target.data);
+    entities[row] = { entityIndex, m_records[entityIndex].generation };
+}
+
+void EntityRegistry::RemoveRow(uint32_t archetypeIndex, uint32_t chunk, uint32_t row) {
+    Archetype& archetype = *m_archetypes[archetypeIndex];
+    const uint32_t lastChunk = static_cast<uint32_t>(archetype.chunks.size() - 1);
+    Chunk& last = archetype.chunks[lastChunk];
+    const uint32_t lastRow = last.count - 1;
+
+    if (chunk != lastChunk || row != lastRow) {
+        Chunk& hole = archetype.chunks[chunk];
+        Entity* holeEntities = reinterpret_cast<Entity*>(hole.data);
+        const Entity moved = reinterpret_cast<Entity*>(last.data)[lastRow];
+        holeEntities[row] = moved;
+        for (uint32_t id : archetype.components) {
+            const uint32_t size = GetComponentInfo(id).size;
+            std::memcpy(hole.data + archetype.offsets[id] + row * size,
+                        last.data + archetype.offsets[id] + lastRow * size, size);
+        }
+        m_records[moved.index].chunk = chunk;
+        m_records[moved.index].row = row;
+    }
+
+    if (--last.count == 0) {
+        if (archetype.chunkBytes == CHUNK_BYTES) {
+            m_freeChunks.push_back(last.data);
+        } else {
+            Platform::MemoryTracker::Free(last.data);
+        }
+        archetype.chunks.pop_back();
+    }
+}
+
+Entity EntityRegistry::CreateWithMask(ComponentMask mask) {
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_records.size());
+        m_records.push_back({ INVALID_INDEX, 0, 0, 0 });
+    }
+
+    EntityRecord& record = m_records[index];
+    record.archetype = GetArchetype(mask);
+    AllocateRow(record.archetype, index, record.chunk, record.row);
+    m_liveCount++;
+    return { index, record.generation };
+}
+
+void EntityRegistry::Destroy(Entity entity) {
+    if (!IsAlive(entity)) return;
+
+    EntityRecord& record = m_records[entity.index];
+    RemoveRow(record.archetype, record.chunk, record.row);
+    record.archetype = INVALID_INDEX;
+    record.generation++;
+    m_freeIndices.push_back(entity.index);
+    m_liveCount--;
+}
+
+bool EntityRegistry::IsAlive(Entity entity) const {
+    return entity.index < m_records.size() && m_records[entity.index].generation == entity.generation &&
+           m_records[entity.index].archetype != INVALID_INDEX;
+}
+
+void* EntityRegistry::GetComponentPointer(Entity entity, uint32_t component) const {
+    if (!IsAlive(entity)) return nullptr;
+
+    const EntityRecord& record = m_records[entity.index];
+    const Archetype& archetype = *m_archetypes[record.archetype];
+    if (!(archetype.mask & (ComponentMask(1) << component))) return nullptr;
+    return archetype.chunks[record.chunk].data + archetype.offsets[component] +
+           record.row * GetComponentInfo(component).size;
+}
+
+void EntityRegistry::MoveEntity(uint32_t entityIndex, uint32_t targetArchetype) {
+    EntityRecord& record = m_records[entityIndex];
+    const uint32_t sourceArchetype = record.archetype;
+    const uint32_t sourceChunk = record.chunk;
+    const uint32_t sourceRow = record.row;
+
+    uint32_t chunk, row;
+    AllocateRow(targetArchetype, entityIndex, chunk, row);
+
+    // Components present in both archetypes carry over; an added one is left for the caller to fill
+    const Archetype& source = *m_archetypes[sourceArchetype];
+    const Archetype& target = *m_archetypes[targetArchetype];
+    const uint8_t* from = source.chunks[sourceChunk].data;
+    uint8_t* to = target.chunks[chunk].data;
+    for (uint32_t id : source.components) {
+        if (target.mask & (ComponentMask(1) << id)) {
+            const uint32_t size = GetComponentInfo(id).size;
+            std::memcpy(to + target.offsets[id] + row * size, from + source.offsets[id] + sourceRow * size, size);
+        }
+    }
+
+    RemoveRow(sourceArchetype, sourceChunk, sourceRow);
+    record.archetype = targetArchetype;
+    record.chunk = chunk;
+    record.row = row;
+}
+
+void* EntityRegistry::AddComponent(Entity entity, uint32_t component) {
+    if (!IsAlive(entity)) return nullptr;
+
+    const uint32_t sourceArchetype = m_records[entity.index].archetype;
+    const ComponentMask mask = m_archetypes[sourceArchetype]->mask;
+    if (!(mask & (ComponentMask(1) << component))) {
+        uint32_t target = m_archetypes[sourceArchetype]->addEdges[component];
+        if (target == INVALID_INDEX) {
+            target = GetArchetype(mask | (ComponentMask(1) << component));
+            m_archetypes[sourceArchetype]->addEdges[component] = target;
+            m_archetypes[target]->removeEdges[component] = sourceArchetype;
+        }
+        MoveEntity(entity.index, target);
+    }
+    return GetComponentPointer(entity, component);
+}
+
+void EntityRegistry::RemoveComponent(Entity entity, uint32_t component) {
+    if (!IsAlive(entity)) return;
+
+    const uint32_t sourceArchetype = m_records[entity.index].archetype;
+    const ComponentMask mask = m_archetypes[sourceArchetype]->mask;
+    if (!(mask & (ComponentMask(1) << component))) return;
+
+    uint32_t target = m_archetypes[sourceArchetype]->removeEdges[component];
+    if (target == INVALID_INDEX) {
+        target = GetArchetype(mask & ~(ComponentMask(1) << component));
+        m_archetypes[sourceArchetype]->removeEdges[component] = target;
+        m_archetypes[target]->addEdges[component] = sourceArchetype;
+    }
+    MoveEntity(entity.index, target);
+}
+
+EntityCommands& EntityRegistry::GetCommands() {
+    const uint32_t thread = GetJobSystem().GetLocalThreadIndex();
+    if (thread != 0) {
+        return m_commands[thread];
+    }
+    const std::thread::id id = std::this_thread::get_id();
+    if (id == m_ownerThread) {
+        return m_commands[0];
+    }
+
+    // Workers of other job systems and other threads; the lock only guards the lookup
+    std::lock_guard<std::mutex> lock(m_otherCommandsMutex);
+    for (auto& entry : m_otherCommands) {
+        if (entry.first == id) return *entry.second;
+    }
+    m_otherCommands.emplace_back(id, std::make_unique<EntityCommands>());
+    return *m_otherCommands.back().second;
+}
+
+void EntityRegistry::FlushCommands() {
+    for (EntityCommands& commands : m_commands) {
+        PlayCommands(commands);
+    }
+    std::lock_guard<std::mutex> lock(m_otherCommandsMutex);
+    for (auto& entry : m_otherCommands) {
+        PlayCommands(*entry.second);
+    }
+}
+
+void EntityRegistry::PlayCommands(EntityCommands& commands) {
+    using Op = EntityCommands::Op;
+    using Header = EntityCommands::Header;
+
+    const uint8_t* cursor = commands.m_bytes.data();
+    const uint8_t* end = cursor + commands.m_bytes.size();
+    while (cursor < end) {
+        Header header;
+        std::memcpy(&header, cursor, sizeof(Header));
+        cursor += sizeof(Header);
+
+        switch (header.op) {
+        case Op::Destroy:
+            Destroy(header.entity);
+            break;
+        case Op::Add:
+            if (void* component = AddComponent(header.entity, header.component)) {
+                std::memcpy(component, cursor, header.size);
+            }
+            break;
+        case Op::Remove:
+            RemoveComponent(header.entity, header.component);
+            break;
+        case Op::Spawn: {
+            // The component records follow; gather the mask first so the entity is placed once
+            ComponentMask mask = 0;
+            const uint8_t* scan = cursor;
+            for (uint32_t i = 0; i < header.component; i++) {
+                Header component;
+                std::memcpy(&component, scan, sizeof(Header));
+                mask |= ComponentMask(1) << component.component;
+                scan += sizeof(Header) + component.size;
+            }
+            Entity entity = CreateWithMask(mask);
+            for (uint32_t i = 0; i < header.component; i++) {
+                Header component;
+                std::memcpy(&component, cursor, sizeof(Header));
+                std::memcpy(GetComponentPointer(entity, component.component), cursor + sizeof(Header),
+                            component.size);
+                cursor += sizeof(Header) + component.size;
+            }
+            break;
+        }
+        case Op::SpawnComponent:
+            break;
+        }
+        cursor += header.size;
+    }
+    commands.Clear();
+}
+
+size_t EntityRegistry::GetChunkCount() const {
+    size_t count = 0;
+    for (const std::unique_ptr<Archetype>& archetype : m_archetypes) {
+        count += archetype->chunks.size();
+    }
+    return count;
+}
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,155 @@
+#include "game/FallingBlocks.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+
+namespace SwordAndStone {
+namespace Game {
+
+namespace {
+
+// Cells pack into one key with y in the high bits, so sorting the keys orders cells bottom-up
+constexpr int KEY_BITS = 21;
+constexpr int64_t KEY_BIAS = 1 << (KEY_BITS - 1);
+constexpr uint64_t KEY_MASK = (1ull << KEY_BITS) - 1;
+
+uint64_t PackCell(int x, int y, int z) {
+    return (static_cast<uint64_t>(y + KEY_BIAS) & KEY_MASK) << (2 * KEY_BITS) |
+           (static_cast<uint64_t>(x + KEY_BIAS) & KEY_MASK) << KEY_BITS |
+           (static_cast<uint64_t>(z + KEY_BIAS) & KEY_MASK);
+}
+
+void UnpackCell(uint64_t key, int& x, int& y, int& z) {
+    y = static_cast<int>(static_cast<int64_t>((key >> (2 * KEY_BITS)) & KEY_MASK) - KEY_BIAS);
+    x = static_cast<int>(static_cast<int64_t>((key >> KEY_BITS) & KEY_MASK) - KEY_BIAS);
+    z = static_cast<int>(static_cast<int64_t>(key & KEY_MASK) - KEY_BIAS);
+}
+
+} // namespace
+
+FallingBlockSimulation::FallingBlockSimulation()
+    : m_accumulator(0.0f)
+    , m_focus{ 0.0f, 0.0f, 0.0f }
+    , m_focusRadius(0.0f)
+    , m_escalationsThisTick(0)
+{
+}
+
+void FallingBlockSimulation::Wake(int x, int y, int z) {
+    m_active.push_back(PackCell(x, y, z));
+    m_active.push_back(PackCell(x, y + 1, z));
+}
+
+void FallingBlockSimulation::OnChunkLoaded(const ChunkCoord& coord) {
+    auto it = m_waiting.find(coord);
+    if (it == m_waiting.end()) return;
+    m_active.insert(m_active.end(), it->second.begin(), it->second.end());
+    m_waiting.erase(it);
+}
+
+size_t FallingBlockSimulation::GetWaitingCount() const {
+    size_t count = 0;
+    for (const auto& entry : m_waiting) {
+        count += entry.second.size();
+    }
+    return count;
+}
+
+void FallingBlockSimulation::Clear() {
+    m_active.clear();
+    m_next.clear();
+    m_waiting.clear();
+    m_escalated.clear();
+    m_accumulator = 0.0f;
+    m_stats = FallingBlockStats();
+}
+
+void FallingBlockSimulation::Update(VoxelSystem& voxels, float deltaTime) {
+    m_escalated.clear();
+    m_stats.ticks = 0;
+    m_stats.moved = 0;
+    m_stats.escalated = 0;
+
+    const float interval = 1.0f / TICK_RATE;
+    m_accumulator += deltaTime;
+    while (m_accumulator >= interval && m_stats.ticks < MAX_TICKS_PER_UPDATE) {
+        m_accumulator -= interval;
+        m_stats.moved += Tick(voxels);
+        m_stats.ticks++;
+    }
+    // After a hitch, fall behind rather than spending ever longer catching up
+    if (m_accumulator >= interval) m_accumulator = 0.0f;
+
+    m_stats.escalated = static_cast<uint32_t>(m_escalated.size());
+    m_stats.active = m_active.size();
+    m_stats.waiting = GetWaitingCount();
+}
+
+uint32_t FallingBlockSimulation::Tick(VoxelSystem& voxels) {
+    PROFILE_ZONE("FallingBlockSimulation::Tick");
+
+    std::sort(m_active.begin(), m_active.end());
+    m_active.erase(std::unique(m_active.begin(), m_active.end()), m_active.end());
+    m_next.clear();
+    m_escalationsThisTick = 0;
+
+    uint32_t moved = 0;
+    for (uint64_t key : m_active) {
+        int x, y, z;
+        UnpackCell(key, x, y, z);
+        const VoxelType type = voxels.GetVoxel(x, y, z);
+        if (!FallsUnderGravity(type)) continue;
+
+        // Terrain that has not loaded yet holds blocks up until it does
+        const ChunkCoord support = VoxelSystem::WorldToChunk(x, y - 1, z);
+        if (!voxels.GetChunk(support)) {
+            std::vector<uint64_t>& waiting = m_waiting[support];
+            if (std::find(waiting.begin(), waiting.end(), key) == waiting.end()) waiting.push_back(key);
+            continue;
+        }
+        const VoxelType below = voxels.GetVoxel(x, y - 1, z);
+        if (IsSolid(below)) continue;
+
+        if (ShouldEscalate(voxels, x, y, z)) {
+            voxels.SetVoxel(x, y, z, VoxelType::Air);
+            m_escalated.push_back({ { x, y, z }, type });
+            m_escalationsThisTick++;
+        } else {
+            // Swapping with the cell below lets blocks sink through water, pushing it up
+            voxels.SetVoxel(x, y - 1, z, type);
+            voxels.SetVoxel(x, y, z, below);
+            m_next.push_back(PackCell(x, y - 1, z));
+            moved++;
+        }
+        // The block above may have been resting on this one
+        m_next.push_back(PackCell(x, y + 1, z));
+    }
+
+    m_active.swap(m_next);
+    m_next.clear();
+    return moved;
+}
+
+void FallingBlockSimulation::SetFocus(const float position[3], float radius) {
+    m_focus[0] = position[0];
+    m_focus[1] = position[1];
+    m_focus[2] = position[2];
+    m_focusRadius = radius;
+}
+
+bool FallingBlockSimulation::ShouldEscalate(const VoxelSystem& voxels, int x, int y, int z) const {
+    if (m_focusRadius <= 0.0f || m_escalationsThisTick >= MAX_ESCALATIONS_PER_TICK) return false;
+
+    const float dx = x + 0.5f - m_focus[0];
+    const float dy = y + 0.5f - m_focus[1];
+    const float dz = z + 0.5f - m_focus[2];
+    if (dx * dx + dy * dy + dz * dz > m_focusRadius * m_focusRadius) return false;
+
+    // A one or two block drop looks the same either way; only long falls are worth a body
+    for (int drop = 1; drop <= ESCALATE_MIN_DROP; drop++) {
+        if (IsSolid(voxels.GetVoxel(x, y - drop, z))) return false;
+    }
+    return true;
+}
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,346 @@
+#include "game/FluidSimulation.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+
+namespace SwordAndStone {
+namespace Game {
+
+namespace {
+
+// Offsets to the neighbouring chunk (or voxel) across each ChunkFace
+constexpr int FACE_OFFSETS[CHUNK_FACE_COUNT][3] = {
+    { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 }
+};
+
+constexpr ChunkFace SIDE_FACES[4] = { ChunkFace::NegX, ChunkFace::PosX, ChunkFace::NegZ, ChunkFace::PosZ };
+
+// Cell index steps along each axis, matching Chunk::Index
+constexpr int STEP_X = 1;
+constexpr int STEP_Z = CHUNK_SIZE;
+constexpr int STEP_Y = CHUNK_SIZE * CHUNK_SIZE;
+
+int Parity(const ChunkCoord& coord) {
+    return (coord.x & 1) | (coord.y & 1) << 1 | (coord.z & 1) << 2;
+}
+
+} // namespace
+
+FluidSimulation::FluidSimulation(Platform::JobSystem* jobSystem)
+    : m_jobSystem(jobSystem)
+    , m_accumulator(0.0f)
+{
+}
+
+FluidSimulation::~FluidSimulation() {
+}
+
+FluidSimulation::FluidChunk* FluidSimulation::FindChunk(const ChunkCoord& coord) const {
+    auto it = m_chunks.find(coord);
+    return it != m_chunks.end() ? it->second.get() : nullptr;
+}
+
+FluidSimulation::FluidChunk* FluidSimulation::GetOrCreateChunk(const VoxelSystem& voxels, const ChunkCoord& coord) {
+    if (FluidChunk* existing = FindChunk(coord)) return existing;
+    const Chunk* voxelChunk = voxels.GetChunk(coord);
+    if (!voxelChunk) return nullptr;
+
+    std::unique_ptr<FluidChunk> chunk(new FluidChunk());
+    chunk->coord = coord;
+    chunk->updated = 0;
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                const VoxelType type = voxelChunk->Get(x, y, z);
+                chunk->cells[Chunk::Index(x, y, z)] = IsSolid(type) ? SOLID : (type == VoxelType::Water ? SOURCE : 0);
+            }
+        }
+    }
+    // Water that was flowing when the chunk unloaded picks up where it left off
+    auto saved = m_unloaded.find(coord);
+    if (saved != m_unloaded.end()) {
+        for (const SavedCell& cell : saved->second) {
+            if (chunk->cells[cell.index] != SOURCE) continue;
+            chunk->cells[cell.index] = cell.level;
+            Queue({ chunk.get(), cell.index });
+        }
+        m_unloaded.erase(saved);
+    }
+    for (int face = 0; face < CHUNK_FACE_COUNT; face++) {
+        const ChunkCoord neighborCoord = { coord.x + FACE_OFFSETS[face][0], coord.y + FACE_OFFSETS[face][1],
+                                           coord.z + FACE_OFFSETS[face][2] };
+        FluidChunk* neighbor = FindChunk(neighborCoord);
+        chunk->neighbors[face] = neighbor;
+        if (neighbor) neighbor->neighbors[face ^ 1] = chunk.get();
+    }
+
+    FluidChunk* result = chunk.get();
+    m_chunks.emplace(coord, std::move(chunk));
+    return result;
+}
+
+FluidSimulation::CellRef FluidSimulation::GetCell(const VoxelSystem& voxels, int x, int y, int z, bool create) {
+    const ChunkCoord coord = VoxelSystem::WorldToChunk(x, y, z);
+    FluidChunk* chunk = create ? GetOrCreateChunk(voxels, coord) : FindChunk(coord);
+    const int index = Chunk::Index(x - coord.x * CHUNK_SIZE, y - coord.y * CHUNK_SIZE, z - coord.z * CHUNK_SIZE);
+    return { chunk, static_cast<uint16_t>(index) };
+}
+
+FluidSimulation::CellRef FluidSimulation::Neighbor(FluidChunk& chunk, uint16_t index, ChunkFace face) {
+    const int x = index & (CHUNK_SIZE - 1);
+    const int z = (index / STEP_Z) & (CHUNK_SIZE - 1);
+    const int y = index / STEP_Y;
+    const int last = CHUNK_SIZE - 1;
+
+    int step = 0;
+    bool inside = false;
+    switch (face) {
+    case ChunkFace::NegX: inside = x > 0;    step = inside ? -STEP_X : last * STEP_X; break;
+    case ChunkFace::PosX: inside = x < last; step = inside ? STEP_X : -last * STEP_X; break;
+    case ChunkFace::NegY: inside = y > 0;    step = inside ? -STEP_Y : last * STEP_Y; break;
+    case ChunkFace::PosY: inside = y < last; step = inside ? STEP_Y : -last * STEP_Y; break;
+    case ChunkFace::NegZ: inside = z > 0;    step = inside ? -STEP_Z : last * STEP_Z; break;
+    case ChunkFace::PosZ: inside = z < last; step = inside ? STEP_Z : -last * STEP_Z; break;
+    }
+    FluidChunk* target = inside ? &chunk : chunk.neighbors[static_cast<int>(face)];
+    return { target, static_cast<uint16_t>(index + step) };
+}
+
+void FluidSimulation::Queue(const CellRef& cell) {
+    FluidChunk& chunk = *cell.chunk;
+    if (chunk.queued[cell.index]) return;
+    chunk.queued.set(cell.index);
+    if (chunk.next.empty()) m_pending.push_back(&chunk);
+    chunk.next.push_back(cell.index);
+}
+
+void FluidSimulation::QueueWithNeighbors(const VoxelSystem& voxels, int x, int y, int z) {
+    const CellRef cell = GetCell(voxels, x, y, z, false);
+    if (cell.chunk) Queue(cell);
+    for (int face = 0; face < CHUNK_FACE_COUNT; face++) {
+        const int nx = x + FACE_OFFSETS[face][0];
+        const int ny = y + FACE_OFFSETS[face][1];
+        const int nz = z + FACE_OFFSETS[face][2];
+        // Water that has never moved has no level layer yet; give it one so it can flow
+        const CellRef neighbor = GetCell(voxels, nx, ny, nz, voxels.GetVoxel(nx, ny, nz) == VoxelType::Water);
+        if (neighbor.chunk) Queue(neighbor);
+    }
+}
+
+void FluidSimulation::Wake(const VoxelSystem& voxels, int x, int y, int z) {
+    const VoxelType type = voxels.GetVoxel(x, y, z);
+    const CellRef cell = GetCell(voxels, x, y, z, type == VoxelType::Water);
+    if (cell.chunk) {
+        uint8_t& value = cell.chunk->cells[cell.index];
+        if (IsSolid(type)) {
+            value = SOLID;
+        } else if (type == VoxelType::Water) {
+            // Water placed by something other than the simulation is a source
+            if (value == 0 || value == SOLID) value = SOURCE;
+        } else {
+            value = 0;
+        }
+    }
+    QueueWithNeighbors(voxels, x, y, z);
+}
+
+void FluidSimulation::SetWater(VoxelSystem& voxels, int x, int y, int z, uint8_t level, bool source) {
+    const bool wet = source || level > 0;
+    voxels.SetVoxel(x, y, z, wet ? VoxelType::Water : VoxelType::Air);
+    const CellRef cell = GetCell(voxels, x, y, z, wet);
+    if (cell.chunk) {
+        cell.chunk->cells[cell.index] = source ? SOURCE : std::min(level, MAX_LEVEL);
+    }
+    QueueWithNeighbors(voxels, x, y, z);
+}
+
+uint8_t FluidSimulation::GetLevel(const VoxelSystem& voxels, int x, int y, int z) const {
+    const ChunkCoord coord = VoxelSystem::WorldToChunk(x, y, z);
+    const FluidChunk* chunk = FindChunk(coord);
+    if (!chunk) return voxels.GetVoxel(x, y, z) == VoxelType::Water ? MAX_LEVEL : 0;
+
+    const uint8_t value =
+        chunk->cells[Chunk::Index(x - coord.x * CHUNK_SIZE, y - coord.y * CHUNK_SIZE, z - coord.z * CHUNK_SIZE)];
+    return value == SOURCE ? MAX_LEVEL : (value == SOLID ? 0 : value);
+}
+
+void FluidSimulation::RemoveChunk(const ChunkCoord& coord) {
+    auto it = m_chunks.find(coord);
+    if (it == m_chunks.end()) return;
+
+    FluidChunk* chunk = it->second.get();
+    std::vector<SavedCell> flowing;
+    for (int index = 0; index < CHUNK_VOLUME; index++) {
+        const uint8_t value = chunk->cells[index];
+        if (value > 0 && value <= MAX_LEVEL) flowing.push_back({ static_cast<uint16_t>(index), value });
+    }
+    if (!flowing.empty()) m_unloaded[coord] = std::move(flowing);
+
+    for (int face = 0; face < CHUNK_FACE_COUNT; face++) {
+        if (chunk->neighbors[face]) chunk->neighbors[face]->neighbors[face ^ 1] = nullptr;
+    }
+    m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), chunk), m_pending.end());
+    m_chunks.erase(it);
+}
+
+void FluidSimulation::Clear() {
+    m_chunks.clear();
+    m_unloaded.clear();
+    m_pending.clear();
+    m_awake.clear();
+    m_accumulator = 0.0f;
+    m_stats = FluidStats();
+}
+
+void FluidSimulation::Update(VoxelSystem& voxels, float deltaTime) {
+    m_stats.ticks = 0;
+    m_stats.updatedCells = 0;
+    m_stats.changedVoxels = 0;
+
+    const float interval = 1.0f / TICK_RATE;
+    m_accumulator += deltaTime;
+    while (m_accumulator >= interval && m_stats.ticks < MAX_TICKS_PER_UPDATE) {
+        m_accumulator -= interval;
+        m_stats.updatedCells += Tick(voxels);
+        m_stats.ticks++;
+    }
+    // After a hitch, fall behind rather than spending ever longer catching up
+    if (m_accumulator >= interval) m_accumulator = 0.0f;
+
+    m_stats.awakeChunks = m_pending.size();
+    m_stats.chunks = m_chunks.size();
+    m_stats.unloadedChunks = m_unloaded.size();
+}
+
+uint32_t FluidSimulation::Tick(VoxelSystem& voxels) {
+    PROFILE_ZONE("FluidSimulation::Tick");
+
+    // Queued cells become this tick's active set
+    m_awake.swap(m_pending);
+    m_pending.clear();
+    for (FluidChunk* chunk : m_awake) {
+        chunk->active.swap(chunk->next);
+        chunk->next.clear();
+        for (uint16_t index : chunk->active) {
+            chunk->queued.reset(index);
+        }
+    }
+
+    // Flow can cross into any loaded neighbour, so give those a level layer before the passes;
+    // no chunk is created while they run
+    for (size_t i = 0; i < m_awake.size(); i++) {
+        FluidChunk* chunk = m_awake[i];
+        for (int face = 0; face < CHUNK_FACE_COUNT; face++) {
+            if (chunk->neighbors[face]) continue;
+            GetOrCreateChunk(voxels, { chunk->coord.x + FACE_OFFSETS[face][0], chunk->coord.y + FACE_OFFSETS[face][1],
+                                       chunk->coord.z + FACE_OFFSETS[face][2] });
+        }
+    }
+
+    for (std::vector<FluidChunk*>& pass : m_passes) {
+        pass.clear();
+    }
+    for (FluidChunk* chunk : m_awake) {
+        m_passes[Parity(chunk->coord)].push_back(chunk);
+    }
+    Platform::JobSystem& jobs = m_jobSystem ? *m_jobSystem : Platform::JobSystem::GetDefault();
+    for (std::vector<FluidChunk*>& pass : m_passes) {
+        if (pass.empty()) continue;
+        jobs.ParallelFor(static_cast<uint32_t>(pass.size()), 1, [this, &pass](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                FlowChunk(*pass[i]);
+            }
+        });
+    }
+
+    // Apply what the passes recorded, in chunk order so the result is the same on any thread count
+    uint32_t updated = 0;
+    for (FluidChunk* chunk : m_awake) {
+        updated += chunk->updated;
+        for (const CellRef& change : chunk->changes) {
+            const FluidChunk& target = *change.chunk;
+            const int x = target.coord.x * CHUNK_SIZE + (change.index & (CHUNK_SIZE - 1));
+            const int y = target.coord.y * CHUNK_SIZE + change.index / STEP_Y;
+            const int z = target.coord.z * CHUNK_SIZE + ((change.index / STEP_Z) & (CHUNK_SIZE - 1));
+            const uint8_t value = target.cells[change.index];
+            const VoxelType type = (value != 0 && value != SOLID) ? VoxelType::Water : VoxelType::Air;
+            const VoxelType current = voxels.GetVoxel(x, y, z);
+            if (current != type && !IsSolid(current)) {
+                voxels.SetVoxel(x, y, z, type);
+                m_stats.changedVoxels++;
+            }
+        }
+        for (const CellRef& wake : chunk->wakes) {
+            Queue(wake);
+        }
+        chunk->changes.clear();
+        chunk->wakes.clear();
+        chunk->active.clear();
+    }
+    m_awake.clear();
+    return updated;
+}
+
+void FluidSimulation::FlowChunk(FluidChunk& chunk) {
+    // Bottom-up, so a falling column moves together
+    std::sort(chunk.active.begin(), chunk.active.end());
+    chunk.updated = static_cast<uint32_t>(chunk.active.size());
+
+    for (uint16_t index : chunk.active) {
+        uint8_t& cell = chunk.cells[index];
+        if (cell == 0 || cell == SOLID) continue;
+        const bool source = cell == SOURCE;
+        uint8_t amount = source ? MAX_LEVEL : cell;
+        bool changed = false;
+
+        // Down first, as much as fits; unloaded terrain below holds the water up
+        bool resting = true;
+        const CellRef below = Neighbor(chunk, index, ChunkFace::NegY);
+        if (below.chunk) {
+            uint8_t& target = below.chunk->cells[below.index];
+            if (target < MAX_LEVEL) {
+                const uint8_t poured = std::min<uint8_t>(amount, MAX_LEVEL - target);
+                if (target == 0) chunk.changes.push_back(below);
+                target += poured;
+                if (!source) amount -= poured;
+                chunk.wakes.push_back(below);
+                changed = true;
+            }
+            resting = target >= MAX_LEVEL;
+        }
+
+        // Then sideways over solid ground or full water, one unit to each side at least two lower
+        if (resting) {
+            for (ChunkFace face : SIDE_FACES) {
+                if (amount < 2) break;
+                const CellRef side = Neighbor(chunk, index, face);
+                if (!side.chunk) continue;
+                uint8_t& target = side.chunk->cells[side.index];
+                if (target >= MAX_LEVEL || amount - target < 2) continue;
+                if (target == 0) chunk.changes.push_back(side);
+                target++;
+                if (!source) amount--;
+                chunk.wakes.push_back(side);
+                changed = true;
+            }
+        }
+
+        // A cell that moved nothing has settled and drops out of the active set
+        if (!changed) continue;
+        if (!source) {
+            cell = amount;
+            if (amount == 0) chunk.changes.push_back({ &chunk, index });
+        }
+
+        // It may move more next tick, and the cells above and beside may now flow into it
+        chunk.wakes.push_back({ &chunk, index });
+        const CellRef above = Neighbor(chunk, index, ChunkFace::PosY);
+        if (above.chunk) chunk.wakes.push_back(above);
+        for (ChunkFace face : SIDE_FACES) {
+            const CellRef side = Neighbor(chunk, index, face);
+            if (side.chunk) chunk.wakes.push_back(side);
+        }
+    }
+}
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -1,9 +1,20 @@
 #include "game/GameWorld.h"
+#include "game/EntityComponents.h"
+#include "platform/Profiler.h"
 
 namespace SwordAndStone {
 namespace Game {
 
-GameWorld::GameWorld() {
+namespace {
+
+// Chunks handed to each job; a chunk of Position + Velocity holds a few hundred entities
+constexpr uint32_t CHUNKS_PER_JOB = 4;
+
+} // namespace
+
+GameWorld::GameWorld(Platform::JobSystem* jobSystem)
+    : m_entities(jobSystem)
+{
 }
 
 GameWorld::~GameWorld() {
@@ -14,7 +25,38 @@ void GameWorld::Initialize() {
 }
 
 void GameWorld::Update(float deltaTime) {
-    // TODO: Update world
+    PROFILE_ZONE("GameWorld::Update");
+
+    m_entities.ParallelForEachChunk<Velocity, Gravity>(
+        [deltaTime](uint32_t count, const Entity*, Velocity* velocities, Gravity* gravities) {
+        for (uint32_t i = 0; i < count; i++) {
+            velocities[i].y -= gravities[i].acceleration * deltaTime;
+        }
+    }, CHUNKS_PER_JOB);
+
+    m_entities.ParallelForEachChunk<Position, Velocity>(
+        [deltaTime](uint32_t count, const Entity*, Position* positions, Velocity* velocities) {
+        for (uint32_t i = 0; i < count; i++) {
+            positions[i].x += velocities[i].x * deltaTime;
+            positions[i].y += velocities[i].y * deltaTime;
+            positions[i].z += velocities[i].z * deltaTime;
+        }
+    }, CHUNKS_PER_JOB);
+
+    m_entities.ParallelForEachChunk<Lifetime>(
+        [this, deltaTime](uint32_t count, const Entity* entities, Lifetime* lifetimes) {
+        EntityCommands* commands = nullptr;
+        for (uint32_t i = 0; i < count; i++) {
+            lifetimes[i].remaining -= deltaTime;
+            if (lifetimes[i].remaining <= 0.0f) {
+                if (!commands) commands = &m_entities.GetCommands();
+                commands->Destroy(entities[i]);
+            }
+        }
+    }, CHUNKS_PER_JOB);
+
+    m_entities.FlushCommands();
+    m_spatialGrid.Sync(m_entities);
 }
 
 void GameWorld::Render() {
@@ -0,0 +1,130 @@
+#include "game/InstanceBatcher.h"
+#include "platform/MemoryTracker.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace SwordAndStone {
+namespace Game {
+
+using namespace Renderer;
+
+InstanceBatcher::InstanceBatcher()
+    : m_totalInstances(0)
+{
+}
+
+uint32_t InstanceBatcher::RegisterMesh(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                                       uint32_t shader, uint32_t texture, uint8_t state, uint32_t pass) {
+    MeshBatch batch;
+    batch.vertexBuffer = vertexBuffer;
+    batch.indexBuffer = indexBuffer;
+    batch.indexCount = indexCount;
+    batch.shader = shader;
+    batch.texture = texture;
+    batch.state = state;
+    batch.pass = pass;
+    m_meshes.push_back(std::move(batch));
+    return static_cast<uint32_t>(m_meshes.size() - 1);
+}
+
+void InstanceBatcher::Begin() {
+    // Keep each mesh's capacity so steady-state frames do not allocate
+    for (MeshBatch& batch : m_meshes) {
+        batch.instances.clear();
+    }
+    m_totalInstances = 0;
+}
+
+void InstanceBatcher::Add(uint32_t mesh, const InstanceData& instance) {
+    if (mesh >= m_meshes.size()) return;
+    m_meshes[mesh].instances.push_back(instance);
+    m_totalInstances++;
+}
+
+void InstanceBatcher::Add(uint32_t mesh, const float position[3], float yaw, float scale, const float* color) {
+    if (mesh >= m_meshes.size()) return;
+
+    float c = std::cos(yaw) * scale;
+    float s = std::sin(yaw) * scale;
+    InstanceData instance = {
+        {  c,     0.0f,  s,    position[0],
+           0.0f,  scale, 0.0f, position[1],
+          -s,     0.0f,  c,    position[2] },
+        { 1.0f, 1.0f, 1.0f, 1.0f }
+    };
+    if (color) {
+        memcpy(instance.color, color, sizeof(instance.color));
+    }
+    m_meshes[mesh].instances.push_back(instance);
+    m_totalInstances++;
+}
+
+uint32_t InstanceBatcher::Flush(IRenderer& renderer, CommandBuffer& commands) {
+    PROFILE_ZONE("InstanceBatcher::Flush");
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Meshes);
+    uint32_t draws = 0;
+    for (MeshBatch& batch : m_meshes) {
+        if (batch.instances.empty()) continue;
+
+        const uint32_t count = static_cast<uint32_t>(batch.instances.size());
+        const size_t size = batch.instances.size() * sizeof(InstanceData);
+
+        uint32_t instanceBuffer = 0;
+        size_t instanceOffset = 0;
+        StreamingAllocation allocation = renderer.AllocateStreaming(size, sizeof(InstanceData));
+        if (allocation) {
+            memcpy(allocation.data, batch.instances.data(), size);
+            instanceBuffer = allocation.buffer;
+            instanceOffset = allocation.offset;
+        } else if (UploadFallback(renderer, batch, size)) {
+            instanceBuffer = batch.fallbackBuffer;
+        } else {
+            continue;
+        }
+
+        uint64_t key = SortKey::Make(batch.pass, batch.shader, batch.texture, 0);
+        commands.DrawIndexedInstanced(key, batch.shader, batch.texture, batch.vertexBuffer, batch.indexBuffer,
+                                      batch.indexCount, instanceBuffer, static_cast<uint32_t>(instanceOffset),
+                                      count, batch.state);
+        draws++;
+    }
+    return draws;
+}
+
+void InstanceBatcher::Release(IRenderer& renderer) {
+    for (MeshBatch& batch : m_meshes) {
+        if (batch.fallbackBuffer) {
+            renderer.DeleteBuffer(batch.fallbackBuffer);
+            batch.fallbackBuffer = 0;
+            batch.fallbackCapacity = 0;
+        }
+    }
+}
+
+uint32_t InstanceBatcher::GetInstanceCount(uint32_t mesh) const {
+    return mesh < m_meshes.size() ? static_cast<uint32_t>(m_meshes[mesh].instances.size()) : 0;
+}
+
+bool InstanceBatcher::UploadFallback(IRenderer& renderer, MeshBatch& batch, size_t size) {
+    if (batch.fallbackBuffer && batch.fallbackCapacity >= size) {
+        renderer.UpdateVertexBuffer(batch.fallbackBuffer, batch.instances.data(), size, 0);
+        return true;
+    }
+
+    // Grow geometrically so a slowly rising instance count does not recreate the buffer every frame
+    if (batch.fallbackBuffer) {
+        renderer.DeleteBuffer(batch.fallbackBuffer);
+    }
+    size_t capacity = std::max(size, batch.fallbackCapacity * 2);
+    batch.fallbackBuffer = renderer.CreateVertexBuffer(nullptr, capacity, BufferUsage::Dynamic);
+    batch.fallbackCapacity = batch.fallbackBuffer ? capacity : 0;
+    if (!batch.fallbackBuffer) return false;
+
+    renderer.UpdateVertexBuffer(batch.fallbackBuffer, batch.instances.data(), size, 0);
+    return true;
+}
+
+} // namespace Game
+} // namespace SwordAndStone
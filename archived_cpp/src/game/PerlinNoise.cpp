@@ -0,0 +1,183 @@
+#include "game/PerlinNoise.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define NOISE_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace SwordAndStone {
+namespace Game {
+
+namespace {
+
+// Eight gradient directions, indexed by the low three bits of a lattice hash
+const float GRADIENT_X[8] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 0.0f };
+const float GRADIENT_Y[8] = { 1.0f, 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 1.0f, -1.0f };
+
+// Octaves are shifted apart so they do not all share a lattice point at the origin
+constexpr float OCTAVE_OFFSET = 57.31f;
+
+inline float Fade(float t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+inline float Lerp(float a, float b, float t) {
+    return a + t * (b - a);
+}
+
+} // namespace
+
+PerlinNoise::PerlinNoise(int seed, float frequency, int octaves, float lacunarity, float gain)
+    : m_frequency(frequency)
+    , m_octaves(std::max(1, octaves))
+    , m_lacunarity(lacunarity)
+    , m_gain(gain)
+{
+    // Fisher-Yates shuffle driven by an LCG, duplicated so lookups never wrap
+    uint8_t values[256];
+    for (int i = 0; i < 256; i++) values[i] = static_cast<uint8_t>(i);
+    uint32_t state = static_cast<uint32_t>(seed) * 747796405u + 2891336453u;
+    for (int i = 255; i > 0; i--) {
+        state = state * 1664525u + 1013904223u;
+        int j = static_cast<int>((state >> 8) % static_cast<uint32_t>(i + 1));
+        std::swap(values[i], values[j]);
+    }
+    for (int i = 0; i < 512; i++) {
+        m_permutation[i] = values[i & 255];
+    }
+
+    float amplitude = 1.0f;
+    float total = 0.0f;
+    for (int octave = 0; octave < m_octaves; octave++) {
+        total += amplitude;
+        amplitude *= m_gain;
+    }
+    m_amplitudeScale = 1.0f / total;
+}
+
+float PerlinNoise::SingleOctave(float x, float y) const {
+    const float xFloor = std::floor(x);
+    const float yFloor = std::floor(y);
+    const int xi = static_cast<int>(xFloor) & 255;
+    const int yi = static_cast<int>(yFloor) & 255;
+    const float xf = x - xFloor;
+    const float yf = y - yFloor;
+
+    const uint8_t* p = m_permutation;
+    const int aa = p[p[xi] + yi] & 7;
+    const int ab = p[p[xi] + yi + 1] & 7;
+    const int ba = p[p[xi + 1] + yi] & 7;
+    const int bb = p[p[xi + 1] + yi + 1] & 7;
+
+    const float u = Fade(xf);
+    const float v = Fade(yf);
+    const float x0 = Lerp(GRADIENT_X[aa] * xf + GRADIENT_Y[aa] * yf,
+                          GRADIENT_X[ba] * (xf - 1.0f) + GRADIENT_Y[ba] * yf, u);
+    const float x1 = Lerp(GRADIENT_X[ab] * xf + GRADIENT_Y[ab] * (yf - 1.0f),
+                          GRADIENT_X[bb] * (xf - 1.0f) + GRADIENT_Y[bb] * (yf - 1.0f), u);
+    return Lerp(x0, x1, v);
+}
+
+float PerlinNoise::Sample(float x, float y) const {
+    float sum = 0.0f;
+    float frequency = m_frequency;
+    float amplitude = 1.0f;
+    for (int octave = 0; octave < m_octaves; octave++) {
+        const float offset = OCTAVE_OFFSET * static_cast<float>(octave);
+        sum += SingleOctave(x * frequency + offset, y * frequency + offset) * amplitude;
+        frequency *= m_lacunarity;
+        amplitude *= m_gain;
+    }
+    return sum * m_amplitudeScale;
+}
+
+void PerlinNoise::SampleGrid(float x, float y, int width, int height, float* out) const {
+    for (int row = 0; row < height; row++) {
+        float* line = out + static_cast<size_t>(row) * width;
+        std::fill(line, line + width, 0.0f);
+
+        float frequency = m_frequency;
+        float amplitude = 1.0f;
+        for (int octave = 0; octave < m_octaves; octave++) {
+            AccumulateRow(x, y + static_cast<float>(row), octave, frequency, amplitude, width, line);
+            frequency *= m_lacunarity;
+            amplitude *= m_gain;
+        }
+        for (int column = 0; column < width; column++) {
+            line[column] *= m_amplitudeScale;
+        }
+    }
+}
+
+void PerlinNoise::AccumulateRow(float x, float y, int octave, float frequency, float amplitude, int width,
+                                float* out) const {
+    const float offset = OCTAVE_OFFSET * static_cast<float>(octave);
+    int column = 0;
+
+#ifdef NOISE_SSE
+    // The row's y lattice terms are shared by every lane; x is evaluated four samples at a time
+    const float sampleY = y * frequency + offset;
+    const float yFloor = std::floor(sampleY);
+    const int yi = static_cast<int>(yFloor) & 255;
+    const __m128 yf = _mm_set1_ps(sampleY - yFloor);
+    const __m128 yf1 = _mm_sub_ps(yf, _mm_set1_ps(1.0f));
+    const float vScalar = Fade(sampleY - yFloor);
+    const __m128 v = _mm_set1_ps(vScalar);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 six = _mm_set1_ps(6.0f);
+    const __m128 fifteen = _mm_set1_ps(15.0f);
+    const __m128 ten = _mm_set1_ps(10.0f);
+    const __m128 lanes = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    const __m128 frequencies = _mm_set1_ps(frequency);
+    const __m128 offsets = _mm_set1_ps(offset);
+    const __m128 amplitudes = _mm_set1_ps(amplitude);
+    const uint8_t* p = m_permutation;
+
+    for (; column + 4 <= width; column += 4) {
+        __m128 columns = _mm_add_ps(_mm_set1_ps(x), _mm_add_ps(_mm_set1_ps(static_cast<float>(column)), lanes));
+        __m128 sampleX = _mm_add_ps(_mm_mul_ps(columns, frequencies), offsets);
+
+        // floor() from truncation, corrected for negative inputs
+        __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(sampleX));
+        __m128 xFloor = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, sampleX), one));
+        __m128 xf = _mm_sub_ps(sampleX, xFloor);
+        __m128 xf1 = _mm_sub_ps(xf, one);
+
+        alignas(16) int32_t cells[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(cells), _mm_cvttps_epi32(xFloor));
+        alignas(16) float gradients[8][4];  // x and y components of the aa, ab, ba, bb corners
+        for (int lane = 0; lane < 4; lane++) {
+            const int xi = cells[lane] & 255;
+            const int corners[4] = { p[p[xi] + yi] & 7, p[p[xi] + yi + 1] & 7,
+                                     p[p[xi + 1] + yi] & 7, p[p[xi + 1] + yi + 1] & 7 };
+            for (int corner = 0; corner < 4; corner++) {
+                gradients[corner * 2][lane] = GRADIENT_X[corners[corner]];
+                gradients[corner * 2 + 1][lane] = GRADIENT_Y[corners[corner]];
+            }
+        }
+
+        __m128 aa = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gradients[0]), xf), _mm_mul_ps(_mm_load_ps(gradients[1]), yf));
+        __m128 ab = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gradients[2]), xf), _mm_mul_ps(_mm_load_ps(gradients[3]), yf1));
+        __m128 ba = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gradients[4]), xf1), _mm_mul_ps(_mm_load_ps(gradients[5]), yf));
+        __m128 bb = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gradients[6]), xf1), _mm_mul_ps(_mm_load_ps(gradients[7]), yf1));
+
+        // Fade(t) = t^3 (t (6t - 15) + 10)
+        __m128 u = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(xf, xf), xf),
+                              _mm_add_ps(_mm_mul_ps(xf, _mm_sub_ps(_mm_mul_ps(xf, six), fifteen)), ten));
+        __m128 x0 = _mm_add_ps(aa, _mm_mul_ps(u, _mm_sub_ps(ba, aa)));
+        __m128 x1 = _mm_add_ps(ab, _mm_mul_ps(u, _mm_sub_ps(bb, ab)));
+        __m128 noise = _mm_add_ps(x0, _mm_mul_ps(v, _mm_sub_ps(x1, x0)));
+        _mm_storeu_ps(out + column, _mm_add_ps(_mm_loadu_ps(out + column), _mm_mul_ps(noise, amplitudes)));
+    }
+#endif
+
+    for (; column < width; column++) {
+        const float sampleX = (x + static_cast<float>(column)) * frequency + offset;
+        out[column] += SingleOctave(sampleX, y * frequency + offset) * amplitude;
+    }
+}
+
+} // namespace Game
+} // namespace SwordAndStone
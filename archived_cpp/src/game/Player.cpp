@@ -1,20 +1,71 @@
 #include "game/Player.h"
+#include <algorithm>
+#include <cmath>
 
 namespace SwordAndStone {
 namespace Game {
 
-Player::Player() {
+namespace {
+
+float MoveToward(float value, float target, float delta) {
+    return value < target ? std::min(value + delta, target) : std::max(value - delta, target);
+}
+
+} // namespace
+
+Player::Player()
+    : m_voxels(nullptr)
+    , m_yaw(0.0f)
+    , m_inputRight(0.0f)
+    , m_inputBack(0.0f)
+    , m_sprint(false)
+    , m_jump(false)
+{
 }
 
 Player::~Player() {
 }
 
-void Player::Initialize() {
-    // TODO: Initialize player
+void Player::Initialize(const VoxelSystem* voxels, const float spawn[3]) {
+    m_voxels = voxels;
+    m_character = Character();
+    m_character.position[0] = spawn[0];
+    m_character.position[1] = spawn[1];
+    m_character.position[2] = spawn[2];
+}
+
+void Player::SetMoveInput(float right, float back, bool sprint, bool jump) {
+    m_inputRight = right;
+    m_inputBack = back;
+    m_sprint = sprint;
+    m_jump = jump;
 }
 
 void Player::Update(float deltaTime) {
-    // TODO: Update player
+    if (!m_voxels) return;
+
+    float* velocity = m_character.velocity;
+    if (m_jump && m_character.grounded) {
+        velocity[1] = JUMP_VELOCITY;
+    }
+    m_jump = false;
+
+    // Input rotated by the yaw, as transform.basis * Vector3(x, 0, y) in the GDScript controller
+    const float s = std::sin(m_yaw);
+    const float c = std::cos(m_yaw);
+    float x = m_inputRight * c + m_inputBack * s;
+    float z = -m_inputRight * s + m_inputBack * c;
+    const float length = std::sqrt(x * x + z * z);
+    const float speed = m_sprint ? RUN_SPEED : WALK_SPEED;
+    if (length > 0.0f) {
+        velocity[0] = x / length * speed;
+        velocity[2] = z / length * speed;
+    } else {
+        velocity[0] = MoveToward(velocity[0], 0.0f, speed);
+        velocity[2] = MoveToward(velocity[2], 0.0f, speed);
+    }
+
+    MoveCharacter(*m_voxels, m_character, deltaTime);
 }
 
 void Player::Render() {
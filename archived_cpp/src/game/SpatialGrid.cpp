@@ -0,0 +1,266 @@
+#include "game/SpatialGrid.h"
+#include "game/EntityComponents.h"
+#include "platform/MemoryTracker.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace SwordAndStone {
+namespace Game {
+
+namespace {
+
+// Queries handed to each job by QueryRadiusBatch
+constexpr uint32_t QUERIES_PER_BATCH = 64;
+
+// Cell coordinates keep 21 bits per axis, about a million cells each way
+constexpr int32_t CELL_COORD_BIAS = 1 << 20;
+constexpr uint64_t CELL_COORD_MASK = (1u << 21) - 1;
+
+float DistanceSquaredToBox(const float point[3], const float min[3], const float max[3]) {
+    float distance = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        const float clamped = std::min(std::max(point[axis], min[axis]), max[axis]);
+        const float delta = point[axis] - clamped;
+        distance += delta * delta;
+    }
+    return distance;
+}
+
+} // namespace
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : m_cellSize(cellSize)
+    , m_inverseCellSize(1.0f / cellSize)
+    , m_stamp(0)
+{
+}
+
+uint64_t SpatialGrid::PackCellKey(int32_t x, int32_t y, int32_t z) {
+    return (static_cast<uint64_t>((x + CELL_COORD_BIAS) & CELL_COORD_MASK)) |
+           (static_cast<uint64_t>((y + CELL_COORD_BIAS) & CELL_COORD_MASK) << 21) |
+           (static_cast<uint64_t>((z + CELL_COORD_BIAS) & CELL_COORD_MASK) << 42);
+}
+
+uint64_t SpatialGrid::GetCellKey(const float point[3]) const {
+    return PackCellKey(static_cast<int32_t>(std::floor(point[0] * m_inverseCellSize)),
+                       static_cast<int32_t>(std::floor(point[1] * m_inverseCellSize)),
+                       static_cast<int32_t>(std::floor(point[2] * m_inverseCellSize)));
+}
+
+uint32_t SpatialGrid::GetCell(uint64_t key) {
+    auto found = m_cellByKey.find(key);
+    if (found != m_cellByKey.end()) {
+        return found->second;
+    }
+    Platform::MemoryTagScope tag(Platform::MemoryTag::Entities);
+    const uint32_t cell = static_cast<uint32_t>(m_cells.size());
+    m_cells.emplace_back();
+    m_cellByKey.emplace(key, cell);
+    return cell;
+}
+
+void SpatialGrid::Link(uint32_t item, uint32_t cell) {
+    Platform::MemoryTagScope tag(Platform::MemoryTag::Entities);
+    std::vector<uint32_t>& list = cell == LARGE_CELL ? m_large : m_cells[cell].items;
+    m_items[item].cell = cell;
+    m_items[item].slot = static_cast<uint32_t>(list.size());
+    list.push_back(item);
+}
+
+void SpatialGrid::Unlink(uint32_t item) {
+    std::vector<uint32_t>& list = m_items[item].cell == LARGE_CELL ? m_large : m_cells[m_items[item].cell].items;
+    const uint32_t slot = m_items[item].slot;
+    list[slot] = list.back();
+    m_items[list[slot]].slot = slot;
+    list.pop_back();
+}
+
+void SpatialGrid::Insert(Entity entity, const float center[3], float radius) {
+    Update(entity, center, radius);
+}
+
+void SpatialGrid::Update(Entity entity, const float center[3], float radius) {
+    if (entity.index < m_itemByEntity.size() && m_itemByEntity[entity.index] != INVALID_INDEX &&
+        m_items[m_itemByEntity[entity.index]].entity != entity) {
+        // The index was recycled for a new entity before the old one was removed
+        Remove(m_items[m_itemByEntity[entity.index]].entity);
+    }
+
+    Platform::MemoryTagScope tag(Platform::MemoryTag::Entities);
+    if (entity.index >= m_itemByEntity.size()) {
+        m_itemByEntity.resize(entity.index + 1, INVALID_INDEX);
+    }
+
+    uint32_t item = m_itemByEntity[entity.index];
+    const uint64_t key = IsLarge(radius) ? LARGE_KEY : GetCellKey(center);
+    if (item == INVALID_INDEX) {
+        item = static_cast<uint32_t>(m_items.size());
+        m_items.push_back({ entity, { 0.0f, 0.0f, 0.0f }, 0.0f, key, INVALID_INDEX, 0, m_stamp });
+        m_itemByEntity[entity.index] = item;
+        Link(item, key == LARGE_KEY ? LARGE_CELL : GetCell(key));
+    } else if (m_items[item].key != key) {
+        Unlink(item);
+        m_items[item].key = key;
+        Link(item, key == LARGE_KEY ? LARGE_CELL : GetCell(key));
+        m_stats.cellChanges++;
+    }
+
+    Item& entry = m_items[item];
+    entry.center[0] = center[0];
+    entry.center[1] = center[1];
+    entry.center[2] = center[2];
+    entry.radius = radius;
+    entry.stamp = m_stamp;
+}
+
+void SpatialGrid::Remove(Entity entity) {
+    if (!Contains(entity)) return;
+
+    const uint32_t item = m_itemByEntity[entity.index];
+    Unlink(item);
+    m_itemByEntity[entity.index] = INVALID_INDEX;
+
+    // Fill the hole with the last item and repoint its cell entry
+    const uint32_t last = static_cast<uint32_t>(m_items.size() - 1);
+    if (item != last) {
+        m_items[item] = m_items[last];
+        const Item& moved = m_items[item];
+        m_itemByEntity[moved.entity.index] = item;
+        (moved.cell == LARGE_CELL ? m_large : m_cells[moved.cell].items)[moved.slot] = item;
+    }
+    m_items.pop_back();
+}
+
+bool SpatialGrid::Contains(Entity entity) const {
+    return entity.index < m_itemByEntity.size() && m_itemByEntity[entity.index] != INVALID_INDEX &&
+           m_items[m_itemByEntity[entity.index]].entity == entity;
+}
+
+void SpatialGrid::Clear() {
+    for (Cell& cell : m_cells) {
+        cell.items.clear();
+    }
+    m_large.clear();
+    m_items.clear();
+    std::fill(m_itemByEntity.begin(), m_itemByEntity.end(), INVALID_INDEX);
+}
+
+void SpatialGrid::Sync(EntityRegistry& registry) {
+    PROFILE_ZONE("SpatialGrid::Sync");
+
+    m_stamp++;
+    m_stats.synced = 0;
+    m_stats.cellChanges = 0;
+    m_stats.removed = 0;
+
+    registry.ForEachChunk<Position, Bounds>(
+        [this](uint32_t count, const Entity* entities, Position* positions, Bounds* bounds) {
+        for (uint32_t i = 0; i < count; i++) {
+            const float center[3] = { positions[i].x, positions[i].y, positions[i].z };
+            Update(entities[i], center, bounds[i].radius);
+        }
+        m_stats.synced += count;
+    });
+
+    // Anything not seen this pass was destroyed or lost its bounds; walk down since Remove swaps from the end
+    for (uint32_t item = static_cast<uint32_t>(m_items.size()); item-- > 0;) {
+        if (m_items[item].stamp != m_stamp) {
+            Remove(m_items[item].entity);
+            m_stats.removed++;
+        }
+    }
+
+    m_stats.entities = m_items.size();
+    m_stats.cells = m_cells.size();
+}
+
+template<typename Overlaps>
+uint32_t SpatialGrid::Query(const float min[3], const float max[3], const Overlaps& overlaps,
+                            std::vector<Entity>& out) const {
+    const size_t start = out.size();
+
+    for (uint32_t item : m_large) {
+        if (overlaps(m_items[item])) out.push_back(m_items[item].entity);
+    }
+
+    // Cells whose loose bounds (grown by half a cell) overlap the query
+    const float margin = 0.5f * m_cellSize;
+    int32_t cellMin[3], cellMax[3];
+    for (int axis = 0; axis < 3; axis++) {
+        cellMin[axis] = static_cast<int32_t>(std::floor((min[axis] - margin) * m_inverseCellSize));
+        cellMax[axis] = static_cast<int32_t>(std::floor((max[axis] + margin) * m_inverseCellSize));
+    }
+
+    for (int32_t z = cellMin[2]; z <= cellMax[2]; z++) {
+        for (int32_t y = cellMin[1]; y <= cellMax[1]; y++) {
+            for (int32_t x = cellMin[0]; x <= cellMax[0]; x++) {
+                auto found = m_cellByKey.find(PackCellKey(x, y, z));
+                if (found == m_cellByKey.end()) continue;
+                for (uint32_t item : m_cells[found->second].items) {
+                    if (overlaps(m_items[item])) out.push_back(m_items[item].entity);
+                }
+            }
+        }
+    }
+    return static_cast<uint32_t>(out.size() - start);
+}
+
+uint32_t SpatialGrid::QueryRadius(const float center[3], float radius, std::vector<Entity>& out) const {
+    const float min[3] = { center[0] - radius, center[1] - radius, center[2] - radius };
+    const float max[3] = { center[0] + radius, center[1] + radius, center[2] + radius };
+    return Query(min, max, [center, radius](const Item& item) {
+        const float dx = item.center[0] - center[0];
+        const float dy = item.center[1] - center[1];
+        const float dz = item.center[2] - center[2];
+        const float reach = item.radius + radius;
+        return dx * dx + dy * dy + dz * dz <= reach * reach;
+    }, out);
+}
+
+uint32_t SpatialGrid::QueryAABB(const float min[3], const float max[3], std::vector<Entity>& out) const {
+    return Query(min, max, [min, max](const Item& item) {
+        return DistanceSquaredToBox(item.center, min, max) <= item.radius * item.radius;
+    }, out);
+}
+
+void SpatialGrid::QueryRadiusBatch(const float* centers, const float* radii, uint32_t count,
+                                   std::vector<uint32_t>& offsets, std::vector<Entity>& results,
+                                   Platform::JobSystem* jobSystem) {
+    PROFILE_ZONE("SpatialGrid::QueryRadiusBatch");
+
+    const uint32_t batches = (count + QUERIES_PER_BATCH - 1) / QUERIES_PER_BATCH;
+    if (m_batchResults.size() < batches) {
+        m_batchResults.resize(batches);
+        m_batchCounts.resize(batches);
+    }
+
+    Platform::JobSystem& jobs = jobSystem ? *jobSystem : Platform::JobSystem::GetDefault();
+    jobs.ParallelFor(batches, 1, [this, centers, radii, count](uint32_t begin, uint32_t end) {
+        for (uint32_t batch = begin; batch < end; batch++) {
+            std::vector<Entity>& found = m_batchResults[batch];
+            std::vector<uint32_t>& counts = m_batchCounts[batch];
+            found.clear();
+            counts.clear();
+            const uint32_t last = std::min(count, (batch + 1) * QUERIES_PER_BATCH);
+            for (uint32_t query = batch * QUERIES_PER_BATCH; query < last; query++) {
+                counts.push_back(QueryRadius(centers + 3 * query, radii[query], found));
+            }
+        }
+    });
+
+    offsets.resize(count + 1);
+    results.clear();
+    uint32_t query = 0;
+    offsets[0] = 0;
+    for (uint32_t batch = 0; batch < batches; batch++) {
+        results.insert(results.end(), m_batchResults[batch].begin(), m_batchResults[batch].end());
+        for (uint32_t found : m_batchCounts[batch]) {
+            offsets[query + 1] = offsets[query] + found;
+            query++;
+        }
+    }
+}
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,74 @@
+#include "game/TileMap.h"
+#include "platform/MemoryTracker.h"
+
+namespace SwordAndStone {
+namespace Game {
+
+namespace {
+
+int FloorDiv(int value, int divisor) {
+    return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+} // namespace
+
+TileRegionCoord TileMap::TileToRegion(int x, int y) {
+    return { FloorDiv(x, TILE_REGION_SIZE), FloorDiv(y, TILE_REGION_SIZE) };
+}
+
+uint16_t TileMap::GetTile(int x, int y) const {
+    TileRegionCoord coord = TileToRegion(x, y);
+    const TileRegion* region = GetRegion(coord);
+    if (!region) return EMPTY_TILE;
+    return region->Get(x - coord.x * TILE_REGION_SIZE, y - coord.y * TILE_REGION_SIZE);
+}
+
+void TileMap::SetTile(int x, int y, uint16_t tile) {
+    TileRegionCoord coord = TileToRegion(x, y);
+    TileRegion* region = GetRegion(coord);
+    if (!region) {
+        if (tile == EMPTY_TILE) return;
+        region = &GetOrCreateRegion(coord);
+    }
+
+    uint16_t& stored = region->tiles[(y - coord.y * TILE_REGION_SIZE) * TILE_REGION_SIZE + (x - coord.x * TILE_REGION_SIZE)];
+    if (stored == tile) return;
+    stored = tile;
+    region->version = ++m_nextVersion;
+}
+
+TileRegion* TileMap::GetRegion(const TileRegionCoord& coord) {
+    auto it = m_regions.find(coord);
+    return it != m_regions.end() ? it->second.get() : nullptr;
+}
+
+const TileRegion* TileMap::GetRegion(const TileRegionCoord& coord) const {
+    auto it = m_regions.find(coord);
+    return it != m_regions.end() ? it->second.get() : nullptr;
+}
+
+TileRegion& TileMap::GetOrCreateRegion(const TileRegionCoord& coord) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Tiles);
+    std::unique_ptr<TileRegion>& region = m_regions[coord];
+    if (!region) {
+        region.reset(new TileRegion());
+        region->version = ++m_nextVersion;
+    }
+    return *region;
+}
+
+TileRegion& TileMap::SetRegion(const TileRegionCoord& coord, std::unique_ptr<TileRegion> region) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Tiles);
+    // Versions come from one counter, so a cached build of the old region never matches
+    region->version = ++m_nextVersion;
+    std::unique_ptr<TileRegion>& slot = m_regions[coord];
+    slot = std::move(region);
+    return *slot;
+}
+
+void TileMap::RemoveRegion(const TileRegionCoord& coord) {
+    m_regions.erase(coord);
+}
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,239 @@
+#include "game/TileRenderer.h"
+#include "platform/MemoryTracker.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace SwordAndStone {
+namespace Game {
+
+using namespace Renderer;
+
+TileRenderer::TileRenderer(const TileRendererDesc& desc)
+    : m_desc(desc)
+    , m_indexBuffer(0)
+    , m_frame(0)
+{
+    if (m_desc.imageHeight <= 0.0f) {
+        m_desc.imageHeight = m_desc.tileHeight;
+    }
+    m_desc.atlasColumns = std::max(1u, m_desc.atlasColumns);
+    m_desc.atlasRows = std::max(1u, m_desc.atlasRows);
+
+    // Isometric tiles overlap their upper neighbours, so each region is meshed along diagonals, back to front
+    m_tileOrder.resize(TILE_REGION_AREA);
+    for (int i = 0; i < TILE_REGION_AREA; i++) {
+        m_tileOrder[i] = static_cast<uint16_t>(i);
+    }
+    if (m_desc.projection == TileProjection::Isometric) {
+        std::stable_sort(m_tileOrder.begin(), m_tileOrder.end(), [](uint16_t a, uint16_t b) {
+            return (a % TILE_REGION_SIZE + a / TILE_REGION_SIZE) < (b % TILE_REGION_SIZE + b / TILE_REGION_SIZE);
+        });
+    }
+}
+
+void TileRenderer::TileToScreen(float x, float y, float screen[2]) const {
+    if (m_desc.projection == TileProjection::Isometric) {
+        screen[0] = (x - y) * m_desc.tileWidth * 0.5f;
+        screen[1] = (x + y) * m_desc.tileHeight * 0.5f;
+    } else {
+        screen[0] = x * m_desc.tileWidth;
+        screen[1] = y * m_desc.tileHeight;
+    }
+}
+
+void TileRenderer::ScreenToTile(float screenX, float screenY, float tile[2]) const {
+    if (m_desc.projection == TileProjection::Isometric) {
+        float u = screenX / (m_desc.tileWidth * 0.5f);
+        float v = screenY / (m_desc.tileHeight * 0.5f);
+        tile[0] = (v + u) * 0.5f;
+        tile[1] = (v - u) * 0.5f;
+    } else {
+        tile[0] = screenX / m_desc.tileWidth;
+        tile[1] = screenY / m_desc.tileHeight;
+    }
+}
+
+void TileRenderer::GetRegionBounds(const TileRegionCoord& coord, float min[2], float max[2]) const {
+    const float x0 = static_cast<float>(coord.x * TILE_REGION_SIZE);
+    const float y0 = static_cast<float>(coord.y * TILE_REGION_SIZE);
+    const float x1 = x0 + TILE_REGION_SIZE;
+    const float y1 = y0 + TILE_REGION_SIZE;
+
+    if (m_desc.projection == TileProjection::Isometric) {
+        float top[2], bottom[2], left[2], right[2];
+        TileToScreen(x0, y0, top);
+        TileToScreen(x1, y1, bottom);
+        TileToScreen(x0, y1, left);
+        TileToScreen(x1, y0, right);
+        min[0] = left[0];
+        max[0] = right[0];
+        min[1] = top[1] + m_desc.tileHeight - m_desc.imageHeight;
+        max[1] = bottom[1];
+    } else {
+        TileToScreen(x0, y0, min);
+        TileToScreen(x1, y1, max);
+    }
+}
+
+void TileRenderer::Render(IRenderer& renderer, CommandBuffer& commands, const TileMap& map,
+                          const float viewMin[2], const float viewMax[2]) {
+    PROFILE_ZONE("TileRenderer::Render");
+    m_frame++;
+    m_stats = TileRenderStats();
+
+    if (!m_indexBuffer) {
+        std::vector<uint32_t> indices(static_cast<size_t>(TILE_REGION_AREA) * 6);
+        for (uint32_t i = 0; i < TILE_REGION_AREA; i++) {
+            const uint32_t base = i * 4;
+            uint32_t* quad = &indices[static_cast<size_t>(i) * 6];
+            quad[0] = base;
+            quad[1] = base + 1;
+            quad[2] = base + 2;
+            quad[3] = base;
+            quad[4] = base + 2;
+            quad[5] = base + 3;
+        }
+        m_indexBuffer = renderer.CreateIndexBuffer(indices.data(), indices.size(), BufferUsage::Static);
+        if (!m_indexBuffer) return;
+    }
+
+    // Tile range under the view; tall isometric images reach up into the view from below it
+    const float reach = m_desc.imageHeight - m_desc.tileHeight;
+    const float corners[4][2] = {
+        { viewMin[0], viewMin[1] }, { viewMax[0], viewMin[1] },
+        { viewMin[0], viewMax[1] + reach }, { viewMax[0], viewMax[1] + reach },
+    };
+    float tileMin[2] = { INFINITY, INFINITY };
+    float tileMax[2] = { -INFINITY, -INFINITY };
+    for (const float* corner : corners) {
+        float tile[2];
+        ScreenToTile(corner[0], corner[1], tile);
+        for (int axis = 0; axis < 2; axis++) {
+            tileMin[axis] = std::min(tileMin[axis], tile[axis]);
+            tileMax[axis] = std::max(tileMax[axis], tile[axis]);
+        }
+    }
+    TileRegionCoord first = TileMap::TileToRegion(static_cast<int>(std::floor(tileMin[0])) - 1,
+                                                  static_cast<int>(std::floor(tileMin[1])) - 1);
+    TileRegionCoord last = TileMap::TileToRegion(static_cast<int>(std::floor(tileMax[0])) + 1,
+                                                 static_cast<int>(std::floor(tileMax[1])) + 1);
+
+    for (int ry = first.y; ry <= last.y; ry++) {
+        for (int rx = first.x; rx <= last.x; rx++) {
+            TileRegionCoord coord = { rx, ry };
+            const TileRegion* region = map.GetRegion(coord);
+            if (!region) continue;
+
+            float min[2], max[2];
+            GetRegionBounds(coord, min, max);
+            if (max[0] < viewMin[0] || min[0] > viewMax[0] || max[1] < viewMin[1] || min[1] > viewMax[1]) continue;
+
+            RegionMesh& mesh = m_meshes[coord];
+            if (mesh.version != region->version) {
+                BuildRegion(renderer, coord, *region, mesh);
+            }
+            mesh.lastVisibleFrame = m_frame;
+            m_stats.regionsVisible++;
+            if (mesh.indexCount == 0) continue;
+
+            // Isometric regions sort along their diagonal, back to front
+            uint32_t depth = 0;
+            if (m_desc.projection == TileProjection::Isometric) {
+                depth = static_cast<uint32_t>(rx + ry + (1 << 23)) & ((1u << SortKey::DEPTH_BITS) - 1);
+            }
+            commands.DrawIndexed(SortKey::Make(m_desc.pass, m_desc.shader, m_desc.texture, depth), m_desc.shader,
+                                 m_desc.texture, mesh.vertexBuffer, m_indexBuffer, mesh.indexCount, m_desc.state);
+            m_stats.drawCalls++;
+        }
+    }
+
+    EvictRegions(renderer, map);
+}
+
+void TileRenderer::BuildRegion(IRenderer& renderer, const TileRegionCoord& coord, const TileRegion& region,
+                               RegionMesh& mesh) {
+    PROFILE_ZONE("TileRenderer::BuildRegion");
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Meshes);
+    const uint32_t tileCount = m_desc.atlasColumns * m_desc.atlasRows;
+    const float uScale = 1.0f / static_cast<float>(m_desc.atlasColumns);
+    const float vScale = 1.0f / static_cast<float>(m_desc.atlasRows);
+    const bool isometric = m_desc.projection == TileProjection::Isometric;
+
+    m_vertices.clear();
+    for (uint16_t index : m_tileOrder) {
+        uint16_t tile = region.tiles[index];
+        if (tile == EMPTY_TILE || tile >= tileCount) continue;
+
+        float screen[2];
+        TileToScreen(static_cast<float>(coord.x * TILE_REGION_SIZE + index % TILE_REGION_SIZE),
+                     static_cast<float>(coord.y * TILE_REGION_SIZE + index / TILE_REGION_SIZE), screen);
+        float x0 = screen[0];
+        float y1 = screen[1] + m_desc.tileHeight;
+        if (isometric) {
+            x0 -= m_desc.tileWidth * 0.5f;
+        }
+        const float x1 = x0 + m_desc.tileWidth;
+        const float y0 = y1 - m_desc.imageHeight;
+
+        const float u0 = static_cast<float>(tile % m_desc.atlasColumns) * uScale;
+        const float v0 = static_cast<float>(tile / m_desc.atlasColumns) * vScale;
+        const float quad[4][4] = {
+            { x0, y0, u0, v0 },
+            { x1, y0, u0 + uScale, v0 },
+            { x1, y1, u0 + uScale, v0 + vScale },
+            { x0, y1, u0, v0 + vScale },
+        };
+        for (const float* corner : quad) {
+            Vertex v = {};
+            v.position[0] = corner[0];
+            v.position[1] = corner[1];
+            v.normal[2] = 1.0f;
+            v.texcoord[0] = corner[2];
+            v.texcoord[1] = corner[3];
+            v.color[0] = v.color[1] = v.color[2] = v.color[3] = 1.0f;
+            m_vertices.push_back(v);
+        }
+    }
+
+    const size_t size = m_vertices.size() * sizeof(Vertex);
+    if (size > 0) {
+        if (mesh.vertexBuffer && size <= mesh.capacity) {
+            renderer.UpdateVertexBuffer(mesh.vertexBuffer, m_vertices.data(), size, 0);
+        } else {
+            if (mesh.vertexBuffer) renderer.DeleteBuffer(mesh.vertexBuffer);
+            mesh.vertexBuffer = renderer.CreateVertexBuffer(m_vertices.data(), size, BufferUsage::Static);
+            mesh.capacity = mesh.vertexBuffer ? size : 0;
+        }
+    }
+
+    mesh.indexCount = mesh.vertexBuffer ? static_cast<uint32_t>(m_vertices.size() / 4 * 6) : 0;
+    mesh.version = region.version;
+    m_stats.regionsRebuilt++;
+    m_stats.tilesBuilt += static_cast<uint32_t>(m_vertices.size() / 4);
+}
+
+void TileRenderer::EvictRegions(IRenderer& renderer, const TileMap& map) {
+    for (auto it = m_meshes.begin(); it != m_meshes.end();) {
+        bool stale = m_frame - it->second.lastVisibleFrame > EVICT_AFTER_FRAMES;
+        if (!stale && map.GetRegion(it->first)) {
+            ++it;
+            continue;
+        }
+        if (it->second.vertexBuffer) renderer.DeleteBuffer(it->second.vertexBuffer);
+        it = m_meshes.erase(it);
+        m_stats.regionsEvicted++;
+    }
+}
+
+void TileRenderer::Release(IRenderer& renderer) {
+    for (auto& entry : m_meshes) {
+        if (entry.second.vertexBuffer) renderer.DeleteBuffer(entry.second.vertexBuffer);
+    }
+    m_meshes.clear();
+    if (m_indexBuffer) renderer.DeleteBuffer(m_indexBuffer);
+    m_indexBuffer = 0;
+}
+
+} // namespace Game
+} // namespace SwordAndStone
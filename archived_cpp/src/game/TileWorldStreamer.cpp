@@ -0,0 +1,174 @@
+#include "game/TileWorldStreamer.h"
+#include "platform/MemoryTracker.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+
+namespace SwordAndStone {
+namespace Game {
+
+TileWorldStreamer::TileWorldStreamer(TileMap& map, const TileWorldDesc& desc, Platform::JobSystem* jobSystem)
+    : m_map(map)
+    , m_desc(desc)
+    , m_jobSystem(jobSystem)
+    , m_terrainNoise(desc.seed, desc.terrainScale, desc.terrainOctaves)
+    , m_moistureNoise(desc.seed + desc.moistureSeedOffset, desc.moistureScale, desc.climateOctaves)
+    , m_temperatureNoise(desc.seed + desc.temperatureSeedOffset, desc.temperatureScale, desc.climateOctaves)
+    , m_frame(0)
+{
+    m_desc.paddingRegions = std::max(0, m_desc.paddingRegions);
+    m_desc.maxRegionsInFlight = std::max(1u, m_desc.maxRegionsInFlight);
+}
+
+TileWorldStreamer::~TileWorldStreamer() {
+    // Workers write into this object, so they must finish before it goes away
+    Platform::JobSystem& jobs = m_jobSystem ? *m_jobSystem : Platform::JobSystem::GetDefault();
+    jobs.Wait(m_counter);
+}
+
+TileTerrain TileWorldStreamer::ClassifyTerrain(float height, float moisture, float temperature) {
+    if (height < 0.35f) return TileTerrain::DeepWater;
+    if (height < 0.42f) return TileTerrain::ShallowWater;
+    if (height < 0.48f) return TileTerrain::Sand;
+    if (height > 0.75f) {
+        return temperature < 0.3f ? TileTerrain::Snow : TileTerrain::Stone;
+    }
+    if (moisture > 0.6f && temperature > 0.4f) return TileTerrain::Forest;
+    if (moisture < 0.3f) return TileTerrain::Dirt;
+    return TileTerrain::Grass;
+}
+
+void TileWorldStreamer::GenerateRegion(const TileRegionCoord& coord, TileRegion& region) const {
+    PROFILE_ZONE("TileWorldStreamer::GenerateRegion");
+    float height[TILE_REGION_AREA];
+    float moisture[TILE_REGION_AREA];
+    float temperature[TILE_REGION_AREA];
+
+    const float x = static_cast<float>(coord.x * TILE_REGION_SIZE);
+    const float y = static_cast<float>(coord.y * TILE_REGION_SIZE);
+    m_terrainNoise.SampleGrid(x, y, TILE_REGION_SIZE, TILE_REGION_SIZE, height);
+    m_moistureNoise.SampleGrid(x, y, TILE_REGION_SIZE, TILE_REGION_SIZE, moisture);
+    m_temperatureNoise.SampleGrid(x, y, TILE_REGION_SIZE, TILE_REGION_SIZE, temperature);
+
+    for (int i = 0; i < TILE_REGION_AREA; i++) {
+        TileTerrain terrain = ClassifyTerrain((height[i] + 1.0f) * 0.5f, (moisture[i] + 1.0f) * 0.5f,
+                                              (temperature[i] + 1.0f) * 0.5f);
+        region.tiles[i] = static_cast<uint16_t>(terrain);
+    }
+}
+
+void TileWorldStreamer::Update(const int tileMin[2], const int tileMax[2]) {
+    PROFILE_ZONE("TileWorldStreamer::Update");
+    m_frame++;
+    m_stats.regionsRequested = 0;
+    m_stats.regionsIntegrated = 0;
+    m_stats.regionsEvicted = 0;
+
+    IntegrateGenerated();
+
+    const int padding = m_desc.paddingRegions;
+    TileRegionCoord first = TileMap::TileToRegion(tileMin[0], tileMin[1]);
+    TileRegionCoord last = TileMap::TileToRegion(tileMax[0], tileMax[1]);
+    first.x -= padding;
+    first.y -= padding;
+    last.x += padding;
+    last.y += padding;
+
+    m_requests.clear();
+    for (int ry = first.y; ry <= last.y; ry++) {
+        for (int rx = first.x; rx <= last.x; rx++) {
+            TileRegionCoord coord = { rx, ry };
+            if (m_resident.count(coord)) {
+                Touch(coord);
+            } else if (m_pending.count(coord)) {
+                continue;
+            } else if (m_map.GetRegion(coord)) {
+                continue;  // loaded or edited by someone else; not ours to overwrite or evict
+            } else {
+                m_requests.push_back(coord);
+            }
+        }
+    }
+
+    // Nearest regions first, so the view fills in from the middle when the queue is capped
+    const int centerX2 = first.x + last.x;
+    const int centerY2 = first.y + last.y;
+    auto distance = [centerX2, centerY2](const TileRegionCoord& coord) {
+        const int64_t dx = coord.x * 2 - centerX2;
+        const int64_t dy = coord.y * 2 - centerY2;
+        return dx * dx + dy * dy;
+    };
+    std::sort(m_requests.begin(), m_requests.end(), [&distance](const TileRegionCoord& a, const TileRegionCoord& b) {
+        return distance(a) < distance(b);
+    });
+
+    Platform::JobSystem& jobs = m_jobSystem ? *m_jobSystem : Platform::JobSystem::GetDefault();
+    for (const TileRegionCoord& coord : m_requests) {
+        if (m_pending.size() >= m_desc.maxRegionsInFlight) break;
+        m_pending.insert(coord);
+        m_stats.regionsRequested++;
+        jobs.Run([this, coord]() {
+            Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Tiles);
+            std::unique_ptr<TileRegion> region(new TileRegion());
+            GenerateRegion(coord, *region);
+            std::lock_guard<std::mutex> lock(m_generatedMutex);
+            m_generated.push_back({ coord, std::move(region) });
+        }, &m_counter);
+    }
+
+    Evict();
+    m_stats.regionsPending = static_cast<uint32_t>(m_pending.size());
+    m_stats.regionsResident = m_resident.size();
+}
+
+void TileWorldStreamer::Flush() {
+    Platform::JobSystem& jobs = m_jobSystem ? *m_jobSystem : Platform::JobSystem::GetDefault();
+    jobs.Wait(m_counter);
+    IntegrateGenerated();
+    m_stats.regionsPending = static_cast<uint32_t>(m_pending.size());
+    m_stats.regionsResident = m_resident.size();
+}
+
+void TileWorldStreamer::IntegrateGenerated() {
+    {
+        std::lock_guard<std::mutex> lock(m_generatedMutex);
+        m_integrating.swap(m_generated);
+    }
+
+    for (GeneratedRegion& generated : m_integrating) {
+        m_pending.erase(generated.coord);
+        // A region written while this one was generating wins over the generated terrain,
+        // and like any region the streamer did not generate, it is never evicted
+        if (m_map.GetRegion(generated.coord)) continue;
+        m_map.SetRegion(generated.coord, std::move(generated.region));
+        m_stats.regionsIntegrated++;
+        Touch(generated.coord);
+    }
+    m_integrating.clear();
+}
+
+void TileWorldStreamer::Touch(const TileRegionCoord& coord) {
+    auto found = m_resident.find(coord);
+    if (found != m_resident.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, found->second);
+        found->second->lastUsedFrame = m_frame;
+        return;
+    }
+    m_lru.push_front({ coord, m_frame });
+    m_resident[coord] = m_lru.begin();
+}
+
+void TileWorldStreamer::Evict() {
+    while (m_resident.size() > m_desc.cacheCapacity) {
+        const CachedRegion& oldest = m_lru.back();
+        // Everything from here on is in view this frame; the cache grows rather than thrashing
+        if (oldest.lastUsedFrame == m_frame) break;
+
+        m_map.RemoveRegion(oldest.coord);
+        m_resident.erase(oldest.coord);
+        m_lru.pop_back();
+        m_stats.regionsEvicted++;
+    }
+}
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -0,0 +1,217 @@
+#include "game/VoxelRaycast.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+
+namespace SwordAndStone {
+namespace Game {
+
+namespace {
+
+// Rays handed to each job by RaycastVoxelsBatch
+constexpr uint32_t RAYS_PER_BATCH = 64;
+
+// Keeps a box flush against a voxel boundary from counting as overlapping the voxel beyond it
+constexpr float SWEEP_EPSILON = 1e-4f;
+
+constexpr float INFINITE_TIME = std::numeric_limits<float>::infinity();
+
+// World voxel to chunk coordinate with an arithmetic shift instead of a floor division
+static_assert(CHUNK_SIZE == 16, "CHUNK_SHIFT must match CHUNK_SIZE");
+constexpr int CHUNK_SHIFT = 4;
+
+// Remembers the last chunk looked up; rays and sweeps stay in one chunk for many steps
+class ChunkCursor {
+public:
+    explicit ChunkCursor(const VoxelSystem& voxels)
+        : m_voxels(voxels)
+        , m_coord{ INT_MIN, INT_MIN, INT_MIN }
+        , m_chunk(nullptr)
+    {
+    }
+
+    const Chunk* GetChunk(const ChunkCoord& coord) {
+        if (coord != m_coord) {
+            m_coord = coord;
+            m_chunk = m_voxels.GetChunk(coord);
+        }
+        return m_chunk;
+    }
+
+    VoxelType Get(int x, int y, int z) {
+        const ChunkCoord coord = { x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT };
+        const Chunk* chunk = GetChunk(coord);
+        return chunk ? chunk->Get(x & (CHUNK_SIZE - 1), y & (CHUNK_SIZE - 1), z & (CHUNK_SIZE - 1)) : VoxelType::Air;
+    }
+
+private:
+    const VoxelSystem& m_voxels;
+    ChunkCoord m_coord;
+    const Chunk* m_chunk;
+};
+
+} // namespace
+
+bool RaycastVoxels(const VoxelSystem& voxels, const float origin[3], const float direction[3], float maxDistance,
+                   VoxelRayHit& hit, VoxelFilter blocks) {
+    hit = VoxelRayHit();
+
+    const float length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] +
+                                   direction[2] * direction[2]);
+    if (length == 0.0f) return false;
+
+    float dir[3];
+    int voxel[3];
+    int step[3];
+    float tMax[3];    // distance at which the ray crosses the next voxel boundary on each axis
+    float tDelta[3];  // distance between boundaries on each axis
+    for (int axis = 0; axis < 3; axis++) {
+        dir[axis] = direction[axis] / length;
+        voxel[axis] = static_cast<int>(std::floor(origin[axis]));
+        step[axis] = dir[axis] > 0.0f ? 1 : (dir[axis] < 0.0f ? -1 : 0);
+        tDelta[axis] = step[axis] ? std::abs(1.0f / dir[axis]) : INFINITE_TIME;
+        tMax[axis] = step[axis] ? (voxel[axis] + (step[axis] > 0 ? 1 : 0) - origin[axis]) / dir[axis] : INFINITE_TIME;
+    }
+
+    ChunkCursor cursor(voxels);
+    int enteredAxis = -1;
+    float t = 0.0f;
+    while (t <= maxDistance) {
+        const ChunkCoord coord = { voxel[0] >> CHUNK_SHIFT, voxel[1] >> CHUNK_SHIFT, voxel[2] >> CHUNK_SHIFT };
+        const Chunk* chunk = cursor.GetChunk(coord);
+
+        if (!chunk || (chunk->IsUniform() && !blocks(chunk->GetUniformType()))) {
+            // Nothing in this chunk stops the ray; jump to the face it leaves through
+            const int chunkOrigin[3] = { coord.x * CHUNK_SIZE, coord.y * CHUNK_SIZE, coord.z * CHUNK_SIZE };
+            float exit = INFINITE_TIME;
+            int exitAxis = 0;
+            for (int axis = 0; axis < 3; axis++) {
+                if (!step[axis]) continue;
+                const int boundary = chunkOrigin[axis] + (step[axis] > 0 ? CHUNK_SIZE : 0);
+                const float crossing = (boundary - origin[axis]) / dir[axis];
+                if (crossing < exit) {
+                    exit = crossing;
+                    exitAxis = axis;
+                }
+            }
+            if (exit > maxDistance) return false;
+
+            // Voxel indices are recomputed from the exit point rather than accumulated, clamped to the
+            // chunk on the axes the ray does not leave through
+            for (int axis = 0; axis < 3; axis++) {
+                if (axis == exitAxis) {
+                    voxel[axis] = step[axis] > 0 ? chunkOrigin[axis] + CHUNK_SIZE : chunkOrigin[axis] - 1;
+                } else {
+                    const int inside = static_cast<int>(std::floor(origin[axis] + dir[axis] * exit));
+                    voxel[axis] = std::min(std::max(inside, chunkOrigin[axis]), chunkOrigin[axis] + CHUNK_SIZE - 1);
+                }
+                if (step[axis]) {
+                    tMax[axis] = (voxel[axis] + (step[axis] > 0 ? 1 : 0) - origin[axis]) / dir[axis];
+                }
+            }
+            t = std::max(t, exit);
+            enteredAxis = exitAxis;
+            continue;
+        }
+
+        const VoxelType type = chunk->Get(voxel[0] - coord.x * CHUNK_SIZE, voxel[1] - coord.y * CHUNK_SIZE,
+                                          voxel[2] - coord.z * CHUNK_SIZE);
+        if (blocks(type)) {
+            hit.hit = true;
+            for (int axis = 0; axis < 3; axis++) {
+                hit.block[axis] = voxel[axis];
+            }
+            if (enteredAxis >= 0) {
+                hit.normal[enteredAxis] = -step[enteredAxis];
+            }
+            hit.distance = t;
+            hit.type = type;
+            return true;
+        }
+
+        enteredAxis = tMax[0] < tMax[1] ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+        t = tMax[enteredAxis];
+        voxel[enteredAxis] += step[enteredAxis];
+        tMax[enteredAxis] += tDelta[enteredAxis];
+    }
+    return false;
+}
+
+void RaycastVoxelsBatch(const VoxelSystem& voxels, const float* origins, const float* directions,
+                        const float* maxDistances, uint32_t count, VoxelRayHit* hits,
+                        VoxelFilter blocks, Platform::JobSystem* jobSystem) {
+    PROFILE_ZONE("RaycastVoxelsBatch");
+    Platform::JobSystem& jobs = jobSystem ? *jobSystem : Platform::JobSystem::GetDefault();
+    jobs.ParallelFor(count, RAYS_PER_BATCH, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            RaycastVoxels(voxels, origins + 3 * i, directions + 3 * i, maxDistances[i], hits[i], blocks);
+        }
+    });
+}
+
+bool SweepVoxels(const VoxelSystem& voxels, const float min[3], const float max[3], const float motion[3],
+                 VoxelSweepHit& hit, VoxelFilter blocks) {
+    hit = VoxelSweepHit();
+
+    int step[3];
+    int layer[3];     // next voxel layer the leading face enters on each axis
+    float tNext[3];   // motion fraction at which it does
+    float tDelta[3];
+    for (int axis = 0; axis < 3; axis++) {
+        step[axis] = motion[axis] > 0.0f ? 1 : (motion[axis] < 0.0f ? -1 : 0);
+        if (step[axis] > 0) {
+            const float boundary = std::ceil(max[axis]);
+            layer[axis] = static_cast<int>(boundary);
+            tNext[axis] = (boundary - max[axis]) / motion[axis];
+        } else if (step[axis] < 0) {
+            const float boundary = std::floor(min[axis]);
+            layer[axis] = static_cast<int>(boundary) - 1;
+            tNext[axis] = (boundary - min[axis]) / motion[axis];
+        } else {
+            layer[axis] = 0;
+            tNext[axis] = INFINITE_TIME;
+        }
+        tDelta[axis] = step[axis] ? std::abs(1.0f / motion[axis]) : INFINITE_TIME;
+    }
+
+    ChunkCursor cursor(voxels);
+    for (;;) {
+        const int axis = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+        const float t = tNext[axis];
+        if (t > 1.0f) return false;
+
+        // The layer just entered, spanning the box's extent on the other axes at that moment
+        int low[3], high[3];
+        for (int other = 0; other < 3; other++) {
+            if (other == axis) {
+                low[other] = high[other] = layer[axis];
+            } else {
+                low[other] = static_cast<int>(std::floor(min[other] + motion[other] * t + SWEEP_EPSILON));
+                high[other] = static_cast<int>(std::floor(max[other] + motion[other] * t - SWEEP_EPSILON));
+            }
+        }
+
+        for (int y = low[1]; y <= high[1]; y++) {
+            for (int z = low[2]; z <= high[2]; z++) {
+                for (int x = low[0]; x <= high[0]; x++) {
+                    if (!blocks(cursor.Get(x, y, z))) continue;
+                    hit.hit = true;
+                    hit.block[0] = x;
+                    hit.block[1] = y;
+                    hit.block[2] = z;
+                    hit.normal[axis] = -step[axis];
+                    hit.time = t;
+                    return true;
+                }
+            }
+        }
+
+        layer[axis] += step[axis];
+        tNext[axis] += tDelta[axis];
+    }
+}
+
+} // namespace Game
+} // namespace SwordAndStone
@@ -1,25 +1,178 @@
 #include "game/VoxelSystem.h"
+#include "platform/MemoryTracker.h"
+#include "platform/Profiler.h"
+#include <cstring>
 
 namespace SwordAndStone {
 namespace Game {
 
-VoxelSystem::VoxelSystem() {
+VoxelSystem::VoxelSystem()
+    : m_terrainTexture(0)
+{
 }
 
 VoxelSystem::~VoxelSystem() {
 }
 
 void VoxelSystem::Initialize() {
-    // TODO: Initialize voxel system
+    m_chunks.clear();
+    m_dirtyChunks.clear();
 }
 
 void VoxelSystem::Update(float deltaTime) {
-    // TODO: Update voxel system
+    RefreshDirtyChunks();
 }
 
 void VoxelSystem::Render() {
     // TODO: Render voxels
 }
 
+Chunk* VoxelSystem::GetChunk(const ChunkCoord& coord) {
+    auto it = m_chunks.find(coord);
+    return it != m_chunks.end() ? it->second.get() : nullptr;
+}
+
+const Chunk* VoxelSystem::GetChunk(const ChunkCoord& coord) const {
+    auto it = m_chunks.find(coord);
+    return it != m_chunks.end() ? it->second.get() : nullptr;
+}
+
+Chunk& VoxelSystem::GetOrCreateChunk(const ChunkCoord& coord) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Voxels);
+    std::unique_ptr<Chunk>& chunk = m_chunks[coord];
+    if (!chunk) {
+        chunk.reset(new Chunk());
+        m_dirtyChunks.push_back(coord);
+    }
+    return *chunk;
+}
+
+void VoxelSystem::RemoveChunk(const ChunkCoord& coord) {
+    m_chunks.erase(coord);
+}
+
+VoxelType VoxelSystem::GetVoxel(int x, int y, int z) const {
+    const Chunk* chunk = GetChunk(WorldToChunk(x, y, z));
+    if (!chunk) return VoxelType::Air;
+
+    return chunk->Get(x - FloorDiv(x, CHUNK_SIZE) * CHUNK_SIZE,
+                      y - FloorDiv(y, CHUNK_SIZE) * CHUNK_SIZE,
+                      z - FloorDiv(z, CHUNK_SIZE) * CHUNK_SIZE);
+}
+
+void VoxelSystem::SetVoxel(int x, int y, int z, VoxelType type) {
+    ChunkCoord coord = WorldToChunk(x, y, z);
+    Chunk* chunk = GetChunk(coord);
+    if (!chunk) {
+        if (type == VoxelType::Air) return;
+        chunk = &GetOrCreateChunk(coord);
+    }
+
+    // Queue the chunk on its first edit since the last refresh
+    bool wasDirty = chunk->IsDirty();
+    chunk->Set(x - coord.x * CHUNK_SIZE, y - coord.y * CHUNK_SIZE, z - coord.z * CHUNK_SIZE, type);
+    if (!wasDirty && chunk->IsDirty()) {
+        m_dirtyChunks.push_back(coord);
+    }
+}
+
+void VoxelSystem::MarkChunkDirty(const ChunkCoord& coord) {
+    Chunk* chunk = GetChunk(coord);
+    if (!chunk) return;
+
+    chunk->SetDirty(true);
+    m_dirtyChunks.push_back(coord);
+}
+
+void VoxelSystem::RefreshDirtyChunks() {
+    PROFILE_ZONE("VoxelSystem::RefreshDirtyChunks");
+    for (const ChunkCoord& coord : m_dirtyChunks) {
+        // A chunk can be queued more than once; only the first entry does work
+        Chunk* chunk = GetChunk(coord);
+        if (!chunk || !chunk->IsDirty()) continue;
+
+        chunk->Compact();
+        chunk->UpdateConnectivity();
+        chunk->UpdateOccluder();
+        chunk->SetDirty(false);
+    }
+    m_dirtyChunks.clear();
+}
+
+bool VoxelSystem::LoadTerrainTextures(Renderer::IRenderer& renderer, const std::string& directory,
+                                      const std::string& cachePath) {
+    // One tile per distinct texture name, in VoxelType order
+    Renderer::TextureAtlas atlas;
+    for (int type = 0; type < VOXEL_TYPE_COUNT; type++) {
+        const char* name = GetBlockTextureName(static_cast<VoxelType>(type));
+        if (!name) continue;
+
+        bool known = false;
+        for (int previous = 0; previous < type && !known; previous++) {
+            const char* previousName = GetBlockTextureName(static_cast<VoxelType>(previous));
+            known = previousName && std::strcmp(previousName, name) == 0;
+        }
+        if (!known && !atlas.AddFile(name, directory + "/" + name + ".png")) {
+            return false;
+        }
+    }
+
+    // BC7 keeps gradients intact at a quarter of the RGBA8 footprint
+    Renderer::TextureAtlasDesc desc;
+    desc.format = Renderer::TextureFormat::BC7SRGB;
+    if (!atlas.Build(desc, cachePath)) {
+        return false;
+    }
+
+    if (m_terrainTexture != 0) {
+        renderer.DeleteTexture(m_terrainTexture);
+    }
+    m_terrainTexture = atlas.Upload(renderer);
+    for (int type = 0; type < VOXEL_TYPE_COUNT; type++) {
+        const char* name = GetBlockTextureName(static_cast<VoxelType>(type));
+        m_blockTextureRects[type] = name ? atlas.GetTileRect(atlas.FindTile(name)) : Renderer::AtlasRect();
+    }
+    return m_terrainTexture != 0;
+}
+
+const char* VoxelSystem::GetBlockTextureName(VoxelType type) {
+    // Types without a texture of their own borrow the closest one
+    switch (type) {
+        case VoxelType::Grass: return "grass";
+        case VoxelType::Dirt: return "dirt";
+        case VoxelType::Stone: return "stone";
+        case VoxelType::Bedrock: return "stone";
+        case VoxelType::Water: return "ice";
+        case VoxelType::Sand: return "sand";
+        case VoxelType::Wood: return "wood";
+        case VoxelType::Leaves: return "leaves";
+        case VoxelType::IronOre: return "iron_ore";
+        case VoxelType::CopperOre: return "copper_ore";
+        case VoxelType::TinOre: return "tin_ore";
+        case VoxelType::Coal: return "coal_ore";
+        case VoxelType::Clay: return "dirt";
+        case VoxelType::Cobblestone: return "cobblestone";
+        case VoxelType::WoodPlanks: return "wood_planks";
+        case VoxelType::Thatch: return "thatch";
+        case VoxelType::Bricks: return "bricks";
+        case VoxelType::StoneBricks: return "bricks";
+        case VoxelType::GoldOre: return "gold_ore";
+        case VoxelType::SilverOre: return "silver_ore";
+        case VoxelType::Snow: return "snow";
+        case VoxelType::Ice: return "ice";
+        case VoxelType::Gravel: return "gravel";
+        default: return nullptr;
+    }
+}
+
+ChunkCoord VoxelSystem::WorldToChunk(int x, int y, int z) {
+    return { FloorDiv(x, CHUNK_SIZE), FloorDiv(y, CHUNK_SIZE), FloorDiv(z, CHUNK_SIZE) };
+}
+
+int VoxelSystem::FloorDiv(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
 } // namespace Game
 } // namespace SwordAndStone
@@ -0,0 +1,160 @@
+#include "platform/JobSystem.h"
+#include "platform/MemoryTracker.h"
+#include <algorithm>
+
+namespace SwordAndStone {
+namespace Platform {
+
+namespace {
+thread_local uint32_t s_threadIndex = 0;
+thread_local const JobSystem* s_threadOwner = nullptr;
+}
+
+JobSystem::JobSystem(uint32_t workerCount)
+    : m_queue(64)
+    , m_queueHead(0)
+    , m_queueSize(0)
+    , m_shutdown(false)
+{
+    if (workerCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++) {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::Run(Job job, JobCounter* counter) {
+    MemoryTagScope memoryTag(MemoryTag::Jobs);
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (m_workers.empty()) {
+        QueuedJob queued{ std::move(job), counter };
+        Execute(queued);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        PushLocked({ std::move(job), counter });
+    }
+    m_condition.notify_one();
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    while (counter.pending.load(std::memory_order_acquire) != 0) {
+        if (!TryRunOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const RangeJob& body) {
+    if (count == 0) return;
+    batchSize = std::max(1u, batchSize);
+
+    if (m_workers.empty() || count <= batchSize) {
+        body(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (uint32_t begin = 0; begin < count; begin += batchSize) {
+        uint32_t end = std::min(count, begin + batchSize);
+        Run([&body, begin, end]() { body(begin, end); }, &counter);
+    }
+    Wait(counter);
+}
+
+uint32_t JobSystem::GetThreadIndex() {
+    return s_threadIndex;
+}
+
+uint32_t JobSystem::GetLocalThreadIndex() const {
+    return s_threadOwner == this ? s_threadIndex : 0;
+}
+
+JobSystem& JobSystem::GetDefault() {
+    static JobSystem instance;
+    return instance;
+}
+
+void JobSystem::WorkerLoop(uint32_t threadIndex) {
+    s_threadIndex = threadIndex;
+    s_threadOwner = this;
+
+    while (true) {
+        QueuedJob queued;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_shutdown || m_queueSize != 0; });
+            if (m_queueSize == 0) {
+                return;
+            }
+            queued = PopLocked();
+        }
+        Execute(queued);
+    }
+}
+
+bool JobSystem::TryRunOne() {
+    QueuedJob queued;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queueSize == 0) {
+            return false;
+        }
+        queued = PopLocked();
+    }
+    Execute(queued);
+    return true;
+}
+
+void JobSystem::PushLocked(QueuedJob&& queued) {
+    if (m_queueSize == m_queue.size()) {
+        // Full; unroll into a buffer twice the size
+        std::vector<QueuedJob> grown(m_queue.size() * 2);
+        for (size_t i = 0; i < m_queueSize; i++) {
+            grown[i] = std::move(m_queue[(m_queueHead + i) % m_queue.size()]);
+        }
+        m_queue.swap(grown);
+        m_queueHead = 0;
+    }
+    m_queue[(m_queueHead + m_queueSize) % m_queue.size()] = std::move(queued);
+    m_queueSize++;
+}
+
+JobSystem::QueuedJob JobSystem::PopLocked() {
+    QueuedJob queued = std::move(m_queue[m_queueHead]);
+    m_queue[m_queueHead].job = nullptr;
+    m_queueHead = (m_queueHead + 1) % m_queue.size();
+    m_queueSize--;
+    return queued;
+}
+
+void JobSystem::Execute(QueuedJob& queued) {
+    queued.job();
+    if (queued.counter) {
+        queued.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+} // namespace Platform
+} // namespace SwordAndStone
@@ -0,0 +1,119 @@
+#include "platform/LinearArena.h"
+#include <algorithm>
+#include <new>
+
+namespace SwordAndStone {
+namespace Platform {
+
+namespace {
+
+// Blocks start on a cache line, so aligned allocations waste little padding
+constexpr size_t BLOCK_ALIGNMENT = 64;
+
+inline size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+LinearArena::LinearArena(size_t blockSize, MemoryTag tag)
+    : m_current(0)
+    , m_offset(0)
+    , m_blockSize(std::max<size_t>(blockSize, BLOCK_ALIGNMENT))
+    , m_tag(tag)
+{
+}
+
+LinearArena::~LinearArena() {
+    for (Block& block : m_blocks) {
+        MemoryTracker::Free(block.data);
+    }
+}
+
+LinearArena::Block LinearArena::AllocateBlock(size_t size) {
+    Block block;
+    block.data = static_cast<uint8_t*>(MemoryTracker::Allocate(size, m_tag, BLOCK_ALIGNMENT));
+    if (!block.data) throw std::bad_alloc();
+    block.size = size;
+    return block;
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment) {
+    if (!m_blocks.empty()) {
+        const Block& block = m_blocks[m_current];
+        size_t offset = AlignUp(reinterpret_cast<uintptr_t>(block.data) + m_offset, alignment) -
+                        reinterpret_cast<uintptr_t>(block.data);
+        if (offset + size <= block.size) {
+            m_offset = offset + size;
+            return block.data + offset;
+        }
+    }
+
+    // Move on to the next kept block, or insert a new one large enough
+    const size_t needed = size + (alignment > BLOCK_ALIGNMENT ? alignment : 0);
+    const uint32_t next = m_blocks.empty() ? 0 : m_current + 1;
+    if (next >= m_blocks.size() || m_blocks[next].size < needed) {
+        m_blocks.insert(m_blocks.begin() + next, AllocateBlock(std::max(m_blockSize, AlignUp(needed, BLOCK_ALIGNMENT))));
+    }
+    m_current = next;
+    const Block& block = m_blocks[m_current];
+    size_t offset = AlignUp(reinterpret_cast<uintptr_t>(block.data), alignment) - reinterpret_cast<uintptr_t>(block.data);
+    m_offset = offset + size;
+    return block.data + offset;
+}
+
+void LinearArena::Rewind(const Marker& marker) {
+    m_current = marker.block;
+    m_offset = marker.offset;
+}
+
+void LinearArena::Reset() {
+    if (m_blocks.size() > 1) {
+        // The last cycle overflowed; one block of the combined size holds the next one
+        size_t total = GetCapacity();
+        for (Block& block : m_blocks) {
+            MemoryTracker::Free(block.data);
+        }
+        m_blocks.clear();
+        m_blocks.push_back(AllocateBlock(total));
+    }
+    m_current = 0;
+    m_offset = 0;
+}
+
+size_t LinearArena::GetUsedBytes() const {
+    size_t used = m_offset;
+    for (uint32_t i = 0; i < m_current && i < m_blocks.size(); i++) {
+        used += m_blocks[i].size;
+    }
+    return used;
+}
+
+size_t LinearArena::GetCapacity() const {
+    size_t capacity = 0;
+    for (const Block& block : m_blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+FrameArena::FrameArena(size_t blockSize)
+    : m_arenas{ LinearArena(blockSize, MemoryTag::FrameArena), LinearArena(blockSize, MemoryTag::FrameArena) }
+    , m_current(0)
+    , m_frame(0)
+{
+}
+
+void FrameArena::BeginFrame() {
+    m_current ^= 1;
+    m_arenas[m_current].Reset();
+    m_frame++;
+}
+
+LinearArena& ScratchScope::GetThreadArena() {
+    thread_local LinearArena arena(256 * 1024, MemoryTag::Scratch);
+    return arena;
+}
+
+} // namespace Platform
+} // namespace SwordAndStone
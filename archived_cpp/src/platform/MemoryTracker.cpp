@@ -0,0 +1,261 @@
+#include "platform/MemoryTracker.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+
+namespace SwordAndStone {
+namespace Platform {
+
+namespace {
+
+// Sits immediately before every tracked pointer
+struct AllocationHeader {
+    uint64_t size;
+    uint32_t offset;  // from the malloc'd block to the user pointer
+    uint8_t tag;
+    uint8_t padding[3];
+};
+
+static_assert(sizeof(AllocationHeader) == 16, "header must keep 16-byte alignment");
+
+// Constant-initialized, so they are usable by allocations made during static initialization
+struct TagCounters {
+    std::atomic<uint64_t> liveBytes;
+    std::atomic<uint64_t> peakBytes;
+    std::atomic<uint64_t> liveAllocations;
+    std::atomic<uint64_t> totalAllocations;
+    std::atomic<uint64_t> histogram[MEMORY_HISTOGRAM_BUCKETS];
+};
+
+TagCounters g_tags[MEMORY_TAG_COUNT];
+std::atomic<uint64_t> g_liveBytes{0};
+std::atomic<uint64_t> g_peakBytes{0};
+
+thread_local MemoryTag t_currentTag = MemoryTag::Untagged;
+
+const char* const TAG_NAMES[MEMORY_TAG_COUNT] = {
+    "Untagged", "Voxels", "Tiles", "Meshes", "RenderResources", "Textures", "Entities", "Jobs", "Profiler",
+    "FrameArena", "Scratch",
+};
+
+void RaisePeak(std::atomic<uint64_t>& peak, uint64_t value) {
+    uint64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void* AllocateTracked(size_t size, MemoryTag tag, size_t alignment) {
+    if (alignment < sizeof(AllocationHeader)) alignment = sizeof(AllocationHeader);
+    const size_t extra = alignment + sizeof(AllocationHeader);
+    if (size > SIZE_MAX - extra) return nullptr;
+
+    // malloc's alignment keeps the user pointer aligned after a 16-byte header unless more is requested
+    const bool overAligned = alignment > sizeof(AllocationHeader) || alignof(std::max_align_t) < sizeof(AllocationHeader);
+    uint8_t* block = static_cast<uint8_t*>(std::malloc(size + (overAligned ? extra : sizeof(AllocationHeader))));
+    if (!block) return nullptr;
+
+    uintptr_t user = reinterpret_cast<uintptr_t>(block) + sizeof(AllocationHeader);
+    user = (user + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    AllocationHeader* header = reinterpret_cast<AllocationHeader*>(user) - 1;
+    header->size = size;
+    header->offset = static_cast<uint32_t>(user - reinterpret_cast<uintptr_t>(block));
+    header->tag = static_cast<uint8_t>(tag);
+
+    TagCounters& counters = g_tags[static_cast<int>(tag)];
+    RaisePeak(counters.peakBytes, counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    RaisePeak(g_peakBytes, g_liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.histogram[MemoryTracker::GetHistogramBucket(size)].fetch_add(1, std::memory_order_relaxed);
+    return reinterpret_cast<void*>(user);
+}
+
+void FreeTracked(void* pointer) {
+    if (!pointer) return;
+    AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+    TagCounters& counters = g_tags[header->tag];
+    counters.liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    g_liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(reinterpret_cast<uint8_t*>(pointer) - header->offset);
+}
+
+} // namespace
+
+void* MemoryTracker::Allocate(size_t size, MemoryTag tag, size_t alignment) {
+    return AllocateTracked(size, tag, alignment);
+}
+
+void MemoryTracker::Free(void* pointer) {
+    FreeTracked(pointer);
+}
+
+MemoryTag MemoryTracker::GetCurrentTag() {
+    return t_currentTag;
+}
+
+void MemoryTracker::SetCurrentTag(MemoryTag tag) {
+    t_currentTag = tag;
+}
+
+MemorySnapshot MemoryTracker::GetSnapshot() {
+    MemorySnapshot snapshot;
+    for (int i = 0; i < MEMORY_TAG_COUNT; i++) {
+        const TagCounters& counters = g_tags[i];
+        MemoryTagStats& stats = snapshot.tags[i];
+        stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+        stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+        stats.liveAllocations = counters.liveAllocations.load(std::memory_order_relaxed);
+        stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+        for (int bucket = 0; bucket < MEMORY_HISTOGRAM_BUCKETS; bucket++) {
+            stats.histogram[bucket] = counters.histogram[bucket].load(std::memory_order_relaxed);
+        }
+    }
+    snapshot.liveBytes = g_liveBytes.load(std::memory_order_relaxed);
+    snapshot.peakBytes = g_peakBytes.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void MemoryTracker::ResetPeaks() {
+    for (TagCounters& counters : g_tags) {
+        counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    g_peakBytes.store(g_liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void MemoryTracker::Dump(std::ostream& out) {
+    const MemorySnapshot snapshot = GetSnapshot();
+    char line[160];
+    std::snprintf(line, sizeof(line), "Memory: %.1f KB live, %.1f KB peak", snapshot.liveBytes / 1024.0,
+                  snapshot.peakBytes / 1024.0);
+    out << line << "\n";
+    std::snprintf(line, sizeof(line), "  %-16s %12s %12s %10s %12s", "tag", "live KB", "peak KB", "live", "total");
+    out << line << "\n";
+
+    for (int i = 0; i < MEMORY_TAG_COUNT; i++) {
+        const MemoryTagStats& stats = snapshot.tags[i];
+        if (stats.totalAllocations == 0) continue;
+        std::snprintf(line, sizeof(line), "  %-16s %12.1f %12.1f %10llu %12llu", TAG_NAMES[i], stats.liveBytes / 1024.0,
+                      stats.peakBytes / 1024.0, static_cast<unsigned long long>(stats.liveAllocations),
+                      static_cast<unsigned long long>(stats.totalAllocations));
+        out << line << "\n    sizes:";
+        for (int bucket = 0; bucket < MEMORY_HISTOGRAM_BUCKETS; bucket++) {
+            if (stats.histogram[bucket] == 0) continue;
+            const bool last = bucket == MEMORY_HISTOGRAM_BUCKETS - 1;
+            std::snprintf(line, sizeof(line), " %s%llu:%llu", last ? ">" : "<=",
+                          static_cast<unsigned long long>(16ull << (last ? bucket - 1 : bucket)),
+                          static_cast<unsigned long long>(stats.histogram[bucket]));
+            out << line;
+        }
+        out << "\n";
+    }
+    out.flush();
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag) {
+    int index = static_cast<int>(tag);
+    return index >= 0 && index < MEMORY_TAG_COUNT ? TAG_NAMES[index] : "Unknown";
+}
+
+int MemoryTracker::GetHistogramBucket(size_t size) {
+    int bucket = 0;
+    size_t limit = 16;
+    while (size > limit && bucket < MEMORY_HISTOGRAM_BUCKETS - 1) {
+        limit <<= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+bool MemoryTracker::IsTrackingGlobalNew() {
+#ifdef SWORDANDSTONE_DISABLE_GLOBAL_NEW_TRACKING
+    return false;
+#else
+    return true;
+#endif
+}
+
+} // namespace Platform
+} // namespace SwordAndStone
+
+#ifndef SWORDANDSTONE_DISABLE_GLOBAL_NEW_TRACKING
+
+// Replacement global allocation functions; every form routes through the tracker
+
+namespace {
+
+void* TrackedNew(size_t size, size_t alignment) {
+    using namespace SwordAndStone::Platform;
+    if (size == 0) size = 1;
+    while (true) {
+        if (void* pointer = MemoryTracker::Allocate(size, MemoryTracker::GetCurrentTag(), alignment)) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* TrackedNewNoThrow(size_t size, size_t alignment) noexcept {
+    try {
+        return TrackedNew(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) { return TrackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return TrackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return TrackedNewNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return TrackedNewNoThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+    return TrackedNew(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return TrackedNew(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return TrackedNewNoThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return TrackedNewNoThrow(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { SwordAndStone::Platform::MemoryTracker::Free(pointer); }
+void operator delete[](void* pointer) noexcept { SwordAndStone::Platform::MemoryTracker::Free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { SwordAndStone::Platform::MemoryTracker::Free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { SwordAndStone::Platform::MemoryTracker::Free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    SwordAndStone::Platform::MemoryTracker::Free(pointer);
+}
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    SwordAndStone::Platform::MemoryTracker::Free(pointer);
+}
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    SwordAndStone::Platform::MemoryTracker::Free(pointer);
+}
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    SwordAndStone::Platform::MemoryTracker::Free(pointer);
+}
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept {
+    SwordAndStone::Platform::MemoryTracker::Free(pointer);
+}
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept {
+    SwordAndStone::Platform::MemoryTracker::Free(pointer);
+}
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    SwordAndStone::Platform::MemoryTracker::Free(pointer);
+}
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    SwordAndStone::Platform::MemoryTracker::Free(pointer);
+}
+
+#endif
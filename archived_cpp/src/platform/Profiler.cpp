@@ -0,0 +1,400 @@
+#include "platform/Profiler.h"
+#include "platform/MemoryTracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define PROFILER_TSC 1
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#define PROFILER_TSC 1
+#include <x86intrin.h>
+#endif
+
+namespace SwordAndStone {
+namespace Platform {
+
+namespace {
+
+// Single-producer (the owning thread), single-consumer (Collect) ring
+struct ThreadRing {
+    ProfileEvent events[Profiler::RING_CAPACITY];
+    std::atomic<uint32_t> head{0};   // written by the owner
+    std::atomic<uint32_t> tail{0};   // written by the collector
+    std::atomic<bool> owned{true};   // cleared when the owning thread exits, so the ring can be reused
+    uint32_t thread = 0;
+    uint32_t openZones = 0;          // owner only: recorded begins whose ends are still to come
+};
+
+struct ProfilerState {
+    std::mutex ringMutex;  // guards the ring list, taken once per thread
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    std::mutex captureMutex;
+    std::vector<ProfileEvent> capture;
+    size_t captureCapacity = Profiler::DEFAULT_CAPTURE_CAPACITY;
+    std::vector<uint32_t> unmatchedEnds;  // per thread, scratch for trimming
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> frame{0};
+    uint64_t baseTicks = 0;
+    std::chrono::steady_clock::time_point baseTime;
+    std::once_flag calibrated;
+};
+
+// Never destroyed: worker threads may still hand back rings during static destruction
+ProfilerState& GetState() {
+    static ProfilerState* state = new ProfilerState();
+    return *state;
+}
+
+// Hands a thread's ring back for reuse when the thread exits
+struct RingOwner {
+    ThreadRing* ring = nullptr;
+    ~RingOwner() {
+        if (ring) ring->owned.store(false, std::memory_order_release);
+    }
+};
+
+thread_local RingOwner s_ringOwner;
+
+ThreadRing& AcquireRing() {
+    MemoryTagScope memoryTag(MemoryTag::Profiler);
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.ringMutex);
+    for (auto& ring : state.rings) {
+        bool owned = false;
+        if (ring->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+            ring->openZones = 0;
+            return *ring;
+        }
+    }
+    state.rings.push_back(std::unique_ptr<ThreadRing>(new ThreadRing()));
+    state.rings.back()->thread = static_cast<uint32_t>(state.rings.size() - 1);
+    return *state.rings.back();
+}
+
+void Calibrate() {
+    ProfilerState& state = GetState();
+    std::call_once(state.calibrated, [&state]() {
+        state.baseTime = std::chrono::steady_clock::now();
+        state.baseTicks = Profiler::ReadTicks();
+    });
+}
+
+void WriteJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text ? text : ""; *c; c++) {
+        switch (*c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(*c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(*c));
+                out << escaped;
+            } else {
+                out << *c;
+            }
+        }
+    }
+    out << '"';
+}
+
+template<typename T>
+void WriteValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void WriteString(std::ofstream& out, const char* text) {
+    const uint16_t length = static_cast<uint16_t>(std::min<size_t>(text ? std::char_traits<char>::length(text) : 0,
+                                                                    UINT16_MAX));
+    WriteValue(out, length);
+    out.write(text, length);
+}
+
+// Drops the oldest events beyond capacity, along with the ends of zones whose begins went with them
+void TrimCapture(ProfilerState& state) {
+    std::vector<ProfileEvent>& capture = state.capture;
+    if (capture.size() <= state.captureCapacity) return;
+
+    const size_t excess = capture.size() - state.captureCapacity;
+    std::vector<uint32_t>& unmatched = state.unmatchedEnds;
+    unmatched.clear();
+    for (size_t i = 0; i < excess; i++) {
+        const ProfileEvent& event = capture[i];
+        if (event.thread >= unmatched.size()) unmatched.resize(event.thread + 1, 0);
+        if (event.type == ProfileEventType::ZoneBegin) {
+            unmatched[event.thread]++;
+        } else if (event.type == ProfileEventType::ZoneEnd && unmatched[event.thread] > 0) {
+            unmatched[event.thread]--;
+        }
+    }
+
+    // Zones are strictly nested per thread, so the orphaned ends are the first ends that
+    // close more zones than the kept events opened
+    capture.erase(capture.begin(), capture.begin() + static_cast<std::ptrdiff_t>(excess));
+    std::vector<uint32_t> depth(unmatched.size(), 0);
+    auto kept = std::remove_if(capture.begin(), capture.end(), [&unmatched, &depth](const ProfileEvent& event) {
+        if (event.thread >= unmatched.size() || unmatched[event.thread] == 0) return false;
+        if (event.type == ProfileEventType::ZoneBegin) {
+            depth[event.thread]++;
+        } else if (event.type == ProfileEventType::ZoneEnd) {
+            if (depth[event.thread] > 0) {
+                depth[event.thread]--;
+            } else {
+                unmatched[event.thread]--;
+                return true;
+            }
+        }
+        return false;
+    });
+    capture.erase(kept, capture.end());
+}
+
+const uint32_t BINARY_MAGIC = 0x46505353;  // "SSPF"
+const uint32_t BINARY_VERSION = 1;
+const uint32_t NO_SOURCE = 0xFFFFFFFF;
+
+} // namespace
+
+std::atomic<bool> Profiler::s_enabled{false};
+
+void Profiler::SetEnabled(bool enabled) {
+    if (enabled) Calibrate();
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::ReadTicks() {
+#ifdef PROFILER_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+double Profiler::GetTicksPerSecond() {
+#ifdef PROFILER_TSC
+    // The TSC rate is measured against the steady clock over the time since calibration
+    Calibrate();
+    ProfilerState& state = GetState();
+    std::chrono::duration<double> elapsed;
+    uint64_t ticks;
+    do {
+        ticks = ReadTicks();
+        elapsed = std::chrono::steady_clock::now() - state.baseTime;
+        if (elapsed.count() < 0.005) std::this_thread::yield();
+    } while (elapsed.count() < 0.005);
+    return static_cast<double>(ticks - state.baseTicks) / elapsed.count();
+#else
+    return 1e9;
+#endif
+}
+
+bool Profiler::Record(ProfileEventType type, const void* source, double value) {
+    if (!s_ringOwner.ring) {
+        s_ringOwner.ring = &AcquireRing();
+    }
+    ThreadRing& ring = *s_ringOwner.ring;
+
+    // Slots are held back for the ends of open zones, so an end always fits once its begin did
+    uint32_t reserved = 0;
+    if (type == ProfileEventType::ZoneEnd) {
+        ring.openZones -= ring.openZones > 0 ? 1 : 0;
+    } else {
+        reserved = ring.openZones + (type == ProfileEventType::ZoneBegin ? 1 : 0);
+    }
+    const uint32_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) + reserved >= RING_CAPACITY) {
+        GetState().dropped.fetch_add(type == ProfileEventType::ZoneBegin ? 2 : 1, std::memory_order_relaxed);
+        return false;
+    }
+    if (type == ProfileEventType::ZoneBegin) {
+        ring.openZones++;
+    }
+    ProfileEvent& event = ring.events[head & (RING_CAPACITY - 1)];
+    event.ticks = ReadTicks();
+    event.source = source;
+    event.value = value;
+    event.thread = ring.thread;
+    event.type = type;
+    ring.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool Profiler::BeginZone(const ProfileZone* zone) {
+    return Record(ProfileEventType::ZoneBegin, zone, 0.0);
+}
+
+void Profiler::EndZone(const ProfileZone* zone) {
+    Record(ProfileEventType::ZoneEnd, zone, 0.0);
+}
+
+void Profiler::Counter(const char* name, double value) {
+    Record(ProfileEventType::Counter, name, value);
+}
+
+void Profiler::FrameMark() {
+    uint64_t frame = GetState().frame.fetch_add(1, std::memory_order_relaxed);
+    Record(ProfileEventType::FrameMark, nullptr, static_cast<double>(frame));
+}
+
+void Profiler::Collect() {
+    MemoryTagScope memoryTag(MemoryTag::Profiler);
+    ProfilerState& state = GetState();
+    std::vector<ThreadRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(state.ringMutex);
+        for (auto& ring : state.rings) rings.push_back(ring.get());
+    }
+
+    std::lock_guard<std::mutex> lock(state.captureMutex);
+    const size_t collected = state.capture.size();
+    for (ThreadRing* ring : rings) {
+        const uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+        const uint32_t head = ring->head.load(std::memory_order_acquire);
+        for (uint32_t i = tail; i != head; i++) {
+            state.capture.push_back(ring->events[i & (RING_CAPACITY - 1)]);
+        }
+        ring->tail.store(head, std::memory_order_release);
+    }
+    // Rings drain one after another; merge the new events into the capture's single timeline
+    auto earlier = [](const ProfileEvent& a, const ProfileEvent& b) { return a.ticks < b.ticks; };
+    auto middle = state.capture.begin() + static_cast<std::ptrdiff_t>(collected);
+    std::stable_sort(middle, state.capture.end(), earlier);
+    // Only the tail of the capture can overlap the new events
+    if (middle != state.capture.end()) {
+        auto overlap = std::upper_bound(state.capture.begin(), middle, *middle, earlier);
+        std::inplace_merge(overlap, middle, state.capture.end(), earlier);
+    }
+    TrimCapture(state);
+}
+
+void Profiler::SetCaptureCapacity(size_t events) {
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.captureMutex);
+    state.captureCapacity = events;
+    TrimCapture(state);
+}
+
+const std::vector<ProfileEvent>& Profiler::GetEvents() {
+    return GetState().capture;
+}
+
+void Profiler::Clear() {
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.captureMutex);
+    state.capture.clear();
+    state.dropped.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::GetDroppedCount() {
+    return GetState().dropped.load(std::memory_order_relaxed);
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path) {
+    Collect();
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.captureMutex);
+    const double microsecondsPerTick = 1e6 / GetTicksPerSecond();
+    const uint64_t origin = state.capture.empty() ? 0 : state.capture.front().ticks;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char timestamp[32];
+    for (const ProfileEvent& event : state.capture) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        std::snprintf(timestamp, sizeof(timestamp), "%.3f", static_cast<double>(event.ticks - origin) * microsecondsPerTick);
+
+        out << "{\"pid\":0,\"tid\":" << event.thread << ",\"ts\":" << timestamp << ",";
+        switch (event.type) {
+        case ProfileEventType::ZoneBegin: {
+            const ProfileZone* zone = static_cast<const ProfileZone*>(event.source);
+            out << "\"ph\":\"B\",\"name\":";
+            WriteJsonString(out, zone->name);
+            out << ",\"args\":{\"file\":";
+            WriteJsonString(out, zone->file);
+            out << ",\"line\":" << zone->line << "}}";
+            break;
+        }
+        case ProfileEventType::ZoneEnd:
+            out << "\"ph\":\"E\",\"name\":";
+            WriteJsonString(out, static_cast<const ProfileZone*>(event.source)->name);
+            out << "}";
+            break;
+        case ProfileEventType::Counter:
+            out << "\"ph\":\"C\",\"name\":";
+            WriteJsonString(out, static_cast<const char*>(event.source));
+            out << ",\"args\":{\"value\":" << event.value << "}}";
+            break;
+        case ProfileEventType::FrameMark:
+            out << "\"ph\":\"i\",\"s\":\"g\",\"name\":\"Frame\",\"args\":{\"frame\":"
+                << static_cast<uint64_t>(event.value) << "}}";
+            break;
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+bool Profiler::ExportBinary(const std::string& path) {
+    Collect();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    ProfilerState& state = GetState();
+    std::lock_guard<std::mutex> lock(state.captureMutex);
+
+    // Zones and counters are written once in a source table; events refer to them by index
+    std::unordered_map<const void*, uint32_t> sourceIndices;
+    std::vector<const ProfileEvent*> sources;
+    for (const ProfileEvent& event : state.capture) {
+        if (event.source && sourceIndices.emplace(event.source, static_cast<uint32_t>(sources.size())).second) {
+            sources.push_back(&event);
+        }
+    }
+
+    WriteValue(out, BINARY_MAGIC);
+    WriteValue(out, BINARY_VERSION);
+    WriteValue(out, GetTicksPerSecond());
+    WriteValue(out, static_cast<uint32_t>(sources.size()));
+    for (const ProfileEvent* event : sources) {
+        if (event->type == ProfileEventType::Counter) {
+            WriteString(out, static_cast<const char*>(event->source));
+            WriteString(out, "");
+            WriteValue(out, uint32_t(0));
+        } else {
+            const ProfileZone* zone = static_cast<const ProfileZone*>(event->source);
+            WriteString(out, zone->name);
+            WriteString(out, zone->file);
+            WriteValue(out, zone->line);
+        }
+    }
+
+    // Per event: ticks, source index, thread, type, value (counters and frame marks only)
+    WriteValue(out, static_cast<uint64_t>(state.capture.size()));
+    for (const ProfileEvent& event : state.capture) {
+        WriteValue(out, event.ticks);
+        WriteValue(out, event.source ? sourceIndices[event.source] : NO_SOURCE);
+        WriteValue(out, static_cast<uint16_t>(event.thread));
+        WriteValue(out, static_cast<uint8_t>(event.type));
+        if (event.type == ProfileEventType::Counter || event.type == ProfileEventType::FrameMark) {
+            WriteValue(out, event.value);
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace Platform
+} // namespace SwordAndStone
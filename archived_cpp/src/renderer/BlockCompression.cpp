@@ -0,0 +1,626 @@
+#include "renderer/BlockCompression.h"
+#include "platform/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define BLOCK_COMPRESSION_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace SwordAndStone {
+namespace Renderer {
+
+namespace {
+
+// BC7 interpolation weights for 4-bit indices, out of 64
+const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// One block's texels as floats, structure of arrays for four-wide index search
+struct BlockTexels {
+    alignas(16) float channel[4][16];  // r, g, b, a
+};
+
+void LoadBlock(const uint8_t* texels, BlockTexels& block) {
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            block.channel[c][i] = texels[i * 4 + c];
+        }
+    }
+}
+
+int RoundToInt(float value, int maxValue) {
+    return std::min(std::max(static_cast<int>(value + 0.5f), 0), maxValue);
+}
+
+// Mean and principal axis (power iteration on the covariance) of the first dims channels
+void PrincipalAxis(const BlockTexels& block, int dims, float mean[4], float axis[4]) {
+    for (int c = 0; c < 4; c++) {
+        float sum = 0.0f;
+        for (int i = 0; i < 16; i++) sum += block.channel[c][i];
+        mean[c] = sum / 16.0f;
+        axis[c] = c < dims ? 1.0f : 0.0f;
+    }
+
+    float covariance[4][4] = {};
+    for (int i = 0; i < 16; i++) {
+        for (int a = 0; a < dims; a++) {
+            for (int b = a; b < dims; b++) {
+                covariance[a][b] += (block.channel[a][i] - mean[a]) * (block.channel[b][i] - mean[b]);
+            }
+        }
+    }
+    for (int a = 0; a < dims; a++) {
+        for (int b = 0; b < a; b++) covariance[a][b] = covariance[b][a];
+    }
+
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[4] = {};
+        float length = 0.0f;
+        for (int a = 0; a < dims; a++) {
+            for (int b = 0; b < dims; b++) next[a] += covariance[a][b] * axis[b];
+            length = std::max(length, std::fabs(next[a]));
+        }
+        // A flat block has no preferred direction; keep the current guess
+        if (length < 1e-6f) break;
+        for (int a = 0; a < dims; a++) axis[a] = next[a] / length;
+    }
+
+    float length = 0.0f;
+    for (int a = 0; a < dims; a++) length += axis[a] * axis[a];
+    length = std::sqrt(length);
+    for (int a = 0; a < dims; a++) axis[a] /= length;
+}
+
+// Projection range of the block onto the axis, relative to the mean
+void ProjectRange(const BlockTexels& block, int dims, const float mean[4], const float axis[4],
+                  float& minProjection, float& maxProjection) {
+    minProjection = 1e30f;
+    maxProjection = -1e30f;
+    for (int i = 0; i < 16; i++) {
+        float projection = 0.0f;
+        for (int c = 0; c < dims; c++) projection += (block.channel[c][i] - mean[c]) * axis[c];
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+}
+
+// Least-squares endpoints for fixed per-texel weights of endpoint 0; false if degenerate
+bool FitEndpoints(const BlockTexels& block, int dims, const float weights[16], float endpoint0[4], float endpoint1[4]) {
+    float a11 = 0.0f, a12 = 0.0f, a22 = 0.0f;
+    float rhs0[4] = {}, rhs1[4] = {};
+    for (int i = 0; i < 16; i++) {
+        float w = weights[i];
+        a11 += w * w;
+        a12 += w * (1.0f - w);
+        a22 += (1.0f - w) * (1.0f - w);
+        for (int c = 0; c < dims; c++) {
+            rhs0[c] += w * block.channel[c][i];
+            rhs1[c] += (1.0f - w) * block.channel[c][i];
+        }
+    }
+    float determinant = a11 * a22 - a12 * a12;
+    if (std::fabs(determinant) < 1e-6f) return false;
+
+    for (int c = 0; c < dims; c++) {
+        endpoint0[c] = (a22 * rhs0[c] - a12 * rhs1[c]) / determinant;
+        endpoint1[c] = (a11 * rhs1[c] - a12 * rhs0[c]) / determinant;
+    }
+    return true;
+}
+
+// ---- BC1 colour ------------------------------------------------------------
+
+uint16_t PackRGB565(const float color[3]) {
+    int r = RoundToInt(color[0] * 31.0f / 255.0f, 31);
+    int g = RoundToInt(color[1] * 63.0f / 255.0f, 63);
+    int b = RoundToInt(color[2] * 31.0f / 255.0f, 31);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void UnpackRGB565(uint16_t value, int color[3]) {
+    int r = (value >> 11) & 31;
+    int g = (value >> 5) & 63;
+    int b = value & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+// Nearest of four palette colours per texel; returns the summed squared error
+float SelectColorIndices(const BlockTexels& block, const float palette[4][3], uint8_t indices[16]) {
+    float error = 0.0f;
+
+#ifdef BLOCK_COMPRESSION_SSE
+    for (int i = 0; i < 16; i += 4) {
+        __m128 r = _mm_load_ps(block.channel[0] + i);
+        __m128 g = _mm_load_ps(block.channel[1] + i);
+        __m128 b = _mm_load_ps(block.channel[2] + i);
+        __m128 best = _mm_set1_ps(1e30f);
+        __m128 bestIndex = _mm_setzero_ps();
+        for (int k = 0; k < 4; k++) {
+            __m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette[k][0]));
+            __m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette[k][1]));
+            __m128 db = _mm_sub_ps(b, _mm_set1_ps(palette[k][2]));
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+            __m128 closer = _mm_cmplt_ps(distance, best);
+            best = _mm_min_ps(distance, best);
+            bestIndex = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(static_cast<float>(k))),
+                                  _mm_andnot_ps(closer, bestIndex));
+        }
+
+        alignas(16) float distances[4];
+        alignas(16) float chosen[4];
+        _mm_store_ps(distances, best);
+        _mm_store_ps(chosen, bestIndex);
+        for (int lane = 0; lane < 4; lane++) {
+            indices[i + lane] = static_cast<uint8_t>(chosen[lane]);
+            error += distances[lane];
+        }
+    }
+#else
+    for (int i = 0; i < 16; i++) {
+        float best = 1e30f;
+        for (int k = 0; k < 4; k++) {
+            float dr = block.channel[0][i] - palette[k][0];
+            float dg = block.channel[1][i] - palette[k][1];
+            float db = block.channel[2][i] - palette[k][2];
+            float distance = dr * dr + dg * dg + db * db;
+            if (distance < best) {
+                best = distance;
+                indices[i] = static_cast<uint8_t>(k);
+            }
+        }
+        error += best;
+    }
+#endif
+
+    return error;
+}
+
+float EvaluateColorEndpoints(const BlockTexels& block, uint16_t color0, uint16_t color1, uint8_t indices[16]) {
+    int c0[3], c1[3];
+    UnpackRGB565(color0, c0);
+    UnpackRGB565(color1, c1);
+
+    float palette[4][3];
+    for (int c = 0; c < 3; c++) {
+        palette[0][c] = static_cast<float>(c0[c]);
+        palette[1][c] = static_cast<float>(c1[c]);
+        palette[2][c] = static_cast<float>((2 * c0[c] + c1[c]) / 3);
+        palette[3][c] = static_cast<float>((c0[c] + 2 * c1[c]) / 3);
+    }
+    return SelectColorIndices(block, palette, indices);
+}
+
+// Four-colour BC1 block: endpoints from the principal axis, refined once by least squares
+void EncodeColorBlock(const BlockTexels& block, uint8_t* out) {
+    float mean[4], axis[4];
+    PrincipalAxis(block, 3, mean, axis);
+    float minProjection, maxProjection;
+    ProjectRange(block, 3, mean, axis, minProjection, maxProjection);
+
+    float endpoint0[4], endpoint1[4];
+    for (int c = 0; c < 3; c++) {
+        endpoint0[c] = mean[c] + axis[c] * maxProjection;
+        endpoint1[c] = mean[c] + axis[c] * minProjection;
+    }
+    uint16_t color0 = PackRGB565(endpoint0);
+    uint16_t color1 = PackRGB565(endpoint1);
+    uint8_t indices[16];
+    float error = EvaluateColorEndpoints(block, color0, color1, indices);
+
+    // Palette weight of endpoint 0 for each index
+    const float paletteWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    float weights[16];
+    for (int i = 0; i < 16; i++) weights[i] = paletteWeights[indices[i]];
+    if (FitEndpoints(block, 3, weights, endpoint0, endpoint1)) {
+        uint16_t refined0 = PackRGB565(endpoint0);
+        uint16_t refined1 = PackRGB565(endpoint1);
+        uint8_t refinedIndices[16];
+        float refinedError = EvaluateColorEndpoints(block, refined0, refined1, refinedIndices);
+        if (refinedError < error) {
+            color0 = refined0;
+            color1 = refined1;
+            memcpy(indices, refinedIndices, sizeof(indices));
+        }
+    }
+
+    // Four-colour mode needs color0 > color1; swapping exchanges indices 0/1 and 2/3
+    if (color0 < color1) {
+        std::swap(color0, color1);
+        for (uint8_t& index : indices) index ^= 1;
+    } else if (color0 == color1) {
+        memset(indices, 0, sizeof(indices));
+    }
+
+    uint32_t packed = 0;
+    for (int i = 0; i < 16; i++) {
+        packed |= static_cast<uint32_t>(indices[i]) << (i * 2);
+    }
+    out[0] = static_cast<uint8_t>(color0);
+    out[1] = static_cast<uint8_t>(color0 >> 8);
+    out[2] = static_cast<uint8_t>(color1);
+    out[3] = static_cast<uint8_t>(color1 >> 8);
+    for (int i = 0; i < 4; i++) {
+        out[4 + i] = static_cast<uint8_t>(packed >> (i * 8));
+    }
+}
+
+void DecodeColorBlock(const uint8_t* block, uint8_t* texels, bool alwaysFourColor) {
+    uint16_t color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+    uint16_t color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+    int c0[3], c1[3];
+    UnpackRGB565(color0, c0);
+    UnpackRGB565(color1, c1);
+
+    uint8_t palette[4][4];
+    for (int c = 0; c < 3; c++) {
+        palette[0][c] = static_cast<uint8_t>(c0[c]);
+        palette[1][c] = static_cast<uint8_t>(c1[c]);
+        if (alwaysFourColor || color0 > color1) {
+            palette[2][c] = static_cast<uint8_t>((2 * c0[c] + c1[c]) / 3);
+            palette[3][c] = static_cast<uint8_t>((c0[c] + 2 * c1[c]) / 3);
+        } else {
+            palette[2][c] = static_cast<uint8_t>((c0[c] + c1[c]) / 2);
+            palette[3][c] = 0;
+        }
+    }
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    palette[3][3] = (alwaysFourColor || color0 > color1) ? 255 : 0;
+
+    uint32_t packed = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+    for (int i = 0; i < 16; i++) {
+        memcpy(texels + i * 4, palette[(packed >> (i * 2)) & 3], 4);
+    }
+}
+
+// ---- BC3 alpha -------------------------------------------------------------
+
+void EncodeAlphaBlock(const BlockTexels& block, uint8_t* out) {
+    float minAlpha = 255.0f, maxAlpha = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        minAlpha = std::min(minAlpha, block.channel[3][i]);
+        maxAlpha = std::max(maxAlpha, block.channel[3][i]);
+    }
+
+    // alpha0 > alpha1 selects eight levels: 0 and 1 are the ends, 2..7 step from alpha0 to alpha1
+    out[0] = static_cast<uint8_t>(maxAlpha);
+    out[1] = static_cast<uint8_t>(minAlpha);
+    uint64_t packed = 0;
+    if (maxAlpha > minAlpha) {
+        float scale = 7.0f / (maxAlpha - minAlpha);
+        for (int i = 0; i < 16; i++) {
+            int step = RoundToInt((maxAlpha - block.channel[3][i]) * scale, 7);
+            uint64_t index = step == 0 ? 0 : (step == 7 ? 1 : step + 1);
+            packed |= index << (i * 3);
+        }
+    }
+    for (int i = 0; i < 6; i++) {
+        out[2 + i] = static_cast<uint8_t>(packed >> (i * 8));
+    }
+}
+
+void DecodeAlphaBlock(const uint8_t* block, uint8_t* texels) {
+    int alpha0 = block[0];
+    int alpha1 = block[1];
+    uint8_t palette[8];
+    palette[0] = static_cast<uint8_t>(alpha0);
+    palette[1] = static_cast<uint8_t>(alpha1);
+    if (alpha0 > alpha1) {
+        for (int i = 1; i < 7; i++) {
+            palette[i + 1] = static_cast<uint8_t>(((7 - i) * alpha0 + i * alpha1) / 7);
+        }
+    } else {
+        for (int i = 1; i < 5; i++) {
+            palette[i + 1] = static_cast<uint8_t>(((5 - i) * alpha0 + i * alpha1) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t packed = 0;
+    for (int i = 0; i < 6; i++) {
+        packed |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+    }
+    for (int i = 0; i < 16; i++) {
+        texels[i * 4 + 3] = palette[(packed >> (i * 3)) & 7];
+    }
+}
+
+// ---- BC7 mode 6 ------------------------------------------------------------
+
+struct BitWriter {
+    uint8_t* bytes;
+    uint32_t position;
+
+    void Write(uint32_t value, uint32_t bits) {
+        for (uint32_t i = 0; i < bits; i++, position++) {
+            if ((value >> i) & 1) bytes[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+        }
+    }
+};
+
+struct BitReader {
+    const uint8_t* bytes;
+    uint32_t position;
+
+    uint32_t Read(uint32_t bits) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < bits; i++, position++) {
+            value |= static_cast<uint32_t>((bytes[position >> 3] >> (position & 7)) & 1) << i;
+        }
+        return value;
+    }
+};
+
+// 7-bit endpoint plus the p-bit (shared lowest bit) that reconstructs it best
+void QuantizeBC7Endpoint(const float endpoint[4], int quantized[4], int& pBit) {
+    float bestError = 1e30f;
+    for (int p = 0; p < 2; p++) {
+        int candidate[4];
+        float error = 0.0f;
+        for (int c = 0; c < 4; c++) {
+            candidate[c] = RoundToInt((endpoint[c] - p) * 0.5f, 127);
+            float difference = static_cast<float>((candidate[c] << 1) | p) - endpoint[c];
+            error += difference * difference;
+        }
+        if (error < bestError) {
+            bestError = error;
+            pBit = p;
+            memcpy(quantized, candidate, sizeof(candidate));
+        }
+    }
+}
+
+// Index per texel by projecting onto the endpoint segment
+void SelectBC7Indices(const BlockTexels& block, const int endpoint0[4], const int endpoint1[4], uint8_t indices[16]) {
+    float delta[4];
+    float lengthSquared = 0.0f;
+    for (int c = 0; c < 4; c++) {
+        delta[c] = static_cast<float>(endpoint1[c] - endpoint0[c]);
+        lengthSquared += delta[c] * delta[c];
+    }
+    if (lengthSquared == 0.0f) {
+        memset(indices, 0, 16);
+        return;
+    }
+    const float scale = 15.0f / lengthSquared;
+
+#ifdef BLOCK_COMPRESSION_SSE
+    for (int i = 0; i < 16; i += 4) {
+        __m128 projection = _mm_setzero_ps();
+        for (int c = 0; c < 4; c++) {
+            __m128 offset = _mm_sub_ps(_mm_load_ps(block.channel[c] + i), _mm_set1_ps(static_cast<float>(endpoint0[c])));
+            projection = _mm_add_ps(projection, _mm_mul_ps(offset, _mm_set1_ps(delta[c])));
+        }
+        __m128 t = _mm_mul_ps(projection, _mm_set1_ps(scale));
+        t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(15.0f));
+        alignas(16) int32_t rounded[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(rounded), _mm_cvtps_epi32(t));
+        for (int lane = 0; lane < 4; lane++) {
+            indices[i + lane] = static_cast<uint8_t>(rounded[lane]);
+        }
+    }
+#else
+    for (int i = 0; i < 16; i++) {
+        float projection = 0.0f;
+        for (int c = 0; c < 4; c++) {
+            projection += (block.channel[c][i] - endpoint0[c]) * delta[c];
+        }
+        indices[i] = static_cast<uint8_t>(RoundToInt(projection * scale, 15));
+    }
+#endif
+}
+
+struct BC7Fit {
+    int quantized[2][4];  // 7-bit endpoints
+    int pBits[2];
+    uint8_t indices[16];
+    float error;
+};
+
+// Quantizes float endpoints, picks indices and measures the decoded error
+void FitBC7(const BlockTexels& block, float endpoints[2][4], BC7Fit& fit) {
+    int reconstructed[2][4];
+    for (int e = 0; e < 2; e++) {
+        for (int c = 0; c < 4; c++) {
+            endpoints[e][c] = std::min(std::max(endpoints[e][c], 0.0f), 255.0f);
+        }
+        QuantizeBC7Endpoint(endpoints[e], fit.quantized[e], fit.pBits[e]);
+        for (int c = 0; c < 4; c++) {
+            reconstructed[e][c] = (fit.quantized[e][c] << 1) | fit.pBits[e];
+        }
+    }
+    SelectBC7Indices(block, reconstructed[0], reconstructed[1], fit.indices);
+
+    fit.error = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        int weight = BC7_WEIGHTS[fit.indices[i]];
+        for (int c = 0; c < 4; c++) {
+            int value = ((64 - weight) * reconstructed[0][c] + weight * reconstructed[1][c] + 32) >> 6;
+            float difference = value - block.channel[c][i];
+            fit.error += difference * difference;
+        }
+    }
+}
+
+void DecodeBlocks(const uint8_t* data, uint32_t width, uint32_t height, uint32_t blockSize,
+                  void (*decode)(const uint8_t*, uint8_t*), std::vector<uint8_t>& pixels) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    pixels.resize(static_cast<size_t>(width) * height * 4);
+
+    uint8_t texels[64];
+    for (uint32_t by = 0; by < blocksY; by++) {
+        for (uint32_t bx = 0; bx < blocksX; bx++) {
+            decode(data + (static_cast<size_t>(by) * blocksX + bx) * blockSize, texels);
+            for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++) {
+                uint32_t columns = std::min(4u, width - bx * 4);
+                memcpy(&pixels[((static_cast<size_t>(by) * 4 + y) * width + bx * 4) * 4], texels + y * 16, columns * 4);
+            }
+        }
+    }
+}
+
+} // namespace
+
+void EncodeBC1Block(const uint8_t* texels, uint8_t* block) {
+    BlockTexels loaded;
+    LoadBlock(texels, loaded);
+    EncodeColorBlock(loaded, block);
+}
+
+void EncodeBC3Block(const uint8_t* texels, uint8_t* block) {
+    BlockTexels loaded;
+    LoadBlock(texels, loaded);
+    EncodeAlphaBlock(loaded, block);
+    EncodeColorBlock(loaded, block + 8);
+}
+
+void EncodeBC7Block(const uint8_t* texels, uint8_t* block) {
+    BlockTexels loaded;
+    LoadBlock(texels, loaded);
+
+    float mean[4], axis[4];
+    PrincipalAxis(loaded, 4, mean, axis);
+    float minProjection, maxProjection;
+    ProjectRange(loaded, 4, mean, axis, minProjection, maxProjection);
+
+    float endpoints[2][4];
+    for (int c = 0; c < 4; c++) {
+        endpoints[0][c] = mean[c] + axis[c] * minProjection;
+        endpoints[1][c] = mean[c] + axis[c] * maxProjection;
+    }
+    BC7Fit fit;
+    FitBC7(loaded, endpoints, fit);
+
+    // Least-squares refinement against the chosen indices while it keeps helping
+    for (int iteration = 0; iteration < 2; iteration++) {
+        float weights[16];
+        for (int i = 0; i < 16; i++) weights[i] = 1.0f - BC7_WEIGHTS[fit.indices[i]] / 64.0f;
+        if (!FitEndpoints(loaded, 4, weights, endpoints[0], endpoints[1])) break;
+
+        BC7Fit refined;
+        FitBC7(loaded, endpoints, refined);
+        if (refined.error >= fit.error) break;
+        fit = refined;
+    }
+
+    // The anchor (first) index is stored without its top bit, so it must be below 8
+    if (fit.indices[0] >= 8) {
+        std::swap(fit.quantized[0], fit.quantized[1]);
+        std::swap(fit.pBits[0], fit.pBits[1]);
+        for (uint8_t& index : fit.indices) index = static_cast<uint8_t>(15 - index);
+    }
+
+    memset(block, 0, 16);
+    BitWriter writer = { block, 0 };
+    writer.Write(1u << 6, 7);  // mode 6
+    for (int c = 0; c < 4; c++) {
+        writer.Write(static_cast<uint32_t>(fit.quantized[0][c]), 7);
+        writer.Write(static_cast<uint32_t>(fit.quantized[1][c]), 7);
+    }
+    writer.Write(static_cast<uint32_t>(fit.pBits[0]), 1);
+    writer.Write(static_cast<uint32_t>(fit.pBits[1]), 1);
+    writer.Write(fit.indices[0], 3);
+    for (int i = 1; i < 16; i++) {
+        writer.Write(fit.indices[i], 4);
+    }
+}
+
+void DecodeBC1Block(const uint8_t* block, uint8_t* texels) {
+    DecodeColorBlock(block, texels, false);
+}
+
+void DecodeBC3Block(const uint8_t* block, uint8_t* texels) {
+    DecodeColorBlock(block + 8, texels, true);
+    DecodeAlphaBlock(block, texels);
+}
+
+void DecodeBC7Block(const uint8_t* block, uint8_t* texels) {
+    if ((block[0] & 0x7F) != 0x40) {
+        for (int i = 0; i < 16; i++) {
+            texels[i * 4] = 255;
+            texels[i * 4 + 1] = 0;
+            texels[i * 4 + 2] = 255;
+            texels[i * 4 + 3] = 255;
+        }
+        return;
+    }
+
+    BitReader reader = { block, 7 };
+    int endpoints[2][4];
+    for (int c = 0; c < 4; c++) {
+        endpoints[0][c] = static_cast<int>(reader.Read(7)) << 1;
+        endpoints[1][c] = static_cast<int>(reader.Read(7)) << 1;
+    }
+    int pBit0 = static_cast<int>(reader.Read(1));
+    int pBit1 = static_cast<int>(reader.Read(1));
+    for (int c = 0; c < 4; c++) {
+        endpoints[0][c] |= pBit0;
+        endpoints[1][c] |= pBit1;
+    }
+
+    for (int i = 0; i < 16; i++) {
+        int weight = BC7_WEIGHTS[reader.Read(i == 0 ? 3 : 4)];
+        for (int c = 0; c < 4; c++) {
+            texels[i * 4 + c] = static_cast<uint8_t>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+        }
+    }
+}
+
+bool CompressTexture(const uint8_t* pixels, uint32_t width, uint32_t height, TextureFormat format,
+                     std::vector<uint8_t>& output, Platform::JobSystem* jobSystem) {
+    const uint32_t blockSize = GetCompressedBlockSize(format);
+    if (blockSize == 0 || !pixels || width == 0 || height == 0) return false;
+
+    void (*encode)(const uint8_t*, uint8_t*) = EncodeBC1Block;
+    if (format == TextureFormat::BC3 || format == TextureFormat::BC3SRGB) {
+        encode = EncodeBC3Block;
+    } else if (format == TextureFormat::BC7 || format == TextureFormat::BC7SRGB) {
+        encode = EncodeBC7Block;
+    }
+
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    output.resize(GetTextureDataSize(width, height, format));
+
+    Platform::JobSystem& jobs = jobSystem ? *jobSystem : Platform::JobSystem::GetDefault();
+    uint8_t* blocks = output.data();
+    jobs.ParallelFor(blocksY, 1, [&](uint32_t begin, uint32_t end) {
+        uint8_t texels[64];
+        for (uint32_t by = begin; by < end; by++) {
+            for (uint32_t bx = 0; bx < blocksX; bx++) {
+                for (uint32_t y = 0; y < 4; y++) {
+                    uint32_t sy = std::min(by * 4 + y, height - 1);
+                    for (uint32_t x = 0; x < 4; x++) {
+                        uint32_t sx = std::min(bx * 4 + x, width - 1);
+                        memcpy(texels + (y * 4 + x) * 4, pixels + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+                    }
+                }
+                encode(texels, blocks + (static_cast<size_t>(by) * blocksX + bx) * blockSize);
+            }
+        }
+    });
+    return true;
+}
+
+bool DecompressTexture(const uint8_t* data, uint32_t width, uint32_t height, TextureFormat format,
+                       std::vector<uint8_t>& pixels) {
+    const uint32_t blockSize = GetCompressedBlockSize(format);
+    if (blockSize == 0 || !data) return false;
+
+    void (*decode)(const uint8_t*, uint8_t*) = DecodeBC1Block;
+    if (format == TextureFormat::BC3 || format == TextureFormat::BC3SRGB) {
+        decode = DecodeBC3Block;
+    } else if (format == TextureFormat::BC7 || format == TextureFormat::BC7SRGB) {
+        decode = DecodeBC7Block;
+    }
+    DecodeBlocks(data, width, height, blockSize, decode, pixels);
+    return true;
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
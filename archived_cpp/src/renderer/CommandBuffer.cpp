@@ -0,0 +1,227 @@
+#include "renderer/CommandBuffer.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+#include <cstring>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+namespace SortKey {
+
+uint64_t Make(uint32_t pass, uint32_t shader, uint32_t texture, uint32_t depth) {
+    uint64_t key = 0;
+    key |= static_cast<uint64_t>(pass & ((1u << PASS_BITS) - 1)) << 60;
+    key |= static_cast<uint64_t>(shader & ((1u << SHADER_BITS) - 1)) << 44;
+    key |= static_cast<uint64_t>(texture & ((1u << TEXTURE_BITS) - 1)) << 28;
+    key |= static_cast<uint64_t>(depth & ((1u << DEPTH_BITS) - 1)) << 4;
+    return key;
+}
+
+uint32_t QuantizeDepth(float depth, bool backToFront) {
+    const uint32_t maxDepth = (1u << DEPTH_BITS) - 1;
+    float clamped = std::min(1.0f, std::max(0.0f, depth));
+    uint32_t quantized = static_cast<uint32_t>(clamped * static_cast<float>(maxDepth));
+    return backToFront ? maxDepth - quantized : quantized;
+}
+
+} // namespace SortKey
+
+RenderStateCache::RenderStateCache()
+    : m_shader(0)
+    , m_state(0)
+    , m_shaderValid(false)
+    , m_textureValid(0)
+    , m_stateValid(0)
+    , m_bindsSkipped(0)
+{
+    memset(m_textures, 0, sizeof(m_textures));
+}
+
+void RenderStateCache::Invalidate() {
+    m_shaderValid = false;
+    m_textureValid = 0;
+    m_stateValid = 0;
+}
+
+void RenderStateCache::BindShader(IRenderer& renderer, uint32_t shader) {
+    if (m_shaderValid && m_shader == shader) {
+        m_bindsSkipped++;
+        return;
+    }
+    renderer.BindShader(shader);
+    m_shader = shader;
+    m_shaderValid = true;
+}
+
+void RenderStateCache::BindTexture(IRenderer& renderer, uint32_t slot, uint32_t texture) {
+    if (slot >= MAX_TEXTURE_SLOTS) {
+        renderer.BindTexture(slot, texture);
+        return;
+    }
+    if ((m_textureValid & (1u << slot)) && m_textures[slot] == texture) {
+        m_bindsSkipped++;
+        return;
+    }
+    renderer.BindTexture(slot, texture);
+    m_textures[slot] = texture;
+    m_textureValid |= 1u << slot;
+}
+
+void RenderStateCache::SetState(IRenderer& renderer, uint8_t state) {
+    const uint8_t flags[] = { StateDepthTest, StateBlending, StateCulling };
+    for (uint8_t flag : flags) {
+        bool enabled = (state & flag) != 0;
+        if ((m_stateValid & flag) && ((m_state & flag) != 0) == enabled) {
+            m_bindsSkipped++;
+            continue;
+        }
+
+        switch (flag) {
+            case StateDepthTest: renderer.SetDepthTest(enabled); break;
+            case StateBlending: renderer.SetBlending(enabled); break;
+            case StateCulling: renderer.SetCulling(enabled); break;
+        }
+        m_state = enabled ? (m_state | flag) : (m_state & ~flag);
+        m_stateValid |= flag;
+    }
+}
+
+void CommandBuffer::Reserve(size_t count) {
+    m_commands.reserve(count);
+    m_order.reserve(count);
+    m_orderScratch.reserve(count);
+    m_keys.reserve(count);
+    m_keysScratch.reserve(count);
+}
+
+void CommandBuffer::DrawIndexed(uint64_t key, uint32_t shader, uint32_t texture, uint32_t vertexBuffer,
+                                uint32_t indexBuffer, uint32_t indexCount, uint8_t state,
+                                PrimitiveTopology topology) {
+    m_commands.push_back({ key, shader, texture, vertexBuffer, indexBuffer, indexCount, topology, state });
+}
+
+void CommandBuffer::Draw(uint64_t key, uint32_t shader, uint32_t texture, uint32_t vertexBuffer,
+                         uint32_t vertexCount, uint8_t state, PrimitiveTopology topology) {
+    m_commands.push_back({ key, shader, texture, vertexBuffer, 0, vertexCount, topology, state });
+}
+
+void CommandBuffer::MultiDrawIndexed(uint64_t key, uint32_t shader, uint32_t texture, uint32_t vertexBuffer,
+                                     uint32_t indexBuffer, const IndirectDrawCommand* commands, uint32_t drawCount,
+                                     uint8_t state, PrimitiveTopology topology) {
+    if (drawCount == 0) return;
+
+    uint32_t first = static_cast<uint32_t>(m_indirectCommands.size());
+    m_indirectCommands.insert(m_indirectCommands.end(), commands, commands + drawCount);
+    m_commands.push_back({ key, shader, texture, vertexBuffer, indexBuffer, drawCount, topology, state, first });
+}
+
+void CommandBuffer::DrawIndexedInstanced(uint64_t key, uint32_t shader, uint32_t texture, uint32_t vertexBuffer,
+                                         uint32_t indexBuffer, uint32_t indexCount, uint32_t instanceBuffer,
+                                         uint32_t instanceOffset, uint32_t instanceCount, uint8_t state,
+                                         PrimitiveTopology topology) {
+    if (instanceCount == 0) return;
+
+    DrawCommand command = { key, shader, texture, vertexBuffer, indexBuffer, indexCount, topology, state };
+    command.instanceBuffer = instanceBuffer;
+    command.instanceOffset = instanceOffset;
+    command.instanceCount = instanceCount;
+    m_commands.push_back(command);
+}
+
+const std::vector<uint32_t>& CommandBuffer::Sort() {
+    const uint32_t count = static_cast<uint32_t>(m_commands.size());
+    m_order.resize(count);
+    m_orderScratch.resize(count);
+    m_keys.resize(count);
+    m_keysScratch.resize(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        m_order[i] = i;
+        m_keys[i] = m_commands[i].key;
+    }
+
+    // LSD radix sort, one byte per pass; all histograms are built up front
+    uint32_t histograms[8][256] = {};
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t key = m_keys[i];
+        for (int pass = 0; pass < 8; pass++) {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    for (int pass = 0; pass < 8; pass++) {
+        uint32_t* histogram = histograms[pass];
+        uint32_t shift = pass * 8;
+
+        // A byte shared by every key leaves the order unchanged
+        if (count == 0 || histogram[(m_keys[0] >> shift) & 0xFF] == count) continue;
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t destination = histogram[(m_keys[i] >> shift) & 0xFF]++;
+            m_keysScratch[destination] = m_keys[i];
+            m_orderScratch[destination] = m_order[i];
+        }
+        m_keys.swap(m_keysScratch);
+        m_order.swap(m_orderScratch);
+    }
+
+    return m_order;
+}
+
+void CommandBuffer::Prepare() {
+    Sort();
+    m_prepared = true;
+}
+
+void CommandBuffer::Execute(IRenderer& renderer) {
+    PROFILE_ZONE("CommandBuffer::Execute");
+    m_stats = RenderStats();
+    m_stateCache.Invalidate();
+    m_stateCache.ResetCounters();
+
+    if (!m_prepared || m_order.size() != m_commands.size()) {
+        Sort();
+    }
+    m_prepared = false;
+
+    for (uint32_t index : m_order) {
+        const DrawCommand& command = m_commands[index];
+        m_stateCache.SetState(renderer, command.state);
+        m_stateCache.BindShader(renderer, command.shader);
+        m_stateCache.BindTexture(renderer, 0, command.texture);
+
+        if (command.instanceCount != 0) {
+            renderer.DrawIndexedInstanced(command.vertexBuffer, command.indexBuffer, command.count,
+                                          command.instanceBuffer, command.instanceOffset, command.instanceCount,
+                                          command.topology);
+        } else if (command.firstIndirect != DrawCommand::NO_INDIRECT) {
+            renderer.MultiDrawIndexed(command.vertexBuffer, command.indexBuffer,
+                                      &m_indirectCommands[command.firstIndirect], command.count, command.topology);
+        } else if (command.indexBuffer != 0) {
+            renderer.DrawIndexed(command.vertexBuffer, command.indexBuffer, command.count, command.topology);
+        } else {
+            renderer.Draw(command.vertexBuffer, command.count, command.topology);
+        }
+        m_stats.drawCalls++;
+    }
+
+    m_stats.commandsSorted = static_cast<uint32_t>(m_commands.size());
+    m_stats.bindsSkipped = m_stateCache.GetBindsSkipped();
+    m_stats.frustumCulled = m_frustumCulled;
+    m_stats.occlusionCulled = m_occlusionCulled;
+    renderer.AddCommandStats(m_stats);
+    m_frustumCulled = 0;
+    m_occlusionCulled = 0;
+    m_commands.clear();
+    m_indirectCommands.clear();
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
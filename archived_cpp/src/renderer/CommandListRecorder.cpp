@@ -0,0 +1,94 @@
+#include "renderer/CommandListRecorder.h"
+#include "platform/JobSystem.h"
+#include "platform/LinearArena.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+CommandListRecorder::CommandListRecorder(Platform::JobSystem* jobSystem)
+    : m_jobSystem(jobSystem)
+    , m_frameArena(nullptr)
+    , m_recorded(false)
+{
+}
+
+void CommandListRecorder::AddPass(RecordFunction record) {
+    m_tasks.push_back({ std::move(record), -1, 0, 0 });
+    m_recorded = false;
+}
+
+void CommandListRecorder::AddParallelPass(uint32_t count, uint32_t batchSize, RangeRecordFunction record) {
+    if (count == 0) return;
+
+    batchSize = std::max(1u, batchSize);
+    const int32_t shared = static_cast<int32_t>(m_rangeRecords.size());
+    m_rangeRecords.push_back(std::move(record));
+    for (uint32_t begin = 0; begin < count; begin += batchSize) {
+        m_tasks.push_back({ nullptr, shared, begin, std::min(count, begin + batchSize) });
+    }
+    m_recorded = false;
+}
+
+void CommandListRecorder::Record() {
+    PROFILE_ZONE("CommandListRecorder::Record");
+    const uint32_t taskCount = static_cast<uint32_t>(m_tasks.size());
+    while (m_lists.size() < taskCount) {
+        m_lists.push_back(std::make_unique<CommandBuffer>());
+    }
+
+    // One task per job: each writes only its own list, so no locking is needed
+    Platform::JobSystem& jobs = m_jobSystem ? *m_jobSystem : Platform::JobSystem::GetDefault();
+    jobs.ParallelFor(taskCount, 1, [this](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            const Task& task = m_tasks[i];
+            CommandBuffer& list = *m_lists[i];
+            list.Clear();
+            if (task.rangeRecord >= 0) {
+                m_rangeRecords[task.rangeRecord](list, task.begin, task.end);
+            } else {
+                task.record(list);
+            }
+            list.Prepare();
+        }
+    });
+    m_recorded = true;
+}
+
+void CommandListRecorder::Submit(IRenderer& renderer) {
+    PROFILE_ZONE("CommandListRecorder::Submit");
+    if (!m_recorded) {
+        Record();
+    }
+
+    const uint32_t count = static_cast<uint32_t>(m_tasks.size());
+    CommandBuffer** submitted;
+    if (m_frameArena) {
+        submitted = m_frameArena->AllocateArray<CommandBuffer*>(count);
+    } else {
+        m_submitted.resize(count);
+        submitted = m_submitted.data();
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        submitted[i] = m_lists[i].get();
+    }
+    renderer.ExecuteCommandLists(submitted, count);
+
+    m_stats = RenderStats();
+    for (uint32_t i = 0; i < count; i++) {
+        const RenderStats& stats = submitted[i]->GetStats();
+        m_stats.drawCalls += stats.drawCalls;
+        m_stats.commandsSorted += stats.commandsSorted;
+        m_stats.bindsSkipped += stats.bindsSkipped;
+        m_stats.frustumCulled += stats.frustumCulled;
+        m_stats.occlusionCulled += stats.occlusionCulled;
+    }
+
+    m_tasks.clear();
+    m_rangeRecords.clear();
+    m_recorded = false;
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -1,4 +1,9 @@
 #include "renderer/DirectX11Renderer.h"
+#include "renderer/CommandBuffer.h"
+#include "platform/MemoryTracker.h"
+#include <d3dcompiler.h>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
 
 #ifdef ENABLE_DX11
@@ -6,10 +11,53 @@
 namespace SwordAndStone {
 namespace Renderer {
 
+namespace {
+
+// Slot 0 streams Vertex; slot 1 streams InstanceData once per instance, as
+// INSTANCE_TRANSFORM0..2 (the rows of the affine transform) and INSTANCE_COLOR
+const D3D11_INPUT_ELEMENT_DESC INPUT_ELEMENTS[] = {
+    { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, offsetof(Vertex, position), D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, offsetof(Vertex, normal), D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, offsetof(Vertex, texcoord), D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, offsetof(Vertex, color), D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    { "INSTANCE_TRANSFORM", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(InstanceData, transform),
+      D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INSTANCE_TRANSFORM", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(InstanceData, transform) + 16,
+      D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INSTANCE_TRANSFORM", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(InstanceData, transform) + 32,
+      D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "INSTANCE_COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(InstanceData, color),
+      D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+};
+constexpr UINT VERTEX_ELEMENT_COUNT = 4;
+constexpr UINT INSTANCED_ELEMENT_COUNT = 8;
+
+ComPtr<ID3DBlob> CompileShader(const std::string& source, const char* target) {
+    ComPtr<ID3DBlob> bytecode;
+    ComPtr<ID3DBlob> errors;
+    HRESULT hr = D3DCompile(source.data(), source.size(), nullptr, nullptr, nullptr, "main", target, 0, 0,
+                            bytecode.GetAddressOf(), errors.GetAddressOf());
+    if (FAILED(hr)) {
+        std::cerr << "Failed to compile " << target << " shader";
+        if (errors) {
+            std::cerr << ": " << static_cast<const char*>(errors->GetBufferPointer());
+        }
+        std::cerr << std::endl;
+        return nullptr;
+    }
+    return bytecode;
+}
+
+} // namespace
+
 DirectX11Renderer::DirectX11Renderer()
     : m_width(0)
     , m_height(0)
     , m_nextID(1)
+    , m_currentShader(0)
+    , m_streamingBuffer(0)
+    , m_submittedFence(0)
+    , m_completedFence(0)
 {
     m_clearColor[0] = 0.2f;
     m_clearColor[1] = 0.3f;
@@ -82,11 +130,17 @@ bool DirectX11Renderer::Initialize(void* windowHandle, uint32_t width, uint32_t
     // Set viewport
     SetViewport(0, 0, width, height);
     
+    if (!CreateStreamingBuffer(DEFAULT_STREAMING_CAPACITY)) {
+        std::cerr << "Failed to create D3D11 streaming buffer" << std::endl;
+        return false;
+    }
+    
     std::cout << "DirectX 11 Renderer initialized" << std::endl;
     return true;
 }
 
 void DirectX11Renderer::Shutdown() {
+    DestroyStreamingBuffer();
     m_buffers.clear();
     m_textures.clear();
     m_textureSRVs.clear();
@@ -121,9 +175,15 @@ void DirectX11Renderer::Resize(uint32_t width, uint32_t height) {
 
 void DirectX11Renderer::BeginFrame() {
     m_stats = RenderStats();
+    RetireStreamingFrames();
 }
 
 void DirectX11Renderer::EndFrame() {
+    if (m_streamingBuffer) {
+        uint64_t fence = ++m_submittedFence;
+        m_context->End(m_frameQueries[fence % FENCE_SLOTS].Get());
+        m_streaming.EndFrame(fence);
+    }
 }
 
 void DirectX11Renderer::Present() {
@@ -174,6 +234,7 @@ void DirectX11Renderer::SetScissor(int x, int y, uint32_t width, uint32_t height
 }
 
 uint32_t DirectX11Renderer::CreateVertexBuffer(const void* data, size_t size, BufferUsage usage) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
     D3D11_BUFFER_DESC bd = {};
     bd.Usage = ConvertBufferUsage(usage);
     bd.ByteWidth = static_cast<UINT>(size);
@@ -196,6 +257,7 @@ uint32_t DirectX11Renderer::CreateVertexBuffer(const void* data, size_t size, Bu
 }
 
 uint32_t DirectX11Renderer::CreateIndexBuffer(const uint32_t* data, size_t count, BufferUsage usage) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
     D3D11_BUFFER_DESC bd = {};
     bd.Usage = ConvertBufferUsage(usage);
     bd.ByteWidth = static_cast<UINT>(count * sizeof(uint32_t));
@@ -221,8 +283,26 @@ void DirectX11Renderer::UpdateVertexBuffer(uint32_t buffer, const void* data, si
     auto it = m_buffers.find(buffer);
     if (it == m_buffers.end()) return;
     
+    D3D11_BUFFER_DESC desc;
+    it->second->GetDesc(&desc);
+    if (offset > desc.ByteWidth || size > desc.ByteWidth - offset) return;
+    
+    if (desc.Usage == D3D11_USAGE_DEFAULT) {
+        D3D11_BOX box = {};
+        box.left = static_cast<UINT>(offset);
+        box.right = static_cast<UINT>(offset + size);
+        box.bottom = 1;
+        box.back = 1;
+        m_context->UpdateSubresource(it->second.Get(), 0, &box, data, 0, 0);
+        return;
+    }
+    
+    // Discarding hands back fresh memory, so only a write of the whole buffer may do it;
+    // a partial write keeps the rest and must not touch data the GPU is still reading
+    const bool whole = offset == 0 && size == desc.ByteWidth;
     D3D11_MAPPED_SUBRESOURCE mapped;
-    if (SUCCEEDED(m_context->Map(it->second.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+    if (SUCCEEDED(m_context->Map(it->second.Get(), 0, whole ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE,
+                                 0, &mapped))) {
         memcpy(static_cast<char*>(mapped.pData) + offset, data, size);
         m_context->Unmap(it->second.Get(), 0);
     }
@@ -232,6 +312,61 @@ void DirectX11Renderer::DeleteBuffer(uint32_t buffer) {
     m_buffers.erase(buffer);
 }
 
+StreamingAllocation DirectX11Renderer::AllocateStreaming(size_t size, size_t alignment) {
+    return m_streaming.Allocate(size, alignment);
+}
+
+void DirectX11Renderer::CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) {
+    if (!source || source.buffer != m_streamingBuffer) return;
+    
+    auto ringIt = m_buffers.find(m_streamingBuffer);
+    auto dstIt = m_buffers.find(buffer);
+    if (ringIt == m_buffers.end() || dstIt == m_buffers.end()) return;
+    
+    // Dynamic buffers cannot be copy destinations; they are updated through UpdateVertexBuffer
+    D3D11_BUFFER_DESC desc;
+    dstIt->second->GetDesc(&desc);
+    if (desc.Usage != D3D11_USAGE_DEFAULT || offset > desc.ByteWidth || source.size > desc.ByteWidth - offset) {
+        return;
+    }
+    if (!UploadStreaming(source.offset, source.size)) return;
+    
+    D3D11_BOX box = {};
+    box.left = static_cast<UINT>(source.offset);
+    box.right = static_cast<UINT>(source.offset + source.size);
+    box.bottom = 1;
+    box.back = 1;
+    m_context->CopySubresourceRegion(dstIt->second.Get(), 0, static_cast<UINT>(offset), 0, 0,
+                                     ringIt->second.Get(), 0, &box);
+    m_stats.bytesStreamed += source.size;
+}
+
+void DirectX11Renderer::CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                                   size_t size) {
+    auto srcIt = m_buffers.find(source);
+    auto dstIt = m_buffers.find(destination);
+    if (srcIt == m_buffers.end() || dstIt == m_buffers.end() || source == destination) return;
+    
+    // CopySubresourceRegion needs a DEFAULT destination and a different source subresource
+    D3D11_BUFFER_DESC srcDesc;
+    D3D11_BUFFER_DESC dstDesc;
+    srcIt->second->GetDesc(&srcDesc);
+    dstIt->second->GetDesc(&dstDesc);
+    if (dstDesc.Usage != D3D11_USAGE_DEFAULT || sourceOffset > srcDesc.ByteWidth ||
+        size > srcDesc.ByteWidth - sourceOffset || destinationOffset > dstDesc.ByteWidth ||
+        size > dstDesc.ByteWidth - destinationOffset) {
+        return;
+    }
+    
+    D3D11_BOX box = {};
+    box.left = static_cast<UINT>(sourceOffset);
+    box.right = static_cast<UINT>(sourceOffset + size);
+    box.bottom = 1;
+    box.back = 1;
+    m_context->CopySubresourceRegion(dstIt->second.Get(), 0, static_cast<UINT>(destinationOffset), 0, 0,
+                                     srcIt->second.Get(), 0, &box);
+}
+
 uint32_t DirectX11Renderer::CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) {
     // TODO: Implement texture creation
     return 0;
@@ -254,17 +389,41 @@ void DirectX11Renderer::BindTexture(uint32_t slot, uint32_t texture) {
 }
 
 uint32_t DirectX11Renderer::CreateShader(const std::string& vertexSource, const std::string& fragmentSource) {
-    // TODO: Implement shader creation
-    return 0;
+    ComPtr<ID3DBlob> vertexBytecode = CompileShader(vertexSource, "vs_5_0");
+    ComPtr<ID3DBlob> pixelBytecode = CompileShader(fragmentSource, "ps_5_0");
+    if (!vertexBytecode || !pixelBytecode) return 0;
+    
+    ShaderData data;
+    if (FAILED(m_device->CreateVertexShader(vertexBytecode->GetBufferPointer(), vertexBytecode->GetBufferSize(),
+                                            nullptr, data.vertexShader.GetAddressOf())) ||
+        FAILED(m_device->CreatePixelShader(pixelBytecode->GetBufferPointer(), pixelBytecode->GetBufferSize(),
+                                           nullptr, data.pixelShader.GetAddressOf()))) {
+        return 0;
+    }
+    
+    // Either layout may fail validation: a shader reading instance inputs has no plain
+    // layout, and one reading only vertex inputs still gets an instanced layout
+    m_device->CreateInputLayout(INPUT_ELEMENTS, VERTEX_ELEMENT_COUNT, vertexBytecode->GetBufferPointer(),
+                                vertexBytecode->GetBufferSize(), data.inputLayout.GetAddressOf());
+    m_device->CreateInputLayout(INPUT_ELEMENTS, INSTANCED_ELEMENT_COUNT, vertexBytecode->GetBufferPointer(),
+                                vertexBytecode->GetBufferSize(), data.instancedLayout.GetAddressOf());
+    
+    uint32_t id = m_nextID++;
+    m_shaders[id] = data;
+    return id;
 }
 
 void DirectX11Renderer::DeleteShader(uint32_t shader) {
     m_shaders.erase(shader);
+    if (shader == m_currentShader) {
+        m_currentShader = 0;
+    }
 }
 
 void DirectX11Renderer::BindShader(uint32_t shader) {
     auto it = m_shaders.find(shader);
     if (it != m_shaders.end()) {
+        m_currentShader = shader;
         m_context->VSSetShader(it->second.vertexShader.Get(), nullptr, 0);
         m_context->PSSetShader(it->second.pixelShader.Get(), nullptr, 0);
     }
@@ -274,6 +433,10 @@ void DirectX11Renderer::SetShaderUniform(uint32_t shader, const std::string& nam
     // TODO: Implement uniform setting
 }
 
+void DirectX11Renderer::SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) {
+    SetShaderUniform(shader, GetUniformName(uniform), data, size);
+}
+
 void DirectX11Renderer::DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount, 
                                     PrimitiveTopology topology) {
     auto vbIt = m_buffers.find(vertexBuffer);
@@ -289,9 +452,7 @@ void DirectX11Renderer::DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer,
     m_context->IASetIndexBuffer(ibIt->second.Get(), DXGI_FORMAT_R32_UINT, 0);
     m_context->IASetPrimitiveTopology(ConvertTopology(topology));
     
-    if (m_inputLayout) {
-        m_context->IASetInputLayout(m_inputLayout.Get());
-    }
+    if (!BindInputLayout(false)) return;
     
     m_context->DrawIndexed(indexCount, 0, 0);
     
@@ -310,9 +471,7 @@ void DirectX11Renderer::Draw(uint32_t vertexBuffer, uint32_t vertexCount, Primit
     m_context->IASetVertexBuffers(0, 1, &vb, &stride, &offset);
     m_context->IASetPrimitiveTopology(ConvertTopology(topology));
     
-    if (m_inputLayout) {
-        m_context->IASetInputLayout(m_inputLayout.Get());
-    }
+    if (!BindInputLayout(false)) return;
     
     m_context->Draw(vertexCount, 0);
     
@@ -320,6 +479,78 @@ void DirectX11Renderer::Draw(uint32_t vertexBuffer, uint32_t vertexCount, Primit
     m_stats.vertices += vertexCount;
 }
 
+void DirectX11Renderer::MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer,
+                                         const IndirectDrawCommand* commands, uint32_t drawCount,
+                                         PrimitiveTopology topology) {
+    auto vbIt = m_buffers.find(vertexBuffer);
+    auto ibIt = m_buffers.find(indexBuffer);
+    
+    if (vbIt == m_buffers.end() || ibIt == m_buffers.end() || drawCount == 0) return;
+    
+    UINT stride = sizeof(Vertex);
+    UINT offset = 0;
+    ID3D11Buffer* vb = vbIt->second.Get();
+    
+    m_context->IASetVertexBuffers(0, 1, &vb, &stride, &offset);
+    m_context->IASetIndexBuffer(ibIt->second.Get(), DXGI_FORMAT_R32_UINT, 0);
+    m_context->IASetPrimitiveTopology(ConvertTopology(topology));
+    
+    if (!BindInputLayout(false)) return;
+    
+    // Per-draw loop; the input assembler is only configured once for the batch
+    for (uint32_t i = 0; i < drawCount; i++) {
+        const IndirectDrawCommand& command = commands[i];
+        m_context->DrawIndexedInstanced(command.indexCount, command.instanceCount, command.firstIndex,
+                                        command.baseVertex, command.baseInstance);
+        m_stats.triangles += (topology == PrimitiveTopology::TriangleList) ?
+                             command.indexCount / 3 * command.instanceCount : 0;
+    }
+    
+    m_stats.drawCalls += drawCount;
+    m_stats.multiDrawCommands += drawCount;
+}
+
+void DirectX11Renderer::DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                                             uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                                             PrimitiveTopology topology) {
+    auto vbIt = m_buffers.find(vertexBuffer);
+    auto ibIt = m_buffers.find(indexBuffer);
+    auto instanceIt = m_buffers.find(instanceBuffer);
+    
+    if (vbIt == m_buffers.end() || ibIt == m_buffers.end() || instanceIt == m_buffers.end() || instanceCount == 0) return;
+    if (!BindInputLayout(true)) return;
+    
+    // Instances written to the streaming ring only exist in the shadow until uploaded
+    size_t instanceBytes = static_cast<size_t>(instanceCount) * sizeof(InstanceData);
+    if (instanceBuffer == m_streamingBuffer) {
+        if (!UploadStreaming(instanceOffset, instanceBytes)) return;
+        m_stats.bytesStreamed += instanceBytes;
+    }
+    
+    // Slot 1 carries the per-instance stream
+    ID3D11Buffer* buffers[2] = { vbIt->second.Get(), instanceIt->second.Get() };
+    UINT strides[2] = { sizeof(Vertex), sizeof(InstanceData) };
+    UINT offsets[2] = { 0, static_cast<UINT>(instanceOffset) };
+    
+    m_context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+    m_context->IASetIndexBuffer(ibIt->second.Get(), DXGI_FORMAT_R32_UINT, 0);
+    m_context->IASetPrimitiveTopology(ConvertTopology(topology));
+    
+    m_context->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, 0);
+    
+    m_stats.drawCalls++;
+    m_stats.instancesDrawn += instanceCount;
+    m_stats.triangles += (topology == PrimitiveTopology::TriangleList) ? indexCount / 3 * instanceCount : 0;
+}
+
+void DirectX11Renderer::ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) {
+    // Emulated: deferred contexts only help drivers that support command lists natively,
+    // so lists recorded on workers are replayed on the immediate context
+    for (uint32_t i = 0; i < count; i++) {
+        lists[i]->Execute(*this);
+    }
+}
+
 void DirectX11Renderer::SetDepthTest(bool enabled) {
     if (enabled) {
         m_context->OMSetDepthStencilState(m_depthStencilStateEnabled.Get(), 0);
@@ -353,6 +584,96 @@ void DirectX11Renderer::SetWireframe(bool enabled) {
     }
 }
 
+bool DirectX11Renderer::BindInputLayout(bool instanced) {
+    auto it = m_shaders.find(m_currentShader);
+    if (it == m_shaders.end()) return false;
+    
+    ID3D11InputLayout* layout = instanced ? it->second.instancedLayout.Get() : it->second.inputLayout.Get();
+    if (!layout) return false;
+    m_context->IASetInputLayout(layout);
+    return true;
+}
+
+bool DirectX11Renderer::CreateStreamingBuffer(size_t capacity) {
+    D3D11_BUFFER_DESC bd = {};
+    bd.Usage = D3D11_USAGE_DYNAMIC;
+    bd.ByteWidth = static_cast<UINT>(capacity);
+    bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    
+    ComPtr<ID3D11Buffer> buffer;
+    if (FAILED(m_device->CreateBuffer(&bd, nullptr, buffer.GetAddressOf()))) {
+        return false;
+    }
+    
+    D3D11_QUERY_DESC queryDesc = {};
+    queryDesc.Query = D3D11_QUERY_EVENT;
+    for (uint32_t i = 0; i < FENCE_SLOTS; i++) {
+        if (FAILED(m_device->CreateQuery(&queryDesc, m_frameQueries[i].ReleaseAndGetAddressOf()))) {
+            return false;
+        }
+    }
+    
+    // The first map of a dynamic buffer must discard; every later one appends without overwriting
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (FAILED(m_context->Map(buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        return false;
+    }
+    m_context->Unmap(buffer.Get(), 0);
+    
+    m_streamingBuffer = m_nextID++;
+    m_buffers[m_streamingBuffer] = buffer;
+    m_streamingShadow.assign(capacity, 0);
+    m_streaming.Initialize(m_streamingShadow.data(), capacity, m_streamingBuffer);
+    return true;
+}
+
+void DirectX11Renderer::DestroyStreamingBuffer() {
+    if (!m_streamingBuffer) return;
+    
+    for (uint32_t i = 0; i < FENCE_SLOTS; i++) {
+        m_frameQueries[i].Reset();
+    }
+    m_buffers.erase(m_streamingBuffer);
+    m_streaming.Initialize(nullptr, 0, 0);
+    m_streamingShadow.clear();
+    m_streamingBuffer = 0;
+    m_submittedFence = m_completedFence = 0;
+}
+
+void DirectX11Renderer::RetireStreamingFrames() {
+    while (m_completedFence < m_submittedFence) {
+        uint64_t fence = m_completedFence + 1;
+        ID3D11Query* query = m_frameQueries[fence % FENCE_SLOTS].Get();
+        
+        // Only block when every ring frame is still in flight
+        bool wait = m_submittedFence - m_completedFence >= StreamingRingBuffer::FRAME_COUNT;
+        HRESULT hr = m_context->GetData(query, nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH);
+        if (hr == S_FALSE && wait) {
+            m_stats.streamingStalls++;
+            do {
+                hr = m_context->GetData(query, nullptr, 0, 0);
+            } while (hr == S_FALSE);
+        }
+        if (hr == S_FALSE) break;
+        
+        m_completedFence = fence;
+    }
+    m_streaming.Retire(m_completedFence);
+}
+
+bool DirectX11Renderer::UploadStreaming(size_t offset, size_t size) {
+    if (offset > m_streamingShadow.size() || size > m_streamingShadow.size() - offset) return false;
+    
+    // The ring never hands out a range the GPU may still be reading, so appending cannot stall
+    ID3D11Buffer* ring = m_buffers[m_streamingBuffer].Get();
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (FAILED(m_context->Map(ring, 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped))) return false;
+    memcpy(static_cast<uint8_t*>(mapped.pData) + offset, m_streamingShadow.data() + offset, size);
+    m_context->Unmap(ring, 0);
+    return true;
+}
+
 bool DirectX11Renderer::CreateRenderTarget() {
     ComPtr<ID3D11Texture2D> backBuffer;
     HRESULT hr = m_swapChain->GetBuffer(0, IID_PPV_ARGS(backBuffer.GetAddressOf()));
@@ -442,10 +763,17 @@ DXGI_FORMAT DirectX11Renderer::ConvertTextureFormat(TextureFormat format) {
     switch (format) {
         case TextureFormat::RGBA8: return DXGI_FORMAT_R8G8B8A8_UNORM;
         case TextureFormat::RGB8: return DXGI_FORMAT_R8G8B8A8_UNORM;  // D3D11 doesn't have RGB8
+        case TextureFormat::SRGBA8: return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
         case TextureFormat::RGBA16F: return DXGI_FORMAT_R16G16B16A16_FLOAT;
         case TextureFormat::RGBA32F: return DXGI_FORMAT_R32G32B32A32_FLOAT;
         case TextureFormat::Depth24Stencil8: return DXGI_FORMAT_D24_UNORM_S8_UINT;
         case TextureFormat::Depth32F: return DXGI_FORMAT_D32_FLOAT;
+        case TextureFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+        case TextureFormat::BC1SRGB: return DXGI_FORMAT_BC1_UNORM_SRGB;
+        case TextureFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+        case TextureFormat::BC3SRGB: return DXGI_FORMAT_BC3_UNORM_SRGB;
+        case TextureFormat::BC7: return DXGI_FORMAT_BC7_UNORM;
+        case TextureFormat::BC7SRGB: return DXGI_FORMAT_BC7_UNORM_SRGB;
         default: return DXGI_FORMAT_R8G8B8A8_UNORM;
     }
 }
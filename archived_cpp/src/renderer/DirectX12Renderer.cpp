@@ -1,4 +1,6 @@
 #include "renderer/DirectX12Renderer.h"
+#include "renderer/CommandBuffer.h"
+#include "platform/JobSystem.h"
 #include <iostream>
 
 #ifdef ENABLE_DX12
@@ -6,6 +8,28 @@
 namespace SwordAndStone {
 namespace Renderer {
 
+namespace {
+
+// Set by a job while it records a CommandBuffer into a deferred list
+struct RecordingContext {
+    const DirectX12Renderer* renderer = nullptr;
+    ID3D12GraphicsCommandList* list = nullptr;
+    RenderStats* stats = nullptr;
+};
+
+thread_local RecordingContext t_recording;
+
+// Adds the counters the draw paths and AddCommandStats keep while a deferred list records
+void MergeRecordedStats(RenderStats& stats, const RenderStats& recorded) {
+    stats.drawCalls += recorded.drawCalls;
+    stats.triangles += recorded.triangles;
+    stats.multiDrawCommands += recorded.multiDrawCommands;
+    stats.instancesDrawn += recorded.instancesDrawn;
+    AccumulateCommandStats(stats, recorded);
+}
+
+} // namespace
+
 DirectX12Renderer::DirectX12Renderer()
     : m_width(0)
     , m_height(0)
@@ -14,6 +38,8 @@ DirectX12Renderer::DirectX12Renderer()
     , m_srvDescriptorSize(0)
     , m_nextID(1)
     , m_fenceEvent(nullptr)
+    , m_streamingBuffer(0)
+    , m_recordedListsUsed(0)
 {
     m_clearColor[0] = 0.2f;
     m_clearColor[1] = 0.3f;
@@ -85,6 +111,11 @@ bool DirectX12Renderer::Initialize(void* windowHandle, uint32_t width, uint32_t
         return false;
     }
     
+    if (!CreateStreamingBuffer(DEFAULT_STREAMING_CAPACITY)) {
+        std::cerr << "Failed to create streaming buffer" << std::endl;
+        return false;
+    }
+    
     // Set viewport and scissor
     m_viewport.TopLeftX = 0;
     m_viewport.TopLeftY = 0;
@@ -104,6 +135,7 @@ bool DirectX12Renderer::Initialize(void* windowHandle, uint32_t width, uint32_t
 
 void DirectX12Renderer::Shutdown() {
     WaitForGPU();
+    DestroyStreamingBuffer();
     
     if (m_fenceEvent) {
         CloseHandle(m_fenceEvent);
@@ -113,6 +145,7 @@ void DirectX12Renderer::Shutdown() {
     m_buffers.clear();
     m_textures.clear();
     m_pipelineStates.clear();
+    m_recordedLists.clear();
     
     std::cout << "DirectX 12 Renderer shut down" << std::endl;
 }
@@ -125,6 +158,8 @@ void DirectX12Renderer::Resize(uint32_t width, uint32_t height) {
 
 void DirectX12Renderer::BeginFrame() {
     m_stats = RenderStats();
+    m_recordedListsUsed = 0;
+    m_streaming.Retire(m_fence->GetCompletedValue());
     
     // Reset command allocator and list
     m_commandAllocators[m_frameIndex]->Reset();
@@ -140,18 +175,7 @@ void DirectX12Renderer::BeginFrame() {
     
     m_commandList->ResourceBarrier(1, &barrier);
     
-    // Set render target
-    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle;
-    rtvHandle.ptr = m_rtvHeap->GetCPUDescriptorHandleForHeapStart().ptr + 
-                    m_frameIndex * m_rtvDescriptorSize;
-    
-    D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = m_dsvHeap->GetCPUDescriptorHandleForHeapStart();
-    
-    m_commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
-    
-    // Set viewport and scissor
-    m_commandList->RSSetViewports(1, &m_viewport);
-    m_commandList->RSSetScissorRects(1, &m_scissorRect);
+    SetFrameTargets(m_commandList.Get());
 }
 
 void DirectX12Renderer::EndFrame() {
@@ -171,6 +195,9 @@ void DirectX12Renderer::EndFrame() {
     // Execute command list
     ID3D12CommandList* commandLists[] = { m_commandList.Get() };
     m_commandQueue->ExecuteCommandLists(1, commandLists);
+    
+    // MoveToNextFrame signals this value once the frame is queued
+    m_streaming.EndFrame(m_fenceValues[m_frameIndex]);
 }
 
 void DirectX12Renderer::Present() {
@@ -187,7 +214,7 @@ void DirectX12Renderer::Clear(uint32_t flags, float r, float g, float b, float a
         D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle;
         rtvHandle.ptr = m_rtvHeap->GetCPUDescriptorHandleForHeapStart().ptr + 
                         m_frameIndex * m_rtvDescriptorSize;
-        m_commandList->ClearRenderTargetView(rtvHandle, color, 0, nullptr);
+        GetRecordingList()->ClearRenderTargetView(rtvHandle, color, 0, nullptr);
     }
     
     if ((flags & ClearDepth) || (flags & ClearStencil)) {
@@ -196,7 +223,7 @@ void DirectX12Renderer::Clear(uint32_t flags, float r, float g, float b, float a
         if (flags & ClearStencil) clearFlags |= D3D12_CLEAR_FLAG_STENCIL;
         
         D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = m_dsvHeap->GetCPUDescriptorHandleForHeapStart();
-        m_commandList->ClearDepthStencilView(dsvHandle, clearFlags, 1.0f, 0, 0, nullptr);
+        GetRecordingList()->ClearDepthStencilView(dsvHandle, clearFlags, 1.0f, 0, 0, nullptr);
     }
 }
 
@@ -240,6 +267,30 @@ void DirectX12Renderer::DeleteBuffer(uint32_t buffer) {
     m_buffers.erase(buffer);
 }
 
+StreamingAllocation DirectX12Renderer::AllocateStreaming(size_t size, size_t alignment) {
+    return m_streaming.Allocate(size, alignment);
+}
+
+void DirectX12Renderer::CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) {
+    if (!source || source.buffer != m_streamingBuffer) return;
+    
+    auto ringIt = m_buffers.find(m_streamingBuffer);
+    auto dstIt = m_buffers.find(buffer);
+    if (ringIt == m_buffers.end() || dstIt == m_buffers.end()) return;
+    
+    CopyBufferRegion(dstIt->second, offset, ringIt->second, source.offset, source.size);
+    GetRecordingStats().bytesStreamed += source.size;
+}
+
+void DirectX12Renderer::CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                                   size_t size) {
+    auto srcIt = m_buffers.find(source);
+    auto dstIt = m_buffers.find(destination);
+    if (srcIt == m_buffers.end() || dstIt == m_buffers.end()) return;
+    
+    CopyBufferRegion(dstIt->second, destinationOffset, srcIt->second, sourceOffset, size);
+}
+
 uint32_t DirectX12Renderer::CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) {
     // TODO: Implement
     return 0;
@@ -274,15 +325,134 @@ void DirectX12Renderer::SetShaderUniform(uint32_t shader, const std::string& nam
     // TODO: Implement
 }
 
+void DirectX12Renderer::SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) {
+    SetShaderUniform(shader, GetUniformName(uniform), data, size);
+}
+
 void DirectX12Renderer::DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount, 
                                     PrimitiveTopology topology) {
     // TODO: Implement
-    m_stats.drawCalls++;
+    GetRecordingStats().drawCalls++;
 }
 
 void DirectX12Renderer::Draw(uint32_t vertexBuffer, uint32_t vertexCount, PrimitiveTopology topology) {
     // TODO: Implement
-    m_stats.drawCalls++;
+    GetRecordingStats().drawCalls++;
+}
+
+void DirectX12Renderer::MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer,
+                                         const IndirectDrawCommand* commands, uint32_t drawCount,
+                                         PrimitiveTopology topology) {
+    auto vbIt = m_buffers.find(vertexBuffer);
+    auto ibIt = m_buffers.find(indexBuffer);
+    if (vbIt == m_buffers.end() || ibIt == m_buffers.end() || drawCount == 0) return;
+    
+    ID3D12GraphicsCommandList* commandList = GetRecordingList();
+    RenderStats& stats = GetRecordingStats();
+    commandList->IASetVertexBuffers(0, 1, &vbIt->second.vertexView);
+    commandList->IASetIndexBuffer(&ibIt->second.indexView);
+    commandList->IASetPrimitiveTopology(ConvertTopology(topology));
+    
+    // Per-draw loop until there is a command signature for ExecuteIndirect; the input
+    // assembler is only configured once for the batch
+    uint32_t drawn = 0;
+    for (uint32_t i = 0; i < drawCount; i++) {
+        const IndirectDrawCommand& command = commands[i];
+        if (command.instanceCount == 0) continue;
+        
+        commandList->DrawIndexedInstanced(command.indexCount, command.instanceCount, command.firstIndex,
+                                          command.baseVertex, command.baseInstance);
+        stats.triangles += (topology == PrimitiveTopology::TriangleList) ?
+                           command.indexCount / 3 * command.instanceCount : 0;
+        drawn++;
+    }
+    
+    stats.drawCalls += drawn;
+    stats.multiDrawCommands += drawn;
+}
+
+void DirectX12Renderer::DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                                             uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                                             PrimitiveTopology topology) {
+    auto vbIt = m_buffers.find(vertexBuffer);
+    auto ibIt = m_buffers.find(indexBuffer);
+    auto instanceIt = m_buffers.find(instanceBuffer);
+    if (vbIt == m_buffers.end() || ibIt == m_buffers.end() || instanceIt == m_buffers.end() || instanceCount == 0) {
+        return;
+    }
+    
+    const BufferResource& instances = instanceIt->second;
+    size_t instanceBytes = static_cast<size_t>(instanceCount) * sizeof(InstanceData);
+    if (instanceOffset > instances.size || instanceBytes > instances.size - instanceOffset) return;
+    
+    // Slot 1 is a view of just this draw's instances, so the per-instance step starts at zero
+    D3D12_VERTEX_BUFFER_VIEW views[2];
+    views[0] = vbIt->second.vertexView;
+    views[1].BufferLocation = instances.buffer->GetGPUVirtualAddress() + instanceOffset;
+    views[1].SizeInBytes = static_cast<UINT>(instanceBytes);
+    views[1].StrideInBytes = sizeof(InstanceData);
+    
+    ID3D12GraphicsCommandList* commandList = GetRecordingList();
+    RenderStats& stats = GetRecordingStats();
+    commandList->IASetVertexBuffers(0, 2, views);
+    commandList->IASetIndexBuffer(&ibIt->second.indexView);
+    commandList->IASetPrimitiveTopology(ConvertTopology(topology));
+    commandList->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, 0);
+    
+    stats.drawCalls++;
+    stats.instancesDrawn += instanceCount;
+    stats.triangles += (topology == PrimitiveTopology::TriangleList) ? indexCount / 3 * instanceCount : 0;
+}
+
+void DirectX12Renderer::ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) {
+    if (count == 0) return;
+    
+    // Lists already submitted this frame may still be executing, so take fresh ones
+    uint32_t first = m_recordedListsUsed;
+    while (m_recordedLists.size() < first + count) {
+        auto recorded = std::make_unique<RecordedList>();
+        if (!CreateRecordedList(*recorded)) {
+            std::cerr << "DirectX 12: failed to create a deferred command list" << std::endl;
+            return;
+        }
+        m_recordedLists.push_back(std::move(recorded));
+    }
+    m_recordedListsUsed += count;
+    
+    // Each job records into its own allocator and list; draws read m_buffers, which no
+    // one modifies until recording is done
+    Platform::JobSystem::GetDefault().ParallelFor(count, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            RecordedList& recorded = *m_recordedLists[first + i];
+            recorded.allocators[m_frameIndex]->Reset();
+            recorded.list->Reset(recorded.allocators[m_frameIndex].Get(), nullptr);
+            recorded.stats = RenderStats();
+            SetFrameTargets(recorded.list.Get());
+            
+            t_recording = { this, recorded.list.Get(), &recorded.stats };
+            lists[i]->Execute(*this);
+            t_recording = RecordingContext();
+            
+            recorded.list->Close();
+        }
+    });
+    
+    // The immediate list goes first so everything recorded on it before this call runs
+    // ahead of the deferred lists
+    m_commandList->Close();
+    m_submission.clear();
+    m_submission.push_back(m_commandList.Get());
+    for (uint32_t i = 0; i < count; i++) {
+        RecordedList& recorded = *m_recordedLists[first + i];
+        MergeRecordedStats(m_stats, recorded.stats);
+        m_submission.push_back(recorded.list.Get());
+    }
+    m_commandQueue->ExecuteCommandLists(static_cast<UINT>(m_submission.size()), m_submission.data());
+    
+    // Reopen the immediate list for the rest of the frame; its allocator is only reset
+    // once the frame's fence has passed
+    m_commandList->Reset(m_commandAllocators[m_frameIndex].Get(), nullptr);
+    SetFrameTargets(m_commandList.Get());
 }
 
 void DirectX12Renderer::SetDepthTest(bool enabled) {
@@ -302,6 +472,50 @@ void DirectX12Renderer::SetWireframe(bool enabled) {
 }
 
 // Helper methods
+ID3D12GraphicsCommandList* DirectX12Renderer::GetRecordingList() {
+    return t_recording.renderer == this ? t_recording.list : m_commandList.Get();
+}
+
+RenderStats& DirectX12Renderer::GetRecordingStats() {
+    return t_recording.renderer == this ? *t_recording.stats : m_stats;
+}
+
+void DirectX12Renderer::SetFrameTargets(ID3D12GraphicsCommandList* list) {
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle;
+    rtvHandle.ptr = m_rtvHeap->GetCPUDescriptorHandleForHeapStart().ptr + 
+                    m_frameIndex * m_rtvDescriptorSize;
+    
+    D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = m_dsvHeap->GetCPUDescriptorHandleForHeapStart();
+    
+    list->OMSetRenderTargets(1, &rtvHandle, FALSE, &dsvHandle);
+    
+    // Set viewport and scissor
+    list->RSSetViewports(1, &m_viewport);
+    list->RSSetScissorRects(1, &m_scissorRect);
+    
+    if (m_rootSignature) {
+        list->SetGraphicsRootSignature(m_rootSignature.Get());
+    }
+}
+
+bool DirectX12Renderer::CreateRecordedList(RecordedList& recorded) {
+    for (uint32_t i = 0; i < FRAME_COUNT; i++) {
+        if (FAILED(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                                     IID_PPV_ARGS(recorded.allocators[i].GetAddressOf())))) {
+            return false;
+        }
+    }
+    
+    if (FAILED(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                           recorded.allocators[m_frameIndex].Get(), nullptr,
+                                           IID_PPV_ARGS(recorded.list.GetAddressOf())))) {
+        return false;
+    }
+    
+    // Lists are created open; jobs expect to reset a closed one
+    return SUCCEEDED(recorded.list->Close());
+}
+
 bool DirectX12Renderer::CreateDevice() {
 #ifdef _DEBUG
     ComPtr<ID3D12Debug> debugController;
@@ -416,6 +630,103 @@ void DirectX12Renderer::MoveToNextFrame() {
     m_fenceValues[m_frameIndex] = currentFenceValue + 1;
 }
 
+bool DirectX12Renderer::CreateStreamingBuffer(size_t capacity) {
+    D3D12_HEAP_PROPERTIES heapProps = {};
+    heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+    
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = capacity;
+    desc.Height = 1;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.Format = DXGI_FORMAT_UNKNOWN;
+    desc.SampleDesc.Count = 1;
+    desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    
+    BufferResource ring = {};
+    if (FAILED(m_device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &desc,
+                                                 D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+                                                 IID_PPV_ARGS(ring.buffer.GetAddressOf())))) {
+        return false;
+    }
+    
+    // Upload heaps stay mapped for their whole lifetime; the CPU never reads them back
+    void* memory = nullptr;
+    D3D12_RANGE noRead = { 0, 0 };
+    if (FAILED(ring.buffer->Map(0, &noRead, &memory))) {
+        return false;
+    }
+    
+    ring.vertexView.BufferLocation = ring.buffer->GetGPUVirtualAddress();
+    ring.vertexView.SizeInBytes = static_cast<UINT>(capacity);
+    ring.vertexView.StrideInBytes = sizeof(InstanceData);
+    ring.size = capacity;
+    ring.isIndexBuffer = false;
+    ring.state = D3D12_RESOURCE_STATE_GENERIC_READ;
+    
+    m_streamingBuffer = m_nextID++;
+    m_buffers[m_streamingBuffer] = ring;
+    m_streaming.Initialize(static_cast<uint8_t*>(memory), capacity, m_streamingBuffer);
+    return true;
+}
+
+void DirectX12Renderer::DestroyStreamingBuffer() {
+    if (!m_streamingBuffer) return;
+    
+    auto it = m_buffers.find(m_streamingBuffer);
+    if (it != m_buffers.end()) {
+        it->second.buffer->Unmap(0, nullptr);
+        m_buffers.erase(it);
+    }
+    m_streaming.Initialize(nullptr, 0, 0);
+    m_streamingBuffer = 0;
+}
+
+void DirectX12Renderer::CopyBufferRegion(BufferResource& destination, size_t destinationOffset,
+                                         BufferResource& source, size_t sourceOffset, size_t size) {
+    if (destinationOffset > destination.size || size > destination.size - destinationOffset ||
+        sourceOffset > source.size || size > source.size - sourceOffset) {
+        return;
+    }
+    // Upload heap buffers can only be read by the GPU
+    if (destination.state == D3D12_RESOURCE_STATE_GENERIC_READ) return;
+    // A buffer cannot be in COPY_SOURCE and COPY_DEST at once
+    if (source.buffer == destination.buffer) {
+        std::cerr << "DirectX 12: copies within one buffer are not supported" << std::endl;
+        return;
+    }
+    
+    D3D12_RESOURCE_BARRIER barriers[2] = {};
+    UINT barrierCount = 0;
+    auto transition = [&](BufferResource& resource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after) {
+        D3D12_RESOURCE_BARRIER& barrier = barriers[barrierCount++];
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Transition.pResource = resource.buffer.Get();
+        barrier.Transition.StateBefore = before;
+        barrier.Transition.StateAfter = after;
+        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    };
+    
+    const bool sourceNeedsTransition = source.state != D3D12_RESOURCE_STATE_GENERIC_READ;
+    transition(destination, destination.state, D3D12_RESOURCE_STATE_COPY_DEST);
+    if (sourceNeedsTransition) {
+        transition(source, source.state, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    }
+    ID3D12GraphicsCommandList* commandList = GetRecordingList();
+    commandList->ResourceBarrier(barrierCount, barriers);
+    
+    commandList->CopyBufferRegion(destination.buffer.Get(), destinationOffset, source.buffer.Get(), sourceOffset,
+                                  size);
+    
+    barrierCount = 0;
+    transition(destination, D3D12_RESOURCE_STATE_COPY_DEST, destination.state);
+    if (sourceNeedsTransition) {
+        transition(source, D3D12_RESOURCE_STATE_COPY_SOURCE, source.state);
+    }
+    commandList->ResourceBarrier(barrierCount, barriers);
+}
+
 D3D12_PRIMITIVE_TOPOLOGY_TYPE DirectX12Renderer::ConvertTopologyType(PrimitiveTopology topology) {
     switch (topology) {
         case PrimitiveTopology::TriangleList:
@@ -444,10 +755,17 @@ DXGI_FORMAT DirectX12Renderer::ConvertTextureFormat(TextureFormat format) {
     switch (format) {
         case TextureFormat::RGBA8: return DXGI_FORMAT_R8G8B8A8_UNORM;
         case TextureFormat::RGB8: return DXGI_FORMAT_R8G8B8A8_UNORM;
+        case TextureFormat::SRGBA8: return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
         case TextureFormat::RGBA16F: return DXGI_FORMAT_R16G16B16A16_FLOAT;
         case TextureFormat::RGBA32F: return DXGI_FORMAT_R32G32B32A32_FLOAT;
         case TextureFormat::Depth24Stencil8: return DXGI_FORMAT_D24_UNORM_S8_UINT;
         case TextureFormat::Depth32F: return DXGI_FORMAT_D32_FLOAT;
+        case TextureFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+        case TextureFormat::BC1SRGB: return DXGI_FORMAT_BC1_UNORM_SRGB;
+        case TextureFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+        case TextureFormat::BC3SRGB: return DXGI_FORMAT_BC3_UNORM_SRGB;
+        case TextureFormat::BC7: return DXGI_FORMAT_BC7_UNORM;
+        case TextureFormat::BC7SRGB: return DXGI_FORMAT_BC7_UNORM_SRGB;
         default: return DXGI_FORMAT_R8G8B8A8_UNORM;
     }
 }
@@ -0,0 +1,95 @@
+#include "renderer/Frustum.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define FRUSTUM_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace SwordAndStone {
+namespace Renderer {
+
+Frustum::Frustum() {
+    for (int p = 0; p < PlaneCount; p++) {
+        m_planes[p][0] = m_planes[p][1] = m_planes[p][2] = 0.0f;
+        m_planes[p][3] = 1.0f;
+    }
+}
+
+Frustum Frustum::FromMatrix(const float* m) {
+    // Row i of the column-major matrix is (m[i], m[4 + i], m[8 + i], m[12 + i])
+    auto row = [m](int i, float out[4]) {
+        out[0] = m[i];
+        out[1] = m[4 + i];
+        out[2] = m[8 + i];
+        out[3] = m[12 + i];
+    };
+
+    float r0[4], r1[4], r2[4], r3[4];
+    row(0, r0);
+    row(1, r1);
+    row(2, r2);
+    row(3, r3);
+
+    Frustum frustum;
+    for (int i = 0; i < 4; i++) {
+        frustum.m_planes[Left][i] = r3[i] + r0[i];
+        frustum.m_planes[Right][i] = r3[i] - r0[i];
+        frustum.m_planes[Bottom][i] = r3[i] + r1[i];
+        frustum.m_planes[Top][i] = r3[i] - r1[i];
+        frustum.m_planes[Near][i] = r3[i] + r2[i];
+        frustum.m_planes[Far][i] = r3[i] - r2[i];
+    }
+    return frustum;
+}
+
+bool Frustum::TestAABB(const float min[3], const float max[3]) const {
+    // A box is outside when its corner furthest along a plane normal is behind that plane
+    for (int p = 0; p < PlaneCount; p++) {
+        const float* plane = m_planes[p];
+        float x = plane[0] > 0.0f ? max[0] : min[0];
+        float y = plane[1] > 0.0f ? max[1] : min[1];
+        float z = plane[2] > 0.0f ? max[2] : min[2];
+        if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Frustum::TestAABBs(const float* minX, const float* minY, const float* minZ,
+                        const float* maxX, const float* maxY, const float* maxZ,
+                        size_t count, uint8_t* visible) const {
+    size_t i = 0;
+
+#ifdef FRUSTUM_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < PlaneCount; p++) {
+            const float* plane = m_planes[p];
+            // The furthest corner is chosen per plane, so it is a choice of source array
+            __m128 x = _mm_loadu_ps((plane[0] > 0.0f ? maxX : minX) + i);
+            __m128 y = _mm_loadu_ps((plane[1] > 0.0f ? maxY : minY) + i);
+            __m128 z = _mm_loadu_ps((plane[2] > 0.0f ? maxZ : minZ) + i);
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), x), _mm_mul_ps(_mm_set1_ps(plane[1]), y)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), z), _mm_set1_ps(plane[3])));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        visible[i] = mask & 1;
+        visible[i + 1] = (mask >> 1) & 1;
+        visible[i + 2] = (mask >> 2) & 1;
+        visible[i + 3] = (mask >> 3) & 1;
+    }
+#endif
+
+    for (; i < count; i++) {
+        const float min[3] = { minX[i], minY[i], minZ[i] };
+        const float max[3] = { maxX[i], maxY[i], maxZ[i] };
+        visible[i] = TestAABB(min, max) ? 1 : 0;
+    }
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -0,0 +1,337 @@
+#include "renderer/GeometryArena.h"
+#include "platform/LinearArena.h"
+#include <algorithm>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+RangeAllocator::RangeAllocator(uint32_t capacity)
+    : m_capacity(0)
+    , m_freeSpace(0)
+{
+    Reset(capacity);
+}
+
+void RangeAllocator::Reset(uint32_t capacity) {
+    m_freeByOffset.clear();
+    m_freeBySize.clear();
+    m_capacity = capacity;
+    m_freeSpace = capacity;
+    if (capacity > 0) {
+        InsertFree(0, capacity);
+    }
+}
+
+void RangeAllocator::Grow(uint32_t capacity) {
+    if (capacity <= m_capacity) return;
+
+    uint32_t oldCapacity = m_capacity;
+    m_capacity = capacity;
+    Free(oldCapacity, capacity - oldCapacity);
+}
+
+uint32_t RangeAllocator::Allocate(uint32_t size) {
+    if (size == 0) return INVALID_OFFSET;
+
+    // Smallest free range that fits; ties go to the lowest offset
+    auto sizeIt = m_freeBySize.lower_bound(size);
+    if (sizeIt == m_freeBySize.end()) return INVALID_OFFSET;
+
+    uint32_t bestSize = sizeIt->first;
+    uint32_t bestOffset = sizeIt->second;
+    for (auto it = sizeIt; it != m_freeBySize.end() && it->first == bestSize; ++it) {
+        bestOffset = std::min(bestOffset, it->second);
+    }
+    return TakeFrom(m_freeByOffset.find(bestOffset), size);
+}
+
+uint32_t RangeAllocator::AllocateBelow(uint32_t size, uint32_t limit) {
+    if (size == 0) return INVALID_OFFSET;
+
+    for (auto it = m_freeByOffset.begin(); it != m_freeByOffset.end(); ++it) {
+        if (static_cast<uint64_t>(it->first) + size > limit) break;
+        if (it->second >= size) {
+            return TakeFrom(it, size);
+        }
+    }
+    return INVALID_OFFSET;
+}
+
+void RangeAllocator::Free(uint32_t offset, uint32_t size) {
+    if (size == 0) return;
+    m_freeSpace += size;
+
+    // Merge with the following and preceding free ranges
+    auto next = m_freeByOffset.lower_bound(offset);
+    if (next != m_freeByOffset.end() && offset + size == next->first) {
+        size += next->second;
+        EraseFree(next);
+    }
+
+    auto prev = m_freeByOffset.lower_bound(offset);
+    if (prev != m_freeByOffset.begin()) {
+        --prev;
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            EraseFree(prev);
+        }
+    }
+
+    InsertFree(offset, size);
+}
+
+uint32_t RangeAllocator::GetLargestFreeRange() const {
+    return m_freeBySize.empty() ? 0 : m_freeBySize.rbegin()->first;
+}
+
+void RangeAllocator::InsertFree(uint32_t offset, uint32_t size) {
+    m_freeByOffset[offset] = size;
+    m_freeBySize.insert({ size, offset });
+}
+
+void RangeAllocator::EraseFree(std::map<uint32_t, uint32_t>::iterator it) {
+    auto range = m_freeBySize.equal_range(it->second);
+    for (auto sizeIt = range.first; sizeIt != range.second; ++sizeIt) {
+        if (sizeIt->second == it->first) {
+            m_freeBySize.erase(sizeIt);
+            break;
+        }
+    }
+    m_freeByOffset.erase(it);
+}
+
+uint32_t RangeAllocator::TakeFrom(std::map<uint32_t, uint32_t>::iterator it, uint32_t size) {
+    uint32_t offset = it->first;
+    uint32_t rangeSize = it->second;
+    EraseFree(it);
+    if (rangeSize > size) {
+        InsertFree(offset + size, rangeSize - size);
+    }
+    m_freeSpace -= size;
+    return offset;
+}
+
+GeometryArena::GeometryArena()
+    : m_renderer(nullptr)
+    , m_vertexBuffer(0)
+    , m_indexBuffer(0)
+    , m_moveBuffer(0)
+    , m_moveBufferSize(0)
+    , m_allocationCount(0)
+{
+}
+
+GeometryArena::~GeometryArena() {
+    Shutdown();
+}
+
+bool GeometryArena::Initialize(IRenderer* renderer, uint32_t vertexCapacity, uint32_t indexCapacity) {
+    Shutdown();
+    m_renderer = renderer;
+    m_vertexSpace.Reset(0);
+    m_indexSpace.Reset(0);
+    return Grow(std::max(1u, vertexCapacity), std::max(1u, indexCapacity));
+}
+
+void GeometryArena::Shutdown() {
+    if (m_renderer) {
+        if (m_vertexBuffer) m_renderer->DeleteBuffer(m_vertexBuffer);
+        if (m_indexBuffer) m_renderer->DeleteBuffer(m_indexBuffer);
+        if (m_moveBuffer) m_renderer->DeleteBuffer(m_moveBuffer);
+    }
+    m_renderer = nullptr;
+    m_vertexBuffer = 0;
+    m_indexBuffer = 0;
+    m_moveBuffer = 0;
+    m_moveBufferSize = 0;
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_allocationCount = 0;
+}
+
+uint32_t GeometryArena::Allocate(uint32_t vertexCount, uint32_t indexCount) {
+    if (!m_renderer || vertexCount == 0 || indexCount == 0) return INVALID_HANDLE;
+
+    uint32_t vertexOffset = m_vertexSpace.Allocate(vertexCount);
+    if (vertexOffset == RangeAllocator::INVALID_OFFSET) {
+        uint32_t capacity = m_vertexSpace.GetCapacity();
+        if (!Grow(std::max(capacity * 2, capacity + vertexCount), m_indexSpace.GetCapacity())) {
+            return INVALID_HANDLE;
+        }
+        vertexOffset = m_vertexSpace.Allocate(vertexCount);
+    }
+
+    uint32_t indexOffset = m_indexSpace.Allocate(indexCount);
+    if (indexOffset == RangeAllocator::INVALID_OFFSET) {
+        uint32_t capacity = m_indexSpace.GetCapacity();
+        if (!Grow(m_vertexSpace.GetCapacity(), std::max(capacity * 2, capacity + indexCount))) {
+            m_vertexSpace.Free(vertexOffset, vertexCount);
+            return INVALID_HANDLE;
+        }
+        indexOffset = m_indexSpace.Allocate(indexCount);
+    }
+
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    m_slots[slot].range = { vertexOffset, vertexCount, indexOffset, indexCount };
+    m_slots[slot].live = true;
+    m_allocationCount++;
+    return slot + 1;
+}
+
+void GeometryArena::Free(uint32_t handle) {
+    if (handle == INVALID_HANDLE || handle > m_slots.size() || !m_slots[handle - 1].live) return;
+
+    Slot& slot = m_slots[handle - 1];
+    m_vertexSpace.Free(slot.range.vertexOffset, slot.range.vertexCount);
+    m_indexSpace.Free(slot.range.indexOffset, slot.range.indexCount);
+    slot.live = false;
+    m_freeSlots.push_back(handle - 1);
+    m_allocationCount--;
+}
+
+void GeometryArena::Upload(uint32_t handle, const Vertex* vertices, const uint32_t* indices) {
+    const GeometryRange* range = GetRange(handle);
+    if (!range) return;
+
+    m_renderer->UpdateVertexBuffer(m_vertexBuffer, vertices, range->vertexCount * sizeof(Vertex),
+                                   range->vertexOffset * sizeof(Vertex));
+    m_renderer->UpdateVertexBuffer(m_indexBuffer, indices, range->indexCount * sizeof(uint32_t),
+                                   range->indexOffset * sizeof(uint32_t));
+}
+
+void GeometryArena::Upload(uint32_t handle, const StreamingAllocation& vertices, const StreamingAllocation& indices) {
+    const GeometryRange* range = GetRange(handle);
+    if (!range || vertices.size < range->vertexCount * sizeof(Vertex) ||
+        indices.size < range->indexCount * sizeof(uint32_t)) return;
+
+    m_renderer->CopyStreamingToBuffer(vertices, m_vertexBuffer, range->vertexOffset * sizeof(Vertex));
+    m_renderer->CopyStreamingToBuffer(indices, m_indexBuffer, range->indexOffset * sizeof(uint32_t));
+}
+
+uint32_t GeometryArena::Defragment(uint32_t maxMoves) {
+    if (!m_renderer || maxMoves == 0) return 0;
+
+    Platform::ScratchScope scratch;
+    Platform::ArenaVector<uint32_t> order{ Platform::ArenaAllocator<uint32_t>(scratch.GetArena()) };
+    order.reserve(m_allocationCount);
+    for (uint32_t i = 0; i < m_slots.size(); i++) {
+        if (m_slots[i].live) order.push_back(i);
+    }
+
+    uint32_t moves = 0;
+
+    // Vertices: highest meshes first, each into the lowest hole below it
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return m_slots[a].range.vertexOffset > m_slots[b].range.vertexOffset;
+    });
+    for (uint32_t i = 0; i < order.size() && moves < maxMoves; i++) {
+        GeometryRange& range = m_slots[order[i]].range;
+        uint32_t offset = m_vertexSpace.AllocateBelow(range.vertexCount, range.vertexOffset);
+        if (offset == RangeAllocator::INVALID_OFFSET) continue;
+
+        if (!MoveBytes(m_vertexBuffer, range.vertexOffset * sizeof(Vertex), offset * sizeof(Vertex),
+                       range.vertexCount * sizeof(Vertex))) {
+            m_vertexSpace.Free(offset, range.vertexCount);
+            return moves;
+        }
+        m_vertexSpace.Free(range.vertexOffset, range.vertexCount);
+        range.vertexOffset = offset;
+        moves++;
+    }
+
+    // Indices are relative to baseVertex, so they move independently of their vertices
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return m_slots[a].range.indexOffset > m_slots[b].range.indexOffset;
+    });
+    for (uint32_t i = 0; i < order.size() && moves < maxMoves; i++) {
+        GeometryRange& range = m_slots[order[i]].range;
+        uint32_t offset = m_indexSpace.AllocateBelow(range.indexCount, range.indexOffset);
+        if (offset == RangeAllocator::INVALID_OFFSET) continue;
+
+        if (!MoveBytes(m_indexBuffer, range.indexOffset * sizeof(uint32_t), offset * sizeof(uint32_t),
+                       range.indexCount * sizeof(uint32_t))) {
+            m_indexSpace.Free(offset, range.indexCount);
+            return moves;
+        }
+        m_indexSpace.Free(range.indexOffset, range.indexCount);
+        range.indexOffset = offset;
+        moves++;
+    }
+
+    return moves;
+}
+
+const GeometryRange* GeometryArena::GetRange(uint32_t handle) const {
+    if (handle == INVALID_HANDLE || handle > m_slots.size() || !m_slots[handle - 1].live) return nullptr;
+    return &m_slots[handle - 1].range;
+}
+
+IndirectDrawCommand GeometryArena::GetDrawCommand(uint32_t handle) const {
+    IndirectDrawCommand command = {};
+    const GeometryRange* range = GetRange(handle);
+    if (range) {
+        command.indexCount = range->indexCount;
+        command.instanceCount = 1;
+        command.firstIndex = range->indexOffset;
+        command.baseVertex = static_cast<int32_t>(range->vertexOffset);
+    }
+    return command;
+}
+
+float GeometryArena::GetFragmentation() const {
+    uint32_t freeSpace = m_vertexSpace.GetFreeSpace();
+    if (freeSpace == 0) return 0.0f;
+    return 1.0f - static_cast<float>(m_vertexSpace.GetLargestFreeRange()) / static_cast<float>(freeSpace);
+}
+
+bool GeometryArena::Grow(uint32_t vertexCapacity, uint32_t indexCapacity) {
+    // New buffers keep every mesh at the same offset, so handles stay valid
+    if (vertexCapacity > m_vertexSpace.GetCapacity()) {
+        uint32_t buffer = m_renderer->CreateVertexBuffer(nullptr, vertexCapacity * sizeof(Vertex), BufferUsage::Static);
+        if (buffer == 0) return false;
+        if (m_vertexBuffer) {
+            m_renderer->CopyBuffer(m_vertexBuffer, 0, buffer, 0, m_vertexSpace.GetCapacity() * sizeof(Vertex));
+            m_renderer->DeleteBuffer(m_vertexBuffer);
+        }
+        m_vertexBuffer = buffer;
+        m_vertexSpace.Grow(vertexCapacity);
+    }
+
+    if (indexCapacity > m_indexSpace.GetCapacity()) {
+        uint32_t buffer = m_renderer->CreateIndexBuffer(nullptr, indexCapacity, BufferUsage::Static);
+        if (buffer == 0) return false;
+        if (m_indexBuffer) {
+            m_renderer->CopyBuffer(m_indexBuffer, 0, buffer, 0, m_indexSpace.GetCapacity() * sizeof(uint32_t));
+            m_renderer->DeleteBuffer(m_indexBuffer);
+        }
+        m_indexBuffer = buffer;
+        m_indexSpace.Grow(indexCapacity);
+    }
+    return true;
+}
+
+bool GeometryArena::MoveBytes(uint32_t buffer, size_t from, size_t to, size_t size) {
+    if (size > m_moveBufferSize) {
+        // Kept between calls and grown geometrically, so a defragmentation pass creates at most a few
+        const size_t capacity = std::max(size, m_moveBufferSize * 2);
+        const uint32_t moveBuffer = m_renderer->CreateVertexBuffer(nullptr, capacity, BufferUsage::Static);
+        if (moveBuffer == 0) return false;
+        if (m_moveBuffer) m_renderer->DeleteBuffer(m_moveBuffer);
+        m_moveBuffer = moveBuffer;
+        m_moveBufferSize = capacity;
+    }
+    m_renderer->CopyBuffer(buffer, from, m_moveBuffer, 0, size);
+    m_renderer->CopyBuffer(m_moveBuffer, 0, buffer, to, size);
+    return true;
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -0,0 +1,542 @@
+#include "renderer/NullRenderer.h"
+#include "renderer/CommandBuffer.h"
+#include "platform/MemoryTracker.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+namespace {
+
+// Capture file layout: header, then one block per frame
+//   header: magic, version, sizeof(RenderStats), sizeof(NullCommand)
+//   frame:  frameIndex, RenderStats, command count, commands
+constexpr uint32_t CAPTURE_MAGIC = 0x43525353;  // "SSRC"
+constexpr uint32_t CAPTURE_VERSION = 1;
+
+template <typename T>
+void WriteValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadValue(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+// FNV-1a, used to record uniform names without storing strings
+uint32_t HashName(const std::string& name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
+NullRenderer::NullRenderer()
+    : m_streamingID(0)
+    , m_submittedFence(0)
+    , m_gpuLatency(StreamingRingBuffer::FRAME_COUNT - 1)
+    , m_width(0)
+    , m_height(0)
+    , m_nextID(1)
+    , m_currentShader(0)
+    , m_depthTest(true)
+    , m_blending(false)
+    , m_culling(true)
+    , m_wireframe(false)
+    , m_recording(true)
+    , m_frameIndex(0)
+{
+    m_clearColor[0] = 0.2f;
+    m_clearColor[1] = 0.3f;
+    m_clearColor[2] = 0.4f;
+    m_clearColor[3] = 1.0f;
+}
+
+NullRenderer::~NullRenderer() {
+    Shutdown();
+}
+
+bool NullRenderer::Initialize(void* windowHandle, uint32_t width, uint32_t height) {
+    m_width = width;
+    m_height = height;
+    m_boundTextures.assign(16, 0);
+    SetStreamingCapacity(DEFAULT_STREAMING_CAPACITY);
+    return true;
+}
+
+void NullRenderer::Shutdown() {
+    EndCapture();
+    m_buffers.clear();
+    m_textures.clear();
+    m_shaders.clear();
+    m_commands.clear();
+    m_streamingBuffer.data.clear();
+    m_streamingBuffer.data.shrink_to_fit();
+    m_streaming.Initialize(nullptr, 0, 0);
+}
+
+void NullRenderer::Resize(uint32_t width, uint32_t height) {
+    m_width = width;
+    m_height = height;
+    SetViewport(0, 0, width, height);
+}
+
+void NullRenderer::BeginFrame() {
+    m_stats = RenderStats();
+    m_commands.clear();
+
+    // Simulated GPU completion; with every ring frame still in flight the CPU has to wait
+    uint64_t completed = m_submittedFence > m_gpuLatency ? m_submittedFence - m_gpuLatency : 0;
+    m_streaming.Retire(completed);
+    if (m_streaming.GetPendingFrameCount() >= StreamingRingBuffer::FRAME_COUNT) {
+        m_streaming.Retire(m_streaming.GetOldestPendingFence());
+        m_stats.streamingStalls++;
+    }
+}
+
+void NullRenderer::EndFrame() {
+    m_streaming.EndFrame(++m_submittedFence);
+
+    if (m_capture.is_open()) {
+        WriteCapturedFrame();
+    }
+    m_frameIndex++;
+}
+
+void NullRenderer::Present() {
+}
+
+void NullRenderer::Clear(uint32_t flags, float r, float g, float b, float a) {
+    Record(NullCommandType::Clear, flags, 0, 0, 0, r, g, b, a);
+}
+
+void NullRenderer::SetClearColor(float r, float g, float b, float a) {
+    m_clearColor[0] = r;
+    m_clearColor[1] = g;
+    m_clearColor[2] = b;
+    m_clearColor[3] = a;
+}
+
+void NullRenderer::SetViewport(int x, int y, uint32_t width, uint32_t height) {
+    Record(NullCommandType::SetViewport, static_cast<uint32_t>(x), static_cast<uint32_t>(y), width, height);
+}
+
+void NullRenderer::SetScissor(int x, int y, uint32_t width, uint32_t height) {
+    Record(NullCommandType::SetScissor, static_cast<uint32_t>(x), static_cast<uint32_t>(y), width, height);
+}
+
+uint32_t NullRenderer::CreateVertexBuffer(const void* data, size_t size, BufferUsage usage) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
+    BufferResource resource;
+    resource.data.resize(size);
+    resource.usage = usage;
+    resource.isIndexBuffer = false;
+    if (data) {
+        memcpy(resource.data.data(), data, size);
+        m_stats.bytesUploaded += size;
+    }
+
+    uint32_t id = m_nextID++;
+    m_buffers[id] = std::move(resource);
+    Record(NullCommandType::CreateVertexBuffer, id, static_cast<uint32_t>(size), static_cast<uint32_t>(usage));
+    return id;
+}
+
+uint32_t NullRenderer::CreateIndexBuffer(const uint32_t* data, size_t count, BufferUsage usage) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
+    size_t size = count * sizeof(uint32_t);
+
+    BufferResource resource;
+    resource.data.resize(size);
+    resource.usage = usage;
+    resource.isIndexBuffer = true;
+    if (data) {
+        memcpy(resource.data.data(), data, size);
+        m_stats.bytesUploaded += size;
+    }
+
+    uint32_t id = m_nextID++;
+    m_buffers[id] = std::move(resource);
+    Record(NullCommandType::CreateIndexBuffer, id, static_cast<uint32_t>(count), static_cast<uint32_t>(usage));
+    return id;
+}
+
+void NullRenderer::UpdateVertexBuffer(uint32_t buffer, const void* data, size_t size, size_t offset) {
+    auto it = m_buffers.find(buffer);
+    if (it == m_buffers.end() || offset > it->second.data.size() || size > it->second.data.size() - offset) return;
+
+    memcpy(it->second.data.data() + offset, data, size);
+    m_stats.bytesUploaded += size;
+    Record(NullCommandType::UpdateVertexBuffer, buffer, static_cast<uint32_t>(size), static_cast<uint32_t>(offset));
+}
+
+StreamingAllocation NullRenderer::AllocateStreaming(size_t size, size_t alignment) {
+    return m_streaming.Allocate(size, alignment);
+}
+
+void NullRenderer::CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) {
+    auto it = m_buffers.find(buffer);
+    if (!source || it == m_buffers.end() || it->second.usage != BufferUsage::Static ||
+        offset > it->second.data.size() || source.size > it->second.data.size() - offset) {
+        return;
+    }
+
+    memcpy(it->second.data.data() + offset, source.data, source.size);
+    m_stats.bytesStreamed += source.size;
+    Record(NullCommandType::CopyStreamingToBuffer, buffer, static_cast<uint32_t>(source.offset),
+           static_cast<uint32_t>(source.size), static_cast<uint32_t>(offset));
+}
+
+void NullRenderer::CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                              size_t size) {
+    const BufferResource* src = FindBuffer(source);
+    BufferResource* dst = FindBuffer(destination);
+    if (!src || !dst || src == dst || dst->usage != BufferUsage::Static || sourceOffset > src->data.size() ||
+        size > src->data.size() - sourceOffset || destinationOffset > dst->data.size() ||
+        size > dst->data.size() - destinationOffset) {
+        return;
+    }
+
+    memcpy(dst->data.data() + destinationOffset, src->data.data() + sourceOffset, size);
+    Record(NullCommandType::CopyBuffer, source, destination, static_cast<uint32_t>(size));
+}
+
+void NullRenderer::SetStreamingCapacity(size_t capacity) {
+    if (m_streamingID == 0) {
+        m_streamingID = m_nextID++;
+    }
+    m_streamingBuffer.data.assign(capacity, 0);
+    m_streamingBuffer.usage = BufferUsage::Stream;
+    m_streamingBuffer.isIndexBuffer = false;
+    m_streaming.Initialize(m_streamingBuffer.data.data(), capacity, m_streamingID);
+}
+
+void NullRenderer::DeleteBuffer(uint32_t buffer) {
+    if (m_buffers.erase(buffer)) {
+        Record(NullCommandType::DeleteBuffer, buffer);
+    }
+}
+
+uint32_t NullRenderer::CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Textures);
+    TextureResource resource;
+    resource.width = width;
+    resource.height = height;
+    resource.format = format;
+    resource.mips.emplace_back(GetTextureDataSize(width, height, format));
+    if (data) {
+        memcpy(resource.mips[0].data(), data, resource.mips[0].size());
+        m_stats.bytesUploaded += resource.mips[0].size();
+    }
+
+    uint32_t id = m_nextID++;
+    m_textures[id] = std::move(resource);
+    Record(NullCommandType::CreateTexture2D, id, width, height, static_cast<uint32_t>(format));
+    return id;
+}
+
+void NullRenderer::UpdateTexture2D(uint32_t texture, const void* data, uint32_t mipLevel) {
+    auto it = m_textures.find(texture);
+    if (it == m_textures.end() || !data) return;
+
+    TextureResource& resource = it->second;
+    // Past the 1x1 level there is no mip to update, and shifting by 32 or more is undefined
+    const uint32_t largest = std::max(resource.width, resource.height);
+    if (mipLevel >= 32 || (largest >> mipLevel) == 0) return;
+
+    uint32_t mipWidth = std::max(1u, resource.width >> mipLevel);
+    uint32_t mipHeight = std::max(1u, resource.height >> mipLevel);
+    if (resource.mips.size() <= mipLevel) {
+        resource.mips.resize(mipLevel + 1);
+    }
+
+    std::vector<uint8_t>& mip = resource.mips[mipLevel];
+    mip.resize(GetTextureDataSize(mipWidth, mipHeight, resource.format));
+    memcpy(mip.data(), data, mip.size());
+    m_stats.bytesUploaded += mip.size();
+    Record(NullCommandType::UpdateTexture2D, texture, mipLevel, static_cast<uint32_t>(mip.size()));
+}
+
+void NullRenderer::DeleteTexture(uint32_t texture) {
+    if (m_textures.erase(texture)) {
+        Record(NullCommandType::DeleteTexture, texture);
+    }
+}
+
+void NullRenderer::BindTexture(uint32_t slot, uint32_t texture) {
+    if (slot >= m_boundTextures.size()) {
+        m_boundTextures.resize(slot + 1, 0);
+    }
+    if (m_boundTextures[slot] != texture) {
+        m_boundTextures[slot] = texture;
+        m_stats.stateChanges++;
+    }
+    m_stats.textureBinds++;
+    Record(NullCommandType::BindTexture, slot, texture);
+}
+
+uint32_t NullRenderer::CreateShader(const std::string& vertexSource, const std::string& fragmentSource) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
+    ShaderResource resource;
+    resource.vertexSource = vertexSource;
+    resource.fragmentSource = fragmentSource;
+
+    uint32_t id = m_nextID++;
+    m_shaders[id] = std::move(resource);
+    Record(NullCommandType::CreateShader, id);
+    return id;
+}
+
+void NullRenderer::DeleteShader(uint32_t shader) {
+    if (m_shaders.erase(shader)) {
+        if (m_currentShader == shader) {
+            m_currentShader = 0;
+        }
+        Record(NullCommandType::DeleteShader, shader);
+    }
+}
+
+void NullRenderer::BindShader(uint32_t shader) {
+    if (m_currentShader != shader) {
+        m_currentShader = shader;
+        m_stats.shaderSwitches++;
+        m_stats.stateChanges++;
+    }
+    Record(NullCommandType::BindShader, shader);
+}
+
+void NullRenderer::SetShaderUniform(uint32_t shader, const std::string& name, const void* data, size_t size) {
+    SetShaderUniform(shader, InternUniformName(name), data, size);
+}
+
+void NullRenderer::SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) {
+    auto it = m_shaders.find(shader);
+    if (it == m_shaders.end() || uniform == INVALID_UNIFORM) return;
+
+    auto inserted = it->second.uniforms.emplace(uniform, UniformValue());
+    UniformValue& value = inserted.first->second;
+    if (inserted.second) {
+        value.nameHash = HashName(GetUniformName(uniform));
+    }
+    value.data.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    m_stats.bytesUploaded += size;
+    Record(NullCommandType::SetShaderUniform, shader, value.nameHash, static_cast<uint32_t>(size));
+}
+
+void NullRenderer::DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                               PrimitiveTopology topology) {
+    if (!FindBuffer(vertexBuffer) || !FindBuffer(indexBuffer)) return;
+
+    m_stats.drawCalls++;
+    m_stats.triangles += CountTriangles(indexCount, topology);
+    m_stats.vertices += indexCount;
+    Record(NullCommandType::DrawIndexed, vertexBuffer, indexBuffer, indexCount, static_cast<uint32_t>(topology));
+}
+
+void NullRenderer::Draw(uint32_t vertexBuffer, uint32_t vertexCount, PrimitiveTopology topology) {
+    if (!FindBuffer(vertexBuffer)) return;
+
+    m_stats.drawCalls++;
+    m_stats.triangles += CountTriangles(vertexCount, topology);
+    m_stats.vertices += vertexCount;
+    Record(NullCommandType::Draw, vertexBuffer, vertexCount, static_cast<uint32_t>(topology));
+}
+
+void NullRenderer::MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, const IndirectDrawCommand* commands,
+                                    uint32_t drawCount, PrimitiveTopology topology) {
+    const BufferResource* indices = FindBuffer(indexBuffer);
+    if (!FindBuffer(vertexBuffer) || !indices || drawCount == 0) return;
+
+    const size_t indexCapacity = indices->data.size() / sizeof(uint32_t);
+    for (uint32_t i = 0; i < drawCount; i++) {
+        const IndirectDrawCommand& command = commands[i];
+        if (static_cast<size_t>(command.firstIndex) + command.indexCount > indexCapacity) continue;
+
+        m_stats.triangles += CountTriangles(command.indexCount, topology) * command.instanceCount;
+        m_stats.vertices += command.indexCount * command.instanceCount;
+    }
+
+    m_stats.drawCalls++;
+    m_stats.multiDrawCommands += drawCount;
+    Record(NullCommandType::MultiDrawIndexed, vertexBuffer, indexBuffer, drawCount, static_cast<uint32_t>(topology));
+}
+
+void NullRenderer::DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                                        uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                                        PrimitiveTopology topology) {
+    const BufferResource* instances = FindBuffer(instanceBuffer);
+    if (!FindBuffer(vertexBuffer) || !FindBuffer(indexBuffer) || !instances || instanceCount == 0) return;
+    if (instanceOffset + static_cast<size_t>(instanceCount) * sizeof(InstanceData) > instances->data.size()) return;
+
+    m_stats.drawCalls++;
+    m_stats.instancesDrawn += instanceCount;
+    m_stats.triangles += CountTriangles(indexCount, topology) * instanceCount;
+    m_stats.vertices += indexCount * instanceCount;
+    Record(NullCommandType::DrawIndexedInstanced, vertexBuffer, indexBuffer, indexCount, instanceCount);
+}
+
+void NullRenderer::ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) {
+    // Emulated deferred lists: replayed in order through the immediate interface
+    Record(NullCommandType::ExecuteCommandLists, count);
+    for (uint32_t i = 0; i < count; i++) {
+        lists[i]->Execute(*this);
+    }
+}
+
+void NullRenderer::SetDepthTest(bool enabled) {
+    SetState(m_depthTest, enabled, NullCommandType::SetDepthTest);
+}
+
+void NullRenderer::SetBlending(bool enabled) {
+    SetState(m_blending, enabled, NullCommandType::SetBlending);
+}
+
+void NullRenderer::SetCulling(bool enabled) {
+    SetState(m_culling, enabled, NullCommandType::SetCulling);
+}
+
+void NullRenderer::SetWireframe(bool enabled) {
+    SetState(m_wireframe, enabled, NullCommandType::SetWireframe);
+}
+
+bool NullRenderer::BeginCapture(const std::string& path) {
+    EndCapture();
+
+    m_capture.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_capture.is_open()) {
+        std::cerr << "Failed to open render capture file: " << path << std::endl;
+        return false;
+    }
+
+    WriteValue(m_capture, CAPTURE_MAGIC);
+    WriteValue(m_capture, CAPTURE_VERSION);
+    WriteValue(m_capture, static_cast<uint32_t>(sizeof(RenderStats)));
+    WriteValue(m_capture, static_cast<uint32_t>(sizeof(NullCommand)));
+    return true;
+}
+
+void NullRenderer::EndCapture() {
+    if (m_capture.is_open()) {
+        m_capture.close();
+    }
+}
+
+bool NullRenderer::LoadCapture(const std::string& path, std::vector<NullCapturedFrame>& frames) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    uint32_t magic = 0, version = 0, statsSize = 0, commandSize = 0;
+    if (!ReadValue(in, magic) || !ReadValue(in, version) ||
+        !ReadValue(in, statsSize) || !ReadValue(in, commandSize)) {
+        return false;
+    }
+    if (magic != CAPTURE_MAGIC || version != CAPTURE_VERSION ||
+        statsSize != sizeof(RenderStats) || commandSize != sizeof(NullCommand)) {
+        return false;
+    }
+
+    // Command counts are checked against what is left of the file before anything is allocated
+    const std::streampos start = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streampos end = in.tellg();
+    in.seekg(start);
+    if (start < 0 || end < start) return false;
+
+    frames.clear();
+    NullCapturedFrame frame;
+    while (ReadValue(in, frame.frameIndex)) {
+        uint32_t commandCount = 0;
+        if (!ReadValue(in, frame.stats) || !ReadValue(in, commandCount)) {
+            frames.clear();
+            return false;
+        }
+        const std::streampos position = in.tellg();
+        const uint64_t remaining = static_cast<uint64_t>(end - position);
+        if (position < 0 || commandCount > remaining / sizeof(NullCommand)) {
+            frames.clear();
+            return false;
+        }
+        frame.commands.resize(commandCount);
+        in.read(reinterpret_cast<char*>(frame.commands.data()), commandCount * sizeof(NullCommand));
+        if (!in) {
+            frames.clear();
+            return false;
+        }
+        frames.push_back(frame);
+    }
+    return in.eof();
+}
+
+const std::vector<uint8_t>* NullRenderer::GetBufferData(uint32_t buffer) const {
+    const BufferResource* resource = FindBuffer(buffer);
+    return resource ? &resource->data : nullptr;
+}
+
+const std::vector<uint8_t>* NullRenderer::GetUniformData(uint32_t shader, const std::string& name) const {
+    auto it = m_shaders.find(shader);
+    if (it == m_shaders.end()) return nullptr;
+
+    auto uniformIt = it->second.uniforms.find(FindUniformHandle(name));
+    return uniformIt != it->second.uniforms.end() ? &uniformIt->second.data : nullptr;
+}
+
+NullRenderer::BufferResource* NullRenderer::FindBuffer(uint32_t buffer) {
+    if (buffer != 0 && buffer == m_streamingID) return &m_streamingBuffer;
+    auto it = m_buffers.find(buffer);
+    return it != m_buffers.end() ? &it->second : nullptr;
+}
+
+const NullRenderer::BufferResource* NullRenderer::FindBuffer(uint32_t buffer) const {
+    return const_cast<NullRenderer*>(this)->FindBuffer(buffer);
+}
+
+void NullRenderer::Record(NullCommandType type, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3,
+                          float v0, float v1, float v2, float v3) {
+    if (!m_recording) return;
+
+    NullCommand command;
+    command.type = type;
+    command.args[0] = a0;
+    command.args[1] = a1;
+    command.args[2] = a2;
+    command.args[3] = a3;
+    command.values[0] = v0;
+    command.values[1] = v1;
+    command.values[2] = v2;
+    command.values[3] = v3;
+    m_commands.push_back(command);
+}
+
+void NullRenderer::SetState(bool& state, bool enabled, NullCommandType type) {
+    if (state != enabled) {
+        state = enabled;
+        m_stats.stateChanges++;
+    }
+    Record(type, enabled ? 1 : 0);
+}
+
+void NullRenderer::WriteCapturedFrame() {
+    WriteValue(m_capture, m_frameIndex);
+    WriteValue(m_capture, m_stats);
+    WriteValue(m_capture, static_cast<uint32_t>(m_commands.size()));
+    m_capture.write(reinterpret_cast<const char*>(m_commands.data()), m_commands.size() * sizeof(NullCommand));
+}
+
+uint32_t NullRenderer::CountTriangles(uint32_t count, PrimitiveTopology topology) {
+    switch (topology) {
+        case PrimitiveTopology::TriangleList: return count / 3;
+        case PrimitiveTopology::TriangleStrip: return count >= 3 ? count - 2 : 0;
+        default: return 0;
+    }
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -0,0 +1,416 @@
+#include "renderer/OcclusionCuller.h"
+#include "platform/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define OCCLUSION_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace SwordAndStone {
+namespace Renderer {
+
+namespace {
+
+// Box corners are indexed by bit: 1 = max x, 2 = max y, 4 = max z.
+// Faces wind counter-clockwise seen from outside the box.
+const int BOX_FACES[6][4] = {
+    { 0, 4, 6, 2 }, { 5, 1, 3, 7 },
+    { 0, 1, 5, 4 }, { 2, 6, 7, 3 },
+    { 0, 2, 3, 1 }, { 4, 5, 7, 6 }
+};
+
+// Clip-space w below which a corner counts as behind the camera
+const float MIN_CLIP_W = 1e-4f;
+
+const int BAND_HEIGHT = 16;
+const uint32_t TEST_BATCH_SIZE = 256;
+
+#ifdef OCCLUSION_SSE
+float HorizontalMin(__m128 v) {
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+float HorizontalMax(__m128 v) {
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+#endif
+
+} // namespace
+
+OcclusionCuller::OcclusionCuller(Platform::JobSystem* jobSystem, uint32_t width, uint32_t height)
+    : m_jobSystem(jobSystem)
+    , m_width((std::max(width, 4u) + 3) & ~3u)
+    , m_height(std::max(height, 1u))
+{
+    std::memset(m_viewProjection, 0, sizeof(m_viewProjection));
+
+    uint32_t levelWidth = m_width;
+    uint32_t levelHeight = m_height;
+    while (true) {
+        m_levels.push_back({ levelWidth, levelHeight, std::vector<float>(levelWidth * levelHeight, 1.0f) });
+        if (levelWidth == 1 && levelHeight == 1) break;
+        levelWidth = std::max(1u, (levelWidth + 1) / 2);
+        levelHeight = std::max(1u, (levelHeight + 1) / 2);
+    }
+}
+
+void OcclusionCuller::BeginFrame(const float* viewProjection) {
+    std::memcpy(m_viewProjection, viewProjection, sizeof(m_viewProjection));
+    m_occluders.clear();
+    m_triangles.clear();
+    for (Level& level : m_levels) {
+        std::fill(level.depth.begin(), level.depth.end(), 1.0f);
+    }
+}
+
+void OcclusionCuller::AddOccluder(const float min[3], const float max[3]) {
+    m_occluders.insert(m_occluders.end(), { min[0], min[1], min[2], max[0], max[1], max[2] });
+}
+
+void OcclusionCuller::RasterizeOccluders() {
+    SetupTriangles();
+
+    if (!m_triangles.empty()) {
+        Platform::JobSystem& jobs = m_jobSystem ? *m_jobSystem : Platform::JobSystem::GetDefault();
+        uint32_t bandCount = (m_height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+        // Bands own disjoint rows, so jobs never write the same pixel
+        jobs.ParallelFor(bandCount, 1, [this](uint32_t begin, uint32_t end) {
+            for (uint32_t band = begin; band < end; band++) {
+                int y0 = static_cast<int>(band) * BAND_HEIGHT;
+                RasterizeBand(y0, std::min(y0 + BAND_HEIGHT, static_cast<int>(m_height)));
+            }
+        });
+    }
+
+    BuildPyramid();
+}
+
+void OcclusionCuller::SetupTriangles() {
+    const float* m = m_viewProjection;
+    const size_t occluderCount = m_occluders.size() / 6;
+
+    for (size_t i = 0; i < occluderCount; i++) {
+        const float* box = &m_occluders[i * 6];
+
+        // Screen x, y and depth per corner
+        float corners[8][3];
+        bool behindCamera = false;
+        for (int c = 0; c < 8 && !behindCamera; c++) {
+            float x = box[(c & 1) ? 3 : 0];
+            float y = box[(c & 2) ? 4 : 1];
+            float z = box[(c & 4) ? 5 : 2];
+            float clipX = m[0] * x + m[4] * y + m[8] * z + m[12];
+            float clipY = m[1] * x + m[5] * y + m[9] * z + m[13];
+            float clipZ = m[2] * x + m[6] * y + m[10] * z + m[14];
+            float clipW = m[3] * x + m[7] * y + m[11] * z + m[15];
+            if (clipW < MIN_CLIP_W) {
+                behindCamera = true;
+                break;
+            }
+            float invW = 1.0f / clipW;
+            corners[c][0] = (clipX * invW * 0.5f + 0.5f) * m_width;
+            corners[c][1] = (0.5f - clipY * invW * 0.5f) * m_height;
+            corners[c][2] = clipZ * invW * 0.5f + 0.5f;
+        }
+
+        // Occluders crossing the near plane are dropped rather than clipped;
+        // losing an occluder only costs culling, never correctness
+        if (behindCamera) continue;
+
+        for (const int* face : BOX_FACES) {
+            AddTriangle(corners[face[0]], corners[face[1]], corners[face[2]]);
+            AddTriangle(corners[face[0]], corners[face[2]], corners[face[3]]);
+        }
+    }
+}
+
+void OcclusionCuller::AddTriangle(const float* a, const float* b, const float* c) {
+    // Screen y points down, so front faces have negative area here
+    float area = (b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]);
+    if (area >= 0.0f) return;
+    std::swap(b, c);
+    area = -area;
+
+    float minX = std::min(std::min(a[0], b[0]), c[0]);
+    float maxX = std::max(std::max(a[0], b[0]), c[0]);
+    float minY = std::min(std::min(a[1], b[1]), c[1]);
+    float maxY = std::max(std::max(a[1], b[1]), c[1]);
+
+    // Pixels whose centres can fall inside the triangle
+    ScreenTriangle tri;
+    tri.minX = std::max(0, static_cast<int>(std::ceil(minX - 0.5f)));
+    tri.maxX = std::min(static_cast<int>(m_width) - 1, static_cast<int>(std::floor(maxX - 0.5f)));
+    tri.minY = std::max(0, static_cast<int>(std::ceil(minY - 0.5f)));
+    tri.maxY = std::min(static_cast<int>(m_height) - 1, static_cast<int>(std::floor(maxY - 0.5f)));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) return;
+
+    const float* vertices[3] = { a, b, c };
+    for (int e = 0; e < 3; e++) {
+        const float* from = vertices[e];
+        const float* to = vertices[(e + 1) % 3];
+        tri.edgeA[e] = from[1] - to[1];
+        tri.edgeB[e] = to[0] - from[0];
+        tri.edgeC[e] = (to[1] - from[1]) * from[0] - (to[0] - from[0]) * from[1];
+    }
+
+    // The barycentric weight of a vertex is the opposite edge over the area
+    float invArea = 1.0f / area;
+    tri.depthA = (a[2] * tri.edgeA[1] + b[2] * tri.edgeA[2] + c[2] * tri.edgeA[0]) * invArea;
+    tri.depthB = (a[2] * tri.edgeB[1] + b[2] * tri.edgeB[2] + c[2] * tri.edgeB[0]) * invArea;
+    tri.depthC = (a[2] * tri.edgeC[1] + b[2] * tri.edgeC[2] + c[2] * tri.edgeC[0]) * invArea;
+
+    m_triangles.push_back(tri);
+}
+
+void OcclusionCuller::RasterizeBand(int y0, int y1) {
+    for (const ScreenTriangle& tri : m_triangles) {
+        if (tri.maxY < y0 || tri.minY >= y1) continue;
+        RasterizeTriangle(tri, std::max(tri.minY, y0), std::min(tri.maxY + 1, y1));
+    }
+}
+
+void OcclusionCuller::RasterizeTriangle(const ScreenTriangle& tri, int y0, int y1) {
+    float* depth = m_levels[0].depth.data();
+
+#ifdef OCCLUSION_SSE
+    // Four pixels per step; the buffer width is a multiple of four
+    const int startX = tri.minX & ~3;
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 a0 = _mm_set1_ps(tri.edgeA[0]);
+    const __m128 a1 = _mm_set1_ps(tri.edgeA[1]);
+    const __m128 a2 = _mm_set1_ps(tri.edgeA[2]);
+    const __m128 depthA = _mm_set1_ps(tri.depthA);
+
+    for (int y = y0; y < y1; y++) {
+        float centreY = y + 0.5f;
+        __m128 row0 = _mm_set1_ps(tri.edgeB[0] * centreY + tri.edgeC[0]);
+        __m128 row1 = _mm_set1_ps(tri.edgeB[1] * centreY + tri.edgeC[1]);
+        __m128 row2 = _mm_set1_ps(tri.edgeB[2] * centreY + tri.edgeC[2]);
+        __m128 rowDepth = _mm_set1_ps(tri.depthB * centreY + tri.depthC);
+        float* rowPixels = depth + static_cast<size_t>(y) * m_width;
+
+        for (int x = startX; x <= tri.maxX; x += 4) {
+            __m128 centreX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+            __m128 inside = _mm_and_ps(
+                _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, centreX), row0), zero),
+                           _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, centreX), row1), zero)),
+                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, centreX), row2), zero));
+            if (_mm_movemask_ps(inside) == 0) continue;
+
+            __m128 z = _mm_add_ps(_mm_mul_ps(depthA, centreX), rowDepth);
+            z = _mm_min_ps(_mm_max_ps(z, zero), one);
+            __m128 current = _mm_loadu_ps(rowPixels + x);
+            __m128 nearest = _mm_min_ps(current, z);
+            _mm_storeu_ps(rowPixels + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+        }
+    }
+#else
+    for (int y = y0; y < y1; y++) {
+        float centreY = y + 0.5f;
+        float* rowPixels = depth + static_cast<size_t>(y) * m_width;
+        for (int x = tri.minX; x <= tri.maxX; x++) {
+            float centreX = x + 0.5f;
+            bool inside = true;
+            for (int e = 0; e < 3 && inside; e++) {
+                inside = tri.edgeA[e] * centreX + tri.edgeB[e] * centreY + tri.edgeC[e] >= 0.0f;
+            }
+            if (!inside) continue;
+
+            float z = tri.depthA * centreX + tri.depthB * centreY + tri.depthC;
+            z = std::min(std::max(z, 0.0f), 1.0f);
+            rowPixels[x] = std::min(rowPixels[x], z);
+        }
+    }
+#endif
+}
+
+void OcclusionCuller::BuildPyramid() {
+    // Each texel keeps the farthest depth of the 2x2 texels below it, so a
+    // test against a coarse level is never more aggressive than level 0
+    for (size_t l = 1; l < m_levels.size(); l++) {
+        const Level& source = m_levels[l - 1];
+        Level& target = m_levels[l];
+
+        for (uint32_t y = 0; y < target.height; y++) {
+            const float* row0 = &source.depth[std::min(y * 2, source.height - 1) * source.width];
+            const float* row1 = &source.depth[std::min(y * 2 + 1, source.height - 1) * source.width];
+            float* out = &target.depth[y * target.width];
+            uint32_t x = 0;
+
+#ifdef OCCLUSION_SSE
+            // Eight source texels to four targets while both stay in bounds
+            for (; x + 4 <= target.width && x * 2 + 8 <= source.width; x += 4) {
+                __m128 low = _mm_max_ps(_mm_loadu_ps(row0 + x * 2), _mm_loadu_ps(row1 + x * 2));
+                __m128 high = _mm_max_ps(_mm_loadu_ps(row0 + x * 2 + 4), _mm_loadu_ps(row1 + x * 2 + 4));
+                __m128 even = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 odd = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+                _mm_storeu_ps(out + x, _mm_max_ps(even, odd));
+            }
+#endif
+
+            for (; x < target.width; x++) {
+                uint32_t x0 = std::min(x * 2, source.width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+                out[x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::ProjectAABB(const float min[3], const float max[3], float rect[4], float& nearestDepth) const {
+    const float* m = m_viewProjection;
+    float minNdcX, minNdcY, maxNdcX, maxNdcY, minNdcZ;
+
+#ifdef OCCLUSION_SSE
+    // Corners as two batches of four: the xy square at min z, then at max z
+    const __m128 xs = _mm_setr_ps(min[0], max[0], min[0], max[0]);
+    const __m128 ys = _mm_setr_ps(min[1], min[1], max[1], max[1]);
+    __m128 lowX = _mm_set1_ps(1e30f), highX = _mm_set1_ps(-1e30f);
+    __m128 lowY = _mm_set1_ps(1e30f), highY = _mm_set1_ps(-1e30f);
+    __m128 lowZ = _mm_set1_ps(1e30f);
+
+    for (int batch = 0; batch < 2; batch++) {
+        const float z = batch == 0 ? min[2] : max[2];
+        auto transform = [&](int row) {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[row]), xs), _mm_mul_ps(_mm_set1_ps(m[4 + row]), ys)),
+                              _mm_set1_ps(m[8 + row] * z + m[12 + row]));
+        };
+        __m128 clipW = transform(3);
+        if (_mm_movemask_ps(_mm_cmplt_ps(clipW, _mm_set1_ps(MIN_CLIP_W))) != 0) {
+            return false;
+        }
+        __m128 invW = _mm_div_ps(_mm_set1_ps(1.0f), clipW);
+        __m128 ndcX = _mm_mul_ps(transform(0), invW);
+        __m128 ndcY = _mm_mul_ps(transform(1), invW);
+        lowX = _mm_min_ps(lowX, ndcX);
+        highX = _mm_max_ps(highX, ndcX);
+        lowY = _mm_min_ps(lowY, ndcY);
+        highY = _mm_max_ps(highY, ndcY);
+        lowZ = _mm_min_ps(lowZ, _mm_mul_ps(transform(2), invW));
+    }
+
+    minNdcX = HorizontalMin(lowX);
+    maxNdcX = HorizontalMax(highX);
+    minNdcY = HorizontalMin(lowY);
+    maxNdcY = HorizontalMax(highY);
+    minNdcZ = HorizontalMin(lowZ);
+#else
+    minNdcX = minNdcY = minNdcZ = 1e30f;
+    maxNdcX = maxNdcY = -1e30f;
+    for (int c = 0; c < 8; c++) {
+        float x = (c & 1) ? max[0] : min[0];
+        float y = (c & 2) ? max[1] : min[1];
+        float z = (c & 4) ? max[2] : min[2];
+        float clipW = m[3] * x + m[7] * y + m[11] * z + m[15];
+        if (clipW < MIN_CLIP_W) {
+            return false;
+        }
+        float invW = 1.0f / clipW;
+        float ndcX = (m[0] * x + m[4] * y + m[8] * z + m[12]) * invW;
+        float ndcY = (m[1] * x + m[5] * y + m[9] * z + m[13]) * invW;
+        float ndcZ = (m[2] * x + m[6] * y + m[10] * z + m[14]) * invW;
+        minNdcX = std::min(minNdcX, ndcX);
+        maxNdcX = std::max(maxNdcX, ndcX);
+        minNdcY = std::min(minNdcY, ndcY);
+        maxNdcY = std::max(maxNdcY, ndcY);
+        minNdcZ = std::min(minNdcZ, ndcZ);
+    }
+#endif
+
+    rect[0] = (minNdcX * 0.5f + 0.5f) * m_width;
+    rect[1] = (0.5f - maxNdcY * 0.5f) * m_height;
+    rect[2] = (maxNdcX * 0.5f + 0.5f) * m_width;
+    rect[3] = (0.5f - minNdcY * 0.5f) * m_height;
+    nearestDepth = minNdcZ * 0.5f + 0.5f;
+    return true;
+}
+
+bool OcclusionCuller::IsOccluded(const float rect[4], float nearestDepth) const {
+    // Off-screen boxes are left to the frustum test
+    if (rect[2] < 0.0f || rect[3] < 0.0f || rect[0] >= m_width || rect[1] >= m_height) {
+        return false;
+    }
+
+    int x0 = std::max(0, static_cast<int>(std::floor(rect[0])));
+    int y0 = std::max(0, static_cast<int>(std::floor(rect[1])));
+    int x1 = std::min(static_cast<int>(m_width) - 1, static_cast<int>(std::floor(rect[2])));
+    int y1 = std::min(static_cast<int>(m_height) - 1, static_cast<int>(std::floor(rect[3])));
+
+    // Coarsest level at which the rectangle still spans at most about 3x3 texels
+    int extent = std::max(x1 - x0, y1 - y0) + 1;
+    size_t level = 0;
+    while (level + 1 < m_levels.size() && (extent >> level) > 2) {
+        level++;
+    }
+
+    const Level& hiz = m_levels[level];
+    int tx1 = std::min(x1 >> level, static_cast<int>(hiz.width) - 1);
+    int ty1 = std::min(y1 >> level, static_cast<int>(hiz.height) - 1);
+    for (int ty = y0 >> level; ty <= ty1; ty++) {
+        const float* row = &hiz.depth[static_cast<size_t>(ty) * hiz.width];
+        for (int tx = x0 >> level; tx <= tx1; tx++) {
+            if (nearestDepth <= row[tx]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool OcclusionCuller::TestAABB(const float min[3], const float max[3]) const {
+    float rect[4];
+    float nearestDepth;
+    if (!ProjectAABB(min, max, rect, nearestDepth)) {
+        return true;
+    }
+    return !IsOccluded(rect, nearestDepth);
+}
+
+uint32_t OcclusionCuller::TestAABBs(const float* minX, const float* minY, const float* minZ,
+                                    const float* maxX, const float* maxY, const float* maxZ,
+                                    size_t count, uint8_t* visible) const {
+    if (count == 0) return 0;
+
+    // Captured by one reference, so the job body fits std::function's inline storage and does not allocate
+    struct Batch {
+        const OcclusionCuller* culler;
+        const float* bounds[6];
+        uint8_t* visible;
+        std::atomic<uint32_t> culled;
+    } batch{ this, { minX, minY, minZ, maxX, maxY, maxZ }, visible, {0} };
+
+    Platform::JobSystem& jobs = m_jobSystem ? *m_jobSystem : Platform::JobSystem::GetDefault();
+    jobs.ParallelFor(static_cast<uint32_t>(count), TEST_BATCH_SIZE, [&batch](uint32_t begin, uint32_t end) {
+        const float* const* bounds = batch.bounds;
+        uint32_t batchCulled = 0;
+        for (uint32_t i = begin; i < end; i++) {
+            if (!batch.visible[i]) continue;
+            const float min[3] = { bounds[0][i], bounds[1][i], bounds[2][i] };
+            const float max[3] = { bounds[3][i], bounds[4][i], bounds[5][i] };
+            if (!batch.culler->TestAABB(min, max)) {
+                batch.visible[i] = 0;
+                batchCulled++;
+            }
+        }
+        batch.culled.fetch_add(batchCulled, std::memory_order_relaxed);
+    });
+    return batch.culled.load();
+}
+
+float OcclusionCuller::GetDepth(size_t level, uint32_t x, uint32_t y) const {
+    const Level& hiz = m_levels[level];
+    return hiz.depth[static_cast<size_t>(y) * hiz.width + x];
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
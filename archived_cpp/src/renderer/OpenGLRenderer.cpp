@@ -1,4 +1,8 @@
 #include "renderer/OpenGLRenderer.h"
+#include "renderer/CommandBuffer.h"
+#include "platform/MemoryTracker.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 // Include GLAD before GLFW
@@ -10,15 +14,69 @@
 namespace SwordAndStone {
 namespace Renderer {
 
+#ifdef ENABLE_OPENGL
+// S3TC is an extension in core profile headers; BPTC is core since 4.2
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#endif
+
+namespace {
+
+// format and type are unused for compressed formats
+struct GLTextureFormat {
+    GLint internalFormat;
+    GLenum format;
+    GLenum type;
+};
+
+GLTextureFormat GetGLTextureFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::RGBA8: return { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE };
+        case TextureFormat::RGB8: return { GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE };
+        case TextureFormat::SRGBA8: return { GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE };
+        case TextureFormat::RGBA16F: return { GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT };
+        case TextureFormat::RGBA32F: return { GL_RGBA32F, GL_RGBA, GL_FLOAT };
+        case TextureFormat::Depth24Stencil8:
+            return { GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8 };
+        case TextureFormat::Depth32F: return { GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT };
+        case TextureFormat::BC1: return { GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 0, 0 };
+        case TextureFormat::BC1SRGB: return { GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 0, 0 };
+        case TextureFormat::BC3: return { GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 0, 0 };
+        case TextureFormat::BC3SRGB: return { GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 0, 0 };
+        case TextureFormat::BC7: return { GL_COMPRESSED_RGBA_BPTC_UNORM, 0, 0 };
+        case TextureFormat::BC7SRGB: return { GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 0, 0 };
+        default: return { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE };
+    }
+}
+
+} // namespace
+#endif
+
 OpenGLRenderer::OpenGLRenderer()
     : m_windowHandle(nullptr)
     , m_width(0)
     , m_height(0)
-    , m_vao(0)
+    , m_currentVAO(0)
     , m_currentShader(0)
     , m_currentVBO(0)
     , m_currentIBO(0)
+    , m_streamingBuffer(0)
+    , m_streamingPersistent(false)
+    , m_submittedFence(0)
+    , m_completedFence(0)
 {
+    for (uint32_t i = 0; i < FENCE_SLOTS; i++) {
+        m_frameFences[i] = nullptr;
+    }
     m_clearColor[0] = 0.2f;
     m_clearColor[1] = 0.3f;
     m_clearColor[2] = 0.4f;
@@ -46,10 +104,6 @@ bool OpenGLRenderer::Initialize(void* windowHandle, uint32_t width, uint32_t hei
     std::cout << "  Renderer: " << glGetString(GL_RENDERER) << std::endl;
     std::cout << "  Version: " << glGetString(GL_VERSION) << std::endl;
     
-    // Create default VAO
-    glGenVertexArrays(1, &m_vao);
-    glBindVertexArray(m_vao);
-    
     // Set default OpenGL state
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
@@ -58,6 +112,8 @@ bool OpenGLRenderer::Initialize(void* windowHandle, uint32_t width, uint32_t hei
     
     SetViewport(0, 0, width, height);
     
+    CreateStreamingBuffer(DEFAULT_STREAMING_CAPACITY);
+    
     return true;
 #else
     return false;
@@ -66,10 +122,15 @@ bool OpenGLRenderer::Initialize(void* windowHandle, uint32_t width, uint32_t hei
 
 void OpenGLRenderer::Shutdown() {
 #ifdef ENABLE_OPENGL
-    if (m_vao) {
-        glDeleteVertexArrays(1, &m_vao);
-        m_vao = 0;
+    DestroyStreamingBuffer();
+    
+    m_deletedVertexArrays.clear();
+    m_vertexArrays.Clear(m_deletedVertexArrays);
+    for (uint32_t vao : m_deletedVertexArrays) {
+        GLuint name = vao;
+        glDeleteVertexArrays(1, &name);
     }
+    m_currentVAO = 0;
     std::cout << "OpenGL Renderer shut down" << std::endl;
 #endif
 }
@@ -82,9 +143,17 @@ void OpenGLRenderer::Resize(uint32_t width, uint32_t height) {
 
 void OpenGLRenderer::BeginFrame() {
     m_stats = RenderStats();
+    RetireStreamingFrames();
 }
 
 void OpenGLRenderer::EndFrame() {
+#ifdef ENABLE_OPENGL
+    if (m_streamingBuffer) {
+        uint64_t fence = ++m_submittedFence;
+        m_frameFences[fence % FENCE_SLOTS] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_streaming.EndFrame(fence);
+    }
+#endif
 }
 
 void OpenGLRenderer::Present() {
@@ -132,11 +201,15 @@ void OpenGLRenderer::SetScissor(int x, int y, uint32_t width, uint32_t height) {
 }
 
 uint32_t OpenGLRenderer::CreateVertexBuffer(const void* data, size_t size, BufferUsage usage) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
 #ifdef ENABLE_OPENGL
     GLuint vbo;
     glGenBuffers(1, &vbo);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, size, data, ConvertBufferUsage(usage));
+    
+    // Build the non-indexed VAO up front so draws only need a single bind
+    GetVertexArray(vbo, 0, LAYOUT_STANDARD);
     return vbo;
 #else
     return 0;
@@ -144,7 +217,11 @@ uint32_t OpenGLRenderer::CreateVertexBuffer(const void* data, size_t size, Buffe
 }
 
 uint32_t OpenGLRenderer::CreateIndexBuffer(const uint32_t* data, size_t count, BufferUsage usage) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
 #ifdef ENABLE_OPENGL
+    // The element array binding is VAO state, so keep cached VAOs out of the way
+    BindVertexArray(0);
+    
     GLuint ibo;
     glGenBuffers(1, &ibo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
@@ -157,6 +234,16 @@ uint32_t OpenGLRenderer::CreateIndexBuffer(const uint32_t* data, size_t count, B
 
 void OpenGLRenderer::UpdateVertexBuffer(uint32_t buffer, const void* data, size_t size, size_t offset) {
 #ifdef ENABLE_OPENGL
+    // Stage through the mapped ring so a buffer the GPU is still reading never stalls
+    if (m_streamingPersistent) {
+        StreamingAllocation staging = m_streaming.Allocate(size, 4);
+        if (staging) {
+            memcpy(staging.data, data, size);
+            CopyStreamingToBuffer(staging, buffer, offset);
+            return;
+        }
+    }
+    
     glBindBuffer(GL_ARRAY_BUFFER, buffer);
     glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
 #endif
@@ -164,24 +251,120 @@ void OpenGLRenderer::UpdateVertexBuffer(uint32_t buffer, const void* data, size_
 
 void OpenGLRenderer::DeleteBuffer(uint32_t buffer) {
 #ifdef ENABLE_OPENGL
+    DeleteVertexArrays(buffer);
+    
     GLuint buf = buffer;
     glDeleteBuffers(1, &buf);
 #endif
 }
 
+StreamingAllocation OpenGLRenderer::AllocateStreaming(size_t size, size_t alignment) {
+    return m_streaming.Allocate(size, alignment);
+}
+
+void OpenGLRenderer::CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) {
+#ifdef ENABLE_OPENGL
+    if (!source || source.buffer != m_streamingBuffer) return;
+    
+    // The ring range is not in use by the GPU, so the shadow upload cannot stall
+    glBindBuffer(GL_COPY_READ_BUFFER, m_streamingBuffer);
+    if (!m_streamingPersistent) {
+        glBufferSubData(GL_COPY_READ_BUFFER, source.offset, source.size, source.data);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, source.offset, offset, source.size);
+    m_stats.bytesStreamed += source.size;
+#endif
+}
+
+void OpenGLRenderer::CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                                size_t size) {
+#ifdef ENABLE_OPENGL
+    glBindBuffer(GL_COPY_READ_BUFFER, source);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, destination);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceOffset, destinationOffset, size);
+#endif
+}
+
 uint32_t OpenGLRenderer::CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) {
-    // TODO: Implement texture creation
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Textures);
+#ifdef ENABLE_OPENGL
+    GLTextureFormat glFormat = GetGLTextureFormat(format);
+    GLuint tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    uint32_t dataSize = GetTextureDataSize(width, height, format);
+    if (IsCompressedFormat(format)) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, 0, glFormat.internalFormat, width, height, 0,
+                               static_cast<GLsizei>(dataSize), data);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, glFormat.internalFormat, width, height, 0, glFormat.format, glFormat.type, data);
+    }
+    
+    // Sampling stops at the highest uploaded level, so a texture without
+    // mips is complete; UpdateTexture2D raises the limit as levels arrive
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    
+    m_textures[tex] = { width, height, format, 1u };
+    if (data) {
+        m_stats.bytesUploaded += dataSize;
+    }
+    return tex;
+#else
     return 0;
+#endif
 }
 
 void OpenGLRenderer::UpdateTexture2D(uint32_t texture, const void* data, uint32_t mipLevel) {
-    // TODO: Implement texture update
+#ifdef ENABLE_OPENGL
+    auto it = m_textures.find(texture);
+    if (it == m_textures.end() || !data || mipLevel >= 32) return;
+    
+    TextureInfo& info = it->second;
+    GLTextureFormat glFormat = GetGLTextureFormat(info.format);
+    uint32_t mipWidth = std::max(1u, info.width >> mipLevel);
+    uint32_t mipHeight = std::max(1u, info.height >> mipLevel);
+    uint32_t dataSize = GetTextureDataSize(mipWidth, mipHeight, info.format);
+    bool compressed = IsCompressedFormat(info.format);
+    
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (info.allocatedLevels & (1u << mipLevel)) {
+        if (compressed) {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, mipLevel, 0, 0, mipWidth, mipHeight, glFormat.internalFormat,
+                                      static_cast<GLsizei>(dataSize), data);
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, mipLevel, 0, 0, mipWidth, mipHeight, glFormat.format, glFormat.type, data);
+        }
+    } else {
+        if (compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, mipLevel, glFormat.internalFormat, mipWidth, mipHeight, 0,
+                                   static_cast<GLsizei>(dataSize), data);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, mipLevel, glFormat.internalFormat, mipWidth, mipHeight, 0,
+                         glFormat.format, glFormat.type, data);
+        }
+        info.allocatedLevels |= 1u << mipLevel;
+        
+        // Levels are sampled only while the chain below them is complete
+        GLint maxLevel = 0;
+        while (maxLevel < 31 && (info.allocatedLevels & (1u << (maxLevel + 1)))) {
+            maxLevel++;
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+    }
+    m_stats.bytesUploaded += dataSize;
+#endif
 }
 
 void OpenGLRenderer::DeleteTexture(uint32_t texture) {
 #ifdef ENABLE_OPENGL
     GLuint tex = texture;
     glDeleteTextures(1, &tex);
+    m_textures.erase(texture);
 #endif
 }
 
@@ -193,6 +376,7 @@ void OpenGLRenderer::BindTexture(uint32_t slot, uint32_t texture) {
 }
 
 uint32_t OpenGLRenderer::CreateShader(const std::string& vertexSource, const std::string& fragmentSource) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
     // TODO: Implement shader creation
     return 0;
 }
@@ -200,6 +384,13 @@ uint32_t OpenGLRenderer::CreateShader(const std::string& vertexSource, const std
 void OpenGLRenderer::DeleteShader(uint32_t shader) {
 #ifdef ENABLE_OPENGL
     glDeleteProgram(shader);
+    for (auto it = m_uniformLocations.begin(); it != m_uniformLocations.end();) {
+        if ((it->first >> 32) == shader) {
+            it = m_uniformLocations.erase(it);
+        } else {
+            ++it;
+        }
+    }
 #endif
 }
 
@@ -211,17 +402,104 @@ void OpenGLRenderer::BindShader(uint32_t shader) {
 }
 
 void OpenGLRenderer::SetShaderUniform(uint32_t shader, const std::string& name, const void* data, size_t size) {
-    // TODO: Implement uniform setting
+    SetShaderUniform(shader, InternUniformName(name), data, size);
+}
+
+void OpenGLRenderer::SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) {
+#ifdef ENABLE_OPENGL
+    if (shader == 0 || uniform == INVALID_UNIFORM || !data) return;
+    
+    uint64_t key = (static_cast<uint64_t>(shader) << 32) | uniform;
+    auto it = m_uniformLocations.find(key);
+    if (it == m_uniformLocations.end()) {
+        // The active type decides which uniform call fits the data
+        UniformLocation resolved = { -1, 0 };
+        const std::string& name = GetUniformName(uniform);
+        const GLchar* names[1] = { name.c_str() };
+        GLuint index = GL_INVALID_INDEX;
+        glGetUniformIndices(shader, 1, names, &index);
+        if (index != GL_INVALID_INDEX) {
+            GLint type = 0;
+            glGetActiveUniformsiv(shader, 1, &index, GL_UNIFORM_TYPE, &type);
+            resolved.location = glGetUniformLocation(shader, name.c_str());
+            resolved.type = static_cast<uint32_t>(type);
+        }
+        it = m_uniformLocations.emplace(key, resolved).first;
+    }
+    
+    const UniformLocation& target = it->second;
+    if (target.location < 0) return;
+    
+    // glProgramUniform* needs GL 4.1 or ARB_separate_shader_objects; a 3.3 context binds the
+    // program for glUniform* and then restores the one BindShader left current
+    const bool direct = glProgramUniform1fv != nullptr;
+    const bool rebind = !direct && shader != m_currentShader;
+    if (rebind) {
+        glUseProgram(shader);
+    }
+    
+    // Arrays are uploaded whole: the element count follows from the size
+    const GLfloat* floats = static_cast<const GLfloat*>(data);
+    const GLint* ints = static_cast<const GLint*>(data);
+    const GLint location = target.location;
+    GLsizei count = static_cast<GLsizei>(size / 4);
+    bool uploaded = true;
+    switch (target.type) {
+        case GL_FLOAT:
+            direct ? glProgramUniform1fv(shader, location, count, floats) : glUniform1fv(location, count, floats);
+            break;
+        case GL_FLOAT_VEC2:
+            direct ? glProgramUniform2fv(shader, location, count / 2, floats)
+                   : glUniform2fv(location, count / 2, floats);
+            break;
+        case GL_FLOAT_VEC3:
+            direct ? glProgramUniform3fv(shader, location, count / 3, floats)
+                   : glUniform3fv(location, count / 3, floats);
+            break;
+        case GL_FLOAT_VEC4:
+            direct ? glProgramUniform4fv(shader, location, count / 4, floats)
+                   : glUniform4fv(location, count / 4, floats);
+            break;
+        case GL_FLOAT_MAT3:
+            direct ? glProgramUniformMatrix3fv(shader, location, count / 9, GL_FALSE, floats)
+                   : glUniformMatrix3fv(location, count / 9, GL_FALSE, floats);
+            break;
+        case GL_FLOAT_MAT4:
+            direct ? glProgramUniformMatrix4fv(shader, location, count / 16, GL_FALSE, floats)
+                   : glUniformMatrix4fv(location, count / 16, GL_FALSE, floats);
+            break;
+        case GL_INT_VEC2:
+            direct ? glProgramUniform2iv(shader, location, count / 2, ints) : glUniform2iv(location, count / 2, ints);
+            break;
+        case GL_INT_VEC3:
+            direct ? glProgramUniform3iv(shader, location, count / 3, ints) : glUniform3iv(location, count / 3, ints);
+            break;
+        case GL_INT_VEC4:
+            direct ? glProgramUniform4iv(shader, location, count / 4, ints) : glUniform4iv(location, count / 4, ints);
+            break;
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_2D_ARRAY:
+            direct ? glProgramUniform1iv(shader, location, count, ints) : glUniform1iv(location, count, ints);
+            break;
+        default:
+            uploaded = false;
+            break;
+    }
+    
+    if (rebind) {
+        glUseProgram(m_currentShader);
+    }
+    if (!uploaded) return;
+    m_stats.bytesUploaded += size;
+#endif
 }
 
 void OpenGLRenderer::DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount, 
                                  PrimitiveTopology topology) {
 #ifdef ENABLE_OPENGL
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
-    
-    SetupVertexAttributes();
+    BindVertexArray(GetVertexArray(vertexBuffer, indexBuffer, LAYOUT_STANDARD));
     
     glDrawElements(ConvertTopology(topology), indexCount, GL_UNSIGNED_INT, nullptr);
     
@@ -232,10 +510,7 @@ void OpenGLRenderer::DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, ui
 
 void OpenGLRenderer::Draw(uint32_t vertexBuffer, uint32_t vertexCount, PrimitiveTopology topology) {
 #ifdef ENABLE_OPENGL
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    
-    SetupVertexAttributes();
+    BindVertexArray(GetVertexArray(vertexBuffer, 0, LAYOUT_STANDARD));
     
     glDrawArrays(ConvertTopology(topology), 0, vertexCount);
     
@@ -244,6 +519,125 @@ void OpenGLRenderer::Draw(uint32_t vertexBuffer, uint32_t vertexCount, Primitive
 #endif
 }
 
+void OpenGLRenderer::MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, const IndirectDrawCommand* commands,
+                                      uint32_t drawCount, PrimitiveTopology topology) {
+#ifdef ENABLE_OPENGL
+    if (drawCount == 0) return;
+    
+    BindVertexArray(GetVertexArray(vertexBuffer, indexBuffer, LAYOUT_STANDARD));
+    GLenum mode = ConvertTopology(topology);
+    
+    uint32_t triangles = 0;
+    for (uint32_t i = 0; i < drawCount; i++) {
+        triangles += (topology == PrimitiveTopology::TriangleList) ?
+                     commands[i].indexCount / 3 * commands[i].instanceCount : 0;
+    }
+    
+#ifdef GL_DRAW_INDIRECT_BUFFER
+    // Commands are written straight into the mapped ring, which doubles as the indirect buffer
+    if (m_streamingPersistent && glMultiDrawElementsIndirect) {
+        size_t size = drawCount * sizeof(IndirectDrawCommand);
+        StreamingAllocation allocation = m_streaming.Allocate(size, sizeof(uint32_t));
+        if (allocation) {
+            memcpy(allocation.data, commands, size);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_streamingBuffer);
+            glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, reinterpret_cast<const void*>(allocation.offset),
+                                        drawCount, 0);
+            
+            m_stats.drawCalls++;
+            m_stats.multiDrawCommands += drawCount;
+            m_stats.triangles += triangles;
+            return;
+        }
+    }
+#endif
+    
+    // GL 3.2 fallback: one glMultiDrawElementsBaseVertex while every command is a single
+    // instance, otherwise one instanced draw per command
+    bool instanced = false;
+    for (uint32_t i = 0; i < drawCount; i++) {
+        instanced = instanced || commands[i].instanceCount > 1;
+    }
+    
+    uint32_t drawn = 0;
+    if (instanced) {
+        for (uint32_t i = 0; i < drawCount; i++) {
+            const IndirectDrawCommand& command = commands[i];
+            if (command.instanceCount == 0) continue;
+            
+            glDrawElementsInstancedBaseVertex(mode, static_cast<GLsizei>(command.indexCount), GL_UNSIGNED_INT,
+                                              reinterpret_cast<const void*>(command.firstIndex * sizeof(uint32_t)),
+                                              static_cast<GLsizei>(command.instanceCount), command.baseVertex);
+            drawn++;
+        }
+        m_stats.drawCalls += drawn;
+    } else {
+        m_multiDrawCounts.clear();
+        m_multiDrawOffsets.clear();
+        m_multiDrawBaseVertices.clear();
+        for (uint32_t i = 0; i < drawCount; i++) {
+            const IndirectDrawCommand& command = commands[i];
+            if (command.instanceCount == 0) continue;
+            
+            m_multiDrawCounts.push_back(static_cast<int32_t>(command.indexCount));
+            m_multiDrawOffsets.push_back(reinterpret_cast<const void*>(command.firstIndex * sizeof(uint32_t)));
+            m_multiDrawBaseVertices.push_back(command.baseVertex);
+        }
+        drawn = static_cast<uint32_t>(m_multiDrawCounts.size());
+        if (drawn == 0) return;
+        glMultiDrawElementsBaseVertex(mode, m_multiDrawCounts.data(), GL_UNSIGNED_INT, m_multiDrawOffsets.data(),
+                                      static_cast<GLsizei>(drawn), m_multiDrawBaseVertices.data());
+        m_stats.drawCalls++;
+    }
+    
+    m_stats.multiDrawCommands += drawn;
+    m_stats.triangles += triangles;
+#endif
+}
+
+void OpenGLRenderer::DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                                          uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                                          PrimitiveTopology topology) {
+#ifdef ENABLE_OPENGL
+    if (instanceCount == 0) return;
+    
+    // Without persistent mapping the ring lives in a CPU shadow; upload the instances first
+    size_t instanceBytes = static_cast<size_t>(instanceCount) * sizeof(InstanceData);
+    if (instanceBuffer == m_streamingBuffer && !m_streamingPersistent) {
+        if (instanceOffset + instanceBytes > m_streamingShadow.size()) return;
+        glBindBuffer(GL_COPY_READ_BUFFER, m_streamingBuffer);
+        glBufferSubData(GL_COPY_READ_BUFFER, instanceOffset, instanceBytes, m_streamingShadow.data() + instanceOffset);
+        m_stats.bytesStreamed += instanceBytes;
+    }
+    
+    BindVertexArray(GetVertexArray(vertexBuffer, indexBuffer, LAYOUT_INSTANCED, instanceBuffer));
+    GLenum mode = ConvertTopology(topology);
+    
+    // An offset on an instance boundary is expressed as the base instance, keeping the VAO untouched
+    if (instanceOffset % sizeof(InstanceData) == 0 && glDrawElementsInstancedBaseInstance) {
+        glDrawElementsInstancedBaseInstance(mode, indexCount, GL_UNSIGNED_INT, nullptr, instanceCount,
+                                            static_cast<GLuint>(instanceOffset / sizeof(InstanceData)));
+    } else {
+        // Re-point the instance attributes for this draw, then restore them for the cached VAO
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        SetupInstanceAttributes(instanceOffset);
+        glDrawElementsInstanced(mode, indexCount, GL_UNSIGNED_INT, nullptr, instanceCount);
+        SetupInstanceAttributes(0);
+    }
+    
+    m_stats.drawCalls++;
+    m_stats.instancesDrawn += instanceCount;
+    m_stats.triangles += (topology == PrimitiveTopology::TriangleList) ? indexCount / 3 * instanceCount : 0;
+#endif
+}
+
+void OpenGLRenderer::ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) {
+    // GL has no deferred contexts; lists recorded on workers are replayed here in order
+    for (uint32_t i = 0; i < count; i++) {
+        lists[i]->Execute(*this);
+    }
+}
+
 void OpenGLRenderer::SetDepthTest(bool enabled) {
 #ifdef ENABLE_OPENGL
     if (enabled) {
@@ -312,6 +706,147 @@ uint32_t OpenGLRenderer::ConvertBufferUsage(BufferUsage usage) {
 #endif
 }
 
+uint32_t OpenGLRenderer::GetVertexArray(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t layout,
+                                        uint32_t instanceBuffer) {
+#ifdef ENABLE_OPENGL
+    // Skipped binds are counted by BindVertexArray alone, so a hit only counts as a hit
+    VertexArrayCache::Key key = { vertexBuffer, indexBuffer, layout, instanceBuffer };
+    uint32_t cached = m_vertexArrays.Find(key);
+    if (cached != 0) {
+        m_stats.vertexArrayCacheHits++;
+        return cached;
+    }
+    
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    BindVertexArray(vao);
+    
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    SetupVertexAttributes();
+    if (layout == LAYOUT_INSTANCED) {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        SetupInstanceAttributes(0);
+    }
+    if (indexBuffer) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    }
+    
+    m_vertexArrays.Insert(key, vao);
+    m_stats.vertexArrayCacheMisses++;
+    return vao;
+#else
+    return 0;
+#endif
+}
+
+void OpenGLRenderer::BindVertexArray(uint32_t vao) {
+#ifdef ENABLE_OPENGL
+    if (vao == m_currentVAO) {
+        m_stats.bindsSkipped++;
+        return;
+    }
+    glBindVertexArray(vao);
+    m_currentVAO = vao;
+#endif
+}
+
+void OpenGLRenderer::DeleteVertexArrays(uint32_t buffer) {
+#ifdef ENABLE_OPENGL
+    m_deletedVertexArrays.clear();
+    m_vertexArrays.RemoveBuffer(buffer, m_deletedVertexArrays);
+    for (uint32_t vao : m_deletedVertexArrays) {
+        if (vao == m_currentVAO) {
+            BindVertexArray(0);
+        }
+        GLuint name = vao;
+        glDeleteVertexArrays(1, &name);
+    }
+#endif
+}
+
+void OpenGLRenderer::CreateStreamingBuffer(size_t capacity) {
+#ifdef ENABLE_OPENGL
+    // Keep the ring out of whatever VAO is bound
+    BindVertexArray(0);
+    
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    
+    uint8_t* memory = nullptr;
+#ifdef GL_MAP_PERSISTENT_BIT
+    if (glBufferStorage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_READ_BUFFER, capacity, nullptr, flags);
+        memory = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, capacity, flags));
+    }
+#endif
+    m_streamingPersistent = memory != nullptr;
+    if (!m_streamingPersistent) {
+        glBufferData(GL_COPY_READ_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        m_streamingShadow.assign(capacity, 0);
+        memory = m_streamingShadow.data();
+    }
+    
+    m_streamingBuffer = buffer;
+    m_streaming.Initialize(memory, capacity, buffer);
+    std::cout << "  Streaming ring: " << (capacity >> 20) << " MB"
+              << (m_streamingPersistent ? " (persistent mapped)" : " (shadow copy)") << std::endl;
+#endif
+}
+
+void OpenGLRenderer::DestroyStreamingBuffer() {
+#ifdef ENABLE_OPENGL
+    if (!m_streamingBuffer) return;
+    
+    for (uint32_t i = 0; i < FENCE_SLOTS; i++) {
+        if (m_frameFences[i]) {
+            glDeleteSync(static_cast<GLsync>(m_frameFences[i]));
+            m_frameFences[i] = nullptr;
+        }
+    }
+    
+    if (m_streamingPersistent) {
+        glBindBuffer(GL_COPY_READ_BUFFER, m_streamingBuffer);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+    }
+    DeleteVertexArrays(m_streamingBuffer);  // instanced VAOs that read from the ring
+    GLuint buffer = m_streamingBuffer;
+    glDeleteBuffers(1, &buffer);
+    
+    m_streaming.Initialize(nullptr, 0, 0);
+    m_streamingShadow.clear();
+    m_streamingBuffer = 0;
+    m_submittedFence = m_completedFence = 0;
+#endif
+}
+
+void OpenGLRenderer::RetireStreamingFrames() {
+#ifdef ENABLE_OPENGL
+    while (m_completedFence < m_submittedFence) {
+        uint64_t fence = m_completedFence + 1;
+        GLsync sync = static_cast<GLsync>(m_frameFences[fence % FENCE_SLOTS]);
+        
+        // Only block when every ring frame is still in flight
+        bool wait = m_submittedFence - m_completedFence >= StreamingRingBuffer::FRAME_COUNT;
+        GLenum result;
+        do {
+            result = glClientWaitSync(sync, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000ull : 0);
+        } while (wait && result == GL_TIMEOUT_EXPIRED);
+        
+        if (result == GL_TIMEOUT_EXPIRED) break;
+        if (result == GL_CONDITION_SATISFIED) {
+            m_stats.streamingStalls++;
+        }
+        
+        glDeleteSync(sync);
+        m_frameFences[fence % FENCE_SLOTS] = nullptr;
+        m_completedFence = fence;
+    }
+    m_streaming.Retire(m_completedFence);
+#endif
+}
+
 void OpenGLRenderer::SetupVertexAttributes() {
 #ifdef ENABLE_OPENGL
     // Position attribute
@@ -332,5 +867,20 @@ void OpenGLRenderer::SetupVertexAttributes() {
 #endif
 }
 
+void OpenGLRenderer::SetupInstanceAttributes(size_t offset) {
+#ifdef ENABLE_OPENGL
+    // Transform rows at locations 4-6, color at 7; each advances once per instance
+    for (GLuint row = 0; row < 3; row++) {
+        glVertexAttribPointer(4 + row, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offset + offsetof(InstanceData, transform) + row * 4 * sizeof(float)));
+        glEnableVertexAttribArray(4 + row);
+        glVertexAttribDivisor(4 + row, 1);
+    }
+    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(offset + offsetof(InstanceData, color)));
+    glEnableVertexAttribArray(7);
+    glVertexAttribDivisor(7, 1);
+#endif
+}
+
 } // namespace Renderer
 } // namespace SwordAndStone
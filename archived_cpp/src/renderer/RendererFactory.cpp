@@ -1,5 +1,7 @@
 #include "renderer/IRenderer.h"
 #include "renderer/OpenGLRenderer.h"
+#include "renderer/SoftwareRenderer.h"
+#include "renderer/NullRenderer.h"
 
 #ifdef ENABLE_DX11
 #include "renderer/DirectX11Renderer.h"
@@ -37,6 +39,12 @@ std::unique_ptr<IRenderer> RendererFactory::Create(RenderAPI api) {
             throw std::runtime_error("DirectX 12 renderer not available on this platform");
 #endif
 
+        case RenderAPI::Software:
+            return std::make_unique<SoftwareRenderer>();
+
+        case RenderAPI::Null:
+            return std::make_unique<NullRenderer>();
+
         default:
             throw std::runtime_error("Unknown or unsupported render API");
     }
@@ -57,6 +65,10 @@ std::vector<RenderAPI> RendererFactory::GetAvailableAPIs() {
     apis.push_back(RenderAPI::DirectX12);
 #endif
 
+    // Always available; last so GPU backends are preferred
+    apis.push_back(RenderAPI::Software);
+    apis.push_back(RenderAPI::Null);
+
     return apis;
 }
 
@@ -0,0 +1,935 @@
+#include "renderer/SoftwareRenderer.h"
+#include "renderer/CommandBuffer.h"
+#include "renderer/BlockCompression.h"
+#include "platform/JobSystem.h"
+#include "platform/MemoryTracker.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define SOFTWARE_RASTER_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace SwordAndStone {
+namespace Renderer {
+
+namespace {
+
+// Vertex transform and triangle setup are split into batches of this size
+constexpr uint32_t VERTEX_BATCH = 8192;
+constexpr uint32_t TRIANGLE_BATCH = 4096;
+
+uint32_t PackColor(float r, float g, float b, float a) {
+    auto toByte = [](float v) {
+        return static_cast<uint32_t>(std::min(1.0f, std::max(0.0f, v)) * 255.0f + 0.5f);
+    };
+    return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+}
+
+void UnpackColor(uint32_t packed, float out[4]) {
+    const float scale = 1.0f / 255.0f;
+    out[0] = static_cast<float>(packed & 0xFF) * scale;
+    out[1] = static_cast<float>((packed >> 8) & 0xFF) * scale;
+    out[2] = static_cast<float>((packed >> 16) & 0xFF) * scale;
+    out[3] = static_cast<float>(packed >> 24) * scale;
+}
+
+// sRGB to linear for each 8-bit channel value
+const float* SrgbDecodeTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values;
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+bool IsSrgbFormat(TextureFormat format) {
+    return format == TextureFormat::SRGBA8 || format == TextureFormat::BC1SRGB ||
+           format == TextureFormat::BC3SRGB || format == TextureFormat::BC7SRGB;
+}
+
+void IdentityMatrix(float m[16]) {
+    for (int i = 0; i < 16; i++) {
+        m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+// Plane equation f(x, y) = p[0] * x + p[1] * y + p[2] through three screen points
+void ComputePlane(const float x[3], const float y[3], const float f[3], float invArea, float plane[3]) {
+    float df1 = f[1] - f[0];
+    float df2 = f[2] - f[0];
+    plane[0] = (df1 * (y[2] - y[0]) - df2 * (y[1] - y[0])) * invArea;
+    plane[1] = (df2 * (x[1] - x[0]) - df1 * (x[2] - x[0])) * invArea;
+    plane[2] = f[0] - plane[0] * x[0] - plane[1] * y[0];
+}
+
+} // namespace
+
+SoftwareRenderer::SoftwareRenderer(Platform::JobSystem* jobSystem)
+    : m_jobSystem(jobSystem ? jobSystem : &Platform::JobSystem::GetDefault())
+    , m_width(0)
+    , m_height(0)
+    , m_stride(0)
+    , m_nextID(1)
+    , m_submittedFence(0)
+    , m_currentShader(0)
+    , m_boundTexture(0)
+    , m_depthTest(true)
+    , m_blending(false)
+    , m_culling(true)
+    , m_tilesX(0)
+    , m_tilesY(0)
+{
+    m_viewport[0] = m_viewport[1] = m_viewport[2] = m_viewport[3] = 0;
+    m_clearColor[0] = 0.2f;
+    m_clearColor[1] = 0.3f;
+    m_clearColor[2] = 0.4f;
+    m_clearColor[3] = 1.0f;
+}
+
+SoftwareRenderer::~SoftwareRenderer() {
+    Shutdown();
+}
+
+bool SoftwareRenderer::Initialize(void* windowHandle, uint32_t width, uint32_t height) {
+    m_width = width;
+    m_height = height;
+    AllocateFramebuffer();
+    SetViewport(0, 0, width, height);
+
+    uint32_t streamingBuffer = CreateVertexBuffer(nullptr, DEFAULT_STREAMING_CAPACITY, BufferUsage::Stream);
+    m_streaming.Initialize(m_buffers[streamingBuffer].data.data(), DEFAULT_STREAMING_CAPACITY, streamingBuffer);
+    return true;
+}
+
+void SoftwareRenderer::Shutdown() {
+    m_triangles.clear();
+    m_drawStates.clear();
+    m_streaming.Initialize(nullptr, 0, 0);
+    m_buffers.clear();
+    m_textures.clear();
+    m_shaders.clear();
+}
+
+void SoftwareRenderer::Resize(uint32_t width, uint32_t height) {
+    Flush();
+    m_width = width;
+    m_height = height;
+    AllocateFramebuffer();
+    SetViewport(0, 0, width, height);
+}
+
+void SoftwareRenderer::BeginFrame() {
+    m_stats = RenderStats();
+    m_streaming.Retire(m_submittedFence);
+}
+
+void SoftwareRenderer::EndFrame() {
+    Flush();
+    m_streaming.EndFrame(++m_submittedFence);
+}
+
+void SoftwareRenderer::Present() {
+}
+
+void SoftwareRenderer::Clear(uint32_t flags, float r, float g, float b, float a) {
+    // Clears are ordered against draws, so pending triangles go first
+    Flush();
+
+    if (flags & ClearColor) {
+        std::fill(m_color.begin(), m_color.end(), PackColor(r, g, b, a));
+    }
+    if (flags & ClearDepth) {
+        std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+    }
+}
+
+void SoftwareRenderer::SetClearColor(float r, float g, float b, float a) {
+    m_clearColor[0] = r;
+    m_clearColor[1] = g;
+    m_clearColor[2] = b;
+    m_clearColor[3] = a;
+}
+
+void SoftwareRenderer::SetViewport(int x, int y, uint32_t width, uint32_t height) {
+    m_viewport[0] = x;
+    m_viewport[1] = y;
+    m_viewport[2] = static_cast<int>(width);
+    m_viewport[3] = static_cast<int>(height);
+}
+
+void SoftwareRenderer::SetScissor(int x, int y, uint32_t width, uint32_t height) {
+    // Scissor testing is never enabled through IRenderer, matching the GL backend
+}
+
+uint32_t SoftwareRenderer::CreateVertexBuffer(const void* data, size_t size, BufferUsage usage) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
+    BufferResource resource;
+    resource.data.resize(size);
+    if (data) {
+        memcpy(resource.data.data(), data, size);
+        m_stats.bytesUploaded += size;
+    }
+
+    uint32_t id = m_nextID++;
+    m_buffers[id] = std::move(resource);
+    return id;
+}
+
+uint32_t SoftwareRenderer::CreateIndexBuffer(const uint32_t* data, size_t count, BufferUsage usage) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
+    return CreateVertexBuffer(data, count * sizeof(uint32_t), usage);
+}
+
+void SoftwareRenderer::UpdateVertexBuffer(uint32_t buffer, const void* data, size_t size, size_t offset) {
+    auto it = m_buffers.find(buffer);
+    if (it == m_buffers.end()) return;
+    const size_t total = it->second.data.size();
+    if (offset > total || size > total - offset) return;
+
+    // Draws are transformed at submission, so pending triangles are unaffected
+    memcpy(it->second.data.data() + offset, data, size);
+    m_stats.bytesUploaded += size;
+}
+
+void SoftwareRenderer::DeleteBuffer(uint32_t buffer) {
+    if (buffer == m_streaming.GetBuffer()) return;
+    m_buffers.erase(buffer);
+}
+
+void SoftwareRenderer::CopyBuffer(uint32_t source, size_t sourceOffset, uint32_t destination, size_t destinationOffset,
+                                  size_t size) {
+    auto srcIt = m_buffers.find(source);
+    auto dstIt = m_buffers.find(destination);
+    if (srcIt == m_buffers.end() || dstIt == m_buffers.end()) return;
+    const size_t sourceTotal = srcIt->second.data.size();
+    const size_t destinationTotal = dstIt->second.data.size();
+    if (sourceOffset > sourceTotal || size > sourceTotal - sourceOffset ||
+        destinationOffset > destinationTotal || size > destinationTotal - destinationOffset) {
+        return;
+    }
+
+    memmove(dstIt->second.data.data() + destinationOffset, srcIt->second.data.data() + sourceOffset, size);
+}
+
+StreamingAllocation SoftwareRenderer::AllocateStreaming(size_t size, size_t alignment) {
+    return m_streaming.Allocate(size, alignment);
+}
+
+void SoftwareRenderer::CopyStreamingToBuffer(const StreamingAllocation& source, uint32_t buffer, size_t offset) {
+    auto it = m_buffers.find(buffer);
+    if (!source || it == m_buffers.end()) return;
+    const size_t total = it->second.data.size();
+    if (offset > total || source.size > total - offset) return;
+
+    memcpy(it->second.data.data() + offset, source.data, source.size);
+    m_stats.bytesStreamed += source.size;
+}
+
+uint32_t SoftwareRenderer::CreateTexture2D(uint32_t width, uint32_t height, TextureFormat format, const void* data) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Textures);
+    TextureResource resource;
+    resource.width = std::max(1u, width);
+    resource.height = std::max(1u, height);
+    resource.format = format;
+    resource.srgb = IsSrgbFormat(format);
+    resource.texels.assign(static_cast<size_t>(resource.width) * resource.height, 0xFFFFFFFFu);
+
+    uint32_t id = m_nextID++;
+    m_textures[id] = std::move(resource);
+
+    if (data) {
+        m_stats.bytesUploaded += WriteTexels(m_textures[id], data);
+    }
+    return id;
+}
+
+void SoftwareRenderer::UpdateTexture2D(uint32_t texture, const void* data, uint32_t mipLevel) {
+    // Only the base level is sampled
+    auto it = m_textures.find(texture);
+    if (it == m_textures.end() || !data || mipLevel != 0) return;
+
+    Flush();
+    m_stats.bytesUploaded += WriteTexels(it->second, data);
+}
+
+size_t SoftwareRenderer::WriteTexels(TextureResource& texture, const void* data) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    std::vector<uint32_t>& texels = texture.texels;
+    if (texture.format == TextureFormat::RGB8) {
+        for (size_t i = 0; i < texels.size(); i++) {
+            texels[i] = bytes[i * 3] | (bytes[i * 3 + 1] << 8) | (bytes[i * 3 + 2] << 16) | 0xFF000000u;
+        }
+        return texels.size() * 3;
+    }
+    if (IsCompressedFormat(texture.format)) {
+        std::vector<uint8_t> pixels;
+        DecompressTexture(bytes, texture.width, texture.height, texture.format, pixels);
+        memcpy(texels.data(), pixels.data(), pixels.size());
+        return GetTextureDataSize(texture.width, texture.height, texture.format);
+    }
+    // RGBA8 and SRGBA8, stored encoded; other formats are not sampled
+    if (texture.format == TextureFormat::RGBA8 || texture.format == TextureFormat::SRGBA8) {
+        memcpy(texels.data(), bytes, texels.size() * 4);
+    }
+    return texels.size() * 4;
+}
+
+void SoftwareRenderer::DeleteTexture(uint32_t texture) {
+    Flush();
+    m_textures.erase(texture);
+    if (m_boundTexture == texture) {
+        m_boundTexture = 0;
+    }
+}
+
+void SoftwareRenderer::BindTexture(uint32_t slot, uint32_t texture) {
+    if (slot == 0) {
+        m_boundTexture = texture;
+    }
+    m_stats.textureBinds++;
+}
+
+uint32_t SoftwareRenderer::CreateShader(const std::string& vertexSource, const std::string& fragmentSource) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::RenderResources);
+    ShaderResource resource;
+    IdentityMatrix(resource.mvp);
+
+    uint32_t id = m_nextID++;
+    m_shaders[id] = resource;
+    return id;
+}
+
+void SoftwareRenderer::DeleteShader(uint32_t shader) {
+    m_shaders.erase(shader);
+    if (m_currentShader == shader) {
+        m_currentShader = 0;
+    }
+}
+
+void SoftwareRenderer::BindShader(uint32_t shader) {
+    if (m_currentShader != shader) {
+        m_stats.shaderSwitches++;
+    }
+    m_currentShader = shader;
+}
+
+void SoftwareRenderer::SetShaderUniform(uint32_t shader, const std::string& name, const void* data, size_t size) {
+    SetShaderUniform(shader, InternUniformName(name), data, size);
+}
+
+void SoftwareRenderer::SetShaderUniform(uint32_t shader, UniformHandle uniform, const void* data, size_t size) {
+    static const UniformHandle mvpUniform = InternUniformName("u_mvp");
+
+    auto it = m_shaders.find(shader);
+    if (it == m_shaders.end()) return;
+
+    if (uniform == mvpUniform && size >= sizeof(it->second.mvp)) {
+        memcpy(it->second.mvp, data, sizeof(it->second.mvp));
+    }
+}
+
+void SoftwareRenderer::DrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                                   PrimitiveTopology topology) {
+    auto vbIt = m_buffers.find(vertexBuffer);
+    auto ibIt = m_buffers.find(indexBuffer);
+
+    if (vbIt == m_buffers.end() || ibIt == m_buffers.end()) return;
+
+    const std::vector<uint8_t>& vertexData = vbIt->second.data;
+    const std::vector<uint8_t>& indexData = ibIt->second.data;
+    indexCount = std::min(indexCount, static_cast<uint32_t>(indexData.size() / sizeof(uint32_t)));
+    uint32_t vertexCount = static_cast<uint32_t>(vertexData.size() / sizeof(Vertex));
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>(indexData.data());
+
+    // Only the vertices the indices reach are transformed, not the whole buffer
+    uint32_t first = vertexCount;
+    uint32_t end = 0;
+    ExtendIndexRange(indices, indexCount, 0, vertexCount, first, end);
+    TransformVertices(reinterpret_cast<const Vertex*>(vertexData.data()), vertexCount, first, end);
+    uint32_t triangles = SubmitTriangles(indices, vertexCount, indexCount, topology);
+
+    m_stats.drawCalls++;
+    m_stats.triangles += triangles;
+    m_stats.vertices += end > first ? end - first : 0;
+}
+
+void SoftwareRenderer::Draw(uint32_t vertexBuffer, uint32_t vertexCount, PrimitiveTopology topology) {
+    auto it = m_buffers.find(vertexBuffer);
+    if (it == m_buffers.end()) return;
+
+    const std::vector<uint8_t>& vertexData = it->second.data;
+    vertexCount = std::min(vertexCount, static_cast<uint32_t>(vertexData.size() / sizeof(Vertex)));
+
+    TransformVertices(reinterpret_cast<const Vertex*>(vertexData.data()), vertexCount, 0, vertexCount);
+    uint32_t triangles = SubmitTriangles(nullptr, vertexCount, vertexCount, topology);
+
+    m_stats.drawCalls++;
+    m_stats.triangles += triangles;
+    m_stats.vertices += vertexCount;
+}
+
+void SoftwareRenderer::MultiDrawIndexed(uint32_t vertexBuffer, uint32_t indexBuffer,
+                                        const IndirectDrawCommand* commands, uint32_t drawCount,
+                                        PrimitiveTopology topology) {
+    auto vbIt = m_buffers.find(vertexBuffer);
+    auto ibIt = m_buffers.find(indexBuffer);
+
+    if (vbIt == m_buffers.end() || ibIt == m_buffers.end() || drawCount == 0) return;
+
+    const std::vector<uint8_t>& vertexData = vbIt->second.data;
+    const std::vector<uint8_t>& indexData = ibIt->second.data;
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>(indexData.data());
+    const size_t indexCapacity = indexData.size() / sizeof(uint32_t);
+    uint32_t vertexCount = static_cast<uint32_t>(vertexData.size() / sizeof(Vertex));
+
+    // The vertices the batch reaches are transformed once for all its commands
+    uint32_t first = vertexCount;
+    uint32_t end = 0;
+    for (uint32_t i = 0; i < drawCount; i++) {
+        const IndirectDrawCommand& command = commands[i];
+        if (command.instanceCount == 0 ||
+            static_cast<size_t>(command.firstIndex) + command.indexCount > indexCapacity) continue;
+        ExtendIndexRange(indices + command.firstIndex, command.indexCount, static_cast<uint32_t>(command.baseVertex),
+                         vertexCount, first, end);
+    }
+    TransformVertices(reinterpret_cast<const Vertex*>(vertexData.data()), vertexCount, first, end);
+    for (uint32_t i = 0; i < drawCount; i++) {
+        const IndirectDrawCommand& command = commands[i];
+        if (command.instanceCount == 0 ||
+            static_cast<size_t>(command.firstIndex) + command.indexCount > indexCapacity) continue;
+
+        m_stats.triangles += SubmitTriangles(indices + command.firstIndex, vertexCount, command.indexCount,
+                                             topology, static_cast<uint32_t>(command.baseVertex));
+    }
+
+    m_stats.drawCalls++;
+    m_stats.multiDrawCommands += drawCount;
+    m_stats.vertices += end > first ? end - first : 0;
+}
+
+void SoftwareRenderer::DrawIndexedInstanced(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t indexCount,
+                                            uint32_t instanceBuffer, size_t instanceOffset, uint32_t instanceCount,
+                                            PrimitiveTopology topology) {
+    auto vbIt = m_buffers.find(vertexBuffer);
+    auto ibIt = m_buffers.find(indexBuffer);
+    auto instanceIt = m_buffers.find(instanceBuffer);
+
+    if (vbIt == m_buffers.end() || ibIt == m_buffers.end() || instanceIt == m_buffers.end() || instanceCount == 0) return;
+
+    const std::vector<uint8_t>& instanceData = instanceIt->second.data;
+    if (instanceOffset + static_cast<size_t>(instanceCount) * sizeof(InstanceData) > instanceData.size()) return;
+
+    const std::vector<uint8_t>& vertexData = vbIt->second.data;
+    const std::vector<uint8_t>& indexData = ibIt->second.data;
+    indexCount = std::min(indexCount, static_cast<uint32_t>(indexData.size() / sizeof(uint32_t)));
+    uint32_t vertexCount = static_cast<uint32_t>(vertexData.size() / sizeof(Vertex));
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>(indexData.data());
+
+    // Every instance is transformed in one pass; each then submits the shared indices against its own range
+    uint32_t first = vertexCount;
+    uint32_t end = 0;
+    ExtendIndexRange(indices, indexCount, 0, vertexCount, first, end);
+    TransformVertices(reinterpret_cast<const Vertex*>(vertexData.data()), vertexCount, first, end,
+                      reinterpret_cast<const InstanceData*>(instanceData.data() + instanceOffset), instanceCount);
+    for (uint32_t instance = 0; instance < instanceCount; instance++) {
+        m_stats.triangles += SubmitTriangles(indices, vertexCount * instanceCount, indexCount, topology,
+                                             instance * vertexCount);
+    }
+
+    m_stats.drawCalls++;
+    m_stats.instancesDrawn += instanceCount;
+    m_stats.vertices += end > first ? (end - first) * instanceCount : 0;
+}
+
+void SoftwareRenderer::ExecuteCommandLists(CommandBuffer* const* lists, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        lists[i]->Execute(*this);
+    }
+}
+
+void SoftwareRenderer::SetDepthTest(bool enabled) {
+    m_depthTest = enabled;
+}
+
+void SoftwareRenderer::SetBlending(bool enabled) {
+    m_blending = enabled;
+}
+
+void SoftwareRenderer::SetCulling(bool enabled) {
+    m_culling = enabled;
+}
+
+void SoftwareRenderer::SetWireframe(bool enabled) {
+    // Wireframe is not supported; triangles are always filled
+}
+
+void SoftwareRenderer::Flush() {
+    if (m_triangles.empty()) return;
+
+    m_jobSystem->ParallelFor(m_tilesX * m_tilesY, 1, [this](uint32_t begin, uint32_t end) {
+        for (uint32_t tile = begin; tile < end; tile++) {
+            RasterizeTile(tile);
+        }
+    });
+
+    for (auto& bin : m_bins) {
+        bin.clear();
+    }
+    m_triangles.clear();
+    m_drawStates.clear();
+}
+
+void SoftwareRenderer::ReadPixels(std::vector<uint8_t>& rgba) const {
+    rgba.resize(static_cast<size_t>(m_width) * m_height * 4);
+    for (uint32_t y = 0; y < m_height; y++) {
+        memcpy(&rgba[static_cast<size_t>(y) * m_width * 4], &m_color[static_cast<size_t>(y) * m_stride], m_width * 4);
+    }
+}
+
+float SoftwareRenderer::ReadDepth(uint32_t x, uint32_t y) const {
+    if (x >= m_width || y >= m_height) return 1.0f;
+    return m_depth[static_cast<size_t>(y) * m_stride + x];
+}
+
+bool SoftwareRenderer::SaveFramebuffer(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    out << "P6\n" << m_width << " " << m_height << "\n255\n";
+    std::vector<uint8_t> row(m_width * 3);
+    for (uint32_t y = 0; y < m_height; y++) {
+        const uint32_t* src = &m_color[static_cast<size_t>(y) * m_stride];
+        for (uint32_t x = 0; x < m_width; x++) {
+            row[x * 3 + 0] = static_cast<uint8_t>(src[x]);
+            row[x * 3 + 1] = static_cast<uint8_t>(src[x] >> 8);
+            row[x * 3 + 2] = static_cast<uint8_t>(src[x] >> 16);
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), row.size());
+    }
+    return static_cast<bool>(out);
+}
+
+void SoftwareRenderer::AllocateFramebuffer() {
+    m_stride = (m_width + 3) & ~3u;
+    m_color.assign(static_cast<size_t>(m_stride) * m_height, PackColor(m_clearColor[0], m_clearColor[1],
+                                                                         m_clearColor[2], m_clearColor[3]));
+    m_depth.assign(static_cast<size_t>(m_stride) * m_height, 1.0f);
+
+    m_tilesX = (m_width + TILE_SIZE - 1) / TILE_SIZE;
+    m_tilesY = (m_height + TILE_SIZE - 1) / TILE_SIZE;
+    m_bins.assign(static_cast<size_t>(m_tilesX) * m_tilesY, std::vector<uint32_t>());
+}
+
+void SoftwareRenderer::ExtendIndexRange(const uint32_t* indices, uint32_t indexCount, uint32_t baseVertex,
+                                        uint32_t vertexCount, uint32_t& first, uint32_t& end) {
+    uint32_t low = UINT32_MAX;
+    uint32_t high = 0;
+    for (uint32_t i = 0; i < indexCount; i++) {
+        low = std::min(low, indices[i]);
+        high = std::max(high, indices[i]);
+    }
+    if (indexCount == 0 || low >= vertexCount - std::min(vertexCount, baseVertex)) return;
+
+    // Indices past the buffer are rejected per triangle, so the range stops at its end
+    first = std::min(first, low + baseVertex);
+    end = std::max(end, static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(high) + baseVertex + 1,
+                                                                 vertexCount)));
+}
+
+void SoftwareRenderer::TransformVertices(const Vertex* vertices, uint32_t count, uint32_t first, uint32_t end,
+                                         const InstanceData* instances, uint32_t instanceCount) {
+    float identity[16];
+    IdentityMatrix(identity);
+    auto shaderIt = m_shaders.find(m_currentShader);
+    const float* m = (shaderIt != m_shaders.end()) ? shaderIt->second.mvp : identity;
+
+    m_clipVertices.resize(static_cast<size_t>(count) * instanceCount);
+    if (end <= first) return;
+
+    const uint32_t span = end - first;
+    m_jobSystem->ParallelFor(span * instanceCount, VERTEX_BATCH,
+        [this, vertices, count, first, span, instances, m](uint32_t begin, uint32_t stop) {
+        for (uint32_t i = begin; i < stop; i++) {
+            const uint32_t instanceIndex = i / span;
+            const uint32_t vertex = first + i % span;
+            const Vertex& v = vertices[vertex];
+            ClipVertex& out = m_clipVertices[static_cast<size_t>(instanceIndex) * count + vertex];
+            float position[3] = { v.position[0], v.position[1], v.position[2] };
+            memcpy(out.color, v.color, sizeof(out.color));
+            if (instances) {
+                const InstanceData& instance = instances[instanceIndex];
+                const float* t = instance.transform;
+                for (int row = 0; row < 3; row++) {
+                    position[row] = t[row * 4] * v.position[0] + t[row * 4 + 1] * v.position[1] +
+                                    t[row * 4 + 2] * v.position[2] + t[row * 4 + 3];
+                }
+                for (int c = 0; c < 4; c++) {
+                    out.color[c] *= instance.color[c];
+                }
+            }
+            for (int row = 0; row < 4; row++) {
+                out.position[row] = m[row] * position[0] + m[4 + row] * position[1] +
+                                    m[8 + row] * position[2] + m[12 + row];
+            }
+            out.texcoord[0] = v.texcoord[0];
+            out.texcoord[1] = v.texcoord[1];
+        }
+    });
+}
+
+uint32_t SoftwareRenderer::SubmitTriangles(const uint32_t* indices, uint32_t vertexCount, uint32_t indexCount,
+                                       PrimitiveTopology topology, uint32_t baseVertex) {
+    uint32_t triangleCount = 0;
+    bool strip = false;
+    if (topology == PrimitiveTopology::TriangleList) {
+        triangleCount = indexCount / 3;
+    } else if (topology == PrimitiveTopology::TriangleStrip) {
+        triangleCount = indexCount >= 3 ? indexCount - 2 : 0;
+        strip = true;
+    }
+    if (triangleCount == 0 || m_bins.empty()) return triangleCount;
+
+    auto textureIt = m_textures.find(m_boundTexture);
+    DrawState state;
+    state.texture = (textureIt != m_textures.end()) ? &textureIt->second : nullptr;
+    state.depthTest = m_depthTest;
+    state.blending = m_blending;
+    uint32_t stateIndex = static_cast<uint32_t>(m_drawStates.size());
+    m_drawStates.push_back(state);
+
+    // Clipping against the near plane can split a triangle in two
+    m_setupScratch.resize(static_cast<size_t>(triangleCount) * 2);
+    m_setupCounts.resize(triangleCount);
+
+    m_jobSystem->ParallelFor(triangleCount, TRIANGLE_BATCH,
+        [this, indices, vertexCount, baseVertex, strip, stateIndex](uint32_t begin, uint32_t end) {
+            for (uint32_t t = begin; t < end; t++) {
+                uint32_t i0, i1, i2;
+                if (strip) {
+                    // Odd strip triangles have reversed winding
+                    i0 = t;
+                    i1 = (t & 1) ? t + 2 : t + 1;
+                    i2 = (t & 1) ? t + 1 : t + 2;
+                } else {
+                    i0 = t * 3;
+                    i1 = t * 3 + 1;
+                    i2 = t * 3 + 2;
+                }
+                if (indices) {
+                    i0 = indices[i0] + baseVertex;
+                    i1 = indices[i1] + baseVertex;
+                    i2 = indices[i2] + baseVertex;
+                }
+                if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) {
+                    m_setupCounts[t] = 0;
+                    continue;
+                }
+                m_setupCounts[t] = static_cast<uint8_t>(SetupTriangle(
+                    m_clipVertices[i0], m_clipVertices[i1], m_clipVertices[i2], stateIndex, &m_setupScratch[t * 2]));
+            }
+        });
+
+    // Binning stays serial so every tile sees triangles in submission order
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        for (uint32_t k = 0; k < m_setupCounts[t]; k++) {
+            m_triangles.push_back(m_setupScratch[t * 2 + k]);
+            BinTriangle(static_cast<uint32_t>(m_triangles.size() - 1));
+        }
+    }
+    return triangleCount;
+}
+
+uint32_t SoftwareRenderer::SetupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2,
+                                         uint32_t state, TriangleSetup* out) const {
+    const ClipVertex* input[3] = { &v0, &v1, &v2 };
+    float distance[3];
+    int inside = 0;
+    for (int i = 0; i < 3; i++) {
+        distance[i] = input[i]->position[2] + input[i]->position[3];
+        inside += distance[i] >= 0.0f ? 1 : 0;
+    }
+
+    if (inside == 0) return 0;
+    if (inside == 3) {
+        return SetupClippedTriangle(v0, v1, v2, state, out[0]) ? 1 : 0;
+    }
+
+    // Sutherland-Hodgman against the near plane (z >= -w)
+    ClipVertex polygon[4];
+    int count = 0;
+    for (int i = 0; i < 3; i++) {
+        int j = (i + 1) % 3;
+        if (distance[i] >= 0.0f) {
+            polygon[count++] = *input[i];
+        }
+        if ((distance[i] >= 0.0f) != (distance[j] >= 0.0f)) {
+            float t = distance[i] / (distance[i] - distance[j]);
+            ClipVertex& v = polygon[count++];
+            for (int k = 0; k < 4; k++) {
+                v.position[k] = input[i]->position[k] + (input[j]->position[k] - input[i]->position[k]) * t;
+                v.color[k] = input[i]->color[k] + (input[j]->color[k] - input[i]->color[k]) * t;
+            }
+            for (int k = 0; k < 2; k++) {
+                v.texcoord[k] = input[i]->texcoord[k] + (input[j]->texcoord[k] - input[i]->texcoord[k]) * t;
+            }
+        }
+    }
+
+    uint32_t written = 0;
+    for (int i = 1; i + 1 < count; i++) {
+        if (SetupClippedTriangle(polygon[0], polygon[i], polygon[i + 1], state, out[written])) {
+            written++;
+        }
+    }
+    return written;
+}
+
+bool SoftwareRenderer::SetupClippedTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2,
+                                            uint32_t state, TriangleSetup& out) const {
+    const ClipVertex* v[3] = { &v0, &v1, &v2 };
+    float x[3], y[3], z[3], invW[3];
+    for (int i = 0; i < 3; i++) {
+        invW[i] = 1.0f / std::max(v[i]->position[3], 1e-6f);
+        float ndcX = v[i]->position[0] * invW[i];
+        float ndcY = v[i]->position[1] * invW[i];
+        x[i] = m_viewport[0] + (ndcX * 0.5f + 0.5f) * m_viewport[2];
+        y[i] = static_cast<float>(m_height) - (m_viewport[1] + (ndcY * 0.5f + 0.5f) * m_viewport[3]);
+        z[i] = v[i]->position[2] * invW[i] * 0.5f + 0.5f;
+    }
+
+    // Counter-clockwise front faces (GL convention) have negative area with y pointing down
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (std::fabs(area) < 1e-8f) return false;
+    if (area > 0.0f && m_culling) return false;
+
+    int order[3] = { 0, 1, 2 };
+    if (area < 0.0f) {
+        std::swap(order[1], order[2]);
+        area = -area;
+    }
+
+    float sx[3], sy[3], sz[3], sw[3];
+    float attributes[6][3];
+    for (int i = 0; i < 3; i++) {
+        int o = order[i];
+        sx[i] = x[o];
+        sy[i] = y[o];
+        sz[i] = z[o];
+        sw[i] = invW[o];
+        attributes[0][i] = v[o]->texcoord[0] * invW[o];
+        attributes[1][i] = v[o]->texcoord[1] * invW[o];
+        for (int c = 0; c < 4; c++) {
+            attributes[2 + c][i] = v[o]->color[c] * invW[o];
+        }
+    }
+
+    int left = std::max(0, m_viewport[0]);
+    int right = std::min(static_cast<int>(m_width), m_viewport[0] + m_viewport[2]) - 1;
+    int top = std::max(0, static_cast<int>(m_height) - (m_viewport[1] + m_viewport[3]));
+    int bottom = std::min(static_cast<int>(m_height), static_cast<int>(m_height) - m_viewport[1]) - 1;
+
+    float minX = std::min(sx[0], std::min(sx[1], sx[2]));
+    float maxX = std::max(sx[0], std::max(sx[1], sx[2]));
+    float minY = std::min(sy[0], std::min(sy[1], sy[2]));
+    float maxY = std::max(sy[0], std::max(sy[1], sy[2]));
+    out.minX = std::max(left, static_cast<int>(std::floor(std::max(minX, -1.0f))));
+    out.maxX = std::min(right, static_cast<int>(std::ceil(std::min(maxX, 65536.0f))));
+    out.minY = std::max(top, static_cast<int>(std::floor(std::max(minY, -1.0f))));
+    out.maxY = std::min(bottom, static_cast<int>(std::ceil(std::min(maxY, 65536.0f))));
+    if (out.minX > out.maxX || out.minY > out.maxY) return false;
+
+    for (int e = 0; e < 3; e++) {
+        int a = e;
+        int b = (e + 1) % 3;
+        out.edges[e][0] = sy[a] - sy[b];
+        out.edges[e][1] = sx[b] - sx[a];
+        out.edges[e][2] = sx[a] * sy[b] - sx[b] * sy[a];
+        // Top-left fill rule: a pixel centre exactly on an edge belongs to the triangle only if the edge
+        // is a top edge (horizontal, running right) or a left edge (running up), so triangles sharing
+        // an edge never both cover it
+        const float dx = sx[b] - sx[a];
+        const float dy = sy[b] - sy[a];
+        out.topLeft[e] = dy < 0.0f || (dy == 0.0f && dx > 0.0f);
+    }
+
+    float invArea = 1.0f / area;
+    ComputePlane(sx, sy, sz, invArea, out.depth);
+    ComputePlane(sx, sy, sw, invArea, out.invW);
+    for (int i = 0; i < 6; i++) {
+        ComputePlane(sx, sy, attributes[i], invArea, out.attributes[i]);
+    }
+    out.state = state;
+    return true;
+}
+
+void SoftwareRenderer::BinTriangle(uint32_t triangle) {
+    const TriangleSetup& tri = m_triangles[triangle];
+    uint32_t tileMinX = static_cast<uint32_t>(tri.minX) / TILE_SIZE;
+    uint32_t tileMaxX = static_cast<uint32_t>(tri.maxX) / TILE_SIZE;
+    uint32_t tileMinY = static_cast<uint32_t>(tri.minY) / TILE_SIZE;
+    uint32_t tileMaxY = static_cast<uint32_t>(tri.maxY) / TILE_SIZE;
+
+    for (uint32_t ty = tileMinY; ty <= tileMaxY; ty++) {
+        for (uint32_t tx = tileMinX; tx <= tileMaxX; tx++) {
+            m_bins[ty * m_tilesX + tx].push_back(triangle);
+        }
+    }
+}
+
+void SoftwareRenderer::RasterizeTile(uint32_t tileIndex) {
+    const std::vector<uint32_t>& bin = m_bins[tileIndex];
+    if (bin.empty()) return;
+
+    int tileX = static_cast<int>((tileIndex % m_tilesX) * TILE_SIZE);
+    int tileY = static_cast<int>((tileIndex / m_tilesX) * TILE_SIZE);
+    int tileRight = std::min(tileX + static_cast<int>(TILE_SIZE), static_cast<int>(m_width)) - 1;
+    int tileBottom = std::min(tileY + static_cast<int>(TILE_SIZE), static_cast<int>(m_height)) - 1;
+
+    for (uint32_t triangle : bin) {
+        const TriangleSetup& tri = m_triangles[triangle];
+        RasterizeTriangle(tri,
+                          std::max(tileX, tri.minX), std::max(tileY, tri.minY),
+                          std::min(tileRight, tri.maxX), std::min(tileBottom, tri.maxY));
+    }
+}
+
+void SoftwareRenderer::RasterizeTriangle(const TriangleSetup& tri, int x0, int y0, int x1, int y1) {
+    const DrawState& state = m_drawStates[tri.state];
+    int alignedX0 = x0 & ~3;
+
+#ifdef SOFTWARE_RASTER_SSE
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 edgeA[3], edgeStep[3], onEdge[3];
+    for (int e = 0; e < 3; e++) {
+        edgeA[e] = _mm_set1_ps(tri.edges[e][0]);
+        edgeStep[e] = _mm_set1_ps(tri.edges[e][0] * 4.0f);
+        onEdge[e] = _mm_castsi128_ps(_mm_set1_epi32(tri.topLeft[e] ? -1 : 0));
+    }
+    const __m128 depthA = _mm_set1_ps(tri.depth[0]);
+    const __m128 depthStep = _mm_set1_ps(tri.depth[0] * 4.0f);
+
+    for (int y = y0; y <= y1; y++) {
+        float py = static_cast<float>(y) + 0.5f;
+        __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(alignedX0)), laneOffsets);
+        __m128 e0 = _mm_add_ps(_mm_mul_ps(edgeA[0], px), _mm_set1_ps(tri.edges[0][1] * py + tri.edges[0][2]));
+        __m128 e1 = _mm_add_ps(_mm_mul_ps(edgeA[1], px), _mm_set1_ps(tri.edges[1][1] * py + tri.edges[1][2]));
+        __m128 e2 = _mm_add_ps(_mm_mul_ps(edgeA[2], px), _mm_set1_ps(tri.edges[2][1] * py + tri.edges[2][2]));
+        __m128 z = _mm_add_ps(_mm_mul_ps(depthA, px), _mm_set1_ps(tri.depth[1] * py + tri.depth[2]));
+
+        float* depthRow = &m_depth[static_cast<size_t>(y) * m_stride];
+        for (int x = alignedX0; x <= x1; x += 4) {
+            __m128 in0 = _mm_or_ps(_mm_cmpgt_ps(e0, zero), _mm_and_ps(_mm_cmpeq_ps(e0, zero), onEdge[0]));
+            __m128 in1 = _mm_or_ps(_mm_cmpgt_ps(e1, zero), _mm_and_ps(_mm_cmpeq_ps(e1, zero), onEdge[1]));
+            __m128 in2 = _mm_or_ps(_mm_cmpgt_ps(e2, zero), _mm_and_ps(_mm_cmpeq_ps(e2, zero), onEdge[2]));
+            __m128 inside = _mm_and_ps(_mm_and_ps(in0, in1), in2);
+            int mask = _mm_movemask_ps(inside);
+
+            // Discard lanes outside this tile's span
+            if (x < x0) mask &= 0xF << (x0 - x);
+            if (x + 3 > x1) mask &= 0xF >> (x + 3 - x1);
+
+            if (mask && state.depthTest) {
+                __m128 stored = _mm_loadu_ps(depthRow + x);
+                __m128 pass = _mm_cmplt_ps(z, stored);
+                mask &= _mm_movemask_ps(pass);
+            }
+
+            if (mask) {
+                alignas(16) float depths[4];
+                _mm_store_ps(depths, z);
+                for (int lane = 0; lane < 4; lane++) {
+                    if (mask & (1 << lane)) {
+                        ShadePixel(tri, state, x + lane, y, depths[lane]);
+                    }
+                }
+            }
+
+            e0 = _mm_add_ps(e0, edgeStep[0]);
+            e1 = _mm_add_ps(e1, edgeStep[1]);
+            e2 = _mm_add_ps(e2, edgeStep[2]);
+            z = _mm_add_ps(z, depthStep);
+        }
+    }
+#else
+    for (int y = y0; y <= y1; y++) {
+        float py = static_cast<float>(y) + 0.5f;
+        float* depthRow = &m_depth[static_cast<size_t>(y) * m_stride];
+        for (int x = x0; x <= x1; x++) {
+            float px = static_cast<float>(x) + 0.5f;
+            bool inside = true;
+            for (int e = 0; e < 3; e++) {
+                const float value = tri.edges[e][0] * px + tri.edges[e][1] * py + tri.edges[e][2];
+                inside = inside && (value > 0.0f || (value == 0.0f && tri.topLeft[e]));
+            }
+            if (!inside) continue;
+
+            float z = tri.depth[0] * px + tri.depth[1] * py + tri.depth[2];
+            if (state.depthTest && !(z < depthRow[x])) continue;
+            ShadePixel(tri, state, x, y, z);
+        }
+    }
+    (void)alignedX0;
+#endif
+}
+
+void SoftwareRenderer::ShadePixel(const TriangleSetup& tri, const DrawState& state, int x, int y, float z) {
+    float px = static_cast<float>(x) + 0.5f;
+    float py = static_cast<float>(y) + 0.5f;
+    float w = 1.0f / (tri.invW[0] * px + tri.invW[1] * py + tri.invW[2]);
+
+    float attributes[6];
+    for (int i = 0; i < 6; i++) {
+        attributes[i] = (tri.attributes[i][0] * px + tri.attributes[i][1] * py + tri.attributes[i][2]) * w;
+    }
+
+    float color[4] = { attributes[2], attributes[3], attributes[4], attributes[5] };
+    if (state.texture) {
+        // Nearest sampling with repeat addressing
+        const TextureResource& texture = *state.texture;
+        int tx = static_cast<int>(std::floor(attributes[0] * texture.width)) % static_cast<int>(texture.width);
+        int ty = static_cast<int>(std::floor(attributes[1] * texture.height)) % static_cast<int>(texture.height);
+        if (tx < 0) tx += texture.width;
+        if (ty < 0) ty += texture.height;
+
+        float texel[4];
+        const uint32_t packed = texture.texels[static_cast<size_t>(ty) * texture.width + tx];
+        UnpackColor(packed, texel);
+        if (texture.srgb) {
+            const float* decode = SrgbDecodeTable();
+            texel[0] = decode[packed & 0xFF];
+            texel[1] = decode[(packed >> 8) & 0xFF];
+            texel[2] = decode[(packed >> 16) & 0xFF];
+        }
+        for (int c = 0; c < 4; c++) {
+            color[c] *= texel[c];
+        }
+    }
+
+    size_t index = static_cast<size_t>(y) * m_stride + x;
+    if (state.blending) {
+        float dst[4];
+        UnpackColor(m_color[index], dst);
+        float alpha = std::min(1.0f, std::max(0.0f, color[3]));
+        for (int c = 0; c < 4; c++) {
+            color[c] = color[c] * alpha + dst[c] * (1.0f - alpha);
+        }
+    }
+
+    m_color[index] = PackColor(color[0], color[1], color[2], color[3]);
+    if (state.depthTest) {
+        m_depth[index] = z;
+    }
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -0,0 +1,167 @@
+#include "renderer/SpriteBatch.h"
+#include <algorithm>
+#include <cstring>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+namespace {
+
+// Maps a float to an unsigned key with the same ordering
+uint32_t SortableFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+} // namespace
+
+SpriteBatch::SpriteBatch()
+    : m_vertexBuffer(0)
+    , m_indexBuffer(0)
+    , m_capacity(0)
+{
+}
+
+void SpriteBatch::Begin() {
+    m_sprites.clear();
+    m_order.clear();
+}
+
+void SpriteBatch::Add(const Sprite& sprite) {
+    m_sprites.push_back(sprite);
+}
+
+void SpriteBatch::SortByDepth() {
+    const uint32_t count = static_cast<uint32_t>(m_sprites.size());
+    m_keys.resize(count);
+    m_keysScratch.resize(count);
+    m_order.resize(count);
+    m_orderScratch.resize(count);
+
+    uint32_t histograms[4][256] = {};
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t key = SortableFloat(m_sprites[i].depth);
+        m_keys[i] = key;
+        m_order[i] = i;
+        for (int pass = 0; pass < 4; pass++) {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    // LSD radix sort, one byte per pass, skipping bytes shared by every key
+    for (int pass = 0; pass < 4; pass++) {
+        uint32_t* histogram = histograms[pass];
+        uint32_t shift = pass * 8;
+        if (count == 0 || histogram[(m_keys[0] >> shift) & 0xFF] == count) continue;
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t destination = histogram[(m_keys[i] >> shift) & 0xFF]++;
+            m_keysScratch[destination] = m_keys[i];
+            m_orderScratch[destination] = m_order[i];
+        }
+        m_keys.swap(m_keysScratch);
+        m_order.swap(m_orderScratch);
+    }
+}
+
+uint32_t SpriteBatch::Flush(IRenderer& renderer, CommandBuffer& commands, uint32_t shader, uint32_t pass,
+                            uint8_t state) {
+    const uint32_t count = static_cast<uint32_t>(m_sprites.size());
+    if (count == 0 || !EnsureCapacity(renderer, count)) return 0;
+
+    SortByDepth();
+
+    m_vertices.resize(static_cast<size_t>(count) * 4);
+    for (uint32_t i = 0; i < count; i++) {
+        const Sprite& sprite = m_sprites[m_order[i]];
+        const float x0 = sprite.position[0];
+        const float y0 = sprite.position[1];
+        const float x1 = x0 + sprite.size[0];
+        const float y1 = y0 + sprite.size[1];
+        const float corners[4][4] = {
+            { x0, y0, sprite.uv[0], sprite.uv[1] },
+            { x1, y0, sprite.uv[2], sprite.uv[1] },
+            { x1, y1, sprite.uv[2], sprite.uv[3] },
+            { x0, y1, sprite.uv[0], sprite.uv[3] },
+        };
+
+        Vertex* quad = &m_vertices[static_cast<size_t>(i) * 4];
+        for (int c = 0; c < 4; c++) {
+            Vertex& v = quad[c];
+            v.position[0] = corners[c][0];
+            v.position[1] = corners[c][1];
+            v.position[2] = 0.0f;
+            v.normal[0] = 0.0f;
+            v.normal[1] = 0.0f;
+            v.normal[2] = 1.0f;
+            v.texcoord[0] = corners[c][2];
+            v.texcoord[1] = corners[c][3];
+            memcpy(v.color, sprite.color, sizeof(v.color));
+        }
+    }
+    renderer.UpdateVertexBuffer(m_vertexBuffer, m_vertices.data(), m_vertices.size() * sizeof(Vertex), 0);
+
+    // One draw per texture run; the run index in the key's depth field keeps the runs in order
+    uint32_t draws = 0;
+    uint32_t runStart = 0;
+    for (uint32_t i = 1; i <= count; i++) {
+        uint32_t texture = m_sprites[m_order[runStart]].texture;
+        if (i < count && m_sprites[m_order[i]].texture == texture) continue;
+
+        IndirectDrawCommand run = { (i - runStart) * 6, 1, runStart * 6, 0, 0 };
+        commands.MultiDrawIndexed(SortKey::Make(pass, shader, 0, draws), shader, texture, m_vertexBuffer,
+                                  m_indexBuffer, &run, 1, state);
+        draws++;
+        runStart = i;
+    }
+    return draws;
+}
+
+void SpriteBatch::Release(IRenderer& renderer) {
+    if (m_vertexBuffer) renderer.DeleteBuffer(m_vertexBuffer);
+    if (m_indexBuffer) renderer.DeleteBuffer(m_indexBuffer);
+    m_vertexBuffer = 0;
+    m_indexBuffer = 0;
+    m_capacity = 0;
+}
+
+bool SpriteBatch::EnsureCapacity(IRenderer& renderer, uint32_t spriteCount) {
+    if (spriteCount <= m_capacity && m_vertexBuffer && m_indexBuffer) return true;
+
+    Release(renderer);
+    uint32_t capacity = std::max(spriteCount, 1024u);
+    capacity = std::max(capacity, spriteCount + spriteCount / 2);
+
+    std::vector<uint32_t> indices(static_cast<size_t>(capacity) * 6);
+    for (uint32_t i = 0; i < capacity; i++) {
+        const uint32_t base = i * 4;
+        uint32_t* quad = &indices[static_cast<size_t>(i) * 6];
+        quad[0] = base;
+        quad[1] = base + 1;
+        quad[2] = base + 2;
+        quad[3] = base;
+        quad[4] = base + 2;
+        quad[5] = base + 3;
+    }
+
+    m_vertexBuffer = renderer.CreateVertexBuffer(nullptr, static_cast<size_t>(capacity) * 4 * sizeof(Vertex),
+                                                 BufferUsage::Dynamic);
+    m_indexBuffer = renderer.CreateIndexBuffer(indices.data(), indices.size(), BufferUsage::Static);
+    if (!m_vertexBuffer || !m_indexBuffer) {
+        Release(renderer);
+        return false;
+    }
+    m_capacity = capacity;
+    return true;
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
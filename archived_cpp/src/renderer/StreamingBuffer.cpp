@@ -0,0 +1,116 @@
+#include "renderer/StreamingBuffer.h"
+
+namespace SwordAndStone {
+namespace Renderer {
+
+StreamingRingBuffer::StreamingRingBuffer()
+    : m_memory(nullptr)
+    , m_capacity(0)
+    , m_buffer(0)
+    , m_head(0)
+    , m_tail(0)
+    , m_frameStart(0)
+    , m_pendingFirst(0)
+    , m_pendingCount(0)
+    , m_failedAllocations(0)
+{
+}
+
+void StreamingRingBuffer::Initialize(uint8_t* memory, size_t capacity, uint32_t buffer) {
+    m_memory = memory;
+    m_capacity = capacity;
+    m_buffer = buffer;
+    Reset();
+}
+
+void StreamingRingBuffer::Reset() {
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_frameStart = 0;
+    m_pendingFirst = 0;
+    m_pendingCount = 0;
+    m_failedAllocations.store(0, std::memory_order_relaxed);
+}
+
+StreamingAllocation StreamingRingBuffer::Allocate(size_t size, size_t alignment) {
+    StreamingAllocation allocation;
+    if (!m_memory || size == 0 || size > m_capacity) {
+        m_failedAllocations.fetch_add(1, std::memory_order_relaxed);
+        return allocation;
+    }
+    if (alignment == 0) alignment = 1;
+
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    uint64_t start;
+    uint64_t end;
+    do {
+        // Align the ring offset, then skip to the next lap if the range would straddle the end
+        size_t offset = static_cast<size_t>(head % m_capacity);
+        size_t aligned = (offset + alignment - 1) / alignment * alignment;
+        start = head + (aligned - offset);
+        if (aligned + size > m_capacity) {
+            start = head + (m_capacity - offset);
+        }
+        end = start + size;
+
+        if (end - m_tail.load(std::memory_order_acquire) > m_capacity) {
+            m_failedAllocations.fetch_add(1, std::memory_order_relaxed);
+            return allocation;
+        }
+    } while (!m_head.compare_exchange_weak(head, end, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    allocation.offset = static_cast<size_t>(start % m_capacity);
+    allocation.data = m_memory + allocation.offset;
+    allocation.buffer = m_buffer;
+    allocation.size = size;
+    return allocation;
+}
+
+void StreamingRingBuffer::EndFrame(uint64_t fence) {
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    m_frameStart = head;
+
+    // The backend waits for the oldest frame before exceeding FRAME_COUNT, but a
+    // frame that never retires must not overflow the queue
+    if (m_pendingCount == FRAME_COUNT + 1) {
+        m_tail.store(m_pending[m_pendingFirst].end, std::memory_order_release);
+        m_pendingFirst = (m_pendingFirst + 1) % (FRAME_COUNT + 1);
+        m_pendingCount--;
+    }
+
+    uint32_t slot = (m_pendingFirst + m_pendingCount) % (FRAME_COUNT + 1);
+    m_pending[slot] = { head, fence };
+    m_pendingCount++;
+}
+
+void StreamingRingBuffer::Retire(uint64_t completedFence) {
+    while (m_pendingCount > 0 && m_pending[m_pendingFirst].fence <= completedFence) {
+        m_tail.store(m_pending[m_pendingFirst].end, std::memory_order_release);
+        m_pendingFirst = (m_pendingFirst + 1) % (FRAME_COUNT + 1);
+        m_pendingCount--;
+    }
+}
+
+void StreamingRingBuffer::GetOpenFrameRange(size_t& begin, size_t& end) const {
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    if (m_capacity == 0 || head == m_frameStart) {
+        begin = end = 0;
+        return;
+    }
+    begin = static_cast<size_t>(m_frameStart % m_capacity);
+    end = static_cast<size_t>(head % m_capacity);
+    if (end == 0) {
+        end = m_capacity;
+    }
+}
+
+uint64_t StreamingRingBuffer::GetOldestPendingFence() const {
+    return m_pendingCount > 0 ? m_pending[m_pendingFirst].fence : 0;
+}
+
+size_t StreamingRingBuffer::GetUsedBytes() const {
+    return static_cast<size_t>(m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire));
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -0,0 +1,534 @@
+#include "renderer/TextureAtlas.h"
+#include "renderer/BlockCompression.h"
+#include "platform/JobSystem.h"
+#include "platform/MemoryTracker.h"
+#include "platform/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define ATLAS_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace SwordAndStone {
+namespace Renderer {
+
+namespace {
+
+// Cache file layout:
+//   magic, version, source hash, tile size, padding, tile count, level count,
+//   format, tile names (length-prefixed), then the bytes of every level
+constexpr uint32_t CACHE_MAGIC = 0x41545353;  // "SSTA"
+constexpr uint32_t CACHE_VERSION = 2;
+
+template <typename T>
+void WriteValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadValue(std::ifstream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+// FNV-1a over raw bytes
+uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template <typename T>
+uint64_t HashValue(uint64_t hash, const T& value) {
+    return HashBytes(hash, &value, sizeof(T));
+}
+
+uint32_t RoundUpToPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+uint32_t RoundDownToPowerOfTwo(uint32_t value) {
+    if (value == 0) return 0;
+    uint32_t result = 1;
+    while (result * 2 <= value) result <<= 1;
+    return result;
+}
+
+uint32_t Log2(uint32_t powerOfTwo) {
+    uint32_t log = 0;
+    while ((1u << log) < powerOfTwo) log++;
+    return log;
+}
+
+// sRGB <-> linear conversion tables; encoding is indexed by linear value * 4095
+struct SrgbTables {
+    float decode[256];
+    uint8_t encode[4096];
+
+    SrgbTables() {
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            decode[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i < 4096; i++) {
+            float l = i / 4095.0f;
+            float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            encode[i] = static_cast<uint8_t>(std::min(255.0f, c * 255.0f + 0.5f));
+        }
+    }
+
+    static const SrgbTables& Get() {
+        static const SrgbTables tables;
+        return tables;
+    }
+};
+
+// Kaiser-windowed sinc for 2:1 reduction: taps at source offsets -2..+3
+// around each output texel, radius 3 source texels, beta 4
+struct KaiserKernel {
+    static constexpr int TAPS = 6;
+    float weights[TAPS];
+
+    KaiserKernel() {
+        auto besselI0 = [](float x) {
+            float sum = 1.0f, term = 1.0f;
+            for (int k = 1; k < 16; k++) {
+                term *= (x * 0.5f / k) * (x * 0.5f / k);
+                sum += term;
+            }
+            return sum;
+        };
+
+        const float pi = 3.14159265f;
+        const float beta = 4.0f;
+        const float radius = 3.0f;
+        float total = 0.0f;
+        for (int k = 0; k < TAPS; k++) {
+            float t = k - 2.5f;  // distance from the output texel centre in source texels
+            float x = pi * t * 0.5f;
+            float sinc = std::sin(x) / x;
+            float ratio = t / radius;
+            float window = besselI0(beta * std::sqrt(1.0f - ratio * ratio)) / besselI0(beta);
+            weights[k] = sinc * window;
+            total += weights[k];
+        }
+        for (float& weight : weights) {
+            weight /= total;
+        }
+    }
+
+    static const KaiserKernel& Get() {
+        static const KaiserKernel kernel;
+        return kernel;
+    }
+};
+
+// One linear RGBA texel per SIMD register
+#ifdef ATLAS_SSE
+using Pixel = __m128;
+inline Pixel LoadPixel(const float* p) { return _mm_loadu_ps(p); }
+inline void StorePixel(float* p, Pixel v) { _mm_storeu_ps(p, v); }
+inline Pixel AddPixels(Pixel a, Pixel b) { return _mm_add_ps(a, b); }
+inline Pixel ScalePixel(Pixel a, float s) { return _mm_mul_ps(a, _mm_set1_ps(s)); }
+inline Pixel ZeroPixel() { return _mm_setzero_ps(); }
+#else
+struct Pixel { float c[4]; };
+inline Pixel LoadPixel(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+inline void StorePixel(float* p, Pixel v) { memcpy(p, v.c, sizeof(v.c)); }
+inline Pixel AddPixels(Pixel a, Pixel b) {
+    return { { a.c[0] + b.c[0], a.c[1] + b.c[1], a.c[2] + b.c[2], a.c[3] + b.c[3] } };
+}
+inline Pixel ScalePixel(Pixel a, float s) { return { { a.c[0] * s, a.c[1] * s, a.c[2] * s, a.c[3] * s } }; }
+inline Pixel ZeroPixel() { return { { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+#endif
+
+// Halves a square power-of-two tile of linear RGBA texels, wrapping at the edges
+void Downsample(const std::vector<float>& source, uint32_t size, MipFilter filter,
+                std::vector<float>& target, std::vector<float>& scratch) {
+    const uint32_t half = size / 2;
+    const uint32_t mask = size - 1;
+    target.resize(static_cast<size_t>(half) * half * 4);
+
+    if (filter == MipFilter::Box) {
+        for (uint32_t y = 0; y < half; y++) {
+            const float* row0 = &source[(y * 2) * size * 4];
+            const float* row1 = &source[(y * 2 + 1) * size * 4];
+            for (uint32_t x = 0; x < half; x++) {
+                Pixel sum = AddPixels(AddPixels(LoadPixel(row0 + x * 8), LoadPixel(row0 + x * 8 + 4)),
+                                      AddPixels(LoadPixel(row1 + x * 8), LoadPixel(row1 + x * 8 + 4)));
+                StorePixel(&target[(y * half + x) * 4], ScalePixel(sum, 0.25f));
+            }
+        }
+        return;
+    }
+
+    // Separable: horizontal into scratch (half x size), then vertical
+    const KaiserKernel& kernel = KaiserKernel::Get();
+    scratch.resize(static_cast<size_t>(half) * size * 4);
+    for (uint32_t y = 0; y < size; y++) {
+        const float* row = &source[y * size * 4];
+        for (uint32_t x = 0; x < half; x++) {
+            Pixel sum = ZeroPixel();
+            for (int k = 0; k < KaiserKernel::TAPS; k++) {
+                uint32_t sx = (x * 2 + k - 2) & mask;
+                sum = AddPixels(sum, ScalePixel(LoadPixel(row + sx * 4), kernel.weights[k]));
+            }
+            StorePixel(&scratch[(y * half + x) * 4], sum);
+        }
+    }
+    for (uint32_t y = 0; y < half; y++) {
+        for (uint32_t x = 0; x < half; x++) {
+            Pixel sum = ZeroPixel();
+            for (int k = 0; k < KaiserKernel::TAPS; k++) {
+                uint32_t sy = (y * 2 + k - 2) & mask;
+                sum = AddPixels(sum, ScalePixel(LoadPixel(&scratch[(sy * half + x) * 4]), kernel.weights[k]));
+            }
+            StorePixel(&target[(y * half + x) * 4], sum);
+        }
+    }
+}
+
+uint8_t EncodeSrgb(float linear) {
+    float clamped = std::min(std::max(linear, 0.0f), 1.0f);
+    return SrgbTables::Get().encode[static_cast<int>(clamped * 4095.0f + 0.5f)];
+}
+
+uint8_t EncodeUnorm(float value) {
+    float clamped = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<uint8_t>(clamped * 255.0f + 0.5f);
+}
+
+struct DecodedImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    const uint8_t* pixels = nullptr;
+    stbi_uc* owned = nullptr;  // freed after the build when decoded here
+};
+
+} // namespace
+
+TextureAtlas::TextureAtlas(Platform::JobSystem* jobSystem)
+    : m_jobSystem(jobSystem)
+    , m_width(0)
+    , m_height(0)
+    , m_tileSize(0)
+    , m_padding(0)
+    , m_columns(1)
+    , m_format(TextureFormat::SRGBA8)
+    , m_sourceHash(0)
+    , m_loadedFromCache(false)
+{
+}
+
+void TextureAtlas::AddImage(const std::string& name, uint32_t width, uint32_t height, const uint8_t* pixels) {
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Textures);
+    Source source;
+    source.name = name;
+    source.width = width;
+    source.height = height;
+    source.bytes.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    m_sources.push_back(std::move(source));
+}
+
+bool TextureAtlas::AddFile(const std::string& name, const std::string& path) {
+    PROFILE_ZONE("TextureAtlas::AddFile");
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Textures);
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    Source source;
+    source.name = name;
+    source.width = 0;
+    source.height = 0;
+    source.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    m_sources.push_back(std::move(source));
+    return true;
+}
+
+void TextureAtlas::Clear() {
+    m_sources.clear();
+    m_tileNames.clear();
+    m_levels.clear();
+    m_width = m_height = 0;
+    m_sourceHash = 0;
+    m_loadedFromCache = false;
+}
+
+bool TextureAtlas::Build(const TextureAtlasDesc& desc, const std::string& cachePath) {
+    PROFILE_ZONE("TextureAtlas::Build");
+    Platform::MemoryTagScope memoryTag(Platform::MemoryTag::Textures);
+    m_loadedFromCache = false;
+    if (m_sources.empty()) return false;
+
+    m_sourceHash = HashSources(desc);
+    if (!cachePath.empty() && LoadCache(cachePath, m_sourceHash)) {
+        m_loadedFromCache = true;
+        return true;
+    }
+
+    Platform::JobSystem& jobs = m_jobSystem ? *m_jobSystem : Platform::JobSystem::GetDefault();
+    const uint32_t tileCount = static_cast<uint32_t>(m_sources.size());
+
+    // Decode every encoded source in parallel
+    std::vector<DecodedImage> images(tileCount);
+    std::atomic<bool> failed{false};
+    jobs.ParallelFor(tileCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            const Source& source = m_sources[i];
+            DecodedImage& image = images[i];
+            if (source.width != 0) {
+                image.width = source.width;
+                image.height = source.height;
+                image.pixels = source.bytes.data();
+                continue;
+            }
+
+            int width = 0, height = 0, channels = 0;
+            image.owned = stbi_load_from_memory(source.bytes.data(), static_cast<int>(source.bytes.size()),
+                                                &width, &height, &channels, 4);
+            if (!image.owned) {
+                failed = true;
+                continue;
+            }
+            image.width = static_cast<uint32_t>(width);
+            image.height = static_cast<uint32_t>(height);
+            image.pixels = image.owned;
+        }
+    });
+
+    if (!failed) {
+        uint32_t tileSize = RoundUpToPowerOfTwo(desc.tileSize != 0 ? desc.tileSize
+                                                                   : std::max(images[0].width, images[0].height));
+        uint32_t padding = std::min(RoundDownToPowerOfTwo(desc.padding), tileSize);
+        uint32_t levelCount = 1 + (padding != 0 ? Log2(padding) : 0);
+        SetLayout(tileSize, padding, tileCount, levelCount, TextureFormat::SRGBA8);
+
+        const SrgbTables& srgb = SrgbTables::Get();
+        jobs.ParallelFor(tileCount, 1, [&](uint32_t begin, uint32_t end) {
+            std::vector<float> linear, next, scratch;
+            for (uint32_t tile = begin; tile < end; tile++) {
+                // Nearest-neighbour fit to the tile size, then to linear space
+                const DecodedImage& image = images[tile];
+                linear.resize(static_cast<size_t>(tileSize) * tileSize * 4);
+                for (uint32_t y = 0; y < tileSize; y++) {
+                    uint32_t sy = static_cast<uint32_t>(static_cast<uint64_t>(y) * image.height / tileSize);
+                    for (uint32_t x = 0; x < tileSize; x++) {
+                        uint32_t sx = static_cast<uint32_t>(static_cast<uint64_t>(x) * image.width / tileSize);
+                        const uint8_t* texel = image.pixels + (static_cast<size_t>(sy) * image.width + sx) * 4;
+                        float* out = &linear[(y * tileSize + x) * 4];
+                        out[0] = srgb.decode[texel[0]];
+                        out[1] = srgb.decode[texel[1]];
+                        out[2] = srgb.decode[texel[2]];
+                        out[3] = texel[3] / 255.0f;
+                    }
+                }
+
+                const uint32_t originX = (tile % m_columns) * (tileSize + padding * 2);
+                const uint32_t originY = (tile / m_columns) * (tileSize + padding * 2);
+                for (uint32_t level = 0; level < levelCount; level++) {
+                    // Write the cell: the tile surrounded by its own wrapped edges
+                    const uint32_t size = tileSize >> level;
+                    const uint32_t border = padding >> level;
+                    const uint32_t cell = size + border * 2;
+                    const uint32_t levelWidth = m_width >> level;
+                    uint8_t* pixels = m_levels[level].data();
+                    for (uint32_t cy = 0; cy < cell; cy++) {
+                        uint32_t sy = (cy + size - border) & (size - 1);
+                        uint8_t* row = pixels + (static_cast<size_t>((originY >> level) + cy) * levelWidth + (originX >> level)) * 4;
+                        for (uint32_t cx = 0; cx < cell; cx++) {
+                            uint32_t sx = (cx + size - border) & (size - 1);
+                            const float* texel = &linear[(sy * size + sx) * 4];
+                            row[cx * 4] = EncodeSrgb(texel[0]);
+                            row[cx * 4 + 1] = EncodeSrgb(texel[1]);
+                            row[cx * 4 + 2] = EncodeSrgb(texel[2]);
+                            row[cx * 4 + 3] = EncodeUnorm(texel[3]);
+                        }
+                    }
+
+                    if (level + 1 < levelCount) {
+                        Downsample(linear, size, desc.filter, next, scratch);
+                        linear.swap(next);
+                    }
+                }
+            }
+        });
+
+        // Block-encode the finished levels; the encoder spreads each level's block rows over the jobs
+        if (IsCompressedFormat(desc.format)) {
+            std::vector<uint8_t> blocks;
+            for (size_t level = 0; level < m_levels.size(); level++) {
+                CompressTexture(m_levels[level].data(), m_width >> level, m_height >> level, desc.format, blocks, &jobs);
+                m_levels[level].swap(blocks);
+            }
+            m_format = desc.format;
+        }
+
+        m_tileNames.clear();
+        for (const Source& source : m_sources) {
+            m_tileNames.push_back(source.name);
+        }
+    }
+
+    for (DecodedImage& image : images) {
+        if (image.owned) {
+            stbi_image_free(image.owned);
+        }
+    }
+    if (failed) return false;
+
+    if (!cachePath.empty()) {
+        SaveCache(cachePath);
+    }
+    return true;
+}
+
+uint32_t TextureAtlas::Upload(IRenderer& renderer) const {
+    if (m_levels.empty()) return 0;
+
+    uint32_t texture = renderer.CreateTexture2D(m_width, m_height, m_format, m_levels[0].data());
+    for (size_t level = 1; level < m_levels.size(); level++) {
+        renderer.UpdateTexture2D(texture, m_levels[level].data(), static_cast<uint32_t>(level));
+    }
+    return texture;
+}
+
+uint32_t TextureAtlas::FindTile(const std::string& name) const {
+    for (size_t i = 0; i < m_tileNames.size(); i++) {
+        if (m_tileNames[i] == name) return static_cast<uint32_t>(i);
+    }
+    return INVALID_TILE;
+}
+
+AtlasRect TextureAtlas::GetTileRect(uint32_t tile) const {
+    AtlasRect rect;
+    if (tile >= m_tileNames.size()) return rect;
+
+    const uint32_t cell = m_tileSize + m_padding * 2;
+    float x = static_cast<float>((tile % m_columns) * cell + m_padding);
+    float y = static_cast<float>((tile / m_columns) * cell + m_padding);
+    rect.u0 = x / m_width;
+    rect.v0 = y / m_height;
+    rect.u1 = (x + m_tileSize) / m_width;
+    rect.v1 = (y + m_tileSize) / m_height;
+    return rect;
+}
+
+uint64_t TextureAtlas::HashSources(const TextureAtlasDesc& desc) const {
+    uint64_t hash = 14695981039346656037ull;
+    hash = HashValue(hash, CACHE_VERSION);
+    hash = HashValue(hash, desc.tileSize);
+    hash = HashValue(hash, desc.padding);
+    hash = HashValue(hash, static_cast<uint32_t>(desc.filter));
+    hash = HashValue(hash, static_cast<uint32_t>(desc.format));
+    for (const Source& source : m_sources) {
+        hash = HashBytes(hash, source.name.data(), source.name.size());
+        hash = HashValue(hash, source.width);
+        hash = HashValue(hash, source.height);
+        hash = HashBytes(hash, source.bytes.data(), source.bytes.size());
+    }
+    return hash;
+}
+
+void TextureAtlas::SetLayout(uint32_t tileSize, uint32_t padding, uint32_t tileCount, uint32_t levelCount,
+                            TextureFormat format) {
+    m_tileSize = tileSize;
+    m_padding = padding;
+    m_format = format;
+    m_columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(tileCount))));
+    uint32_t rows = (tileCount + m_columns - 1) / m_columns;
+    m_width = m_columns * (tileSize + padding * 2);
+    m_height = rows * (tileSize + padding * 2);
+
+    m_levels.resize(levelCount);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        m_levels[level].assign(GetTextureDataSize(m_width >> level, m_height >> level, format), 0);
+    }
+}
+
+bool TextureAtlas::LoadCache(const std::string& path, uint64_t hash) {
+    PROFILE_ZONE("TextureAtlas::LoadCache");
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    uint32_t magic = 0, version = 0;
+    uint64_t cachedHash = 0;
+    uint32_t tileSize = 0, padding = 0, tileCount = 0, levelCount = 0, format = 0;
+    if (!ReadValue(in, magic) || !ReadValue(in, version) || !ReadValue(in, cachedHash) ||
+        !ReadValue(in, tileSize) || !ReadValue(in, padding) || !ReadValue(in, tileCount) ||
+        !ReadValue(in, levelCount) || !ReadValue(in, format)) {
+        return false;
+    }
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION || cachedHash != hash ||
+        tileCount != m_sources.size() || levelCount == 0 || levelCount > 32) {
+        return false;
+    }
+
+    std::vector<std::string> names(tileCount);
+    for (std::string& name : names) {
+        uint32_t length = 0;
+        if (!ReadValue(in, length) || length > 4096) return false;
+        name.resize(length);
+        in.read(&name[0], length);
+    }
+
+    SetLayout(tileSize, padding, tileCount, levelCount, static_cast<TextureFormat>(format));
+    for (std::vector<uint8_t>& level : m_levels) {
+        in.read(reinterpret_cast<char*>(level.data()), static_cast<std::streamsize>(level.size()));
+    }
+    if (!in) {
+        m_levels.clear();
+        m_width = m_height = 0;
+        return false;
+    }
+
+    m_tileNames.swap(names);
+    return true;
+}
+
+bool TextureAtlas::SaveCache(const std::string& path) const {
+    PROFILE_ZONE("TextureAtlas::SaveCache");
+    // Written beside the target and renamed, so an interrupted write never leaves a torn cache
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        WriteValue(out, CACHE_MAGIC);
+        WriteValue(out, CACHE_VERSION);
+        WriteValue(out, m_sourceHash);
+        WriteValue(out, m_tileSize);
+        WriteValue(out, m_padding);
+        WriteValue(out, static_cast<uint32_t>(m_tileNames.size()));
+        WriteValue(out, static_cast<uint32_t>(m_levels.size()));
+        WriteValue(out, static_cast<uint32_t>(m_format));
+        for (const std::string& name : m_tileNames) {
+            WriteValue(out, static_cast<uint32_t>(name.size()));
+            out.write(name.data(), static_cast<std::streamsize>(name.size()));
+        }
+        for (const std::vector<uint8_t>& level : m_levels) {
+            out.write(reinterpret_cast<const char*>(level.data()), static_cast<std::streamsize>(level.size()));
+        }
+        if (!out) return false;
+    }
+
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -0,0 +1,127 @@
+#include "renderer/UniformBlock.h"
+#include "renderer/IRenderer.h"
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace SwordAndStone {
+namespace Renderer {
+
+namespace {
+
+// Process-wide name table; names live in a deque so references stay valid
+struct UniformRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, UniformHandle> handles;
+    std::deque<std::string> names;
+
+    UniformRegistry() {
+        names.emplace_back();  // INVALID_UNIFORM
+    }
+
+    static UniformRegistry& Get() {
+        static UniformRegistry registry;
+        return registry;
+    }
+};
+
+} // namespace
+
+UniformHandle InternUniformName(const std::string& name) {
+    UniformRegistry& registry = UniformRegistry::Get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.handles.find(name);
+    if (it != registry.handles.end()) return it->second;
+
+    UniformHandle handle = static_cast<UniformHandle>(registry.names.size());
+    registry.names.push_back(name);
+    registry.handles.emplace(name, handle);
+    return handle;
+}
+
+UniformHandle FindUniformHandle(const std::string& name) {
+    UniformRegistry& registry = UniformRegistry::Get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.handles.find(name);
+    return it != registry.handles.end() ? it->second : INVALID_UNIFORM;
+}
+
+const std::string& GetUniformName(UniformHandle handle) {
+    UniformRegistry& registry = UniformRegistry::Get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return handle < registry.names.size() ? registry.names[handle] : registry.names[INVALID_UNIFORM];
+}
+
+UniformBlock::UniformBlock(UniformFrequency frequency)
+    : m_frequency(frequency)
+    , m_version(1)
+{
+}
+
+uint32_t UniformBlock::AddField(const std::string& name, size_t size) {
+    Field field;
+    field.handle = InternUniformName(name);
+    field.offset = static_cast<uint32_t>(m_data.size());
+    field.size = static_cast<uint32_t>(size);
+    // A new field is a change, so shaders that are up to date still receive it
+    field.changedVersion = ++m_version;
+    m_fields.push_back(field);
+    m_data.resize(m_data.size() + size, 0);
+    return static_cast<uint32_t>(m_fields.size() - 1);
+}
+
+uint32_t UniformBlock::FindField(UniformHandle handle) const {
+    for (size_t i = 0; i < m_fields.size(); i++) {
+        if (m_fields[i].handle == handle) return static_cast<uint32_t>(i);
+    }
+    return INVALID_FIELD;
+}
+
+bool UniformBlock::Set(uint32_t field, const void* data) {
+    if (field >= m_fields.size()) return false;
+
+    Field& target = m_fields[field];
+    uint8_t* stored = &m_data[target.offset];
+    if (memcmp(stored, data, target.size) == 0) return false;
+
+    memcpy(stored, data, target.size);
+    target.changedVersion = ++m_version;
+    return true;
+}
+
+uint32_t UniformBlock::Upload(IRenderer& renderer, uint32_t shader) {
+    // A shader that has never seen the block gets every field
+    uint64_t uploaded = 0;
+    std::pair<uint32_t, uint64_t>* entry = nullptr;
+    for (auto& candidate : m_uploadedVersions) {
+        if (candidate.first == shader) {
+            entry = &candidate;
+            uploaded = candidate.second;
+            break;
+        }
+    }
+    if (uploaded == m_version) return 0;
+
+    uint32_t sent = 0;
+    for (const Field& field : m_fields) {
+        if (field.changedVersion > uploaded) {
+            renderer.SetShaderUniform(shader, field.handle, &m_data[field.offset], field.size);
+            sent++;
+        }
+    }
+
+    if (entry) {
+        entry->second = m_version;
+    } else {
+        m_uploadedVersions.emplace_back(shader, m_version);
+    }
+    return sent;
+}
+
+void UniformBlock::Invalidate() {
+    m_uploadedVersions.clear();
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
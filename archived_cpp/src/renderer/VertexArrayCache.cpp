@@ -0,0 +1,70 @@
+#include "renderer/VertexArrayCache.h"
+
+namespace SwordAndStone {
+namespace Renderer {
+
+uint32_t VertexArrayCache::Find(const Key& key) const {
+    auto it = m_vertexArrays.find(key);
+    return it != m_vertexArrays.end() ? it->second : 0;
+}
+
+void VertexArrayCache::Insert(const Key& key, uint32_t vertexArray) {
+    m_vertexArrays[key] = vertexArray;
+    m_buffersToVertexArrays[key.vertexBuffer].push_back(key);
+    if (key.indexBuffer && key.indexBuffer != key.vertexBuffer) {
+        m_buffersToVertexArrays[key.indexBuffer].push_back(key);
+    }
+    if (key.instanceBuffer && key.instanceBuffer != key.vertexBuffer && key.instanceBuffer != key.indexBuffer) {
+        m_buffersToVertexArrays[key.instanceBuffer].push_back(key);
+    }
+}
+
+void VertexArrayCache::RemoveBuffer(uint32_t buffer, std::vector<uint32_t>& removed) {
+    auto it = m_buffersToVertexArrays.find(buffer);
+    if (it == m_buffersToVertexArrays.end()) return;
+
+    std::vector<Key> keys;
+    keys.swap(it->second);
+    m_buffersToVertexArrays.erase(it);
+
+    for (const Key& key : keys) {
+        auto arrayIt = m_vertexArrays.find(key);
+        if (arrayIt == m_vertexArrays.end()) continue;
+        removed.push_back(arrayIt->second);
+        m_vertexArrays.erase(arrayIt);
+
+        // Drop the key from the other buffers' lists as well
+        const uint32_t others[] = { key.vertexBuffer, key.indexBuffer, key.instanceBuffer };
+        for (uint32_t other : others) {
+            if (other != buffer) Unlink(other, key);
+        }
+    }
+}
+
+void VertexArrayCache::Clear(std::vector<uint32_t>& removed) {
+    for (const auto& entry : m_vertexArrays) {
+        removed.push_back(entry.second);
+    }
+    m_vertexArrays.clear();
+    m_buffersToVertexArrays.clear();
+}
+
+void VertexArrayCache::Unlink(uint32_t buffer, const Key& key) {
+    auto it = m_buffersToVertexArrays.find(buffer);
+    if (it == m_buffersToVertexArrays.end()) return;
+
+    std::vector<Key>& keys = it->second;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] == key) {
+            keys[i] = keys.back();
+            keys.pop_back();
+            break;
+        }
+    }
+    if (keys.empty()) {
+        m_buffersToVertexArrays.erase(it);
+    }
+}
+
+} // namespace Renderer
+} // namespace SwordAndStone
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+
+// Minimal assertion helpers shared by the test executables
+namespace SwordAndStone {
+namespace Tests {
+
+inline int& FailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+// Column-major perspective * lookAt, GL clip conventions
+inline void BuildViewProjection(const float eye[3], const float target[3], float out[16]) {
+    float f[3] = { target[0] - eye[0], target[1] - eye[1], target[2] - eye[2] };
+    float length = std::sqrt(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+    for (float& v : f) v /= length;
+    float s[3] = { f[1] * 0.0f - f[2] * 1.0f, f[2] * 0.0f - f[0] * 0.0f, f[0] * 1.0f - f[1] * 0.0f };
+    length = std::sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+    for (float& v : s) v /= length;
+    float u[3] = { s[1] * f[2] - s[2] * f[1], s[2] * f[0] - s[0] * f[2], s[0] * f[1] - s[1] * f[0] };
+
+    float view[16] = {
+        s[0], u[0], -f[0], 0.0f,
+        s[1], u[1], -f[1], 0.0f,
+        s[2], u[2], -f[2], 0.0f,
+        -(s[0] * eye[0] + s[1] * eye[1] + s[2] * eye[2]),
+        -(u[0] * eye[0] + u[1] * eye[1] + u[2] * eye[2]),
+        f[0] * eye[0] + f[1] * eye[1] + f[2] * eye[2], 1.0f
+    };
+
+    const float nearPlane = 0.1f;
+    const float farPlane = 400.0f;
+    const float t = 1.0f / std::tan(35.0f * 3.14159265f / 180.0f);
+    float projection[16] = {
+        t / (16.0f / 9.0f), 0.0f, 0.0f, 0.0f,
+        0.0f, t, 0.0f, 0.0f,
+        0.0f, 0.0f, (farPlane + nearPlane) / (nearPlane - farPlane), -1.0f,
+        0.0f, 0.0f, 2.0f * farPlane * nearPlane / (nearPlane - farPlane), 0.0f
+    };
+
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++) {
+                sum += projection[k * 4 + row] * view[col * 4 + k];
+            }
+            out[col * 4 + row] = sum;
+        }
+    }
+}
+
+} // namespace Tests
+} // namespace SwordAndStone
+
+#define TEST_CHECK(condition)                                                       \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: "          \
+                      << #condition << std::endl;                                   \
+            ++SwordAndStone::Tests::FailureCount();                                 \
+        }                                                                           \
+    } while (0)
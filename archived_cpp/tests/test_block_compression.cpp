@@ -0,0 +1,152 @@
+#include "renderer/BlockCompression.h"
+#include "renderer/TextureAtlas.h"
+#include "renderer/NullRenderer.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace SwordAndStone::Renderer;
+
+namespace {
+
+// Largest per-channel difference over the RGB (and optionally alpha) channels
+int MaxError(const uint8_t* a, const uint8_t* b, size_t texels, bool alpha) {
+    int worst = 0;
+    for (size_t i = 0; i < texels; i++) {
+        for (int c = 0; c < (alpha ? 4 : 3); c++) {
+            worst = std::max(worst, std::abs(a[i * 4 + c] - b[i * 4 + c]));
+        }
+    }
+    return worst;
+}
+
+int SquaredError(const uint8_t* a, const uint8_t* b, size_t texels) {
+    int total = 0;
+    for (size_t i = 0; i < texels * 4; i++) {
+        total += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    return total;
+}
+
+} // namespace
+
+// Test BC1/BC3/BC7 encoding quality, texture compression and compressed uploads
+void test_block_compression() {
+    std::cout << "Testing Block Compression..." << std::endl;
+
+    // A smooth diagonal colour ramp with an alpha ramp across it
+    uint8_t gradient[64];
+    for (int i = 0; i < 16; i++) {
+        int x = i % 4, y = i / 4;
+        gradient[i * 4] = static_cast<uint8_t>(40 + x * 20 + y * 10);
+        gradient[i * 4 + 1] = static_cast<uint8_t>(100 + x * 10 + y * 5);
+        gradient[i * 4 + 2] = static_cast<uint8_t>(200 - x * 10 - y * 10);
+        gradient[i * 4 + 3] = static_cast<uint8_t>(255 - x * 40);
+    }
+
+    uint8_t block[16];
+    uint8_t bc1[64], bc3[64], bc7[64];
+    EncodeBC1Block(gradient, block);
+    DecodeBC1Block(block, bc1);
+    EncodeBC3Block(gradient, block);
+    DecodeBC3Block(block, bc3);
+    EncodeBC7Block(gradient, block);
+    TEST_CHECK((block[0] & 0x7F) == 0x40);
+    DecodeBC7Block(block, bc7);
+
+    // Mode 6 fits colour and alpha on one line, so an independent alpha ramp costs some colour accuracy
+    TEST_CHECK(MaxError(gradient, bc1, 16, false) <= 16);
+    TEST_CHECK(MaxError(gradient, bc3, 16, true) <= 16);
+    TEST_CHECK(MaxError(gradient, bc7, 16, true) <= 20);
+    TEST_CHECK(bc1[3] == 255);
+
+    // On colour alone BC7's 16 levels beat BC1's four
+    uint8_t opaque[64];
+    for (int i = 0; i < 64; i++) {
+        opaque[i] = (i % 4 == 3) ? 255 : gradient[i];
+    }
+    EncodeBC1Block(opaque, block);
+    DecodeBC1Block(block, bc1);
+    EncodeBC7Block(opaque, block);
+    DecodeBC7Block(block, bc7);
+    TEST_CHECK(SquaredError(opaque, bc7, 16) * 2 < SquaredError(opaque, bc1, 16));
+    TEST_CHECK(MaxError(opaque, bc7, 16, true) <= 8);
+
+    // Flat blocks come back within endpoint precision
+    uint8_t flat[64];
+    for (int i = 0; i < 16; i++) {
+        flat[i * 4] = 90;
+        flat[i * 4 + 1] = 160;
+        flat[i * 4 + 2] = 30;
+        flat[i * 4 + 3] = 128;
+    }
+    EncodeBC3Block(flat, block);
+    DecodeBC3Block(block, bc3);
+    TEST_CHECK(MaxError(flat, bc3, 16, false) <= 4 && bc3[3] == 128);
+    EncodeBC7Block(flat, block);
+    DecodeBC7Block(block, bc7);
+    TEST_CHECK(MaxError(flat, bc7, 16, true) <= 1);
+
+    // A 10x6 image rounds up to 3x2 blocks
+    std::vector<uint8_t> image(10 * 6 * 4);
+    for (size_t i = 0; i < image.size(); i++) {
+        image[i] = static_cast<uint8_t>((i * 7) % 256);
+    }
+    std::vector<uint8_t> compressed, decompressed;
+    TEST_CHECK(!CompressTexture(image.data(), 10, 6, TextureFormat::RGBA8, compressed));
+    TEST_CHECK(CompressTexture(image.data(), 10, 6, TextureFormat::BC1, compressed));
+    TEST_CHECK(compressed.size() == 6 * 8);
+    TEST_CHECK(CompressTexture(image.data(), 10, 6, TextureFormat::BC7SRGB, compressed));
+    TEST_CHECK(compressed.size() == 6 * 16 && compressed.size() == GetTextureDataSize(10, 6, TextureFormat::BC7));
+    TEST_CHECK(DecompressTexture(compressed.data(), 10, 6, TextureFormat::BC7SRGB, decompressed));
+    TEST_CHECK(decompressed.size() == image.size());
+
+    // The null backend sizes compressed uploads by block
+    NullRenderer renderer;
+    renderer.Initialize(nullptr, 640, 480);
+    uint32_t texture = renderer.CreateTexture2D(10, 6, TextureFormat::BC7SRGB, compressed.data());
+    TEST_CHECK(texture != 0);
+    TEST_CHECK(renderer.GetStats().bytesUploaded == 6 * 16);
+
+    // A compressed atlas keeps its blocks through the cache
+    std::vector<uint8_t> tile(16 * 16 * 4);
+    for (size_t i = 0; i < tile.size(); i++) {
+        tile[i] = static_cast<uint8_t>(i % 4 == 3 ? 255 : (i / 64) * 16);
+    }
+    TextureAtlasDesc desc;
+    desc.padding = 4;
+    desc.format = TextureFormat::BC7SRGB;
+
+    const std::string cachePath = "block_compression_cache.bin";
+    std::remove(cachePath.c_str());
+    TextureAtlas atlas;
+    atlas.AddImage("ramp", 16, 16, tile.data());
+    TEST_CHECK(atlas.Build(desc, cachePath));
+    TEST_CHECK(atlas.GetFormat() == TextureFormat::BC7SRGB);
+    TEST_CHECK(atlas.GetWidth() == 24 && atlas.GetLevelCount() == 3);
+    TEST_CHECK(atlas.GetLevel(0).size() == 6 * 6 * 16);
+    TEST_CHECK(atlas.GetLevel(2).size() == 2 * 2 * 16);
+
+    TextureAtlas cached;
+    cached.AddImage("ramp", 16, 16, tile.data());
+    TEST_CHECK(cached.Build(desc, cachePath));
+    TEST_CHECK(cached.WasLoadedFromCache());
+    TEST_CHECK(cached.GetFormat() == TextureFormat::BC7SRGB && cached.GetLevel(0) == atlas.GetLevel(0));
+
+    // Changing only the format misses the cache
+    desc.format = TextureFormat::SRGBA8;
+    TextureAtlas uncompressed;
+    uncompressed.AddImage("ramp", 16, 16, tile.data());
+    TEST_CHECK(uncompressed.Build(desc, cachePath));
+    TEST_CHECK(!uncompressed.WasLoadedFromCache());
+    TEST_CHECK(uncompressed.GetLevel(0).size() == 24 * 24 * 4);
+    std::remove(cachePath.c_str());
+
+    renderer.ResetStats();
+    TEST_CHECK(cached.Upload(renderer) != 0);
+    TEST_CHECK(renderer.GetStats().bytesUploaded == (36 + 9 + 4) * 16);
+
+    std::cout << "Block Compression test passed!" << std::endl;
+}
@@ -0,0 +1,155 @@
+#include "game/CharacterController.h"
+#include "game/Player.h"
+#include "platform/JobSystem.h"
+#include "TestFramework.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace SwordAndStone::Game;
+using namespace SwordAndStone::Platform;
+
+namespace {
+
+const float DT = 1.0f / 60.0f;
+
+void Simulate(const VoxelSystem& voxels, Character& character, int frames) {
+    for (int i = 0; i < frames; i++) {
+        MoveCharacter(voxels, character, DT);
+    }
+}
+
+} // namespace
+
+// Test landing, walls, step-up, ground snapping, ceilings, batching and the player
+void test_character_controller() {
+    std::cout << "Testing Character Controller..." << std::endl;
+
+    // Floor at y = 0 (top face y = 1); a one-block step at x >= 10, a two-block wall at z >= 10,
+    // a one-block drop at x < -5 and a low ceiling over x in [0, 2)
+    VoxelSystem voxels;
+    for (int x = -16; x < 32; x++) {
+        for (int z = -16; z < 32; z++) {
+            if (x >= -5) voxels.SetVoxel(x, 0, z, VoxelType::Stone);
+            else voxels.SetVoxel(x, -1, z, VoxelType::Stone);
+            if (x >= 10) voxels.SetVoxel(x, 1, z, VoxelType::Dirt);
+            if (z >= 10) {
+                voxels.SetVoxel(x, 1, z, VoxelType::Stone);
+                voxels.SetVoxel(x, 2, z, VoxelType::Stone);
+            }
+            if (x >= 0 && x < 2 && z < 0) voxels.SetVoxel(x, 4, z, VoxelType::Stone);
+        }
+    }
+    voxels.Update(0.0f);
+
+    // Falls, lands exactly on the floor and stays there
+    Character character;
+    character.position[0] = 5.5f;
+    character.position[1] = 6.0f;
+    character.position[2] = 0.5f;
+    Simulate(voxels, character, 120);
+    TEST_CHECK(character.grounded && character.position[1] == 1.0f && character.velocity[1] == 0.0f);
+
+    // Walks up the one-block step
+    character.velocity[0] = 5.0f;
+    Simulate(voxels, character, 60);
+    TEST_CHECK(character.grounded && character.position[1] == 2.0f && character.position[0] > 10.0f);
+
+    // A two-block wall stops it, touching the wall
+    Character walker;
+    walker.position[0] = 5.5f;
+    walker.position[1] = 1.0f;
+    walker.position[2] = 5.5f;
+    walker.grounded = true;
+    walker.velocity[2] = 5.0f;
+    Simulate(voxels, walker, 90);
+    TEST_CHECK(walker.position[1] == 1.0f && std::abs(walker.position[2] + walker.desc.radius - 10.0f) < 1e-4f);
+    TEST_CHECK(walker.velocity[2] == 0.0f);
+
+    // Sliding diagonally along the wall keeps the free axis moving
+    walker.velocity[0] = 3.0f;
+    walker.velocity[2] = 3.0f;
+    float before = walker.position[0];
+    Simulate(voxels, walker, 10);
+    TEST_CHECK(walker.position[0] > before && std::abs(walker.position[2] + walker.desc.radius - 10.0f) < 1e-4f);
+
+    // Walking off the one-block drop snaps down without going airborne
+    Character descender;
+    descender.position[0] = -3.5f;
+    descender.position[1] = 1.0f;
+    descender.position[2] = 0.5f;
+    descender.grounded = true;
+    bool stayedGrounded = true;
+    for (int i = 0; i < 30; i++) {
+        descender.velocity[0] = -5.0f;
+        MoveCharacter(voxels, descender, DT);
+        stayedGrounded = stayedGrounded && descender.grounded;
+    }
+    TEST_CHECK(stayedGrounded && descender.position[1] == 0.0f && descender.position[0] < -6.0f);
+
+    // A jump leaves the ground and a low ceiling cuts it short
+    Character jumper;
+    jumper.position[0] = 1.0f;
+    jumper.position[1] = 1.0f;
+    jumper.position[2] = -3.0f;
+    jumper.grounded = true;
+    jumper.velocity[1] = 6.0f;
+    MoveCharacter(voxels, jumper, DT);
+    TEST_CHECK(!jumper.grounded && jumper.position[1] > 1.0f);
+    float peak = 0.0f;
+    for (int i = 0; i < 60; i++) {
+        MoveCharacter(voxels, jumper, DT);
+        peak = std::max(peak, jumper.position[1] + jumper.desc.height);
+    }
+    TEST_CHECK(peak <= 4.0f && jumper.grounded);
+
+    // The player follows the GDScript controller's conventions: forward is -Z at yaw 0
+    Player player;
+    const float spawn[3] = { 5.5f, 1.0f, 5.5f };
+    player.Initialize(&voxels, spawn);
+    player.SetMoveInput(0.0f, -1.0f, false, false);
+    for (int i = 0; i < 30; i++) player.Update(DT);
+    TEST_CHECK(player.GetCharacter().grounded);
+    TEST_CHECK(std::abs(player.GetCharacter().position[2] - (5.5f - Player::WALK_SPEED * 0.5f)) < 0.05f);
+    player.SetYaw(3.14159265f * 0.5f);
+    player.SetMoveInput(0.0f, -1.0f, true, true);
+    player.Update(DT);
+    TEST_CHECK(!player.GetCharacter().grounded && player.GetCharacter().velocity[0] < -Player::WALK_SPEED);
+
+    // Many NPCs at once match one at a time
+    JobSystem jobs(3);
+    std::vector<Character> crowd(2000);
+    for (size_t i = 0; i < crowd.size(); i++) {
+        Character& npc = crowd[i];
+        npc.position[0] = -4.0f + static_cast<float>(i % 30);
+        npc.position[1] = 3.0f + static_cast<float>(i % 3);
+        npc.position[2] = -12.0f + static_cast<float>(i / 100);
+        npc.velocity[0] = (i % 2) ? 4.0f : -4.0f;
+        npc.velocity[2] = (i % 5) * 0.5f;
+    }
+    std::vector<Character> serial = crowd;
+    for (int frame = 0; frame < 30; frame++) {
+        MoveCharacters(voxels, crowd.data(), static_cast<uint32_t>(crowd.size()), DT, &jobs);
+        for (Character& npc : serial) MoveCharacter(voxels, npc, DT);
+    }
+    bool matches = true;
+    for (size_t i = 0; i < crowd.size(); i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            matches = matches && crowd[i].position[axis] == serial[i].position[axis];
+        }
+    }
+    TEST_CHECK(matches);
+
+    const int frames = 60;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (Character& npc : serial) MoveCharacter(voxels, npc, DT);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  character move: "
+              << std::chrono::duration<double, std::nano>(end - start).count() / (frames * serial.size())
+              << " ns per character" << std::endl;
+
+    std::cout << "Character Controller test passed!" << std::endl;
+}
@@ -0,0 +1,99 @@
+#include "game/ChunkVisibility.h"
+#include "TestFramework.h"
+#include <iostream>
+
+using namespace SwordAndStone::Game;
+using SwordAndStone::Renderer::Frustum;
+using SwordAndStone::Tests::BuildViewProjection;
+
+// Test chunk connectivity, batched frustum tests and cave culling
+void test_chunk_visibility() {
+    std::cout << "Testing Chunk Visibility..." << std::endl;
+
+    // A stone chunk with a tunnel along X connects only its X faces
+    Chunk tunnel(VoxelType::Stone);
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        tunnel.Set(x, 8, 8, VoxelType::Air);
+    }
+    tunnel.UpdateConnectivity();
+    TEST_CHECK(tunnel.AreFacesConnected(ChunkFace::NegX, ChunkFace::PosX));
+    TEST_CHECK(!tunnel.AreFacesConnected(ChunkFace::NegY, ChunkFace::PosY));
+    TEST_CHECK(!tunnel.AreFacesConnected(ChunkFace::NegX, ChunkFace::PosZ));
+    Chunk air;
+    air.UpdateConnectivity();
+    TEST_CHECK(air.GetConnectivity() == Chunk::ALL_FACES_CONNECTED);
+
+    TEST_CHECK(VoxelSystem::FloorDiv(-1, CHUNK_SIZE) == -1 && VoxelSystem::FloorDiv(16, CHUNK_SIZE) == 1);
+
+    // Terrain: four solid chunk layers, then a surface chunk half stone, half air
+    VoxelSystem voxels;
+    const int renderDistance = VoxelSystem::RENDER_DISTANCE;
+    for (int cx = -renderDistance; cx <= renderDistance; cx++) {
+        for (int cz = -renderDistance; cz <= renderDistance; cz++) {
+            for (int cy = 0; cy < 4; cy++) {
+                voxels.GetOrCreateChunk({ cx, cy, cz }).Fill(VoxelType::Stone);
+            }
+            Chunk& surface = voxels.GetOrCreateChunk({ cx, 4, cz });
+            for (int y = 0; y < 8; y++) {
+                for (int z = 0; z < CHUNK_SIZE; z++) {
+                    for (int x = 0; x < CHUNK_SIZE; x++) {
+                        surface.Set(x, y, z, VoxelType::Stone);
+                    }
+                }
+            }
+        }
+    }
+    voxels.Update(0.0f);
+    TEST_CHECK(voxels.GetChunk({ 0, 0, 0 })->IsUniform());
+    TEST_CHECK(voxels.GetVoxel(3, 4 * CHUNK_SIZE + 7, -5) == VoxelType::Stone);
+    TEST_CHECK(voxels.GetVoxel(3, 4 * CHUNK_SIZE + 8, -5) == VoxelType::Air);
+
+    // Camera standing on the surface, looking slightly down across the terrain
+    const float eye[3] = { 8.0f, 4.0f * CHUNK_SIZE + 10.0f, 8.0f };
+    const float target[3] = { 100.0f, 4.0f * CHUNK_SIZE - 10.0f, 20.0f };
+    float viewProjection[16];
+    BuildViewProjection(eye, target, viewProjection);
+    Frustum frustum = Frustum::FromMatrix(viewProjection);
+
+    // The SIMD batch agrees with the scalar test
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+    for (int i = 0; i < 103; i++) {
+        float x = static_cast<float>((i * 37) % 200) - 50.0f;
+        float y = static_cast<float>((i * 11) % 120);
+        float z = static_cast<float>((i * 53) % 160) - 80.0f;
+        minX.push_back(x); minY.push_back(y); minZ.push_back(z);
+        maxX.push_back(x + 4.0f); maxY.push_back(y + 4.0f); maxZ.push_back(z + 4.0f);
+    }
+    std::vector<uint8_t> batched(minX.size());
+    frustum.TestAABBs(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(),
+                      minX.size(), batched.data());
+    bool agrees = true;
+    for (size_t i = 0; i < minX.size(); i++) {
+        const float min[3] = { minX[i], minY[i], minZ[i] };
+        const float max[3] = { maxX[i], maxY[i], maxZ[i] };
+        agrees = agrees && (batched[i] != 0) == frustum.TestAABB(min, max);
+    }
+    TEST_CHECK(agrees);
+
+    ChunkVisibility visibility;
+    visibility.SetCaveCulling(false);
+    visibility.Update(voxels, eye, frustum);
+    uint32_t frustumVisible = visibility.GetStats().visible;
+    TEST_CHECK(visibility.GetStats().chunksInRange == 17 * 17 * 5);
+    TEST_CHECK(visibility.GetStats().frustumCulled > 0);
+
+    visibility.SetCaveCulling(true);
+    visibility.Update(voxels, eye, frustum);
+    const ChunkVisibilityStats& stats = visibility.GetStats();
+    TEST_CHECK(stats.visible * 2 < frustumVisible);
+    TEST_CHECK(stats.connectivityCulled > 0);
+    TEST_CHECK(stats.visible + stats.frustumCulled + stats.connectivityCulled == stats.chunksInRange);
+
+    bool surfaceAhead = false;
+    for (const ChunkCoord& coord : visibility.GetVisibleChunks()) {
+        surfaceAhead = surfaceAhead || (coord.x == 4 && coord.y == 4 && coord.z == 0);
+    }
+    TEST_CHECK(surfaceAhead);
+
+    std::cout << "Chunk Visibility test passed!" << std::endl;
+}
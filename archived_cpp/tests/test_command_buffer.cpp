@@ -0,0 +1,66 @@
+#include "renderer/CommandBuffer.h"
+#include "renderer/NullRenderer.h"
+#include "TestFramework.h"
+#include <iostream>
+
+using namespace SwordAndStone::Renderer;
+
+// Test sort-key ordering and redundant state elimination
+void test_command_buffer() {
+    std::cout << "Testing Command Buffer..." << std::endl;
+
+    TEST_CHECK(SortKey::Make(1, 0, 0, 0) > SortKey::Make(0, 0xFFFF, 0xFFFF, 0xFFFFFF));
+    TEST_CHECK(SortKey::Make(0, 2, 0, 0) > SortKey::Make(0, 1, 0xFFFF, 0xFFFFFF));
+    TEST_CHECK(SortKey::QuantizeDepth(0.25f) < SortKey::QuantizeDepth(0.75f));
+    TEST_CHECK(SortKey::QuantizeDepth(0.25f, true) > SortKey::QuantizeDepth(0.75f, true));
+
+    NullRenderer renderer;
+    renderer.Initialize(nullptr, 640, 480);
+
+    Vertex vertices[3] = {};
+    uint32_t indices[3] = { 0, 1, 2 };
+    uint32_t vb = renderer.CreateVertexBuffer(vertices, sizeof(vertices), BufferUsage::Static);
+    uint32_t ib = renderer.CreateIndexBuffer(indices, 3, BufferUsage::Static);
+    uint32_t shaders[2] = { renderer.CreateShader("a", "a"), renderer.CreateShader("b", "b") };
+    uint32_t textures[2] = { renderer.CreateTexture2D(1, 1, TextureFormat::RGBA8, nullptr),
+                             renderer.CreateTexture2D(1, 1, TextureFormat::RGBA8, nullptr) };
+
+    // 64 draws alternating shader and texture, with the transparent pass recorded first
+    CommandBuffer commands;
+    for (uint32_t i = 0; i < 64; i++) {
+        uint32_t shader = shaders[i % 2];
+        uint32_t texture = textures[(i / 2) % 2];
+        uint32_t pass = (i < 8) ? 1 : 0;
+        uint8_t state = pass == 1 ? (StateDepthTest | StateBlending) : StateDefault;
+        uint64_t key = SortKey::Make(pass, shader, texture, SortKey::QuantizeDepth(i / 64.0f, pass == 1));
+        commands.DrawIndexed(key, shader, texture, vb, ib, 3, state);
+    }
+
+    const std::vector<uint32_t>& order = commands.Sort();
+    TEST_CHECK(order.size() == 64);
+    bool sorted = true;
+    for (size_t i = 1; i < order.size(); i++) {
+        sorted = sorted && commands.GetCommands()[order[i - 1]].key <= commands.GetCommands()[order[i]].key;
+    }
+    TEST_CHECK(sorted);
+
+    renderer.BeginFrame();
+    commands.Execute(renderer);
+    renderer.EndFrame();
+
+    const RenderStats& stats = renderer.GetStats();
+    TEST_CHECK(stats.drawCalls == 64);
+    TEST_CHECK(stats.shaderSwitches <= 4);
+    TEST_CHECK(commands.GetStats().commandsSorted == 64);
+    TEST_CHECK(commands.GetStats().bindsSkipped > 64 * 3);
+    TEST_CHECK(stats.commandsSorted == 64 && stats.bindsSkipped == commands.GetStats().bindsSkipped);
+    TEST_CHECK(commands.GetCommandCount() == 0);
+
+    size_t shaderBinds = 0;
+    for (const NullCommand& command : renderer.GetFrameCommands()) {
+        shaderBinds += command.type == NullCommandType::BindShader ? 1 : 0;
+    }
+    TEST_CHECK(shaderBinds <= 4);
+
+    std::cout << "Command Buffer test passed!" << std::endl;
+}
@@ -0,0 +1,183 @@
+#include "game/EntityRegistry.h"
+#include "game/EntityComponents.h"
+#include "game/GameWorld.h"
+#include "platform/JobSystem.h"
+#include "TestFramework.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace SwordAndStone::Game;
+using namespace SwordAndStone::Platform;
+
+namespace {
+
+struct alignas(32) Wide {
+    float values[8];
+};
+
+} // namespace
+
+// Test entity lifetime, archetype moves, queries, deferred changes and a 100k-entity tick
+void test_entity_registry() {
+    std::cout << "Testing Entity Registry..." << std::endl;
+
+    JobSystem jobs(3);
+    EntityRegistry registry(&jobs);
+
+    // Handles go stale when their entity is destroyed, even after the index is reused
+    Entity a = registry.Create(Position{ 1.0f, 2.0f, 3.0f }, Velocity{ 1.0f, 0.0f, 0.0f });
+    Entity b = registry.Create(Position{ 4.0f, 5.0f, 6.0f });
+    TEST_CHECK(registry.IsAlive(a) && registry.GetEntityCount() == 2);
+    TEST_CHECK(registry.Has<Velocity>(a) && !registry.Has<Velocity>(b));
+    TEST_CHECK(registry.Get<Position>(b)->z == 6.0f);
+    registry.Destroy(a);
+    TEST_CHECK(!registry.IsAlive(a) && registry.Get<Position>(a) == nullptr);
+    Entity c = registry.Create(Position{ 7.0f, 8.0f, 9.0f });
+    TEST_CHECK(c.index == a.index && c != a && !registry.IsAlive(a));
+    registry.Destroy(a);
+    TEST_CHECK(registry.IsAlive(c) && registry.GetEntityCount() == 2);
+
+    // Adding and removing components moves the row and keeps the values it shares
+    registry.Add(b, Lifetime{ 2.0f });
+    registry.Add(b, Wide{ { 1, 2, 3, 4, 5, 6, 7, 8 } });
+    TEST_CHECK(registry.Get<Position>(b)->x == 4.0f && registry.Get<Lifetime>(b)->remaining == 2.0f);
+    TEST_CHECK(reinterpret_cast<uintptr_t>(registry.Get<Wide>(b)) % alignof(Wide) == 0);
+    TEST_CHECK(registry.Get<Wide>(b)->values[7] == 8.0f);
+    registry.Remove<Lifetime>(b);
+    TEST_CHECK(!registry.Has<Lifetime>(b) && registry.Get<Wide>(b)->values[0] == 1.0f);
+    TEST_CHECK(registry.Get<Position>(c)->y == 8.0f);
+    registry.Destroy(b);
+    registry.Destroy(c);
+    TEST_CHECK(registry.GetEntityCount() == 0 && registry.GetChunkCount() == 0);
+
+    // Swap-removal across several chunks keeps every survivor's data addressable
+    const uint32_t batch = 5000;
+    std::vector<Entity> entities;
+    for (uint32_t i = 0; i < batch; i++) {
+        entities.push_back(registry.Create(Position{ float(i), 0.0f, 0.0f }, Velocity{ 0.0f, 0.0f, 0.0f }));
+    }
+    TEST_CHECK(registry.GetChunkCount() > 1);
+    for (uint32_t i = 0; i < batch; i += 3) {
+        registry.Destroy(entities[i]);
+    }
+    bool intact = true;
+    for (uint32_t i = 0; i < batch; i++) {
+        if (i % 3 == 0) continue;
+        const Position* position = registry.Get<Position>(entities[i]);
+        intact = intact && position && position->x == float(i);
+    }
+    TEST_CHECK(intact);
+
+    // Queries see exactly the entities holding every requested component, including archetypes made later
+    uint32_t moving = 0;
+    registry.ForEach<Position, Velocity>([&moving](Entity, Position&, Velocity&) { moving++; });
+    TEST_CHECK(moving == batch - (batch + 2) / 3);
+    registry.Add(entities[1], Gravity{ 10.0f });
+    uint32_t falling = 0;
+    registry.ForEach<Gravity>([&falling](Entity, Gravity&) { falling++; });
+    moving = 0;
+    registry.ForEach<Position, Velocity>([&moving](Entity, Position&, Velocity&) { moving++; });
+    TEST_CHECK(falling == 1 && moving == batch - (batch + 2) / 3);
+
+    // Structural changes recorded from parallel systems apply at the flush
+    registry.ParallelForEach<Position>([&registry](Entity entity, Position& position) {
+        if (int(position.x) % 2 == 0) {
+            registry.GetCommands().Destroy(entity);
+        } else if (int(position.x) % 5 == 0) {
+            registry.GetCommands().Add(entity, Lifetime{ 1.0f });
+        }
+    });
+    registry.GetCommands().Spawn(Position{ -1.0f, 0.0f, 0.0f }, ItemDrop{ 3, 64 });
+    registry.GetCommands().Destroy(entities[0]);  // already gone, ignored
+    size_t expected = 0;
+    for (uint32_t i = 0; i < batch; i++) {
+        if (i % 3 != 0 && i % 2 != 0) expected++;
+    }
+    registry.FlushCommands();
+    TEST_CHECK(registry.GetEntityCount() == expected + 1);
+    uint32_t drops = 0;
+    registry.ForEach<Position, ItemDrop>([&drops](Entity, Position& position, ItemDrop& drop) {
+        drops += position.x == -1.0f && drop.count == 64 ? 1 : 0;
+    });
+    uint32_t expiring = 0;
+    registry.ForEach<Lifetime>([&expiring](Entity, Lifetime&) { expiring++; });
+    TEST_CHECK(drops == 1 && expiring > 0);
+    TEST_CHECK(registry.Get<Lifetime>(entities[5]) && !registry.IsAlive(entities[4]));
+
+    // Workers of another job system record into buffers of their own, even while the registry's workers record
+    JobSystem otherJobs(6);
+    JobCounter otherDone;
+    std::atomic<uint32_t> sharedBuffers{0};
+    EntityCommands* ownerCommands = &registry.GetCommands();
+    for (int job = 0; job < 64; job++) {
+        otherJobs.Run([&registry, &sharedBuffers, ownerCommands]() {
+            EntityCommands& commands = registry.GetCommands();
+            sharedBuffers += &commands == ownerCommands ? 1 : 0;
+            for (int i = 0; i < 50; i++) commands.Spawn(ItemDrop{ 1, 1 });
+        }, &otherDone);
+    }
+    uint32_t positioned = 0;
+    registry.ForEach<Position>([&positioned](Entity, Position&) { positioned++; });
+    registry.ParallelForEach<Position>([&registry](Entity, Position&) {
+        registry.GetCommands().Spawn(ItemDrop{ 1, 2 });
+    });
+    while (otherDone.pending.load() != 0) {
+        std::this_thread::yield();  // Wait() would run the remaining jobs on this thread
+    }
+    registry.FlushCommands();
+    uint32_t otherSpawns = 0;
+    uint32_t ownSpawns = 0;
+    registry.ForEach<ItemDrop>([&otherSpawns, &ownSpawns](Entity, ItemDrop& drop) {
+        otherSpawns += drop.itemType == 1 && drop.count == 1 ? 1 : 0;
+        ownSpawns += drop.itemType == 1 && drop.count == 2 ? 1 : 0;
+    });
+    TEST_CHECK(sharedBuffers == 0 && otherSpawns == 64 * 50 && ownSpawns == positioned);
+
+    // GameWorld systems: 100k drops, projectiles and particles integrated and expired per tick
+    GameWorld world(&jobs);
+    EntityRegistry& worldEntities = world.GetEntities();
+    const uint32_t count = 100000;
+    for (uint32_t i = 0; i < count; i++) {
+        const Position position = { float(i % 100), 64.0f, float(i / 100) };
+        switch (i % 3) {
+        case 0:
+            worldEntities.Create(position, Velocity{ 0.0f, 0.0f, 0.0f }, Gravity{ 20.0f }, ItemDrop{ 1, 1 },
+                                 Lifetime{ 300.0f });
+            break;
+        case 1:
+            worldEntities.Create(position, Velocity{ 30.0f, 5.0f, 0.0f }, Gravity{ 9.8f },
+                                 Projectile{ 4.0f, 0 }, Lifetime{ 10.0f });
+            break;
+        default:
+            // Particles die after a few ticks
+            worldEntities.Create(position, Velocity{ 0.0f, 1.0f, 0.0f }, Lifetime{ 0.05f + 0.001f * (i % 50) });
+            break;
+        }
+    }
+    TEST_CHECK(worldEntities.GetEntityCount() == count);
+
+    const float dt = 1.0f / 60.0f;
+    world.Update(dt);
+    const Position* dropped = worldEntities.Get<Position>({ 0, 0 });
+    const Velocity* fall = worldEntities.Get<Velocity>({ 0, 0 });
+    TEST_CHECK(dropped && fall && fall->y < 0.0f && dropped->y < 64.0f);
+
+    const int ticks = 60;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        world.Update(dt);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    uint32_t particles = 0;
+    worldEntities.ForEach<Lifetime>([&particles](Entity, Lifetime& lifetime) {
+        particles += lifetime.remaining < 1.0f ? 1 : 0;
+    });
+    TEST_CHECK(particles == 0);
+    TEST_CHECK(worldEntities.GetEntityCount() == count - (count / 3));
+    std::cout << "  tick of " << count << " entities: "
+              << std::chrono::duration<double, std::micro>(end - start).count() / ticks << " us" << std::endl;
+
+    std::cout << "Entity Registry test passed!" << std::endl;
+}
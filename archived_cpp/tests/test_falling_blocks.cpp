@@ -0,0 +1,175 @@
+#include "game/FallingBlocks.h"
+#include "TestFramework.h"
+#include <chrono>
+#include <iostream>
+
+using namespace SwordAndStone::Game;
+
+namespace {
+
+// Stone floor at y = 0 over x, z in [0, 32)
+void BuildFloor(VoxelSystem& voxels) {
+    for (int cx = 0; cx < 2; cx++) {
+        for (int cz = 0; cz < 2; cz++) {
+            for (int cy = 0; cy < 4; cy++) {
+                voxels.GetOrCreateChunk({ cx, cy, cz });
+            }
+        }
+    }
+    for (int x = 0; x < 32; x++) {
+        for (int z = 0; z < 32; z++) {
+            voxels.SetVoxel(x, 0, z, VoxelType::Stone);
+        }
+    }
+    voxels.Update(0.0f);
+}
+
+int RunUntilSettled(FallingBlockSimulation& simulation, VoxelSystem& voxels, int maxTicks) {
+    int ticks = 0;
+    while (simulation.GetActiveCount() > 0 && ticks < maxTicks) {
+        simulation.Tick(voxels);
+        ticks++;
+    }
+    return ticks;
+}
+
+} // namespace
+
+// Test columns falling, supports being removed, water displacement, fixed-rate ticking and escalation
+void test_falling_blocks() {
+    std::cout << "Testing Falling Blocks..." << std::endl;
+
+    VoxelSystem voxels;
+    BuildFloor(voxels);
+    FallingBlockSimulation simulation;
+
+    // A floating column of sand over gravel lands in order on the floor
+    voxels.SetVoxel(4, 10, 4, VoxelType::Gravel);
+    voxels.SetVoxel(4, 11, 4, VoxelType::Sand);
+    voxels.SetVoxel(4, 12, 4, VoxelType::Sand);
+    simulation.Wake(4, 10, 4);
+    simulation.Wake(4, 11, 4);
+    simulation.Wake(4, 12, 4);
+    int ticks = RunUntilSettled(simulation, voxels, 100);
+    TEST_CHECK(ticks <= 12 && simulation.GetActiveCount() == 0);
+    TEST_CHECK(voxels.GetVoxel(4, 1, 4) == VoxelType::Gravel);
+    TEST_CHECK(voxels.GetVoxel(4, 2, 4) == VoxelType::Sand && voxels.GetVoxel(4, 3, 4) == VoxelType::Sand);
+    TEST_CHECK(voxels.GetVoxel(4, 4, 4) == VoxelType::Air && voxels.GetVoxel(4, 12, 4) == VoxelType::Air);
+
+    // Blocks on solid ground and blocks that do not fall stay put
+    voxels.SetVoxel(6, 1, 6, VoxelType::Sand);
+    voxels.SetVoxel(6, 5, 6, VoxelType::Dirt);
+    simulation.Wake(6, 1, 6);
+    simulation.Wake(6, 5, 6);
+    TEST_CHECK(simulation.Tick(voxels) == 0);
+    TEST_CHECK(voxels.GetVoxel(6, 1, 6) == VoxelType::Sand && voxels.GetVoxel(6, 5, 6) == VoxelType::Dirt);
+
+    // Breaking the block under a sand pile brings the pile down
+    for (int y = 6; y < 9; y++) voxels.SetVoxel(6, y, 6, VoxelType::Sand);
+    voxels.SetVoxel(6, 5, 6, VoxelType::Air);
+    simulation.Wake(6, 5, 6);
+    RunUntilSettled(simulation, voxels, 100);
+    for (int y = 1; y <= 4; y++) TEST_CHECK(voxels.GetVoxel(6, y, 6) == VoxelType::Sand);
+    TEST_CHECK(voxels.GetVoxel(6, 5, 6) == VoxelType::Air);
+
+    // Sand sinks through water, which is pushed up rather than destroyed
+    voxels.SetVoxel(8, 1, 8, VoxelType::Water);
+    voxels.SetVoxel(8, 2, 8, VoxelType::Water);
+    voxels.SetVoxel(8, 3, 8, VoxelType::Sand);
+    simulation.Wake(8, 3, 8);
+    RunUntilSettled(simulation, voxels, 100);
+    TEST_CHECK(voxels.GetVoxel(8, 1, 8) == VoxelType::Sand);
+    TEST_CHECK(voxels.GetVoxel(8, 2, 8) == VoxelType::Water && voxels.GetVoxel(8, 3, 8) == VoxelType::Water);
+
+    // Unloaded terrain holds blocks up until it loads; y = 64 is the bottom layer of its chunk
+    voxels.SetVoxel(40, 64, 40, VoxelType::Sand);
+    simulation.Wake(40, 64, 40);
+    TEST_CHECK(simulation.Tick(voxels) == 0 && voxels.GetVoxel(40, 64, 40) == VoxelType::Sand);
+    TEST_CHECK(simulation.GetActiveCount() == 0 && simulation.GetWaitingCount() == 1);
+    const ChunkCoord below = VoxelSystem::WorldToChunk(40, 63, 40);
+    voxels.GetOrCreateChunk(below);
+    simulation.OnChunkLoaded(below);
+    TEST_CHECK(simulation.GetActiveCount() == 1 && simulation.GetWaitingCount() == 0);
+    RunUntilSettled(simulation, voxels, 100);
+    TEST_CHECK(voxels.GetVoxel(40, 64, 40) == VoxelType::Air && voxels.GetVoxel(40, 48, 40) == VoxelType::Sand);
+    TEST_CHECK(simulation.GetWaitingCount() == 1);  // now on the next unloaded chunk down
+    voxels.SetVoxel(40, 48, 40, VoxelType::Air);
+    simulation.Clear();
+
+    // Ticks run at a fixed rate whatever the frame time, with a cap after a hitch
+    voxels.SetVoxel(10, 20, 10, VoxelType::Sand);
+    simulation.Wake(10, 20, 10);
+    simulation.Update(voxels, 0.5f / FallingBlockSimulation::TICK_RATE);
+    TEST_CHECK(simulation.GetStats().ticks == 0 && voxels.GetVoxel(10, 20, 10) == VoxelType::Sand);
+    simulation.Update(voxels, 0.6f / FallingBlockSimulation::TICK_RATE);
+    TEST_CHECK(simulation.GetStats().ticks == 1 && voxels.GetVoxel(10, 19, 10) == VoxelType::Sand);
+    simulation.Update(voxels, 1.0f);
+    TEST_CHECK(simulation.GetStats().ticks == FallingBlockSimulation::MAX_TICKS_PER_UPDATE);
+    TEST_CHECK(voxels.GetVoxel(10, 19 - FallingBlockSimulation::MAX_TICKS_PER_UPDATE, 10) == VoxelType::Sand);
+    RunUntilSettled(simulation, voxels, 100);
+    voxels.Update(0.0f);
+
+    // Near the focus, long falls become rigid bodies, a few per tick; short drops and far blocks stay on the grid
+    FallingBlockSimulation focused;
+    const float camera[3] = { 20.5f, 10.0f, 20.5f };
+    focused.SetFocus(camera, 8.0f);
+    for (int x = 18; x < 24; x++) {
+        voxels.SetVoxel(x, 12, 20, VoxelType::Gravel);
+        focused.Wake(x, 12, 20);
+    }
+    voxels.SetVoxel(22, 2, 22, VoxelType::Sand);
+    focused.Wake(22, 2, 22);
+    voxels.SetVoxel(2, 12, 2, VoxelType::Sand);
+    focused.Wake(2, 12, 2);
+    focused.Update(voxels, 1.0f / FallingBlockSimulation::TICK_RATE);
+    TEST_CHECK(focused.GetEscalatedBlocks().size() == FallingBlockSimulation::MAX_ESCALATIONS_PER_TICK);
+    const EscalatedBlock& body = focused.GetEscalatedBlocks()[0];
+    TEST_CHECK(body.type == VoxelType::Gravel && body.position[1] == 12);
+    TEST_CHECK(voxels.GetVoxel(body.position[0], 12, 20) == VoxelType::Air);
+    TEST_CHECK(voxels.GetVoxel(22, 1, 22) == VoxelType::Sand && voxels.GetVoxel(2, 11, 2) == VoxelType::Sand);
+    int escalated = static_cast<int>(focused.GetEscalatedBlocks().size());
+    while (focused.GetActiveCount() > 0) {
+        focused.Update(voxels, 1.0f / FallingBlockSimulation::TICK_RATE);
+        escalated += static_cast<int>(focused.GetEscalatedBlocks().size());
+    }
+    int onGrid = 0;
+    for (int x = 18; x < 24; x++) onGrid += voxels.GetVoxel(x, 1, 20) == VoxelType::Gravel ? 1 : 0;
+    TEST_CHECK(escalated + onGrid == 6 && escalated >= 4);
+
+    // A collapse of a few hundred gravel blocks costs time per moving block
+    VoxelSystem quarry;
+    BuildFloor(quarry);
+    FallingBlockSimulation collapse;
+    for (int x = 8; x < 16; x++) {
+        for (int z = 8; z < 16; z++) {
+            for (int y = 20; y < 26; y++) quarry.SetVoxel(x, y, z, VoxelType::Gravel);
+            quarry.SetVoxel(x, 19, z, VoxelType::Dirt);
+        }
+    }
+    quarry.Update(0.0f);
+    for (int x = 8; x < 16; x++) {
+        for (int z = 8; z < 16; z++) {
+            quarry.SetVoxel(x, 19, z, VoxelType::Air);
+            collapse.Wake(x, 19, z);
+        }
+    }
+    uint32_t moved = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (collapse.GetActiveCount() > 0) {
+        moved += collapse.Tick(quarry);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    quarry.Update(0.0f);
+    bool landed = true;
+    for (int x = 8; x < 16; x++) {
+        for (int z = 8; z < 16; z++) {
+            for (int y = 1; y <= 6; y++) landed = landed && quarry.GetVoxel(x, y, z) == VoxelType::Gravel;
+            landed = landed && quarry.GetVoxel(x, 7, z) == VoxelType::Air;
+        }
+    }
+    TEST_CHECK(landed && moved == 384 * 19);
+    std::cout << "  gravel collapse: 384 blocks, " << moved << " moves, "
+              << std::chrono::duration<double, std::nano>(end - start).count() / moved << " ns per move" << std::endl;
+
+    std::cout << "Falling Blocks test passed!" << std::endl;
+}
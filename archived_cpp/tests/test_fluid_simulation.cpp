@@ -0,0 +1,197 @@
+#include "game/FluidSimulation.h"
+#include "platform/JobSystem.h"
+#include "TestFramework.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace SwordAndStone::Game;
+using namespace SwordAndStone::Platform;
+
+namespace {
+
+// Stone floor at y = 0 over x, z in [0, 32); nothing is loaded beyond, which water treats as a wall
+void BuildFloor(VoxelSystem& voxels) {
+    for (int cx = 0; cx < 2; cx++) {
+        for (int cz = 0; cz < 2; cz++) {
+            for (int cy = 0; cy < 2; cy++) {
+                voxels.GetOrCreateChunk({ cx, cy, cz });
+            }
+        }
+    }
+    for (int x = 0; x < 32; x++) {
+        for (int z = 0; z < 32; z++) {
+            voxels.SetVoxel(x, 0, z, VoxelType::Stone);
+        }
+    }
+    voxels.Update(0.0f);
+}
+
+int RunUntilSettled(FluidSimulation& fluids, VoxelSystem& voxels, int maxTicks) {
+    int ticks = 0;
+    while (fluids.GetAwakeChunkCount() > 0 && ticks < maxTicks) {
+        fluids.Tick(voxels);
+        ticks++;
+    }
+    return ticks;
+}
+
+int TotalWater(const FluidSimulation& fluids, const VoxelSystem& voxels, int yEnd) {
+    int total = 0;
+    for (int y = 1; y < yEnd; y++) {
+        for (int z = 0; z < 32; z++) {
+            for (int x = 0; x < 32; x++) {
+                total += fluids.GetLevel(voxels, x, y, z);
+            }
+        }
+    }
+    return total;
+}
+
+} // namespace
+
+// Test pouring, levelling, sleeping, reloading, flow out of a dug lake, thread-count independence and idle cost
+void test_fluid_simulation() {
+    std::cout << "Testing Fluid Simulation..." << std::endl;
+
+    JobSystem jobs(3);
+
+    // Water poured into a walled basin falls, spreads out without losing volume and goes to sleep
+    VoxelSystem voxels;
+    BuildFloor(voxels);
+    for (int y = 1; y <= 3; y++) {
+        for (int i = 1; i <= 7; i++) {
+            voxels.SetVoxel(i, y, 1, VoxelType::Stone);
+            voxels.SetVoxel(i, y, 7, VoxelType::Stone);
+            voxels.SetVoxel(1, y, i, VoxelType::Stone);
+            voxels.SetVoxel(7, y, i, VoxelType::Stone);
+        }
+    }
+    FluidSimulation fluids(&jobs);
+    fluids.SetWater(voxels, 4, 3, 4, FluidSimulation::MAX_LEVEL);
+    TEST_CHECK(voxels.GetVoxel(4, 3, 4) == VoxelType::Water && fluids.GetAwakeChunkCount() == 1);
+    int ticks = RunUntilSettled(fluids, voxels, 200);
+    TEST_CHECK(ticks < 200 && fluids.GetAwakeChunkCount() == 0);
+    TEST_CHECK(TotalWater(fluids, voxels, 8) == FluidSimulation::MAX_LEVEL);
+    TEST_CHECK(fluids.GetLevel(voxels, 4, 3, 4) == 0 && voxels.GetVoxel(4, 3, 4) == VoxelType::Air);
+    bool level = true;
+    bool matchesVoxels = true;
+    for (int z = 2; z < 7; z++) {
+        for (int x = 2; x < 7; x++) {
+            const int here = fluids.GetLevel(voxels, x, 1, z);
+            if (x < 6) level = level && std::abs(here - fluids.GetLevel(voxels, x + 1, 1, z)) <= 1;
+            if (z < 6) level = level && std::abs(here - fluids.GetLevel(voxels, x, 1, z + 1)) <= 1;
+            matchesVoxels = matchesVoxels && (voxels.GetVoxel(x, 1, z) == VoxelType::Water) == (here > 0);
+        }
+    }
+    TEST_CHECK(level && matchesVoxels);
+    TEST_CHECK(fluids.Tick(voxels) == 0);
+
+    // Unloading and reloading the chunk keeps the pour finite instead of turning it into sources
+    const int puddle = fluids.GetLevel(voxels, 4, 1, 4);
+    fluids.RemoveChunk({ 0, 0, 0 });
+    fluids.Wake(voxels, 4, 1, 4);
+    TEST_CHECK(fluids.GetLevel(voxels, 4, 1, 4) == puddle && puddle < FluidSimulation::MAX_LEVEL);
+    RunUntilSettled(fluids, voxels, 200);
+    TEST_CHECK(fluids.GetAwakeChunkCount() == 0 && TotalWater(fluids, voxels, 8) == FluidSimulation::MAX_LEVEL);
+
+    // A static lake has no level layer until its rim is dug out; then it feeds a channel that
+    // runs downhill from it one level per cell, and the lake itself never drains
+    for (int x = 15; x <= 24; x++) {
+        for (int z = 15; z <= 24; z++) {
+            const bool rim = x == 15 || x == 24 || z == 15 || z == 24;
+            voxels.SetVoxel(x, 1, z, rim ? VoxelType::Stone : VoxelType::Water);
+        }
+    }
+    for (int x = 25; x < 32; x++) {
+        voxels.SetVoxel(x, 1, 19, VoxelType::Stone);
+        voxels.SetVoxel(x, 1, 21, VoxelType::Stone);
+    }
+    voxels.Update(0.0f);
+    TEST_CHECK(fluids.GetLevel(voxels, 20, 1, 20) == FluidSimulation::MAX_LEVEL);
+    voxels.SetVoxel(24, 1, 20, VoxelType::Air);
+    fluids.Wake(voxels, 24, 1, 20);
+    RunUntilSettled(fluids, voxels, 200);
+    TEST_CHECK(fluids.GetAwakeChunkCount() == 0);
+    bool channel = true;
+    for (int x = 24; x < 32; x++) {
+        const int expected = FluidSimulation::MAX_LEVEL - (x - 23);
+        channel = channel && fluids.GetLevel(voxels, x, 1, 20) == expected;
+        channel = channel && (voxels.GetVoxel(x, 1, 20) == VoxelType::Water) == (expected > 0);
+    }
+    TEST_CHECK(channel);
+    TEST_CHECK(fluids.GetLevel(voxels, 23, 1, 20) == FluidSimulation::MAX_LEVEL);
+    TEST_CHECK(fluids.GetLevel(voxels, 20, 1, 20) == FluidSimulation::MAX_LEVEL);
+
+    // Damming the channel leaves the water beyond the dam to settle on its own
+    voxels.SetVoxel(26, 1, 20, VoxelType::Stone);
+    fluids.Wake(voxels, 26, 1, 20);
+    RunUntilSettled(fluids, voxels, 200);
+    TEST_CHECK(fluids.GetLevel(voxels, 26, 1, 20) == 0 && voxels.GetVoxel(26, 1, 20) == VoxelType::Stone);
+    TEST_CHECK(fluids.GetLevel(voxels, 25, 1, 20) == FluidSimulation::MAX_LEVEL - 2);
+
+    // Flow across chunk boundaries gives the same result on any number of threads, and conserves water
+    VoxelSystem serialVoxels;
+    VoxelSystem parallelVoxels;
+    BuildFloor(serialVoxels);
+    BuildFloor(parallelVoxels);
+    JobSystem oneThread(1);
+    FluidSimulation serial(&oneThread);
+    FluidSimulation parallel(&jobs);
+    for (int x = 12; x < 20; x++) {
+        for (int z = 12; z < 20; z++) {
+            serial.SetWater(serialVoxels, x, 8 + (x + z) % 3, z, 5);
+            parallel.SetWater(parallelVoxels, x, 8 + (x + z) % 3, z, 5);
+        }
+    }
+    const int poured = 64 * 5;
+    bool same = true;
+    int cellVisits = 0;
+    std::chrono::duration<double, std::nano> flowTime(0.0);
+    for (int tick = 0; tick < 60; tick++) {
+        serial.Tick(serialVoxels);
+        auto tickStart = std::chrono::high_resolution_clock::now();
+        cellVisits += parallel.Tick(parallelVoxels);
+        flowTime += std::chrono::high_resolution_clock::now() - tickStart;
+        if (tick % 10 != 0) continue;
+        for (int y = 0; y < 12 && same; y++) {
+            for (int z = 0; z < 32; z++) {
+                for (int x = 0; x < 32; x++) {
+                    same = same && serial.GetLevel(serialVoxels, x, y, z) == parallel.GetLevel(parallelVoxels, x, y, z);
+                }
+            }
+        }
+    }
+    TEST_CHECK(same);
+    RunUntilSettled(parallel, parallelVoxels, 500);
+    TEST_CHECK(parallel.GetAwakeChunkCount() == 0 && TotalWater(parallel, parallelVoxels, 16) == poured);
+    std::cout << "  flow: " << cellVisits << " cell updates, "
+              << flowTime.count() / cellVisits << " ns per update" << std::endl;
+
+    // Once settled, an ocean costs nothing per tick however much water it holds
+    VoxelSystem ocean;
+    for (int cx = -4; cx < 4; cx++) {
+        for (int cz = -4; cz < 4; cz++) {
+            ocean.GetOrCreateChunk({ cx, -1, cz }).Fill(VoxelType::Stone);
+            ocean.GetOrCreateChunk({ cx, 0, cz }).Fill(VoxelType::Water);
+        }
+    }
+    ocean.Update(0.0f);
+    FluidSimulation tide(&jobs);
+    ocean.SetVoxel(0, 15, 0, VoxelType::Air);
+    tide.Wake(ocean, 0, 15, 0);
+    RunUntilSettled(tide, ocean, 50);
+    TEST_CHECK(tide.GetAwakeChunkCount() == 0 && ocean.GetVoxel(0, 15, 0) == VoxelType::Water);
+    const int idleTicks = 1000;
+    auto start = std::chrono::high_resolution_clock::now();
+    uint32_t idleVisits = 0;
+    for (int i = 0; i < idleTicks; i++) {
+        idleVisits += tide.Tick(ocean);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    TEST_CHECK(idleVisits == 0);
+    std::cout << "  settled ocean (" << 64 * CHUNK_VOLUME << " water voxels): "
+              << std::chrono::duration<double, std::nano>(end - start).count() / idleTicks << " ns per tick" << std::endl;
+
+    std::cout << "Fluid Simulation test passed!" << std::endl;
+}
@@ -0,0 +1,208 @@
+#include "platform/LinearArena.h"
+#include "platform/JobSystem.h"
+#include "game/ChunkVisibility.h"
+#include "renderer/CommandListRecorder.h"
+#include "renderer/NullRenderer.h"
+#include "TestFramework.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+using namespace SwordAndStone::Platform;
+using namespace SwordAndStone::Game;
+using namespace SwordAndStone::Renderer;
+using SwordAndStone::Tests::BuildViewProjection;
+
+namespace {
+
+uint64_t TotalAllocations() {
+    MemorySnapshot snapshot = MemoryTracker::GetSnapshot();
+    uint64_t total = 0;
+    for (const MemoryTagStats& stats : snapshot.tags) {
+        total += stats.totalAllocations;
+    }
+    return total;
+}
+
+// One frame of the hot paths: a voxel edit and chunk refresh, culling, and parallel command recording
+struct FrameWorkload {
+    VoxelSystem voxels;
+    ChunkVisibility visibility;
+    JobSystem jobs{ 3 };
+    CommandListRecorder recorder{ &jobs };
+    NullRenderer renderer;
+    FrameArena frameArena{ 4096 };
+    OcclusionCuller culler;
+    Frustum frustum;
+    float viewProjection[16];
+    float eye[3] = { 8.0f, 2.0f * CHUNK_SIZE + 10.0f, 8.0f };
+    uint32_t frame = 0;
+    size_t usedBytes = 0;
+
+    FrameWorkload() {
+        for (int cx = -4; cx <= 4; cx++) {
+            for (int cz = -4; cz <= 4; cz++) {
+                voxels.GetOrCreateChunk({ cx, 0, cz }).Fill(VoxelType::Stone);
+                Chunk& surface = voxels.GetOrCreateChunk({ cx, 1, cz });
+                for (int z = 0; z < CHUNK_SIZE; z++) {
+                    for (int x = 0; x < CHUNK_SIZE; x++) {
+                        surface.Set(x, 0, z, VoxelType::Grass);
+                    }
+                }
+            }
+        }
+        voxels.Update(0.0f);
+        visibility.SetOcclusionCuller(&culler);
+        visibility.SetFrameArena(&frameArena);
+        recorder.SetFrameArena(&frameArena);
+        const float target[3] = { 100.0f, CHUNK_SIZE - 10.0f, 20.0f };
+        BuildViewProjection(eye, target, viewProjection);
+        frustum = Frustum::FromMatrix(viewProjection);
+    }
+
+    void Run() {
+        frameArena.BeginFrame();
+        float* transforms = frameArena.AllocateArray<float>(16 * 64);
+        transforms[0] = static_cast<float>(frame);
+
+        voxels.SetVoxel(3, CHUNK_SIZE + 1, 3, frame % 2 ? VoxelType::Stone : VoxelType::Air);
+        voxels.Update(0.0f);
+        culler.BeginFrame(viewProjection);
+        visibility.Update(voxels, eye, frustum);
+
+        const std::vector<ChunkCoord>& visible = visibility.GetVisibleChunks();
+        recorder.AddParallelPass(static_cast<uint32_t>(visible.size()), 16,
+                                 [&visible](CommandBuffer& list, uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                uint32_t texture = static_cast<uint32_t>(visible[i].x & 3);
+                list.DrawIndexed(SortKey::Make(1, 1, texture, i), 1, texture, 1, 2, 36);
+            }
+        });
+        recorder.AddPass([this](CommandBuffer& list) {
+            list.Draw(SortKey::Make(2, 2, 0, 0), 2, 0, 1, 6, StateBlending);
+        });
+        recorder.Record();
+
+        renderer.BeginFrame();
+        recorder.Submit(renderer);
+        renderer.EndFrame();
+        usedBytes = frameArena.GetArena().GetUsedBytes();
+        frame++;
+    }
+};
+
+} // namespace
+
+// Test linear, frame and scratch arenas, and that steady-state frames do not touch the heap
+void test_frame_allocator() {
+    std::cout << "Testing Frame Allocator..." << std::endl;
+
+    // Bump allocation, alignment and markers
+    uint64_t scratchBlocks = MemoryTracker::GetSnapshot()[MemoryTag::Scratch].totalAllocations;
+    LinearArena arena(256);
+    uint8_t* a = static_cast<uint8_t*>(arena.Allocate(3, 1));
+    double* b = arena.AllocateArray<double>(2);
+    TEST_CHECK(a && reinterpret_cast<uintptr_t>(b) % alignof(double) == 0);
+    TEST_CHECK(reinterpret_cast<uint8_t*>(b) - a < 16);
+    void* aligned = arena.Allocate(8, 128);
+    TEST_CHECK(reinterpret_cast<uintptr_t>(aligned) % 128 == 0);
+
+    LinearArena::Marker marker = arena.GetMarker();
+    void* first = arena.Allocate(32);
+    arena.Rewind(marker);
+    TEST_CHECK(arena.Allocate(32) == first);
+
+    // Overflow chains blocks; Reset merges them so the same cycle then fits one block with no new allocations
+    for (int i = 0; i < 3; i++) {
+        arena.Allocate(200);
+    }
+    TEST_CHECK(arena.GetBlockCount() > 1);
+    size_t capacity = arena.GetCapacity();
+    arena.Reset();
+    TEST_CHECK(arena.GetBlockCount() == 1 && arena.GetCapacity() == capacity && arena.GetUsedBytes() == 0);
+    uint64_t afterMerge = MemoryTracker::GetSnapshot()[MemoryTag::Scratch].totalAllocations;
+    TEST_CHECK(afterMerge > scratchBlocks);
+    for (int cycle = 0; cycle < 3; cycle++) {
+        for (int i = 0; i < 3; i++) {
+            arena.Allocate(200);
+        }
+        arena.Reset();
+    }
+    TEST_CHECK(MemoryTracker::GetSnapshot()[MemoryTag::Scratch].totalAllocations == afterMerge);
+    TEST_CHECK(arena.GetBlockCount() == 1);
+
+    // Frame memory survives the next frame and is recycled the one after
+    FrameArena frameArena(1024);
+    frameArena.BeginFrame();
+    char* message = frameArena.AllocateArray<char>(6);
+    std::memcpy(message, "frame", 6);
+    frameArena.BeginFrame();
+    char* other = frameArena.AllocateArray<char>(6);
+    TEST_CHECK(other != message && std::strcmp(message, "frame") == 0);
+    frameArena.BeginFrame();
+    TEST_CHECK(frameArena.AllocateArray<char>(6) == message);
+    TEST_CHECK(frameArena.GetFrame() == 3);
+
+    // Scratch scopes nest and rewind on exit
+    void* outerFirst;
+    {
+        ScratchScope outer;
+        outerFirst = outer.Allocate(64);
+        void* innerFirst;
+        {
+            ScratchScope inner;
+            innerFirst = inner.Allocate(64);
+            TEST_CHECK(innerFirst != outerFirst);
+        }
+        ScratchScope again;
+        TEST_CHECK(again.Allocate(64) == innerFirst);
+
+        // STL containers on the scratch stack
+        ArenaVector<int> values{ ArenaAllocator<int>(outer.GetArena()) };
+        for (int i = 0; i < 1000; i++) {
+            values.push_back(i);
+        }
+        TEST_CHECK(values.size() == 1000 && values[999] == 999);
+    }
+    {
+        ScratchScope scope;
+        TEST_CHECK(scope.Allocate(64) == outerFirst);
+    }
+
+    if (MemoryTracker::IsTrackingGlobalNew()) {
+        FrameWorkload workload;
+        for (int i = 0; i < 8; i++) {
+            workload.Run();
+        }
+        TEST_CHECK(workload.visibility.GetStats().visible > 0);
+        TEST_CHECK(workload.recorder.GetStats().drawCalls > 0);
+        // Culling scratch and the submitted list array come from the frame arena
+        TEST_CHECK(workload.visibility.GetStats().occluders > 0);
+        const size_t boundsBytes = workload.visibility.GetStats().visible * 6 * sizeof(float);
+        TEST_CHECK(workload.usedBytes > 16 * 64 * sizeof(float) + boundsBytes);
+
+        uint64_t before = TotalAllocations();
+        for (int i = 0; i < 32; i++) {
+            workload.Run();
+        }
+        uint64_t steady = TotalAllocations() - before;
+        std::cout << "  steady-state heap allocations over 32 frames: " << steady << std::endl;
+        TEST_CHECK(steady == 0);
+    }
+
+    // Cost of a bump allocation against a tracked new/delete pair
+    const int iterations = 1000000;
+    LinearArena bench(iterations * 16);
+    auto start = std::chrono::high_resolution_clock::now();
+    uintptr_t sum = 0;
+    for (int i = 0; i < iterations; i++) {
+        sum += reinterpret_cast<uintptr_t>(bench.Allocate(16, 16));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    TEST_CHECK(sum != 0);
+    std::cout << "  arena allocation: "
+              << std::chrono::duration<double, std::nano>(end - start).count() / iterations << " ns" << std::endl;
+
+    std::cout << "Frame Allocator test passed!" << std::endl;
+}
@@ -0,0 +1,146 @@
+#include "renderer/GeometryArena.h"
+#include "renderer/CommandBuffer.h"
+#include "renderer/NullRenderer.h"
+#include "TestFramework.h"
+#include <iostream>
+
+using namespace SwordAndStone::Renderer;
+
+namespace {
+
+// Uploads a mesh whose vertices all carry the mesh id in position[0]
+void UploadMesh(GeometryArena& arena, uint32_t handle, uint32_t id) {
+    const GeometryRange* range = arena.GetRange(handle);
+    std::vector<Vertex> vertices(range->vertexCount, Vertex());
+    std::vector<uint32_t> indices(range->indexCount);
+    for (Vertex& vertex : vertices) {
+        vertex.position[0] = static_cast<float>(id);
+    }
+    for (uint32_t i = 0; i < range->indexCount; i++) {
+        indices[i] = i % range->vertexCount;
+    }
+    arena.Upload(handle, vertices.data(), indices.data());
+}
+
+bool MeshIntact(const NullRenderer& renderer, const GeometryArena& arena, uint32_t handle, uint32_t id) {
+    const GeometryRange* range = arena.GetRange(handle);
+    const Vertex* vertices = reinterpret_cast<const Vertex*>(renderer.GetBufferData(arena.GetVertexBuffer())->data());
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>(renderer.GetBufferData(arena.GetIndexBuffer())->data());
+    for (uint32_t i = 0; i < range->vertexCount; i++) {
+        if (vertices[range->vertexOffset + i].position[0] != static_cast<float>(id)) return false;
+    }
+    for (uint32_t i = 0; i < range->indexCount; i++) {
+        if (indices[range->indexOffset + i] != i % range->vertexCount) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// Test range suballocation, arena growth, defragmentation and multi-draw batching
+void test_geometry_arena() {
+    std::cout << "Testing Geometry Arena..." << std::endl;
+
+    RangeAllocator ranges(100);
+    uint32_t a = ranges.Allocate(10);
+    uint32_t b = ranges.Allocate(20);
+    uint32_t c = ranges.Allocate(30);
+    TEST_CHECK(a == 0 && b == 10 && c == 30);
+    ranges.Free(b, 20);
+    TEST_CHECK(ranges.Allocate(15) == 10);  // best fit picks the 20-unit hole over the 40-unit tail
+    ranges.Free(10, 15);
+    ranges.Free(a, 10);
+    TEST_CHECK(ranges.GetFreeRangeCount() == 2);
+    ranges.Free(c, 30);
+    TEST_CHECK(ranges.GetFreeRangeCount() == 1 && ranges.GetLargestFreeRange() == 100);
+    TEST_CHECK(ranges.Allocate(101) == RangeAllocator::INVALID_OFFSET);
+
+    NullRenderer renderer;
+    renderer.Initialize(nullptr, 1280, 720);
+    renderer.SetStreamingCapacity(1 << 20);
+
+    // The null backend refuses the copies GPUs refuse, so the arena is checked against real usage rules
+    const uint32_t marker = 0xABCD1234u;
+    uint32_t dynamicBuffer = renderer.CreateVertexBuffer(nullptr, 64, BufferUsage::Dynamic);
+    uint32_t staticBuffer = renderer.CreateVertexBuffer(&marker, sizeof(marker), BufferUsage::Static);
+    renderer.CopyBuffer(staticBuffer, 0, dynamicBuffer, 0, sizeof(marker));
+    TEST_CHECK((*renderer.GetBufferData(dynamicBuffer))[0] == 0);
+    renderer.DeleteBuffer(dynamicBuffer);
+    renderer.DeleteBuffer(staticBuffer);
+
+    // Render distance 8: 17 x 17 chunk columns, 16 chunks high
+    const uint32_t chunkCount = 17 * 17 * 16;
+    GeometryArena arena;
+    TEST_CHECK(arena.Initialize(&renderer, 1 << 16, 1 << 16));
+
+    std::vector<uint32_t> handles(chunkCount);
+    for (uint32_t i = 0; i < chunkCount; i++) {
+        uint32_t faces = 4 + (i * 7) % 60;
+        handles[i] = arena.Allocate(faces * 4, faces * 6);
+        UploadMesh(arena, handles[i], i);
+    }
+    TEST_CHECK(arena.GetAllocationCount() == chunkCount);
+    TEST_CHECK(MeshIntact(renderer, arena, handles[0], 0));  // survived every buffer growth
+    TEST_CHECK(MeshIntact(renderer, arena, handles[chunkCount - 1], chunkCount - 1));
+
+    // Unload every other chunk, then compact
+    for (uint32_t i = 0; i < chunkCount; i += 2) {
+        arena.Free(handles[i]);
+        handles[i] = GeometryArena::INVALID_HANDLE;
+    }
+    float fragmented = arena.GetFragmentation();
+    uint32_t moved = arena.Defragment(chunkCount);
+    TEST_CHECK(moved > 0);
+    TEST_CHECK(arena.GetFragmentation() < fragmented);
+    bool intact = true;
+    for (uint32_t i = 1; i < chunkCount; i += 2) {
+        intact = intact && MeshIntact(renderer, arena, handles[i], i);
+    }
+    TEST_CHECK(intact);
+
+    // Meshes written by jobs into streaming memory land in their range next to the compacted ones
+    renderer.BeginFrame();
+    uint32_t streamed = arena.Allocate(8, 12);
+    StreamingAllocation streamedVertices = renderer.AllocateStreaming(8 * sizeof(Vertex), sizeof(Vertex));
+    StreamingAllocation streamedIndices = renderer.AllocateStreaming(12 * sizeof(uint32_t), sizeof(uint32_t));
+    for (uint32_t i = 0; i < 8; i++) {
+        static_cast<Vertex*>(streamedVertices.data)[i] = Vertex();
+        static_cast<Vertex*>(streamedVertices.data)[i].position[0] = 99999.0f;
+    }
+    for (uint32_t i = 0; i < 12; i++) {
+        static_cast<uint32_t*>(streamedIndices.data)[i] = i % 8;
+    }
+    arena.Upload(streamed, streamedVertices, streamedIndices);
+    renderer.EndFrame();
+    TEST_CHECK(MeshIntact(renderer, arena, streamed, 99999));
+    TEST_CHECK(MeshIntact(renderer, arena, handles[1], 1));
+    TEST_CHECK(MeshIntact(renderer, arena, handles[chunkCount - 1], chunkCount - 1));
+    arena.Free(streamed);
+
+    // Opaque and transparent passes each collapse to one multi-draw
+    std::vector<IndirectDrawCommand> opaque;
+    std::vector<IndirectDrawCommand> transparent;
+    uint32_t expectedTriangles = 0;
+    for (uint32_t i = 1; i < chunkCount; i += 2) {
+        IndirectDrawCommand command = arena.GetDrawCommand(handles[i]);
+        (i % 5 == 0 ? transparent : opaque).push_back(command);
+        expectedTriangles += command.indexCount / 3;
+    }
+
+    CommandBuffer commands;
+    commands.MultiDrawIndexed(SortKey::Make(0, 1, 1, 0), 1, 1, arena.GetVertexBuffer(), arena.GetIndexBuffer(),
+                              opaque.data(), static_cast<uint32_t>(opaque.size()));
+    commands.MultiDrawIndexed(SortKey::Make(1, 1, 1, 0), 1, 1, arena.GetVertexBuffer(), arena.GetIndexBuffer(),
+                              transparent.data(), static_cast<uint32_t>(transparent.size()),
+                              StateDepthTest | StateBlending);
+
+    renderer.BeginFrame();
+    commands.Execute(renderer);
+    renderer.EndFrame();
+
+    TEST_CHECK(renderer.GetStats().drawCalls == 2);
+    TEST_CHECK(renderer.GetStats().multiDrawCommands == chunkCount / 2);
+    TEST_CHECK(renderer.GetStats().triangles == expectedTriangles);
+
+    std::cout << "Geometry Arena test passed!" << std::endl;
+}
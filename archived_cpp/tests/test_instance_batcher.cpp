@@ -0,0 +1,129 @@
+#include "game/InstanceBatcher.h"
+#include "renderer/NullRenderer.h"
+#include "renderer/SoftwareRenderer.h"
+#include "TestFramework.h"
+#include <iostream>
+
+using namespace SwordAndStone::Renderer;
+using SwordAndStone::Game::InstanceBatcher;
+
+namespace {
+
+// Unit quad around the origin in the z = 0 plane, counter-clockwise, white
+void MakeQuad(float halfSize, Vertex vertices[4], uint32_t indices[6]) {
+    const float corners[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+    for (int i = 0; i < 4; i++) {
+        vertices[i] = Vertex{};
+        vertices[i].position[0] = corners[i][0] * halfSize;
+        vertices[i].position[1] = corners[i][1] * halfSize;
+        for (float& channel : vertices[i].color) channel = 1.0f;
+    }
+    const uint32_t quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int i = 0; i < 6; i++) indices[i] = quadIndices[i];
+}
+
+uint32_t PixelAt(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t x, uint32_t y) {
+    const uint8_t* p = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
+
+} // namespace
+
+// Test instanced draws on the headless backends and per-mesh instance batching
+void test_instance_batcher() {
+    std::cout << "Testing Instance Batcher..." << std::endl;
+
+    Vertex quad[4];
+    uint32_t quadIndices[6];
+    MakeQuad(0.1f, quad, quadIndices);
+
+    // Thousands of dropped items and arrows collapse into one draw per mesh type
+    NullRenderer null;
+    null.Initialize(nullptr, 640, 480);
+    uint32_t itemVb = null.CreateVertexBuffer(quad, sizeof(quad), BufferUsage::Static);
+    uint32_t itemIb = null.CreateIndexBuffer(quadIndices, 6, BufferUsage::Static);
+    uint32_t arrowVb = null.CreateVertexBuffer(quad, sizeof(quad), BufferUsage::Static);
+    uint32_t arrowIb = null.CreateIndexBuffer(quadIndices, 6, BufferUsage::Static);
+    uint32_t shader = null.CreateShader("vs", "fs");
+
+    InstanceBatcher batcher;
+    uint32_t item = batcher.RegisterMesh(itemVb, itemIb, 6, shader, 0);
+    uint32_t arrow = batcher.RegisterMesh(arrowVb, arrowIb, 6, shader, 0);
+    uint32_t unused = batcher.RegisterMesh(itemVb, itemIb, 6, shader, 0);
+    TEST_CHECK(batcher.GetMeshCount() == 3);
+
+    const uint32_t itemCount = 3000;
+    const uint32_t arrowCount = 1500;
+    batcher.Begin();
+    for (uint32_t i = 0; i < itemCount + arrowCount; i++) {
+        float position[3] = { static_cast<float>(i % 64), 0.0f, static_cast<float>(i / 64) };
+        batcher.Add(i < itemCount ? item : arrow, position, 0.1f * i, 0.5f);
+    }
+    batcher.Add(InstanceBatcher::INVALID_MESH, InstanceData{});
+    TEST_CHECK(batcher.GetInstanceCount(item) == itemCount && batcher.GetInstanceCount(arrow) == arrowCount);
+    TEST_CHECK(batcher.GetInstanceCount(unused) == 0);
+    TEST_CHECK(batcher.GetTotalInstanceCount() == itemCount + arrowCount);
+
+    CommandBuffer commands;
+    null.BeginFrame();
+    null.ResetStats();
+    TEST_CHECK(batcher.Flush(null, commands) == 2);
+    TEST_CHECK(commands.GetCommandCount() == 2);
+    commands.Execute(null);
+    null.EndFrame();
+    TEST_CHECK(null.GetStats().drawCalls == 2);
+    TEST_CHECK(null.GetStats().instancesDrawn == itemCount + arrowCount);
+    TEST_CHECK(null.GetStats().triangles == (itemCount + arrowCount) * 2);
+    TEST_CHECK(commands.GetStats().drawCalls == 2);
+
+    // A full streaming ring falls back to the mesh's own instance buffer
+    null.SetStreamingCapacity(1024);
+    size_t buffersBefore = null.GetBufferCount();
+    null.BeginFrame();
+    null.ResetStats();
+    TEST_CHECK(batcher.Flush(null, commands) == 2);
+    commands.Execute(null);
+    null.EndFrame();
+    TEST_CHECK(null.GetBufferCount() == buffersBefore + 2);
+    TEST_CHECK(null.GetStats().instancesDrawn == itemCount + arrowCount);
+    batcher.Release(null);
+    TEST_CHECK(null.GetBufferCount() == buffersBefore);
+
+    batcher.Begin();
+    TEST_CHECK(batcher.GetTotalInstanceCount() == 0);
+    TEST_CHECK(batcher.Flush(null, commands) == 0 && commands.GetCommandCount() == 0);
+
+    // Software: each instance is moved by its transform and tinted by its color
+    SoftwareRenderer software;
+    TEST_CHECK(software.Initialize(nullptr, 200, 200));
+    uint32_t softwareVb = software.CreateVertexBuffer(quad, sizeof(quad), BufferUsage::Static);
+    uint32_t softwareIb = software.CreateIndexBuffer(quadIndices, 6, BufferUsage::Static);
+
+    InstanceBatcher tiles;
+    uint32_t tile = tiles.RegisterMesh(softwareVb, softwareIb, 6, 0, 0);
+    const float red[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+    const float blue[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+    const float left[3] = { -0.5f, 0.0f, 0.0f };
+    const float right[3] = { 0.5f, 0.0f, 0.0f };
+    tiles.Begin();
+    tiles.Add(tile, left, 0.0f, 1.0f, red);
+    tiles.Add(tile, right, 0.0f, 2.0f, blue);
+
+    software.BeginFrame();
+    software.Clear(ClearColor | ClearDepth, 0.0f, 0.0f, 0.0f, 1.0f);
+    TEST_CHECK(tiles.Flush(software, commands) == 1);
+    commands.Execute(software);
+    software.EndFrame();
+
+    std::vector<uint8_t> pixels;
+    software.ReadPixels(pixels);
+    TEST_CHECK(PixelAt(pixels, 200, 50, 100) == 0xFF0000FFu);   // red instance at x = -0.5
+    TEST_CHECK(PixelAt(pixels, 200, 150, 100) == 0xFFFF0000u);  // blue instance at x = +0.5
+    TEST_CHECK(PixelAt(pixels, 200, 165, 100) == 0xFFFF0000u);  // twice the size
+    TEST_CHECK(PixelAt(pixels, 200, 70, 100) == 0xFF000000u);   // outside the unscaled instance
+    TEST_CHECK(PixelAt(pixels, 200, 100, 100) == 0xFF000000u);
+    TEST_CHECK(software.GetStats().drawCalls == 1 && software.GetStats().instancesDrawn == 2);
+    TEST_CHECK(software.GetStats().triangles == 4);
+
+    std::cout << "Instance Batcher test passed!" << std::endl;
+}
@@ -1,10 +1,70 @@
+#include "TestFramework.h"
 #include <iostream>
 
+void test_renderer_factory();
+void test_null_renderer();
+void test_software_renderer();
+void test_command_buffer();
+void test_command_list_recorder();
+void test_streaming_buffer();
+void test_geometry_arena();
+void test_vertex_array_cache();
+void test_chunk_visibility();
+void test_occlusion_culler();
+void test_texture_atlas();
+void test_block_compression();
+void test_uniform_block();
+void test_instance_batcher();
+void test_tile_renderer();
+void test_tile_world_streamer();
+void test_profiler();
+void test_memory_tracker();
+void test_frame_allocator();
+void test_input_manager();
+void test_entity_registry();
+void test_spatial_grid();
+void test_voxel_raycast();
+void test_character_controller();
+void test_falling_blocks();
+void test_fluid_simulation();
+
 // Simple test framework
 int main(int argc, char** argv) {
     std::cout << "Running Sword And Stone Tests..." << std::endl;
     
-    // TODO: Add actual tests
+    test_renderer_factory();
+    test_null_renderer();
+    test_software_renderer();
+    test_command_buffer();
+    test_command_list_recorder();
+    test_streaming_buffer();
+    test_geometry_arena();
+    test_vertex_array_cache();
+    test_chunk_visibility();
+    test_occlusion_culler();
+    test_texture_atlas();
+    test_block_compression();
+    test_uniform_block();
+    test_instance_batcher();
+    test_tile_renderer();
+    test_tile_world_streamer();
+    test_profiler();
+    test_memory_tracker();
+    test_frame_allocator();
+    test_input_manager();
+    test_entity_registry();
+    test_spatial_grid();
+    test_voxel_raycast();
+    test_character_controller();
+    test_falling_blocks();
+    test_fluid_simulation();
+    
+    int failures = SwordAndStone::Tests::FailureCount();
+    if (failures > 0) {
+        std::cout << failures << " check(s) failed!" << std::endl;
+        return 1;
+    }
+    
     std::cout << "All tests passed!" << std::endl;
     
     return 0;
@@ -0,0 +1,114 @@
+#include "platform/MemoryTracker.h"
+#include "game/VoxelSystem.h"
+#include "TestFramework.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace SwordAndStone::Platform;
+using namespace SwordAndStone::Game;
+
+namespace {
+
+struct alignas(64) CacheLine {
+    uint8_t bytes[64];
+};
+
+uint64_t LiveBytes(MemoryTag tag) {
+    return MemoryTracker::GetSnapshot()[tag].liveBytes;
+}
+
+} // namespace
+
+// Test per-tag accounting of global and explicitly tagged allocations
+void test_memory_tracker() {
+    std::cout << "Testing Memory Tracker..." << std::endl;
+
+    // Size buckets
+    TEST_CHECK(MemoryTracker::GetHistogramBucket(1) == 0 && MemoryTracker::GetHistogramBucket(16) == 0);
+    TEST_CHECK(MemoryTracker::GetHistogramBucket(17) == 1 && MemoryTracker::GetHistogramBucket(4096) == 8);
+    TEST_CHECK(MemoryTracker::GetHistogramBucket(size_t(1) << 40) == MEMORY_HISTOGRAM_BUCKETS - 1);
+    TEST_CHECK(std::string(MemoryTracker::GetTagName(MemoryTag::RenderResources)) == "RenderResources");
+
+    // Explicit tags ignore the thread's current tag; live, peak and histogram follow the allocation
+    MemorySnapshot before = MemoryTracker::GetSnapshot();
+    {
+        std::vector<uint32_t, TaggedAllocator<uint32_t, MemoryTag::Meshes>> indices;
+        indices.reserve(1000);
+        TEST_CHECK(LiveBytes(MemoryTag::Meshes) == before[MemoryTag::Meshes].liveBytes + 4000);
+        MemorySnapshot during = MemoryTracker::GetSnapshot();
+        TEST_CHECK(during[MemoryTag::Meshes].totalAllocations == before[MemoryTag::Meshes].totalAllocations + 1);
+        TEST_CHECK(during[MemoryTag::Meshes].histogram[8] == before[MemoryTag::Meshes].histogram[8] + 1);
+        TEST_CHECK(during[MemoryTag::Meshes].peakBytes >= during[MemoryTag::Meshes].liveBytes);
+    }
+    TEST_CHECK(LiveBytes(MemoryTag::Meshes) == before[MemoryTag::Meshes].liveBytes);
+
+    void* aligned = MemoryTracker::Allocate(100, MemoryTag::Textures, 256);
+    TEST_CHECK(aligned && reinterpret_cast<uintptr_t>(aligned) % 256 == 0);
+    TEST_CHECK(LiveBytes(MemoryTag::Textures) == before[MemoryTag::Textures].liveBytes + 100);
+    MemoryTracker::Free(aligned);
+    TEST_CHECK(LiveBytes(MemoryTag::Textures) == before[MemoryTag::Textures].liveBytes);
+
+    // Peaks survive frees until reset
+    MemoryTracker::ResetPeaks();
+    void* large = MemoryTracker::Allocate(1 << 20, MemoryTag::Entities);
+    MemoryTracker::Free(large);
+    MemorySnapshot afterLarge = MemoryTracker::GetSnapshot();
+    TEST_CHECK(afterLarge[MemoryTag::Entities].peakBytes >= afterLarge[MemoryTag::Entities].liveBytes + (1 << 20));
+    TEST_CHECK(afterLarge.peakBytes >= (1 << 20));
+    MemoryTracker::ResetPeaks();
+    TEST_CHECK(MemoryTracker::GetSnapshot()[MemoryTag::Entities].peakBytes ==
+               MemoryTracker::GetSnapshot()[MemoryTag::Entities].liveBytes);
+
+    if (MemoryTracker::IsTrackingGlobalNew()) {
+        // Plain new is charged to the scope's tag, and freed from another thread back to it
+        uint64_t voxels = LiveBytes(MemoryTag::Voxels);
+        std::unique_ptr<std::vector<uint8_t>> data;
+        {
+            MemoryTagScope scope(MemoryTag::Voxels);
+            data.reset(new std::vector<uint8_t>(5000));
+            TEST_CHECK(MemoryTracker::GetCurrentTag() == MemoryTag::Voxels);
+        }
+        TEST_CHECK(MemoryTracker::GetCurrentTag() == MemoryTag::Untagged);
+        TEST_CHECK(LiveBytes(MemoryTag::Voxels) == voxels + 5000 + sizeof(std::vector<uint8_t>));
+        std::thread([&data]() { data.reset(); }).join();
+        TEST_CHECK(LiveBytes(MemoryTag::Voxels) == voxels);
+
+        CacheLine* line;
+        {
+            MemoryTagScope scope(MemoryTag::Jobs);
+            line = new CacheLine();
+        }
+        TEST_CHECK(reinterpret_cast<uintptr_t>(line) % 64 == 0);
+        delete line;
+
+        // Subsystems tag their own allocations
+        VoxelSystem voxelSystem;
+        voxelSystem.GetOrCreateChunk({ 0, 0, 0 });
+        TEST_CHECK(LiveBytes(MemoryTag::Voxels) >= voxels + sizeof(Chunk));
+    }
+
+    std::ostringstream report;
+    MemoryTracker::Dump(report);
+    TEST_CHECK(report.str().find("Meshes") != std::string::npos);
+    TEST_CHECK(report.str().find("sizes:") != std::string::npos);
+
+    // Cost of a tracked new/delete pair
+    const int iterations = 1000000;
+    std::vector<int*> values(1000);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i += 1000) {
+        for (int j = 0; j < 1000; j++) values[j] = new int(j);
+        for (int j = 0; j < 1000; j++) delete values[j];
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  tracked new/delete: "
+              << std::chrono::duration<double, std::nano>(end - start).count() / iterations << " ns per pair"
+              << std::endl;
+
+    std::cout << "Memory Tracker test passed!" << std::endl;
+}
@@ -0,0 +1,110 @@
+#include "renderer/NullRenderer.h"
+#include "TestFramework.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace SwordAndStone::Renderer;
+
+// Test null backend recording, statistics and capture files
+void test_null_renderer() {
+    std::cout << "Testing Null Renderer..." << std::endl;
+
+    NullRenderer renderer;
+    TEST_CHECK(renderer.Initialize(nullptr, 1280, 720));
+
+    Vertex vertices[3] = {};
+    uint32_t indices[6] = { 0, 1, 2, 2, 1, 0 };
+    uint32_t vb = renderer.CreateVertexBuffer(vertices, sizeof(vertices), BufferUsage::Static);
+    uint32_t ib = renderer.CreateIndexBuffer(indices, 6, BufferUsage::Static);
+    uint32_t shader = renderer.CreateShader("vs", "fs");
+    TEST_CHECK(vb != 0 && ib != 0 && shader != 0);
+    TEST_CHECK(renderer.GetBufferCount() == 2);
+
+    const std::string capturePath = "null_renderer_capture.bin";
+    TEST_CHECK(renderer.BeginCapture(capturePath));
+
+    renderer.BeginFrame();
+    renderer.Clear(ClearColor | ClearDepth, 0.0f, 0.0f, 0.0f, 1.0f);
+    renderer.BindShader(shader);
+    renderer.BindShader(shader);
+    float mvp[16] = { 1.0f };
+    renderer.SetShaderUniform(shader, "u_mvp", mvp, sizeof(mvp));
+    renderer.SetBlending(true);
+    renderer.SetBlending(true);
+    renderer.DrawIndexed(vb, ib, 6, PrimitiveTopology::TriangleList);
+    renderer.Draw(vb, 3, PrimitiveTopology::TriangleList);
+    renderer.DrawIndexed(vb, 9999, 6, PrimitiveTopology::TriangleList);
+    renderer.EndFrame();
+
+    const RenderStats& stats = renderer.GetStats();
+    TEST_CHECK(stats.drawCalls == 2);
+    TEST_CHECK(stats.triangles == 3);
+    TEST_CHECK(stats.shaderSwitches == 1);
+    TEST_CHECK(stats.stateChanges == 2);
+    TEST_CHECK(stats.bytesUploaded == sizeof(mvp));
+    TEST_CHECK(renderer.GetFrameCommands().size() == 8);
+
+    const std::vector<uint8_t>* uniform = renderer.GetUniformData(shader, "u_mvp");
+    TEST_CHECK(uniform && uniform->size() == sizeof(mvp));
+
+    renderer.BeginFrame();
+    renderer.Draw(vb, 3, PrimitiveTopology::TriangleList);
+    renderer.EndFrame();
+    renderer.EndCapture();
+
+    std::vector<NullCapturedFrame> frames;
+    TEST_CHECK(NullRenderer::LoadCapture(capturePath, frames));
+    TEST_CHECK(frames.size() == 2);
+    if (frames.size() == 2) {
+        TEST_CHECK(frames[0].stats.drawCalls == 2);
+        TEST_CHECK(frames[0].commands.size() == 8);
+        TEST_CHECK(frames[0].commands[0].type == NullCommandType::Clear);
+        TEST_CHECK(frames[1].frameIndex == frames[0].frameIndex + 1);
+        TEST_CHECK(frames[1].commands.size() == 1);
+    }
+
+    // A truncated capture, or one claiming more commands than it holds, fails without allocating for them
+    {
+        std::vector<char> bytes;
+        if (FILE* file = std::fopen(capturePath.c_str(), "rb")) {
+            char buffer[4096];
+            size_t read;
+            while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) bytes.insert(bytes.end(), buffer, buffer + read);
+            std::fclose(file);
+        }
+        const size_t countOffset = 16 + sizeof(uint64_t) + sizeof(RenderStats);
+        TEST_CHECK(bytes.size() > countOffset + sizeof(uint32_t));
+        if (bytes.size() > countOffset + sizeof(uint32_t)) {
+            const std::string corruptPath = "null_renderer_corrupt.bin";
+            std::vector<char> corrupt = bytes;
+            const uint32_t hugeCount = 0xFFFFFFF0u;
+            memcpy(&corrupt[countOffset], &hugeCount, sizeof(hugeCount));
+            FILE* file = std::fopen(corruptPath.c_str(), "wb");
+            std::fwrite(corrupt.data(), 1, corrupt.size(), file);
+            std::fclose(file);
+            TEST_CHECK(!NullRenderer::LoadCapture(corruptPath, frames) && frames.empty());
+
+            file = std::fopen(corruptPath.c_str(), "wb");
+            std::fwrite(bytes.data(), 1, bytes.size() - 5, file);
+            std::fclose(file);
+            TEST_CHECK(!NullRenderer::LoadCapture(corruptPath, frames) && frames.empty());
+            std::remove(corruptPath.c_str());
+        }
+    }
+    std::remove(capturePath.c_str());
+
+    // Out-of-range updates are ignored rather than wrapping around
+    renderer.UpdateVertexBuffer(vb, vertices, sizeof(vertices), static_cast<size_t>(-8));
+    uint32_t texture = renderer.CreateTexture2D(4, 4, TextureFormat::RGBA8, nullptr);
+    uint8_t texels[64] = {};
+    renderer.UpdateTexture2D(texture, texels, 40);
+    renderer.UpdateTexture2D(texture, texels, 3);
+    renderer.DeleteTexture(texture);
+
+    renderer.DeleteBuffer(vb);
+    renderer.DeleteBuffer(ib);
+    TEST_CHECK(renderer.GetBufferCount() == 0);
+
+    std::cout << "Null Renderer test passed!" << std::endl;
+}
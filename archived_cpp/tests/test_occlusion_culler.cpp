@@ -0,0 +1,169 @@
+#include "game/ChunkVisibility.h"
+#include "renderer/CommandBuffer.h"
+#include "renderer/NullRenderer.h"
+#include "platform/JobSystem.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace SwordAndStone::Game;
+using SwordAndStone::Platform::JobSystem;
+using SwordAndStone::Renderer::CommandBuffer;
+using SwordAndStone::Renderer::Frustum;
+using SwordAndStone::Renderer::NullRenderer;
+using SwordAndStone::Renderer::OcclusionCuller;
+using SwordAndStone::Tests::BuildViewProjection;
+
+// Test HiZ rasterization, box tests and chunk occlusion culling
+void test_occlusion_culler() {
+    std::cout << "Testing Occlusion Culler..." << std::endl;
+
+    JobSystem jobs(2);
+    const float eye[3] = { 0.0f, 0.0f, 0.0f };
+    const float target[3] = { 0.0f, 0.0f, -1.0f };
+    float viewProjection[16];
+    BuildViewProjection(eye, target, viewProjection);
+
+    // A wall 20 units ahead, narrower than the view
+    OcclusionCuller culler(&jobs, 128, 64);
+    culler.BeginFrame(viewProjection);
+    const float wallMin[3] = { -10.0f, -6.0f, -22.0f };
+    const float wallMax[3] = { 10.0f, 6.0f, -20.0f };
+    culler.AddOccluder(wallMin, wallMax);
+    culler.RasterizeOccluders();
+    TEST_CHECK(culler.GetOccluderCount() == 1);
+    TEST_CHECK(culler.GetLevelCount() == 8);
+    TEST_CHECK(culler.GetDepth(0, 64, 32) < 1.0f);
+    TEST_CHECK(culler.GetDepth(culler.GetLevelCount() - 1, 0, 0) == 1.0f);
+
+    // Coarser levels hold the farthest depth of the texels they cover
+    bool conservative = true;
+    for (uint32_t y = 0; y < 32; y++) {
+        for (uint32_t x = 0; x < 64; x++) {
+            float farthest = std::max(std::max(culler.GetDepth(0, x * 2, y * 2), culler.GetDepth(0, x * 2 + 1, y * 2)),
+                                      std::max(culler.GetDepth(0, x * 2, y * 2 + 1), culler.GetDepth(0, x * 2 + 1, y * 2 + 1)));
+            conservative = conservative && culler.GetDepth(1, x, y) == farthest;
+        }
+    }
+    TEST_CHECK(conservative);
+
+    const float behindMin[3] = { -2.0f, -2.0f, -42.0f };
+    const float behindMax[3] = { 2.0f, 2.0f, -38.0f };
+    TEST_CHECK(!culler.TestAABB(behindMin, behindMax));
+    const float frontMin[3] = { -2.0f, -2.0f, -12.0f };
+    const float frontMax[3] = { 2.0f, 2.0f, -8.0f };
+    TEST_CHECK(culler.TestAABB(frontMin, frontMax));
+    const float tallMin[3] = { -2.0f, 10.0f, -80.0f };
+    const float tallMax[3] = { 2.0f, 60.0f, -76.0f };
+    TEST_CHECK(culler.TestAABB(tallMin, tallMax));
+    const float aroundMin[3] = { -1.0f, -1.0f, -1.0f };
+    const float aroundMax[3] = { 1.0f, 1.0f, 1.0f };
+    TEST_CHECK(culler.TestAABB(aroundMin, aroundMax));
+
+    // The batched test agrees with single tests and only looks at visible entries
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+    for (int i = 0; i < 1000; i++) {
+        float x = static_cast<float>((i * 37) % 90) - 45.0f;
+        float y = static_cast<float>((i * 11) % 50) - 25.0f;
+        float z = -static_cast<float>((i * 53) % 70) - 2.0f;
+        minX.push_back(x); minY.push_back(y); minZ.push_back(z);
+        maxX.push_back(x + 1.5f); maxY.push_back(y + 1.5f); maxZ.push_back(z + 1.5f);
+    }
+    std::vector<uint8_t> visible(minX.size(), 1);
+    visible[0] = 0;
+    uint32_t culled = culler.TestAABBs(minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(),
+                                       minX.size(), visible.data());
+    bool agrees = visible[0] == 0;
+    uint32_t expectedCulled = 0;
+    for (size_t i = 1; i < minX.size(); i++) {
+        const float min[3] = { minX[i], minY[i], minZ[i] };
+        const float max[3] = { maxX[i], maxY[i], maxZ[i] };
+        bool single = culler.TestAABB(min, max);
+        agrees = agrees && (visible[i] != 0) == single;
+        expectedCulled += single ? 0 : 1;
+    }
+    TEST_CHECK(agrees);
+    TEST_CHECK(culled == expectedCulled && culled > 0);
+
+    // Chunks: stone ground, a solid wall of chunks at chunk x = 2 with a single
+    // tunnel through it, and hilly ground behind the wall
+    VoxelSystem voxels;
+    for (int cz = -VoxelSystem::RENDER_DISTANCE; cz <= VoxelSystem::RENDER_DISTANCE; cz++) {
+        for (int cx = -VoxelSystem::RENDER_DISTANCE; cx <= VoxelSystem::RENDER_DISTANCE; cx++) {
+            voxels.GetOrCreateChunk({ cx, 0, cz }).Fill(VoxelType::Stone);
+        }
+        for (int cy = 1; cy < 6; cy++) {
+            voxels.GetOrCreateChunk({ 2, cy, cz }).Fill(VoxelType::Stone);
+        }
+        for (int cx = 3; cx <= VoxelSystem::RENDER_DISTANCE; cx++) {
+            Chunk& surface = voxels.GetOrCreateChunk({ cx, 1, cz });
+            for (int y = 0; y < 8; y++) {
+                for (int z = 0; z < CHUNK_SIZE; z++) {
+                    for (int x = 0; x < CHUNK_SIZE; x++) {
+                        surface.Set(x, y, z, VoxelType::Dirt);
+                    }
+                }
+            }
+        }
+    }
+    Chunk& tunnel = *voxels.GetChunk({ 2, 1, 0 });
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+        tunnel.Set(x, 8, 8, VoxelType::Air);
+    }
+    voxels.Update(0.0f);
+    TEST_CHECK(voxels.GetChunk({ 2, 2, 0 })->GetOccluderHeight() == CHUNK_SIZE);
+    TEST_CHECK(tunnel.GetOccluderHeight() == 8);
+    TEST_CHECK(voxels.GetChunk({ 5, 1, 0 })->GetOccluderHeight() == 8);
+
+    const float chunkEye[3] = { 8.0f, CHUNK_SIZE + 8.5f, 8.0f };
+    const float chunkTarget[3] = { 100.0f, CHUNK_SIZE + 8.5f, 8.0f };
+    BuildViewProjection(chunkEye, chunkTarget, viewProjection);
+    Frustum frustum = Frustum::FromMatrix(viewProjection);
+
+    auto isVisible = [](const ChunkVisibility& visibility, const ChunkCoord& coord) {
+        const std::vector<ChunkCoord>& chunks = visibility.GetVisibleChunks();
+        return std::find(chunks.begin(), chunks.end(), coord) != chunks.end();
+    };
+
+    // The walk squeezes through the tunnel, so connectivity alone keeps the far side
+    ChunkVisibility visibility;
+    visibility.Update(voxels, chunkEye, frustum);
+    uint32_t connectivityVisible = visibility.GetStats().visible;
+    TEST_CHECK(visibility.GetStats().occlusionCulled == 0);
+    TEST_CHECK(isVisible(visibility, { 6, 1, 5 }));
+
+    OcclusionCuller chunkCuller(&jobs);
+    visibility.SetOcclusionCuller(&chunkCuller);
+    chunkCuller.BeginFrame(viewProjection);
+    visibility.Update(voxels, chunkEye, frustum);
+    const ChunkVisibilityStats& stats = visibility.GetStats();
+    TEST_CHECK(stats.occluders > 0 && stats.occluders <= 64);
+    TEST_CHECK(stats.occlusionCulled > 0);
+    TEST_CHECK(stats.visible + stats.occlusionCulled == connectivityVisible);
+    TEST_CHECK(stats.visible + stats.frustumCulled + stats.connectivityCulled + stats.occlusionCulled ==
+               stats.chunksInRange);
+    TEST_CHECK(!isVisible(visibility, { 6, 1, 5 }));
+    TEST_CHECK(isVisible(visibility, { 2, 1, 0 }));
+    TEST_CHECK(isVisible(visibility, { 1, 0, 0 }));
+
+    // Entities reuse the pyramid built for the chunks
+    const float hiddenMin[3] = { 80.0f, CHUNK_SIZE + 8.0f, 60.0f };
+    const float hiddenMax[3] = { 81.0f, CHUNK_SIZE + 10.0f, 61.0f };
+    TEST_CHECK(!chunkCuller.TestAABB(hiddenMin, hiddenMax));
+    const float shownMin[3] = { 24.0f, CHUNK_SIZE, 4.0f };
+    const float shownMax[3] = { 25.0f, CHUNK_SIZE + 2.0f, 5.0f };
+    TEST_CHECK(chunkCuller.TestAABB(shownMin, shownMax));
+
+    // Culling counts reach RenderStats through the command buffer
+    NullRenderer renderer;
+    renderer.Initialize(nullptr, 640, 480);
+    CommandBuffer commands;
+    commands.AddCullingStats(stats.frustumCulled, stats.occlusionCulled);
+    commands.Execute(renderer);
+    TEST_CHECK(commands.GetStats().frustumCulled == stats.frustumCulled);
+    TEST_CHECK(commands.GetStats().occlusionCulled == stats.occlusionCulled);
+    commands.Execute(renderer);
+    TEST_CHECK(commands.GetStats().occlusionCulled == 0);
+
+    std::cout << "Occlusion Culler test passed!" << std::endl;
+}
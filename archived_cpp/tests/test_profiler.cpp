@@ -0,0 +1,191 @@
+#include "platform/Profiler.h"
+#include "platform/JobSystem.h"
+#include "TestFramework.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <vector>
+
+using namespace SwordAndStone::Platform;
+
+namespace {
+
+void NestedWork(int depth) {
+    PROFILE_ZONE("NestedWork");
+    if (depth > 0) NestedWork(depth - 1);
+}
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Every end closes the innermost open zone of its thread, and no zone is left open
+bool Balanced(const std::vector<ProfileEvent>& events) {
+    std::map<uint32_t, std::vector<const void*>> stacks;
+    for (const ProfileEvent& event : events) {
+        std::vector<const void*>& stack = stacks[event.thread];
+        if (event.type == ProfileEventType::ZoneBegin) {
+            stack.push_back(event.source);
+        } else if (event.type == ProfileEventType::ZoneEnd) {
+            if (stack.empty() || stack.back() != event.source) return false;
+            stack.pop_back();
+        }
+    }
+    for (auto& entry : stacks) {
+        if (!entry.second.empty()) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// Test per-thread zone recording, runtime toggling, overflow and trace export
+void test_profiler() {
+    std::cout << "Testing Profiler..." << std::endl;
+#ifdef SWORDANDSTONE_PROFILER_DISABLED
+    std::cout << "Profiler compiled out, skipped" << std::endl;
+    return;
+#endif
+
+    Profiler::Collect();
+    Profiler::Clear();
+
+    // Nothing is recorded while off
+    TEST_CHECK(!Profiler::IsEnabled());
+    NestedWork(3);
+    PROFILE_COUNTER("Off", 1);
+    Profiler::Collect();
+    TEST_CHECK(Profiler::GetEvents().empty());
+
+    // Zones from several threads nest and balance per thread
+    Profiler::SetEnabled(true);
+    JobSystem jobs(4);
+    PROFILE_FRAME_MARK();
+    {
+        PROFILE_ZONE("Frame");
+        jobs.ParallelFor(64, 1, [](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) NestedWork(2);
+        });
+        PROFILE_COUNTER("Jobs", 64);
+    }
+    PROFILE_FRAME_MARK();
+    Profiler::SetEnabled(false);
+    Profiler::Collect();
+
+    const std::vector<ProfileEvent>& events = Profiler::GetEvents();
+    size_t begins = 0, counters = 0, frames = 0;
+    bool ordered = true;
+    bool nested = true;
+    std::map<uint32_t, std::vector<const void*>> stacks;
+    for (size_t i = 0; i < events.size(); i++) {
+        const ProfileEvent& event = events[i];
+        ordered = ordered && (i == 0 || events[i - 1].ticks <= event.ticks);
+        std::vector<const void*>& stack = stacks[event.thread];
+        switch (event.type) {
+        case ProfileEventType::ZoneBegin:
+            begins++;
+            stack.push_back(event.source);
+            break;
+        case ProfileEventType::ZoneEnd:
+            nested = nested && !stack.empty() && stack.back() == event.source;
+            if (!stack.empty()) stack.pop_back();
+            break;
+        case ProfileEventType::Counter:
+            counters++;
+            TEST_CHECK(event.value == 64.0);
+            break;
+        case ProfileEventType::FrameMark:
+            frames++;
+            break;
+        }
+    }
+    TEST_CHECK(begins == 1 + 64 * 3);
+    TEST_CHECK(counters == 1 && frames == 2);
+    TEST_CHECK(ordered && nested);
+    for (auto& entry : stacks) {
+        TEST_CHECK(entry.second.empty());
+    }
+    TEST_CHECK(Profiler::GetDroppedCount() == 0);
+
+    // Both exports describe the same capture
+    const std::string tracePath = "profiler_trace.json";
+    const std::string binaryPath = "profiler_trace.bin";
+    TEST_CHECK(Profiler::ExportChromeTrace(tracePath));
+    std::string trace = ReadFile(tracePath);
+    TEST_CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+    TEST_CHECK(trace.find("\"name\":\"NestedWork\"") != std::string::npos);
+    TEST_CHECK(trace.find("\"ph\":\"C\"") != std::string::npos && trace.find("\"ph\":\"i\"") != std::string::npos);
+    TEST_CHECK(Profiler::ExportBinary(binaryPath));
+    std::string binary = ReadFile(binaryPath);
+    TEST_CHECK(binary.size() > 8 && binary.compare(0, 4, "SSPF") == 0);
+    TEST_CHECK(binary.size() < trace.size() / 4);
+    std::remove(tracePath.c_str());
+    std::remove(binaryPath.c_str());
+    Profiler::Clear();
+
+    // A full ring drops new events instead of blocking
+    Profiler::SetEnabled(true);
+    for (uint32_t i = 0; i < Profiler::RING_CAPACITY + 10; i++) {
+        PROFILE_COUNTER("Fill", i);
+    }
+    Profiler::SetEnabled(false);
+    TEST_CHECK(Profiler::GetDroppedCount() == 10);
+    Profiler::Collect();
+    TEST_CHECK(Profiler::GetEvents().size() == Profiler::RING_CAPACITY);
+    Profiler::Clear();
+
+    // Nested zones filling a ring are dropped whole, leaving every end with its begin
+    Profiler::SetEnabled(true);
+    for (uint32_t i = 0; i < Profiler::RING_CAPACITY / 2; i++) {
+        PROFILE_ZONE("FillOuter");
+        PROFILE_ZONE("FillInner");
+    }
+    Profiler::SetEnabled(false);
+    TEST_CHECK(Profiler::GetDroppedCount() == Profiler::RING_CAPACITY);
+    Profiler::Collect();
+    TEST_CHECK(Profiler::GetEvents().size() == Profiler::RING_CAPACITY && Balanced(Profiler::GetEvents()));
+    Profiler::Clear();
+
+    // Collecting for a long session keeps only the latest events, trimmed on whole zones
+    Profiler::SetCaptureCapacity(1000);
+    Profiler::SetEnabled(true);
+    for (int frame = 0; frame < 8; frame++) {
+        for (int i = 0; i < 150; i++) {
+            PROFILE_ZONE("FrameOuter");
+            PROFILE_ZONE("FrameInner");
+        }
+        Profiler::Collect();
+        TEST_CHECK(Profiler::GetEvents().size() <= 1000 && Balanced(Profiler::GetEvents()));
+    }
+    Profiler::SetEnabled(false);
+    TEST_CHECK(Profiler::GetEvents().size() >= 1000 - 4);
+    Profiler::SetCaptureCapacity(Profiler::DEFAULT_CAPTURE_CAPACITY);
+    Profiler::Clear();
+
+    // Cost per zone, off and on
+    const int iterations = 1000000;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        PROFILE_ZONE("Off");
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    Profiler::SetEnabled(true);
+    for (int i = 0; i < iterations; i += 4096) {
+        for (int j = 0; j < 4096; j++) {
+            PROFILE_ZONE("On");
+        }
+        Profiler::Collect();
+        Profiler::Clear();
+    }
+    Profiler::SetEnabled(false);
+    auto end = std::chrono::high_resolution_clock::now();
+    double offNs = std::chrono::duration<double, std::nano>(middle - start).count() / iterations;
+    double onNs = std::chrono::duration<double, std::nano>(end - middle).count() / iterations;
+    std::cout << "  zone cost: " << offNs << " ns off, " << onNs << " ns on (including collection)" << std::endl;
+
+    std::cout << "Profiler test passed!" << std::endl;
+}
@@ -1,4 +1,6 @@
 #include "renderer/IRenderer.h"
+#include "TestFramework.h"
+#include <algorithm>
 #include <iostream>
 
 // Test renderer functionality
@@ -12,5 +14,11 @@ void test_renderer_factory() {
         std::cout << "  - API available" << std::endl;
     }
     
+    // The null backend must always be creatable for headless tests
+    using SwordAndStone::Renderer::RenderAPI;
+    TEST_CHECK(std::find(apis.begin(), apis.end(), RenderAPI::Null) != apis.end());
+    auto renderer = SwordAndStone::Renderer::RendererFactory::Create(RenderAPI::Null);
+    TEST_CHECK(renderer && renderer->GetAPI() == RenderAPI::Null);
+    
     std::cout << "Renderer Factory test passed!" << std::endl;
 }
@@ -0,0 +1,235 @@
+#include "renderer/SoftwareRenderer.h"
+#include "platform/JobSystem.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace SwordAndStone::Renderer;
+using SwordAndStone::Platform::JobSystem;
+
+namespace {
+
+Vertex MakeVertex(float x, float y, float z, float r, float g, float b) {
+    Vertex v = {};
+    v.position[0] = x;
+    v.position[1] = y;
+    v.position[2] = z;
+    v.color[0] = r;
+    v.color[1] = g;
+    v.color[2] = b;
+    v.color[3] = 1.0f;
+    return v;
+}
+
+uint32_t PixelAt(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t x, uint32_t y) {
+    const uint8_t* p = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
+
+} // namespace
+
+// Test job system and tile-binned software rasterization
+void test_software_renderer() {
+    std::cout << "Testing Software Renderer..." << std::endl;
+
+    JobSystem jobs(3);
+    std::atomic<uint32_t> sum{0};
+    jobs.ParallelFor(1000, 7, [&sum](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            sum += i;
+        }
+    });
+    TEST_CHECK(sum == 499500);
+
+    SoftwareRenderer renderer(&jobs);
+    TEST_CHECK(renderer.Initialize(nullptr, 200, 150));
+
+    // Red quad at depth 0.5 in front of a green quad at depth 0, both counter-clockwise
+    Vertex quads[12] = {
+        MakeVertex(-1, -1, 0.5f, 1, 0, 0), MakeVertex(1, -1, 0.5f, 1, 0, 0), MakeVertex(1, 1, 0.5f, 1, 0, 0),
+        MakeVertex(-1, -1, 0.5f, 1, 0, 0), MakeVertex(1, 1, 0.5f, 1, 0, 0), MakeVertex(-1, 1, 0.5f, 1, 0, 0),
+        MakeVertex(-0.5f, -0.5f, 0.0f, 0, 1, 0), MakeVertex(0.5f, -0.5f, 0.0f, 0, 1, 0), MakeVertex(0.5f, 0.5f, 0.0f, 0, 1, 0),
+        MakeVertex(-0.5f, -0.5f, 0.0f, 0, 1, 0), MakeVertex(0.5f, 0.5f, 0.0f, 0, 1, 0), MakeVertex(-0.5f, 0.5f, 0.0f, 0, 1, 0),
+    };
+    uint32_t vb = renderer.CreateVertexBuffer(quads, sizeof(quads), BufferUsage::Static);
+
+    renderer.BeginFrame();
+    renderer.Clear(ClearColor | ClearDepth, 0.0f, 0.0f, 0.0f, 1.0f);
+    renderer.Draw(vb, 12, PrimitiveTopology::TriangleList);
+    renderer.EndFrame();
+
+    std::vector<uint8_t> pixels;
+    renderer.ReadPixels(pixels);
+    TEST_CHECK(pixels.size() == 200 * 150 * 4);
+    TEST_CHECK(PixelAt(pixels, 200, 5, 5) == 0xFF0000FFu);      // red border
+    TEST_CHECK(PixelAt(pixels, 200, 100, 75) == 0xFF00FF00u);   // green center wins depth test
+    TEST_CHECK(PixelAt(pixels, 200, 70, 70) == 0xFF00FF00u);    // spans a tile boundary
+    TEST_CHECK(renderer.ReadDepth(100, 75) < 0.6f);
+    TEST_CHECK(renderer.GetStats().triangles == 4);
+
+    // Clockwise triangle is culled by default and drawn with culling off
+    Vertex backFacing[3] = {
+        MakeVertex(-1, -1, 0, 0, 0, 1), MakeVertex(-1, 1, 0, 0, 0, 1), MakeVertex(1, -1, 0, 0, 0, 1),
+    };
+    uint32_t backVb = renderer.CreateVertexBuffer(backFacing, sizeof(backFacing), BufferUsage::Static);
+
+    renderer.BeginFrame();
+    renderer.Clear(ClearColor | ClearDepth, 0.0f, 0.0f, 0.0f, 1.0f);
+    renderer.Draw(backVb, 3, PrimitiveTopology::TriangleList);
+    renderer.EndFrame();
+    renderer.ReadPixels(pixels);
+    TEST_CHECK(PixelAt(pixels, 200, 10, 140) == 0xFF000000u);
+
+    renderer.SetCulling(false);
+    renderer.BeginFrame();
+    renderer.Draw(backVb, 3, PrimitiveTopology::TriangleList);
+    renderer.EndFrame();
+    renderer.ReadPixels(pixels);
+    TEST_CHECK(PixelAt(pixels, 200, 10, 140) == 0xFFFF0000u);
+
+    // Textured and blended draw: 50% white over blue
+    uint32_t white = 0x80FFFFFFu;
+    uint32_t texture = renderer.CreateTexture2D(1, 1, TextureFormat::RGBA8, &white);
+    Vertex overlay[3] = {
+        MakeVertex(-1, -1, 0, 1, 1, 1), MakeVertex(3, -1, 0, 1, 1, 1), MakeVertex(-1, 3, 0, 1, 1, 1),
+    };
+    uint32_t overlayVb = renderer.CreateVertexBuffer(overlay, sizeof(overlay), BufferUsage::Static);
+    renderer.BeginFrame();
+    renderer.SetDepthTest(false);
+    renderer.SetBlending(true);
+    renderer.BindTexture(0, texture);
+    renderer.Draw(overlayVb, 3, PrimitiveTopology::TriangleList);
+    renderer.EndFrame();
+    renderer.ReadPixels(pixels);
+    uint32_t blended = PixelAt(pixels, 200, 10, 140);
+    TEST_CHECK((blended & 0xFF) >= 126 && (blended & 0xFF) <= 130);
+    TEST_CHECK(((blended >> 16) & 0xFF) == 0xFF);
+
+    // sRGB texels are decoded to linear when sampled: mid grey 128 is about 0.216 linear
+    uint32_t grey = 0xFF808080u;
+    uint32_t srgbTexture = renderer.CreateTexture2D(1, 1, TextureFormat::SRGBA8, &grey);
+    renderer.BeginFrame();
+    renderer.BindTexture(0, srgbTexture);
+    renderer.Draw(overlayVb, 3, PrimitiveTopology::TriangleList);
+    renderer.EndFrame();
+    renderer.ReadPixels(pixels);
+    uint32_t decoded = PixelAt(pixels, 200, 10, 140);
+    TEST_CHECK((decoded & 0xFF) >= 54 && (decoded & 0xFF) <= 56);
+
+    // Ranges past the end of a buffer are refused, including ones whose end would wrap
+    uint8_t bytes[16] = {};
+    uint32_t small = renderer.CreateVertexBuffer(bytes, sizeof(bytes), BufferUsage::Static);
+    uint8_t marker = 0xAB;
+    uint64_t uploaded = renderer.GetStats().bytesUploaded;
+    renderer.UpdateVertexBuffer(small, &marker, SIZE_MAX, 8);
+    renderer.UpdateVertexBuffer(small, &marker, 1, SIZE_MAX);
+    renderer.CopyBuffer(small, 8, small, 0, SIZE_MAX - 4);
+    TEST_CHECK(renderer.GetStats().bytesUploaded == uploaded);
+
+    // Two triangles sharing a diagonal through pixel centres: the top-left rule shades each pixel once,
+    // so a 50% red blend over black is the same everywhere instead of doubling along the diagonal
+    SoftwareRenderer edges(&jobs);
+    TEST_CHECK(edges.Initialize(nullptr, 64, 64));
+    Vertex halves[6] = {
+        MakeVertex(-1, -1, 0, 1, 0, 0), MakeVertex(1, -1, 0, 1, 0, 0), MakeVertex(1, 1, 0, 1, 0, 0),
+        MakeVertex(-1, -1, 0, 1, 0, 0), MakeVertex(1, 1, 0, 1, 0, 0), MakeVertex(-1, 1, 0, 1, 0, 0),
+    };
+    for (Vertex& v : halves) v.color[3] = 0.5f;
+    uint32_t halvesVb = edges.CreateVertexBuffer(halves, sizeof(halves), BufferUsage::Static);
+    edges.BeginFrame();
+    edges.Clear(ClearColor | ClearDepth, 0.0f, 0.0f, 0.0f, 1.0f);
+    edges.SetDepthTest(false);
+    edges.SetBlending(true);
+    edges.Draw(halvesVb, 6, PrimitiveTopology::TriangleList);
+    edges.EndFrame();
+    edges.ReadPixels(pixels);
+    bool uniform = true;
+    for (uint32_t y = 0; y < 64; y++) {
+        for (uint32_t x = 0; x < 64; x++) {
+            uniform = uniform && PixelAt(pixels, 64, x, y) == PixelAt(pixels, 64, 0, 63);
+        }
+    }
+    uint32_t once = PixelAt(pixels, 64, 0, 63);
+    TEST_CHECK(uniform && (once & 0xFF) >= 126 && (once & 0xFF) <= 130);
+
+    // An indexed draw transforms only the vertices its indices reach
+    Vertex many[1000] = {};
+    for (int i = 0; i < 3; i++) many[500 + i] = halves[i];
+    uint32_t manyVb = edges.CreateVertexBuffer(many, sizeof(many), BufferUsage::Static);
+    uint32_t rangeIndices[3] = { 500, 501, 502 };
+    uint32_t rangeIb = edges.CreateIndexBuffer(rangeIndices, 3, BufferUsage::Static);
+    edges.ResetStats();
+    edges.BeginFrame();
+    edges.DrawIndexed(manyVb, rangeIb, 3, PrimitiveTopology::TriangleList);
+    edges.EndFrame();
+    TEST_CHECK(edges.GetStats().vertices == 3 && edges.GetStats().triangles == 1);
+
+    // A 1080p frame of a blocky chunk field: 128 x 128 columns seen in perspective
+    std::vector<Vertex> field;
+    std::vector<uint32_t> fieldIndices;
+    auto height = [](int x, int z) {
+        return static_cast<int>(4.0f + 3.0f * std::sin(x * 0.15f) + 3.0f * std::cos(z * 0.11f));
+    };
+    auto addQuad = [&](const float (&corners)[4][3], float shade) {
+        uint32_t base = static_cast<uint32_t>(field.size());
+        for (const float (&c)[3] : corners) {
+            field.push_back(MakeVertex(c[0], c[1], c[2], 0.3f * shade, 0.7f * shade, 0.2f * shade));
+        }
+        const uint32_t quad[6] = { 0, 1, 2, 0, 2, 3 };
+        for (uint32_t i : quad) fieldIndices.push_back(base + i);
+    };
+    for (int z = 0; z < 128; z++) {
+        for (int x = 0; x < 128; x++) {
+            const float fx = x - 64.0f;
+            const float fz = -z - 2.0f;
+            const float top = height(x, z) - 12.0f;
+            const float cap[4][3] = { { fx, top, fz }, { fx + 1, top, fz }, { fx + 1, top, fz - 1 }, { fx, top, fz - 1 } };
+            addQuad(cap, 1.0f);
+            const float lower = std::min(top, height(x, z - 1) - 12.0f);
+            if (lower < top) {
+                const float front[4][3] = { { fx, lower, fz }, { fx + 1, lower, fz }, { fx + 1, top, fz }, { fx, top, fz } };
+                addQuad(front, 0.8f);
+            }
+        }
+    }
+    const float aspect = 1920.0f / 1080.0f;
+    const float focal = 1.0f / std::tan(0.5f * 1.0472f);
+    const float nearPlane = 0.1f;
+    const float farPlane = 500.0f;
+    float projection[16] = {};
+    projection[0] = focal / aspect;
+    projection[5] = focal;
+    projection[10] = (farPlane + nearPlane) / (nearPlane - farPlane);
+    projection[11] = -1.0f;
+    projection[14] = 2.0f * farPlane * nearPlane / (nearPlane - farPlane);
+
+    SoftwareRenderer hd(&jobs);
+    TEST_CHECK(hd.Initialize(nullptr, 1920, 1080));
+    uint32_t fieldVb = hd.CreateVertexBuffer(field.data(), field.size() * sizeof(Vertex), BufferUsage::Static);
+    uint32_t fieldIb = hd.CreateIndexBuffer(fieldIndices.data(), fieldIndices.size(), BufferUsage::Static);
+    uint32_t fieldShader = hd.CreateShader("", "");
+    hd.SetCulling(false);
+    const int hdFrames = 5;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int frame = 0; frame < hdFrames; frame++) {
+        hd.BeginFrame();
+        hd.Clear(ClearColor | ClearDepth, 0.5f, 0.7f, 1.0f, 1.0f);
+        hd.BindShader(fieldShader);
+        hd.SetShaderUniform(fieldShader, "u_mvp", projection, sizeof(projection));
+        hd.DrawIndexed(fieldVb, fieldIb, static_cast<uint32_t>(fieldIndices.size()), PrimitiveTopology::TriangleList);
+        hd.EndFrame();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    hd.ReadPixels(pixels);
+    TEST_CHECK(PixelAt(pixels, 1920, 960, 1000) != PixelAt(pixels, 1920, 960, 5));  // terrain below, sky above
+    std::cout << "  1080p chunk field (" << fieldIndices.size() / 3 << " triangles, "
+              << jobs.GetThreadCount() << " threads): "
+              << std::chrono::duration<double, std::milli>(end - start).count() / hdFrames << " ms per frame" << std::endl;
+
+    std::cout << "Software Renderer test passed!" << std::endl;
+}
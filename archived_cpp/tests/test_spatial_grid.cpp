@@ -0,0 +1,169 @@
+#include "game/SpatialGrid.h"
+#include "game/EntityComponents.h"
+#include "game/GameWorld.h"
+#include "platform/JobSystem.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace SwordAndStone::Game;
+using namespace SwordAndStone::Platform;
+
+namespace {
+
+struct Body {
+    Entity entity;
+    float center[3];
+    float radius;
+};
+
+bool SameEntities(std::vector<Entity> a, std::vector<Entity> b) {
+    auto less = [](const Entity& l, const Entity& r) { return l.index < r.index; };
+    std::sort(a.begin(), a.end(), less);
+    std::sort(b.begin(), b.end(), less);
+    return a == b;
+}
+
+std::vector<Entity> BruteRadius(const std::vector<Body>& bodies, const float center[3], float radius) {
+    std::vector<Entity> found;
+    for (const Body& body : bodies) {
+        float dx = body.center[0] - center[0], dy = body.center[1] - center[1], dz = body.center[2] - center[2];
+        float reach = body.radius + radius;
+        if (dx * dx + dy * dy + dz * dz <= reach * reach) found.push_back(body.entity);
+    }
+    return found;
+}
+
+} // namespace
+
+// Test grid maintenance, queries against brute force, ECS sync and batched queries
+void test_spatial_grid() {
+    std::cout << "Testing Spatial Grid..." << std::endl;
+
+    // Random bodies, some larger than half a cell and some at negative coordinates
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.1f, 3.0f);
+    SpatialGrid grid(8.0f);
+    std::vector<Body> bodies;
+    for (uint32_t i = 0; i < 2000; i++) {
+        Body body = { { i, 0 }, { coord(rng), coord(rng) * 0.2f, coord(rng) }, i % 100 == 0 ? 12.0f : size(rng) };
+        grid.Insert(body.entity, body.center, body.radius);
+        bodies.push_back(body);
+    }
+    TEST_CHECK(grid.GetEntityCount() == bodies.size());
+
+    // Move a third, remove a fifth
+    for (uint32_t i = 0; i < bodies.size(); i += 3) {
+        bodies[i].center[0] += coord(rng) * 0.1f;
+        bodies[i].center[2] -= 9.0f;
+        grid.Update(bodies[i].entity, bodies[i].center, bodies[i].radius);
+    }
+    for (uint32_t i = static_cast<uint32_t>(bodies.size()); i-- > 0;) {
+        if (i % 5 == 0) {
+            grid.Remove(bodies[i].entity);
+            bodies.erase(bodies.begin() + i);
+        }
+    }
+    TEST_CHECK(grid.GetEntityCount() == bodies.size() && !grid.Contains({ 0, 0 }) && grid.Contains({ 1, 0 }));
+    TEST_CHECK(!grid.Contains({ 1, 1 }));  // stale generation
+
+    bool radiusMatches = true;
+    bool boxMatches = true;
+    for (int q = 0; q < 200; q++) {
+        const float center[3] = { coord(rng), coord(rng) * 0.2f, coord(rng) };
+        const float radius = size(rng) * 4.0f;
+        std::vector<Entity> found;
+        grid.QueryRadius(center, radius, found);
+        radiusMatches = radiusMatches && SameEntities(found, BruteRadius(bodies, center, radius));
+
+        const float min[3] = { center[0] - radius, center[1] - 2.0f, center[2] - 2.0f * radius };
+        const float max[3] = { center[0] + radius, center[1] + 2.0f, center[2] };
+        found.clear();
+        grid.QueryAABB(min, max, found);
+        std::vector<Entity> expected;
+        for (const Body& body : bodies) {
+            float distance = 0.0f;
+            for (int axis = 0; axis < 3; axis++) {
+                float delta = body.center[axis] - std::min(std::max(body.center[axis], min[axis]), max[axis]);
+                distance += delta * delta;
+            }
+            if (distance <= body.radius * body.radius) expected.push_back(body.entity);
+        }
+        boxMatches = boxMatches && SameEntities(found, expected);
+    }
+    TEST_CHECK(radiusMatches);
+    TEST_CHECK(boxMatches);
+
+    // Batched queries return the same sets, laid out per query
+    JobSystem jobs(3);
+    std::vector<float> centers;
+    std::vector<float> radii;
+    for (int q = 0; q < 300; q++) {
+        centers.insert(centers.end(), { coord(rng), 0.0f, coord(rng) });
+        radii.push_back(size(rng) * 3.0f);
+    }
+    std::vector<uint32_t> offsets;
+    std::vector<Entity> results;
+    grid.QueryRadiusBatch(centers.data(), radii.data(), 300, offsets, results, &jobs);
+    TEST_CHECK(offsets.size() == 301 && offsets.back() == results.size());
+    bool batchMatches = true;
+    for (uint32_t q = 0; q < 300; q++) {
+        std::vector<Entity> slice(results.begin() + offsets[q], results.begin() + offsets[q + 1]);
+        batchMatches = batchMatches && SameEntities(slice, BruteRadius(bodies, &centers[3 * q], radii[q]));
+    }
+    TEST_CHECK(batchMatches);
+
+    // GameWorld keeps the grid in step with its entities: moved, destroyed and bounds-less ones
+    GameWorld world(&jobs);
+    EntityRegistry& entities = world.GetEntities();
+    Entity arrow = entities.Create(Position{ 0.0f, 1.0f, 0.0f }, Velocity{ 60.0f, 0.0f, 0.0f }, Bounds{ 0.2f });
+    Entity drop = entities.Create(Position{ 5.0f, 1.0f, 5.0f }, Bounds{ 0.3f }, Lifetime{ 0.01f });
+    Entity marker = entities.Create(Position{ 0.0f, 1.0f, 0.0f });
+    world.Update(0.0f);
+    SpatialGrid& worldGrid = world.GetSpatialGrid();
+    std::vector<Entity> near;
+    const float origin[3] = { 0.0f, 1.0f, 0.0f };
+    worldGrid.QueryRadius(origin, 1.0f, near);
+    TEST_CHECK(near.size() == 1 && near[0] == arrow && !worldGrid.Contains(marker));
+    world.Update(0.5f);
+    near.clear();
+    worldGrid.QueryRadius(origin, 1.0f, near);
+    TEST_CHECK(near.empty());
+    const float ahead[3] = { 30.0f, 1.0f, 0.0f };
+    worldGrid.QueryRadius(ahead, 1.0f, near);
+    TEST_CHECK(near.size() == 1 && !worldGrid.Contains(drop) && worldGrid.GetStats().removed == 1);
+    TEST_CHECK(worldGrid.GetStats().cellChanges == 1);
+
+    // Sync cost for 100k slow movers and pickup queries around 1000 players
+    GameWorld crowd(&jobs);
+    const uint32_t count = 100000;
+    for (uint32_t i = 0; i < count; i++) {
+        crowd.GetEntities().Create(Position{ coord(rng) * 5.0f, 0.0f, coord(rng) * 5.0f },
+                                   Velocity{ size(rng), 0.0f, -size(rng) }, Bounds{ 0.25f });
+    }
+    crowd.Update(0.0f);
+    std::vector<float> players;
+    std::vector<float> reach(1000, 2.0f);
+    for (int p = 0; p < 1000; p++) {
+        players.insert(players.end(), { coord(rng) * 5.0f, 0.0f, coord(rng) * 5.0f });
+    }
+    const int ticks = 20;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        crowd.GetSpatialGrid().Sync(crowd.GetEntities());
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        crowd.GetSpatialGrid().QueryRadiusBatch(players.data(), reach.data(), 1000, offsets, results, &jobs);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    TEST_CHECK(crowd.GetSpatialGrid().GetEntityCount() == count);
+    std::cout << "  sync of " << count << " entities: "
+              << std::chrono::duration<double, std::micro>(middle - start).count() / ticks << " us, 1000 pickup queries: "
+              << std::chrono::duration<double, std::micro>(end - middle).count() / ticks << " us" << std::endl;
+
+    std::cout << "Spatial Grid test passed!" << std::endl;
+}
@@ -0,0 +1,129 @@
+#include "renderer/TextureAtlas.h"
+#include "renderer/NullRenderer.h"
+#include "game/VoxelSystem.h"
+#include "TestFramework.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace SwordAndStone::Renderer;
+using SwordAndStone::Game::VoxelSystem;
+using SwordAndStone::Game::VoxelType;
+
+namespace {
+
+// 16x16 one-texel black and white checkerboard, and a solid red tile
+void MakeTiles(std::vector<uint8_t>& checker, std::vector<uint8_t>& red) {
+    checker.resize(16 * 16 * 4);
+    red.resize(16 * 16 * 4);
+    for (int i = 0; i < 16 * 16; i++) {
+        uint8_t value = ((i % 16 + i / 16) % 2 == 0) ? 0 : 255;
+        checker[i * 4] = checker[i * 4 + 1] = checker[i * 4 + 2] = value;
+        checker[i * 4 + 3] = 255;
+        red[i * 4] = 255;
+        red[i * 4 + 1] = red[i * 4 + 2] = 0;
+        red[i * 4 + 3] = 255;
+    }
+}
+
+const uint8_t* Texel(const TextureAtlas& atlas, size_t level, uint32_t x, uint32_t y) {
+    uint32_t width = atlas.GetWidth() >> level;
+    return &atlas.GetLevel(level)[(static_cast<size_t>(y) * width + x) * 4];
+}
+
+} // namespace
+
+// Test atlas packing, gamma-correct mips and the build cache
+void test_texture_atlas() {
+    std::cout << "Testing Texture Atlas..." << std::endl;
+
+    std::vector<uint8_t> checker, red;
+    MakeTiles(checker, red);
+
+    TextureAtlasDesc desc;
+    desc.padding = 4;
+    desc.filter = MipFilter::Box;
+
+    TextureAtlas atlas;
+    atlas.AddImage("checker", 16, 16, checker.data());
+    atlas.AddImage("red", 16, 16, red.data());
+    TEST_CHECK(!atlas.AddFile("missing", "does/not/exist.png"));
+    TEST_CHECK(atlas.Build(desc));
+    TEST_CHECK(!atlas.WasLoadedFromCache());
+
+    // Two 24x24 cells side by side; mips stop while the padding is still a texel
+    TEST_CHECK(atlas.GetTileSize() == 16 && atlas.GetPadding() == 4);
+    TEST_CHECK(atlas.GetWidth() == 48 && atlas.GetHeight() == 24);
+    TEST_CHECK(atlas.GetLevelCount() == 3);
+    TEST_CHECK(atlas.GetLevel(2).size() == 12 * 6 * 4);
+    TEST_CHECK(atlas.FindTile("red") == 1);
+    TEST_CHECK(atlas.FindTile("missing") == TextureAtlas::INVALID_TILE);
+
+    AtlasRect rect = atlas.GetTileRect(1);
+    TEST_CHECK(std::fabs(rect.u0 - 28.0f / 48.0f) < 1e-6f && std::fabs(rect.u1 - 44.0f / 48.0f) < 1e-6f);
+    TEST_CHECK(std::fabs(rect.v0 - 4.0f / 24.0f) < 1e-6f && std::fabs(rect.v1 - 20.0f / 24.0f) < 1e-6f);
+
+    // Padding repeats the opposite edge of the tile
+    TEST_CHECK(Texel(atlas, 0, 0, 0)[0] == checker[(12 * 16 + 12) * 4]);
+    TEST_CHECK(Texel(atlas, 0, 1, 0)[0] == checker[(12 * 16 + 13) * 4]);
+    TEST_CHECK(Texel(atlas, 0, 24, 0)[0] == 255 && Texel(atlas, 0, 24, 0)[1] == 0);
+
+    // Averaging black and white in linear space gives sRGB 188, not 128
+    const uint8_t* grey = Texel(atlas, 1, 5, 5);
+    TEST_CHECK(grey[0] >= 187 && grey[0] <= 189 && grey[0] == grey[1] && grey[3] == 255);
+    TEST_CHECK(Texel(atlas, 2, 8, 3)[0] == 255 && Texel(atlas, 2, 8, 3)[2] == 0);
+
+    desc.filter = MipFilter::Kaiser;
+    TextureAtlas kaiser;
+    kaiser.AddImage("checker", 16, 16, checker.data());
+    kaiser.AddImage("red", 16, 16, red.data());
+    TEST_CHECK(kaiser.Build(desc));
+    grey = Texel(kaiser, 2, 3, 3);
+    TEST_CHECK(grey[0] >= 187 && grey[0] <= 189);
+    TEST_CHECK(Texel(kaiser, 1, 16, 6)[0] == 255 && Texel(kaiser, 1, 16, 6)[1] == 0);
+
+    // A second build with identical sources loads the cache
+    const std::string cachePath = "texture_atlas_cache.bin";
+    std::remove(cachePath.c_str());
+    TEST_CHECK(kaiser.Build(desc, cachePath));
+    TEST_CHECK(!kaiser.WasLoadedFromCache());
+
+    TextureAtlas cached;
+    cached.AddImage("checker", 16, 16, checker.data());
+    cached.AddImage("red", 16, 16, red.data());
+    TEST_CHECK(cached.Build(desc, cachePath));
+    TEST_CHECK(cached.WasLoadedFromCache());
+    TEST_CHECK(cached.GetSourceHash() == kaiser.GetSourceHash());
+    TEST_CHECK(cached.GetLevelCount() == kaiser.GetLevelCount() && cached.FindTile("red") == 1);
+    bool identical = true;
+    for (size_t level = 0; level < kaiser.GetLevelCount(); level++) {
+        identical = identical && cached.GetLevel(level) == kaiser.GetLevel(level);
+    }
+    TEST_CHECK(identical);
+
+    // Any source change misses the cache
+    red[0] = 254;
+    TextureAtlas changed;
+    changed.AddImage("checker", 16, 16, checker.data());
+    changed.AddImage("red", 16, 16, red.data());
+    TEST_CHECK(changed.Build(desc, cachePath));
+    TEST_CHECK(!changed.WasLoadedFromCache());
+    TEST_CHECK(changed.GetSourceHash() != kaiser.GetSourceHash());
+    std::remove(cachePath.c_str());
+
+    // One texture with every level
+    NullRenderer renderer;
+    renderer.Initialize(nullptr, 640, 480);
+    uint32_t texture = cached.Upload(renderer);
+    TEST_CHECK(texture != 0 && renderer.GetTextureCount() == 1);
+    TEST_CHECK(renderer.GetStats().bytesUploaded == (48 * 24 + 24 * 12 + 12 * 6) * 4);
+
+    TEST_CHECK(std::strcmp(VoxelSystem::GetBlockTextureName(VoxelType::Stone), "stone") == 0);
+    TEST_CHECK(VoxelSystem::GetBlockTextureName(VoxelType::Air) == nullptr);
+    VoxelSystem voxels;
+    TEST_CHECK(!voxels.LoadTerrainTextures(renderer, "does/not/exist"));
+    TEST_CHECK(voxels.GetTerrainTexture() == 0);
+
+    std::cout << "Texture Atlas test passed!" << std::endl;
+}
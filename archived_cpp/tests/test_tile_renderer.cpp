@@ -0,0 +1,171 @@
+#include "game/TileRenderer.h"
+#include "renderer/NullRenderer.h"
+#include "renderer/SpriteBatch.h"
+#include "TestFramework.h"
+#include <iostream>
+
+using namespace SwordAndStone::Renderer;
+using namespace SwordAndStone::Game;
+
+namespace {
+
+const Vertex* BufferVertices(const NullRenderer& renderer, uint32_t buffer, size_t& count) {
+    const std::vector<uint8_t>* data = renderer.GetBufferData(buffer);
+    count = data ? data->size() / sizeof(Vertex) : 0;
+    return data ? reinterpret_cast<const Vertex*>(data->data()) : nullptr;
+}
+
+} // namespace
+
+// Test sparse tile regions, cached region meshes and depth-sorted sprites
+void test_tile_renderer() {
+    std::cout << "Testing Tile Renderer..." << std::endl;
+
+    // Sparse regions in every direction
+    TileMap map;
+    TEST_CHECK(map.GetTile(-1, -1) == EMPTY_TILE);
+    map.SetTile(-1, -1, 3);
+    map.SetTile(100000, -70000, 5);
+    TEST_CHECK(map.GetTile(-1, -1) == 3 && map.GetTile(100000, -70000) == 5);
+    TEST_CHECK(map.GetRegion({ -1, -1 }) && map.GetRegion({ -1, -1 })->Get(31, 31) == 3);
+    TEST_CHECK(map.GetRegionCount() == 2);
+    map.SetTile(5000, 5000, EMPTY_TILE);  // clearing an absent tile allocates nothing
+    TEST_CHECK(map.GetRegionCount() == 2);
+    uint32_t version = map.GetRegion({ -1, -1 })->version;
+    map.SetTile(-1, -1, 3);
+    TEST_CHECK(map.GetRegion({ -1, -1 })->version == version);
+    map.SetTile(-2, -1, 3);
+    TEST_CHECK(map.GetRegion({ -1, -1 })->version != version);
+    map.Clear();
+
+    // A 512x512 top-down world; only regions under the view are meshed
+    for (int y = 0; y < 512; y++) {
+        for (int x = 0; x < 512; x++) {
+            map.SetTile(x, y, static_cast<uint16_t>((x + y) % 8));
+        }
+    }
+    TEST_CHECK(map.GetRegionCount() == 256);
+
+    NullRenderer renderer;
+    renderer.Initialize(nullptr, 1280, 720);
+    CommandBuffer commands;
+
+    TileRendererDesc desc;
+    desc.tileWidth = 32.0f;
+    desc.tileHeight = 32.0f;
+    desc.texture = 7;
+    desc.shader = renderer.CreateShader("tile_vs", "tile_fs");
+    TileRenderer topDown(desc);
+
+    // Regions are 1024x1024 pixels; this view overlaps regions (1, 1) to (2, 2)
+    const float viewMin[2] = { 1100.0f, 1100.0f };
+    const float viewMax[2] = { 2380.0f, 2200.0f };
+    topDown.Render(renderer, commands, map, viewMin, viewMax);
+    TEST_CHECK(topDown.GetStats().regionsVisible == 4);
+    TEST_CHECK(topDown.GetStats().regionsRebuilt == 4);
+    TEST_CHECK(topDown.GetStats().tilesBuilt == 4 * TILE_REGION_AREA);
+    TEST_CHECK(commands.GetCommandCount() == 4 && topDown.GetCachedRegionCount() == 4);
+    renderer.BeginFrame();
+    commands.Execute(renderer);
+    renderer.EndFrame();
+    TEST_CHECK(renderer.GetStats().drawCalls == 4);
+    TEST_CHECK(renderer.GetStats().triangles == 4 * TILE_REGION_AREA * 2);
+
+    // Unchanged frame rebuilds nothing; one edit rebuilds one region
+    topDown.Render(renderer, commands, map, viewMin, viewMax);
+    TEST_CHECK(topDown.GetStats().regionsRebuilt == 0 && topDown.GetStats().drawCalls == 4);
+    commands.Clear();
+    map.SetTile(40, 40, EMPTY_TILE);
+    topDown.Render(renderer, commands, map, viewMin, viewMax);
+    TEST_CHECK(topDown.GetStats().regionsRebuilt == 1);
+    TEST_CHECK(topDown.GetStats().tilesBuilt == TILE_REGION_AREA - 1);
+    commands.Clear();
+
+    // Regions that leave the map, or stay off screen, give their buffers back
+    map.RemoveRegion({ 2, 2 });
+    topDown.Render(renderer, commands, map, viewMin, viewMax);
+    TEST_CHECK(topDown.GetStats().regionsVisible == 3 && topDown.GetCachedRegionCount() == 3);
+    commands.Clear();
+    const float farMin[2] = { 9000.0f, 9000.0f };
+    const float farMax[2] = { 9100.0f, 9100.0f };
+    for (uint32_t i = 0; i <= TileRenderer::EVICT_AFTER_FRAMES; i++) {
+        topDown.Render(renderer, commands, map, farMin, farMax);
+        commands.Clear();
+    }
+    TEST_CHECK(topDown.GetCachedRegionCount() == 1);
+    size_t buffers = renderer.GetBufferCount();
+    topDown.Release(renderer);
+    TEST_CHECK(renderer.GetBufferCount() == buffers - 2);  // region and shared index buffer
+
+    // Isometric: tiles are meshed back to front, regions are drawn along diagonals
+    desc.projection = TileProjection::Isometric;
+    desc.tileWidth = 64.0f;
+    desc.tileHeight = 32.0f;
+    desc.imageHeight = 48.0f;
+    TileRenderer isometric(desc);
+    float screen[2];
+    float tile[2];
+    isometric.TileToScreen(10.0f, 4.0f, screen);
+    isometric.ScreenToTile(screen[0], screen[1], tile);
+    TEST_CHECK(std::fabs(tile[0] - 10.0f) < 1e-4f && std::fabs(tile[1] - 4.0f) < 1e-4f);
+
+    const float isoMin[2] = { -640.0f, 0.0f };
+    const float isoMax[2] = { 640.0f, 1440.0f };
+    isometric.Render(renderer, commands, map, isoMin, isoMax);
+    TEST_CHECK(isometric.GetStats().regionsVisible > 0);
+    TEST_CHECK(commands.GetCommandCount() == isometric.GetStats().drawCalls);
+
+    const std::vector<uint32_t>& order = commands.Sort();
+    bool diagonalOrder = true;
+    float previousTop = -1e30f;
+    for (uint32_t index : order) {
+        size_t count = 0;
+        const Vertex* vertices = BufferVertices(renderer, commands.GetCommands()[index].vertexBuffer, count);
+        TEST_CHECK(vertices && count > 0);
+        // Region sort keys step one diagonal at a time; the first quad sits on the region's top corner
+        diagonalOrder = diagonalOrder && vertices[0].position[1] >= previousTop;
+        previousTop = vertices[0].position[1];
+
+        bool backToFront = true;
+        for (size_t quad = 1; quad < count / 4; quad++) {
+            backToFront = backToFront && vertices[quad * 4].position[1] >= vertices[(quad - 1) * 4].position[1];
+        }
+        TEST_CHECK(backToFront);
+    }
+    TEST_CHECK(diagonalOrder);
+    commands.Clear();
+    isometric.Release(renderer);
+
+    // Sprites: stable radix sort by depth, one draw per texture run
+    SpriteBatch sprites;
+    sprites.Begin();
+    const float depths[] = { 5.0f, -2.0f, 5.0f, 100.0f, 0.0f, -300.5f, 5.0f };
+    const uint32_t textures[] = { 1, 1, 2, 2, 1, 1, 2 };
+    for (int i = 0; i < 7; i++) {
+        Sprite sprite = {};
+        sprite.position[0] = static_cast<float>(i);
+        sprite.size[0] = sprite.size[1] = 16.0f;
+        sprite.uv[2] = sprite.uv[3] = 1.0f;
+        sprite.color[0] = sprite.color[1] = sprite.color[2] = sprite.color[3] = 1.0f;
+        sprite.depth = depths[i];
+        sprite.texture = textures[i];
+        sprites.Add(sprite);
+    }
+    uint32_t draws = sprites.Flush(renderer, commands, desc.shader);
+    const uint32_t expectedOrder[] = { 5, 1, 4, 0, 2, 6, 3 };
+    TEST_CHECK(sprites.GetDrawOrder().size() == 7);
+    for (int i = 0; i < 7; i++) {
+        TEST_CHECK(sprites.GetDrawOrder()[i] == expectedOrder[i]);
+    }
+    TEST_CHECK(draws == 2);  // textures 1 1 1 1 | 2 2 2 in draw order
+
+    renderer.BeginFrame();
+    renderer.ResetStats();
+    commands.Execute(renderer);
+    renderer.EndFrame();
+    TEST_CHECK(renderer.GetStats().drawCalls == 2);
+    TEST_CHECK(renderer.GetStats().triangles == 14);
+    sprites.Release(renderer);
+
+    std::cout << "Tile Renderer test passed!" << std::endl;
+}
@@ -0,0 +1,62 @@
+#include "renderer/VertexArrayCache.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace SwordAndStone::Renderer;
+
+namespace {
+
+bool Contains(const std::vector<uint32_t>& values, uint32_t value) {
+    return std::find(values.begin(), values.end(), value) != values.end();
+}
+
+} // namespace
+
+// Test vertex array lookups and their invalidation when a buffer they read from is deleted
+void test_vertex_array_cache() {
+    std::cout << "Testing Vertex Array Cache..." << std::endl;
+
+    VertexArrayCache cache;
+    const VertexArrayCache::Key plain = { 1, 0, 0, 0 };
+    const VertexArrayCache::Key indexed = { 1, 2, 0, 0 };
+    const VertexArrayCache::Key instanced = { 1, 2, 1, 3 };
+    const VertexArrayCache::Key other = { 4, 2, 0, 0 };
+    TEST_CHECK(cache.Find(plain) == 0);
+    cache.Insert(plain, 10);
+    cache.Insert(indexed, 11);
+    cache.Insert(instanced, 12);
+    cache.Insert(other, 13);
+    TEST_CHECK(cache.GetSize() == 4);
+    TEST_CHECK(cache.Find(plain) == 10 && cache.Find(indexed) == 11 && cache.Find(instanced) == 12);
+    TEST_CHECK(cache.Find({ 1, 2, 1, 5 }) == 0);
+
+    // Deleting the instance buffer drops only the array that read from it
+    std::vector<uint32_t> removed;
+    cache.RemoveBuffer(3, removed);
+    TEST_CHECK(removed.size() == 1 && removed[0] == 12);
+    TEST_CHECK(cache.Find(instanced) == 0 && cache.Find(indexed) == 11);
+
+    // Deleting a shared index buffer drops it from every vertex buffer's arrays
+    removed.clear();
+    cache.RemoveBuffer(2, removed);
+    TEST_CHECK(removed.size() == 2 && Contains(removed, 11) && Contains(removed, 13));
+    TEST_CHECK(cache.GetSize() == 1 && cache.Find(plain) == 10);
+
+    // A deleted vertex buffer's arrays are gone, and a reused name starts from an empty cache
+    removed.clear();
+    cache.RemoveBuffer(1, removed);
+    TEST_CHECK(removed.size() == 1 && removed[0] == 10 && cache.GetSize() == 0);
+    removed.clear();
+    cache.RemoveBuffer(1, removed);
+    cache.RemoveBuffer(4, removed);
+    TEST_CHECK(removed.empty());
+    cache.Insert(indexed, 20);
+    TEST_CHECK(cache.Find(indexed) == 20 && cache.Find(plain) == 0);
+
+    removed.clear();
+    cache.Clear(removed);
+    TEST_CHECK(removed.size() == 1 && removed[0] == 20 && cache.GetSize() == 0);
+
+    std::cout << "Vertex Array Cache test passed!" << std::endl;
+}
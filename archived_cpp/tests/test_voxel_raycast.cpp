@@ -0,0 +1,164 @@
+#include "game/VoxelRaycast.h"
+#include "platform/JobSystem.h"
+#include "TestFramework.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace SwordAndStone::Game;
+using namespace SwordAndStone::Platform;
+
+namespace {
+
+// Reference: march in tiny steps and report the first solid voxel
+bool MarchReference(const VoxelSystem& voxels, const float origin[3], const float direction[3], float maxDistance,
+                    int block[3]) {
+    const float length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] +
+                                   direction[2] * direction[2]);
+    for (float t = 0.0f; t <= maxDistance; t += 0.001f) {
+        int voxel[3];
+        for (int axis = 0; axis < 3; axis++) {
+            voxel[axis] = static_cast<int>(std::floor(origin[axis] + direction[axis] / length * t));
+        }
+        if (IsSolid(voxels.GetVoxel(voxel[0], voxel[1], voxel[2]))) {
+            for (int axis = 0; axis < 3; axis++) block[axis] = voxel[axis];
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+// Test DDA raycasts against a reference march, chunk skipping, batching and swept boxes
+void test_voxel_raycast() {
+    std::cout << "Testing Voxel Raycast..." << std::endl;
+
+    // Stone floor below y = 0, scattered blocks and a water pool above, sky beyond
+    VoxelSystem voxels;
+    for (int cx = -4; cx < 4; cx++) {
+        for (int cz = -4; cz < 4; cz++) {
+            voxels.GetOrCreateChunk({ cx, -1, cz }).Fill(VoxelType::Stone);
+        }
+    }
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> coord(-60, 59);
+    std::uniform_int_distribution<int> height(0, 20);
+    for (int i = 0; i < 400; i++) {
+        voxels.SetVoxel(coord(rng), height(rng), coord(rng), VoxelType::Wood);
+    }
+    for (int x = 20; x < 26; x++) {
+        for (int z = 20; z < 26; z++) {
+            voxels.SetVoxel(x, 0, z, VoxelType::Water);
+        }
+    }
+    voxels.Update(0.0f);
+
+    // Looking straight down hits the floor's top face
+    VoxelRayHit hit;
+    const float above[3] = { 0.5f, 10.5f, 0.5f };
+    const float down[3] = { 0.0f, -1.0f, 0.0f };
+    for (int y = 0; y <= 20; y++) {
+        voxels.SetVoxel(0, y, 0, VoxelType::Air);
+    }
+    TEST_CHECK(RaycastVoxels(voxels, above, down, 100.0f, hit));
+    TEST_CHECK(hit.block[1] == -1 && hit.normal[1] == 1 && hit.normal[0] == 0);
+    TEST_CHECK(std::abs(hit.distance - 10.5f) < 1e-4f);
+
+    // Water does not stop the default filter but does stop a custom one
+    const float pool[3] = { 22.5f, 3.5f, 22.5f };
+    TEST_CHECK(RaycastVoxels(voxels, pool, down, 10.0f, hit) && hit.type == VoxelType::Stone);
+    TEST_CHECK(RaycastVoxels(voxels, pool, down, 10.0f, hit, [](VoxelType type) { return type != VoxelType::Air; }));
+    TEST_CHECK(hit.type == VoxelType::Water && hit.block[1] == 0);
+
+    // Starting inside a block reports it with no normal; out of range and zero directions miss
+    const float inside[3] = { 3.5f, -3.5f, 3.5f };
+    TEST_CHECK(RaycastVoxels(voxels, inside, down, 5.0f, hit) && hit.distance == 0.0f && hit.normal[1] == 0);
+    const float sky[3] = { 0.5f, 200.0f, 0.5f };
+    TEST_CHECK(!RaycastVoxels(voxels, sky, down, 50.0f, hit) && !hit.hit);
+    const float zero[3] = { 0.0f, 0.0f, 0.0f };
+    TEST_CHECK(!RaycastVoxels(voxels, above, zero, 50.0f, hit));
+
+    // Random rays agree with a fine march, including ones that cross empty and missing chunks
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    int agreements = 0;
+    int hits = 0;
+    const int rays = 300;
+    std::vector<float> origins;
+    std::vector<float> directions;
+    std::vector<float> ranges(rays, 80.0f);
+    for (int i = 0; i < rays; i++) {
+        const float origin[3] = { position(rng), 1.0f + std::abs(position(rng)) * 0.6f, position(rng) };
+        const float direction[3] = { unit(rng), unit(rng) - 0.3f, unit(rng) };
+        origins.insert(origins.end(), origin, origin + 3);
+        directions.insert(directions.end(), direction, direction + 3);
+        int expected[3];
+        bool expectHit = MarchReference(voxels, origin, direction, 80.0f, expected);
+        bool found = RaycastVoxels(voxels, origin, direction, 80.0f, hit);
+        hits += found ? 1 : 0;
+        if (found == expectHit && (!found || (hit.block[0] == expected[0] && hit.block[1] == expected[1] &&
+                                              hit.block[2] == expected[2]))) {
+            agreements++;
+        }
+    }
+    // The march can clip a voxel corner the exact traversal resolves differently; allow a couple
+    TEST_CHECK(agreements >= rays - 2);
+    TEST_CHECK(hits > rays / 2);
+
+    // The batch matches single rays
+    JobSystem jobs(3);
+    std::vector<VoxelRayHit> batch(rays);
+    RaycastVoxelsBatch(voxels, origins.data(), directions.data(), ranges.data(), rays, batch.data(), IsSolid, &jobs);
+    bool batchMatches = true;
+    for (int i = 0; i < rays; i++) {
+        RaycastVoxels(voxels, &origins[3 * i], &directions[3 * i], ranges[i], hit);
+        batchMatches = batchMatches && hit.hit == batch[i].hit && hit.block[0] == batch[i].block[0] &&
+                       hit.block[1] == batch[i].block[1] && hit.block[2] == batch[i].block[2];
+    }
+    TEST_CHECK(batchMatches);
+
+    // A falling box lands on the floor; a box flush against a wall slides along it
+    VoxelSystem room;
+    for (int x = 0; x < 16; x++) {
+        for (int z = 0; z < 16; z++) {
+            room.SetVoxel(x, 0, z, VoxelType::Stone);
+            room.SetVoxel(10, 1 + (x & 1), z, VoxelType::Stone);
+        }
+    }
+    room.Update(0.0f);
+    VoxelSweepHit sweep;
+    const float boxMin[3] = { 2.2f, 5.0f, 2.2f };
+    const float boxMax[3] = { 2.8f, 6.8f, 2.8f };
+    const float fall[3] = { 0.0f, -10.0f, 0.0f };
+    TEST_CHECK(SweepVoxels(room, boxMin, boxMax, fall, sweep));
+    TEST_CHECK(sweep.normal[1] == 1 && sweep.block[1] == 0 && std::abs(5.0f + fall[1] * sweep.time - 1.0f) < 1e-4f);
+
+    const float restingMin[3] = { 9.4f, 1.0f, 2.2f };
+    const float restingMax[3] = { 10.0f, 2.8f, 2.8f };
+    const float along[3] = { 0.0f, 0.0f, 8.0f };
+    TEST_CHECK(!SweepVoxels(room, restingMin, restingMax, along, sweep));
+    const float into[3] = { 1.0f, 0.0f, 0.5f };
+    TEST_CHECK(SweepVoxels(room, restingMin, restingMax, into, sweep) && sweep.time == 0.0f && sweep.normal[0] == -1);
+
+    // Motion diagonal to the floor stops on the axis that made contact
+    const float diagonal[3] = { 3.0f, -6.0f, 0.0f };
+    TEST_CHECK(SweepVoxels(room, boxMin, boxMax, diagonal, sweep) && sweep.normal[1] == 1);
+
+    // Block picking cost over a view's worth of rays
+    const int pickRays = 100000;
+    auto start = std::chrono::high_resolution_clock::now();
+    int picked = 0;
+    for (int i = 0; i < pickRays; i++) {
+        const float direction[3] = { directions[3 * (i % rays)], directions[3 * (i % rays) + 1] - 0.5f,
+                                     directions[3 * (i % rays) + 2] };
+        picked += RaycastVoxels(voxels, &origins[3 * (i % rays)], direction, 8.0f, hit) ? 1 : 0;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    TEST_CHECK(picked > 0);
+    std::cout << "  block pick (8 blocks reach): "
+              << std::chrono::duration<double, std::nano>(end - start).count() / pickRays << " ns" << std::endl;
+
+    std::cout << "Voxel Raycast test passed!" << std::endl;
+}